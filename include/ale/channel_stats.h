@@ -0,0 +1,163 @@
+/**
+ * @file channel_stats.h
+ * @brief Per-channel occupancy and noise statistics for PC-ALE 2.0
+ *
+ * LQA entries only change when something is decoded. This service keeps
+ * statistics for every scanned channel from demodulator band energy
+ * alone, so channel selection also knows which frequencies are noisy or
+ * in use when no station has sounded on them:
+ * - Busy fraction: frames whose in-band level is over the noise floor
+ *   (BandEnergy::is_active, as ChannelOccupancyDetector), and how many
+ *   looked tonal
+ * - Noise floor percentiles, from a fixed histogram
+ * - Activity events: each run of busy frames counts once
+ *
+ * Frames are counted into fixed-size time buckets (a ring per channel),
+ * so memory is fixed per channel, adding a frame is a few increments,
+ * and old data ages out as its bucket is reused.
+ */
+
+#pragma once
+
+#include "fft_demodulator.h"
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace ale {
+
+constexpr int CHANNEL_STATS_NOISE_BINS = 64;   ///< Noise floor histogram bins
+
+/**
+ * @brief Configuration for channel statistics
+ */
+struct ChannelStatsConfig {
+    uint32_t bucket_ms = 60000;       ///< Bucket length (1 minute)
+    uint32_t bucket_count = 60;       ///< Buckets kept per channel (1 hour)
+    float threshold_db = 6.0f;        ///< In-band level over noise floor for a busy frame
+    float min_magnitude = 1.0f;       ///< Absolute in-band level below which a frame is idle
+    float tonal_ratio = 3.0f;         ///< Peak-to-mean ratio of a tonal (data) frame
+    float noise_min_db = -40.0f;      ///< Lower edge of the noise histogram (dB magnitude)
+    float noise_bin_db = 2.0f;        ///< Histogram bin width
+};
+
+/**
+ * @brief Statistics of one channel over a time window
+ */
+struct ChannelStatsSummary {
+    uint32_t frequency_hz;           ///< Channel frequency
+    uint32_t frames;                 ///< Frames measured in the window
+    float busy_fraction;             ///< Fraction of busy frames (0-1)
+    float tonal_fraction;            ///< Fraction of busy frames that looked tonal (0-1)
+    uint32_t events;                 ///< Runs of busy frames started in the window
+    float noise_p10_db;              ///< Noise floor percentiles (dB magnitude)
+    float noise_p50_db;
+    float noise_p90_db;
+    float peak_level_db;             ///< Highest in-band level over noise floor
+    uint32_t last_measurement_ms;    ///< Last frame on this channel (any window)
+    
+    ChannelStatsSummary()
+        : frequency_hz(0), frames(0), busy_fraction(0.0f), tonal_fraction(0.0f), events(0),
+          noise_p10_db(0.0f), noise_p50_db(0.0f), noise_p90_db(0.0f), peak_level_db(0.0f),
+          last_measurement_ms(0) {}
+};
+
+/**
+ * @brief Occupancy and noise statistics per channel
+ *
+ * Usage:
+ * @code
+ * ChannelStats stats;
+ *
+ * // Per FFT frame while scanning
+ * stats.add_measurement(radio_frequency, demod.measure_band_energy(), now_ms);
+ *
+ * // Channel selection
+ * ChannelStatsSummary s = stats.get_summary(7073000, 600000, now_ms);
+ * if (s.frames > 0 && s.busy_fraction > 0.5f) {
+ *     // Occupied, try another channel
+ * }
+ * @endcode
+ */
+class ChannelStats {
+public:
+    /**
+     * @brief Construct empty statistics
+     */
+    ChannelStats();
+    
+    /**
+     * @brief Set configuration (clears collected statistics)
+     */
+    void set_config(const ChannelStatsConfig& config);
+    
+    /**
+     * @brief Get configuration
+     */
+    const ChannelStatsConfig& get_config() const { return config_; }
+    
+    /**
+     * @brief Add one frame of band energy measured on a channel
+     *
+     * @param frequency_hz Channel the receiver was tuned to
+     * @param energy Band energy of the frame
+     * @param now_ms Frame time
+     */
+    void add_measurement(uint32_t frequency_hz, const BandEnergy& energy, uint32_t now_ms);
+    
+    /**
+     * @brief Summarize a channel over the most recent window
+     *
+     * @param frequency_hz Channel frequency
+     * @param window_ms Window length (rounded up to whole buckets, at most
+     *        bucket_count buckets)
+     * @param now_ms Current time
+     * @return Summary (frames == 0 if nothing was measured in the window)
+     */
+    ChannelStatsSummary get_summary(uint32_t frequency_hz, uint32_t window_ms,
+                                    uint32_t now_ms) const;
+    
+    /**
+     * @brief Summaries of every measured channel, by frequency
+     */
+    std::vector<ChannelStatsSummary> get_all_summaries(uint32_t window_ms, uint32_t now_ms) const;
+    
+    /**
+     * @brief Number of channels with statistics
+     */
+    size_t get_channel_count() const { return channels_.size(); }
+    
+    /**
+     * @brief Drop all statistics
+     */
+    void clear();
+    
+private:
+    struct Bucket {
+        uint32_t epoch;              ///< now_ms / bucket_ms when filled
+        uint32_t frames;
+        uint32_t busy_frames;
+        uint32_t tonal_frames;
+        uint32_t events;
+        float peak_level_db;
+        uint32_t noise[CHANNEL_STATS_NOISE_BINS];
+    };
+    
+    struct Channel {
+        std::vector<Bucket> buckets; ///< Ring indexed by epoch % bucket_count
+        bool busy;                   ///< Last frame was busy (event edges)
+        uint32_t last_measurement_ms;
+    };
+    
+    ChannelStatsConfig config_;                  ///< Configuration
+    std::map<uint32_t, Channel> channels_;       ///< Statistics by frequency
+    uint32_t cached_frequency_;                  ///< Channel of the last frame
+    Channel* cached_channel_;                    ///< Its statistics (receivers dwell)
+    
+    /**
+     * @brief Percentile of a noise histogram (bin center, dB)
+     */
+    float noise_percentile(const uint32_t* histogram, uint32_t total, float fraction) const;
+};
+
+} // namespace ale
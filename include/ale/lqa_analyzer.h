@@ -10,6 +10,7 @@
 
 #pragma once
 
+#include "ale/channel_stats.h"
 #include "ale/lqa_database.h"
 #include "ale/lqa_metrics.h"
 #include <cstdint>
@@ -19,6 +20,8 @@
 
 namespace ale {
 
+class SoundingScheduler;
+
 /**
  * @brief Channel ranking entry
  * 
@@ -45,6 +48,8 @@ struct AnalyzerConfig {
     uint32_t sounding_interval_ms = 300000; ///< Sounding interval (5 minutes)
     bool prefer_recent_contacts = true;   ///< Weight recent contacts higher
     bool enable_automatic_sounding = false; ///< Auto-sound periodically
+    uint32_t occupancy_window_ms = 600000; ///< Channel statistics window (10 minutes)
+    float max_busy_fraction = 0.5f;       ///< Busier channels are not selected
 };
 
 /**
@@ -193,6 +198,38 @@ public:
      */
     void set_sounding_callback(std::function<void(uint32_t)> callback);
     
+    /**
+     * @brief Attach sounding scheduler for automatic sounding
+     * 
+     * When attached, update() syncs channel scores into the scheduler and
+     * requests soundings for its planned batch instead of every due
+     * channel. Pass nullptr to restore the fixed-interval behavior.
+     * 
+     * @param scheduler Scheduler (not owned), or nullptr
+     */
+    void set_scheduler(SoundingScheduler* scheduler);
+    
+    /**
+     * @brief Attach channel occupancy/noise statistics
+     * 
+     * When attached, channels busier than max_busy_fraction over the
+     * last occupancy_window_ms are skipped by get_best_channel() and
+     * get_best_channel_for_station(), and ranked scores are scaled by
+     * the idle fraction. Statistics must be fed with the analyzer's clock
+     * (ms since epoch). Pass nullptr to select on LQA alone.
+     * 
+     * @param stats Statistics (not owned), or nullptr
+     */
+    void set_channel_stats(ChannelStats* stats);
+    
+    /**
+     * @brief Get occupancy/noise statistics of a channel
+     * 
+     * @param frequency_hz Channel frequency
+     * @return Summary over occupancy_window_ms (frames == 0 if none)
+     */
+    ChannelStatsSummary get_channel_statistics(uint32_t frequency_hz) const;
+    
     /**
      * @brief Update analyzer (call periodically in main loop)
      * 
@@ -242,9 +279,21 @@ private:
      */
     std::string score_to_quality_level(float score) const;
     
+    /**
+     * @brief Check if channel statistics show the channel occupied
+     */
+    bool is_channel_occupied(uint32_t frequency_hz, uint32_t now_ms) const;
+    
+    /**
+     * @brief Idle fraction of a channel (1 without statistics)
+     */
+    float idle_factor(uint32_t frequency_hz, uint32_t now_ms) const;
+    
     LQADatabase* database_;                      ///< LQA database
     AnalyzerConfig config_;                      ///< Configuration
     std::function<void(uint32_t)> sounding_cb_;  ///< Sounding callback
+    SoundingScheduler* scheduler_;               ///< Optional sounding scheduler
+    ChannelStats* channel_stats_;                ///< Optional occupancy statistics
 };
 
 } // namespace ale
@@ -13,6 +13,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -52,6 +53,46 @@ struct LQAEntry {
           sample_count(0) {}
 };
 
+constexpr size_t LQA_UPDATE_STATION_LENGTH = 15;   ///< Longest ALE address
+constexpr uint8_t LQA_UPDATE_EXTENDED = 0x01;      ///< SINAD, multipath, noise floor valid
+constexpr uint8_t LQA_UPDATE_SOUNDING = 0x02;      ///< Sounding: also update channel entry
+
+/**
+ * @brief One measurement, as a fixed-size record
+ *
+ * Arguments of one update_entry() or update_entry_extended() call,
+ * without heap storage, so records can be queued between threads
+ * (see LQAUpdateQueue).
+ */
+struct LQAUpdate {
+    uint32_t frequency_hz;           ///< Channel frequency in Hz
+    uint32_t timestamp_ms;           ///< Measurement time (0 = time applied)
+    float snr_db;
+    float ber;
+    float sinad_db;                  ///< Only with LQA_UPDATE_EXTENDED
+    float multipath_score;           ///< Only with LQA_UPDATE_EXTENDED
+    float noise_floor_dbm;           ///< Only with LQA_UPDATE_EXTENDED
+    int32_t fec_errors;
+    int32_t total_words;
+    uint8_t flags;                   ///< LQA_UPDATE_* bits
+    uint8_t station_length;
+    char station[LQA_UPDATE_STATION_LENGTH];   ///< Remote station, not terminated
+    
+    LQAUpdate()
+        : frequency_hz(0), timestamp_ms(0), snr_db(0.0f), ber(0.0f), sinad_db(0.0f),
+          multipath_score(0.0f), noise_floor_dbm(-120.0f), fec_errors(0), total_words(0),
+          flags(0), station_length(0), station() {}
+    
+    /**
+     * @brief Set station (longer addresses are truncated)
+     */
+    void set_station(const std::string& address);
+    
+    std::string get_station() const { return std::string(station, station_length); }
+    
+    bool same_key(const LQAUpdate& other) const;
+};
+
 /**
  * @brief Configuration parameters for LQA scoring algorithm
  * 
@@ -171,6 +212,34 @@ public:
                               int total_words,
                               uint32_t timestamp_ms = 0);
     
+    /**
+     * @brief Fold in an entry reported by another station
+     * 
+     * SNR and BER are averaged into the local entry as in update_entry(),
+     * except that the remote observation counts as weight samples rather
+     * than one. Reports no newer than the local entry's last activity are
+     * ignored, so a table received twice is folded in once.
+     * 
+     * @param remote Remote entry, timestamps on the local clock
+     * @param weight Trust in remote data relative to a local sample (0-1)
+     * @return true if folded in
+     */
+    bool merge_entry(const LQAEntry& remote, float weight);
+    
+    /**
+     * @brief Apply a batch of update records in order
+     *
+     * Same result as calling update_entry() (or update_entry_extended()
+     * for LQA_UPDATE_EXTENDED records) once per record. Consecutive
+     * records for the same channel and station share one index lookup
+     * and one rescore, so batches grouped by key are cheapest.
+     * LQA_UPDATE_SOUNDING is not interpreted here.
+     *
+     * @param updates Records
+     * @param count Number of records
+     */
+    void apply_updates(const LQAUpdate* updates, size_t count);
+    
     /**
      * @brief Get LQA entry for specific channel/station
      * 
@@ -211,6 +280,27 @@ public:
      */
     int prune_stale_entries();
     
+    /**
+     * @brief Remove entries stale at now_ms, oldest first
+     * 
+     * Entries are kept in a time-ordered expiry index, so only expired
+     * entries are visited. A limit lets the main loop prune in small
+     * slices; call again (or check next_expiry()) for the rest.
+     * 
+     * @param now_ms Reference time
+     * @param limit Most entries to remove (0 = no limit)
+     * @return Number of entries removed
+     */
+    int prune_expired(uint32_t now_ms, size_t limit = 0);
+    
+    /**
+     * @brief Time from which the least recently active entry is stale
+     * 
+     * @param expiry_ms Set to the first time prune_expired() removes it
+     * @return false if the database is empty
+     */
+    bool next_expiry(uint32_t& expiry_ms);
+    
     /**
      * @brief Clear all entries from database
      */
@@ -261,6 +351,29 @@ public:
      * @return Composite score (0-31)
      */
     float compute_score(const LQAEntry& entry) const;
+    
+    /**
+     * @brief Recompute the score of every entry in one pass
+     * 
+     * The recency term decays with time, so stored scores go stale;
+     * call periodically to refresh them. set_config() rescores by itself.
+     * Runs over the score columns only, so it stays cheap for thousands
+     * of entries.
+     * 
+     * @param now_ms Reference time (0 = use current time)
+     */
+    void rescore_all(uint32_t now_ms = 0);
+    
+    /**
+     * @brief Score every entry under another configuration (what-if)
+     * 
+     * Stored scores are left unchanged.
+     * 
+     * @param config Configuration to evaluate
+     * @param now_ms Reference time (0 = use current time)
+     * @return Scores in get_all_entries() order
+     */
+    std::vector<float> score_all(const LQAConfig& config, uint32_t now_ms = 0) const;
 
 private:
     /**
@@ -277,6 +390,131 @@ private:
         }
     };
     
+    /**
+     * @brief Scoring constants derived from LQAConfig
+     */
+    struct ScoreParams {
+        float snr_weight;
+        float success_weight;
+        float recency_weight;
+        uint32_t max_age_ms;         ///< Clamped to fit int32 (float conversion)
+        float max_age;
+    };
+    
+    /**
+     * @brief Entries stored column by column (structure of arrays)
+     * 
+     * Row order is arbitrary; index_ maps keys to rows. The score inputs
+     * sit in their own contiguous columns so the scoring kernel can run
+     * over the whole table as one branch-free, vectorizable loop.
+     */
+    struct EntryColumns {
+        std::vector<uint32_t> frequency_hz;
+        std::vector<std::string> remote_station;
+        std::vector<float> snr_db;
+        std::vector<float> ber;
+        std::vector<float> sinad_db;
+        std::vector<int> fec_errors;
+        std::vector<int> total_words;
+        std::vector<float> multipath_score;
+        std::vector<float> noise_floor_dbm;
+        std::vector<uint32_t> last_sounding_ms;
+        std::vector<uint32_t> last_contact_ms;
+        std::vector<uint32_t> last_activity_ms;  ///< max(last_sounding_ms, last_contact_ms)
+        std::vector<float> score;
+        std::vector<uint32_t> sample_count;
+        
+        size_t size() const { return frequency_hz.size(); }
+    };
+    
+    static ScoreParams make_score_params(const LQAConfig& config);
+    
+    /**
+     * @brief Score count rows of score inputs (shared by every scoring path)
+     */
+    static void score_kernel(const ScoreParams& params,
+                             const float* snr_db,
+                             const float* ber,
+                             const int* total_words,
+                             const uint32_t* last_activity_ms,
+                             uint32_t now_ms,
+                             float* scores,
+                             size_t count);
+    
+    /**
+     * @brief Find row for key, appending an empty one if missing
+     * @param created Set when the row was appended
+     */
+    size_t find_or_add_row(uint32_t frequency_hz, const std::string& remote_station,
+                           bool& created);
+    
+    /**
+     * @brief Append row holding entry
+     */
+    void add_row(const LQAEntry& entry);
+    
+    /**
+     * @brief Copy row out as an entry
+     */
+    LQAEntry row_entry(size_t row) const;
+    
+    /**
+     * @brief Record activity on a row and rescore it
+     */
+    void touch_row(size_t row, const std::string& remote_station, uint32_t now_ms);
+    
+    /**
+     * @brief Update row's last activity (and expiry) and rescore it
+     */
+    void refresh_row(size_t row);
+    
+    /**
+     * @brief Average one update record into row (timestamps untouched)
+     */
+    void fold_update(size_t row, bool created, const LQAUpdate& update);
+    
+    /**
+     * @brief Drop row (the last row moves into its place)
+     */
+    void remove_row(size_t row);
+    
+    /**
+     * @brief Expiry index item: an entry's activity time when pushed
+     * 
+     * Items are not removed when an entry is updated or dropped; one
+     * whose time no longer matches its entry is skipped when it surfaces.
+     */
+    struct ExpiryItem {
+        uint32_t last_activity_ms;
+        EntryKey key;
+    };
+    
+    /**
+     * @brief Heap order: least recent activity on top (wrap-safe for
+     * entries less than 24 days apart)
+     */
+    struct ExpiryLater {
+        bool operator()(const ExpiryItem& a, const ExpiryItem& b) const {
+            return static_cast<int32_t>(a.last_activity_ms - b.last_activity_ms) > 0;
+        }
+    };
+    
+    /**
+     * @brief Add row's current activity time to the expiry index
+     */
+    void push_expiry(size_t row);
+    
+    /**
+     * @brief Drop superseded items from the top of the expiry index
+     * @return Row of the least recently active entry, or -1 if empty
+     */
+    long top_expiry_row();
+    
+    /**
+     * @brief Rebuild the expiry index from the rows
+     */
+    void rebuild_expiry();
+    
     /**
      * @brief Get current timestamp in milliseconds
      * @return Milliseconds since epoch
@@ -295,7 +533,10 @@ private:
                                uint32_t old_samples) const;
     
     LQAConfig config_;                           ///< Configuration parameters
-    std::map<EntryKey, LQAEntry> entries_;      ///< Database of LQA entries
+    ScoreParams params_;                         ///< Derived from config_
+    EntryColumns columns_;                       ///< Database of LQA entries
+    std::map<EntryKey, size_t> index_;           ///< Key -> row in columns_
+    std::vector<ExpiryItem> expiry_;             ///< Min-heap by last activity
 };
 
 } // namespace ale
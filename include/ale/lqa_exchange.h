@@ -0,0 +1,145 @@
+/**
+ * @file lqa_exchange.h
+ * @brief Compact LQA table exchange between stations for PC-ALE 2.0
+ *
+ * Lets stations in a net share what their LQA databases know, so each
+ * can rank channels without sounding every one itself. Tables are
+ * small enough to ship as an AMD/DBM message or over FS-1052:
+ * - Entries sorted by frequency, frequencies delta-encoded as varints
+ * - Station addresses interned once per table, entries refer by index
+ * - SNR (0.5 dB steps), BER (logarithmic) and score (1/8 steps) in a
+ *   byte each
+ * - Activity times as seconds before the sender's clock at encoding, so
+ *   stations need no common time base
+ * - Delta tables carry only entries active since a given time
+ *
+ * Format (version 1, multi-byte fields big-endian):
+ * @code
+ * 'L' 'X' version flags sender_time:32 since:32
+ * station_count:varint { length:8 address }
+ * entry_count:varint { freq_delta:varint station:varint snr:8 ber:8
+ *                      score:8 age_s:varint samples:varint words:varint
+ *                      entry_flags:8 }
+ * @endcode
+ *
+ * Only score inputs travel; SINAD, multipath and noise floor stay local.
+ */
+
+#pragma once
+
+#include "ale/lqa_database.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ale {
+
+constexpr uint8_t LQA_EXCHANGE_VERSION = 1;
+
+/**
+ * @brief One entry of a received table
+ */
+struct LQAExchangeEntry {
+    uint32_t frequency_hz;           ///< Channel frequency in Hz
+    std::string remote_station;      ///< Station the sender heard ("" for sounding)
+    float snr_db;                    ///< Quantized to 0.5 dB
+    float ber;                       ///< Quantized logarithmically
+    float score;                     ///< Sender's score, quantized to 1/8
+    uint32_t age_s;                  ///< Seconds since last activity at sender_time_ms
+    uint32_t sample_count;
+    uint32_t total_words;
+    bool sounding;                   ///< Last activity was a sounding, not a contact
+    
+    LQAExchangeEntry()
+        : frequency_hz(0), snr_db(0.0f), ber(0.0f), score(0.0f), age_s(0),
+          sample_count(0), total_words(0), sounding(false) {}
+};
+
+/**
+ * @brief Decoded table
+ */
+struct LQAExchangeTable {
+    uint32_t sender_time_ms;         ///< Sender's clock when encoded
+    uint32_t since_ms;               ///< Delta base on the sender's clock (0 = full table)
+    std::vector<LQAExchangeEntry> entries;
+    
+    LQAExchangeTable() : sender_time_ms(0), since_ms(0) {}
+};
+
+/**
+ * @brief Encodes local and merges remote LQA tables
+ *
+ * Usage:
+ * @code
+ * LQAExchange exchange(&lqa_database);
+ *
+ * // Sender: everything that changed since the last broadcast
+ * std::vector<uint8_t> message = exchange.encode(now_ms, last_sent_ms);
+ *
+ * // Receiver
+ * LQAExchangeTable table;
+ * if (LQAExchange::decode(data, length, table)) {
+ *     exchange.merge(table, "ALFA", "BRAVO", now_ms);
+ * }
+ * @endcode
+ */
+class LQAExchange {
+public:
+    /**
+     * @brief Construct exchange for a database
+     * @param database LQA database to encode from and merge into
+     */
+    explicit LQAExchange(LQADatabase* database = nullptr);
+    
+    /**
+     * @brief Set LQA database
+     */
+    void set_database(LQADatabase* database);
+    
+    /**
+     * @brief Trust in remote data relative to a local sample (default 0.5)
+     */
+    void set_merge_weight(float weight);
+    
+    /**
+     * @brief Encode the local table
+     *
+     * @param now_ms Current time (entry ages are taken from it)
+     * @param since_ms Only entries active after this time (0 = all)
+     * @return Encoded table
+     */
+    std::vector<uint8_t> encode(uint32_t now_ms, uint32_t since_ms = 0) const;
+    
+    /**
+     * @brief Decode a table
+     * @return false if malformed or of an unknown version
+     */
+    static bool decode(const uint8_t* data, size_t length, LQAExchangeTable& table);
+    
+    /**
+     * @brief Fold a received table into the local database
+     *
+     * Entries about local_station describe the path between the two
+     * stations and are filed under source_station (propagation is
+     * reciprocal); all others keep their station. Activity times are
+     * placed on the local clock by age, and entries are folded in with
+     * LQADatabase::merge_entry() at the merge weight.
+     *
+     * @param table Decoded table
+     * @param source_station Sender's address
+     * @param local_station This station's address
+     * @param now_ms Current local time
+     * @return Number of entries folded in
+     */
+    int merge(const LQAExchangeTable& table,
+              const std::string& source_station,
+              const std::string& local_station,
+              uint32_t now_ms);
+    
+private:
+    LQADatabase* database_;          ///< LQA database
+    float merge_weight_;             ///< Remote observation weight
+};
+
+} // namespace ale
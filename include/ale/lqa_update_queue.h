@@ -0,0 +1,168 @@
+/**
+ * @file lqa_update_queue.h
+ * @brief Lock-free LQA update queue for PC-ALE 2.0
+ *
+ * Receiver threads post measurements as LQAUpdate records instead of
+ * calling LQADatabase directly; one owner thread drains the queue into
+ * the database in batches. Producers never block each other or the
+ * owner, and the database needs no lock.
+ *
+ * Bounded multi-producer single-consumer ring: each slot carries a
+ * sequence number telling producers and the consumer whose turn it is
+ * (one CAS per push, no CAS per pop). When the ring is full, push()
+ * fails and the record is counted as dropped.
+ *
+ * drain() groups a batch by channel and station (stable, so each key's
+ * records keep their order) and hands it to LQADatabase::apply_updates(),
+ * which then does one index lookup and one rescore per key instead of
+ * one per record. The result matches applying the records one by one.
+ */
+
+#pragma once
+
+#include "ale/lqa_database.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ale {
+
+struct MetricsSample;
+
+/**
+ * @brief Queue statistics
+ */
+struct LQAUpdateQueueStats {
+    uint64_t pushed;                 ///< Records accepted
+    uint64_t dropped;                ///< Records refused (ring full)
+    uint64_t applied;                ///< Records applied to the database
+    uint64_t batches;                ///< Non-empty drains
+    uint64_t keys;                   ///< Distinct channel/station runs applied
+};
+
+/**
+ * @brief Multi-producer single-consumer queue of LQA updates
+ *
+ * Usage:
+ * @code
+ * LQAUpdateQueue queue(&lqa_database);
+ *
+ * // Any receiver thread
+ * queue.push_update(7073000, "REMOTE", snr, ber, fec_errors, words);
+ *
+ * // Database owner thread, periodically
+ * queue.drain();
+ * @endcode
+ */
+class LQAUpdateQueue {
+public:
+    /**
+     * @brief Construct queue
+     * @param database Database drained into (owner thread only)
+     * @param capacity Ring size in records (rounded up to a power of two)
+     */
+    explicit LQAUpdateQueue(LQADatabase* database = nullptr, size_t capacity = 1024);
+    
+    LQAUpdateQueue(const LQAUpdateQueue&) = delete;
+    LQAUpdateQueue& operator=(const LQAUpdateQueue&) = delete;
+    
+    /**
+     * @brief Set LQA database (owner thread only)
+     */
+    void set_database(LQADatabase* database);
+    
+    /**
+     * @brief Post a record (any thread)
+     *
+     * A timestamp of 0 is replaced by the current time here, so the
+     * record keeps its measurement time however late it is drained.
+     *
+     * @return false if the ring is full (record dropped)
+     */
+    bool push(const LQAUpdate& update);
+    
+    /**
+     * @brief Post the equivalent of LQADatabase::update_entry() (any thread)
+     */
+    bool push_update(uint32_t frequency_hz,
+                     const std::string& remote_station,
+                     float snr_db,
+                     float ber,
+                     int fec_errors,
+                     int total_words,
+                     uint32_t timestamp_ms = 0);
+    
+    /**
+     * @brief Post the equivalent of LQAAnalyzer::process_sounding() (any thread)
+     *
+     * One record; drain() applies it to both the channel entry and the
+     * station's entry.
+     */
+    bool push_sounding(const std::string& station,
+                       uint32_t frequency_hz,
+                       float snr_db,
+                       float ber,
+                       uint32_t timestamp_ms = 0);
+    
+    /**
+     * @brief Post the equivalent of LQAAnalyzer::process_sounding_extended() (any thread)
+     */
+    bool push_sounding_extended(const std::string& station,
+                                uint32_t frequency_hz,
+                                const MetricsSample& sample);
+    
+    /**
+     * @brief Apply queued records to the database (owner thread only)
+     *
+     * Records taken while no database is set are discarded.
+     *
+     * @param max_records Stop after this many records (0 = all queued)
+     * @return Number of records taken from the ring
+     */
+    size_t drain(size_t max_records = 0);
+    
+    /**
+     * @brief Ring capacity in records
+     */
+    size_t capacity() const { return mask_ + 1; }
+    
+    /**
+     * @brief Approximate number of queued records (owner thread)
+     */
+    size_t size_approx() const;
+    
+    /**
+     * @brief Get statistics (owner thread; pushed/dropped may lag producers)
+     */
+    LQAUpdateQueueStats get_stats() const;
+    
+private:
+    struct Slot {
+        std::atomic<size_t> sequence;    ///< == position: free, == position + 1: full
+        LQAUpdate update;
+    };
+    
+    LQADatabase* database_;              ///< Database drained into
+    std::unique_ptr<Slot[]> slots_;      ///< Ring
+    size_t mask_;                        ///< Capacity - 1
+    
+    alignas(64) std::atomic<size_t> tail_;      ///< Next position to claim (producers)
+    std::atomic<uint64_t> pushed_;
+    std::atomic<uint64_t> dropped_;
+    
+    alignas(64) size_t head_;                   ///< Next position to take (consumer)
+    std::vector<LQAUpdate> batch_;              ///< Drain scratch, reused
+    uint64_t applied_;
+    uint64_t batches_;
+    uint64_t keys_;
+    
+    /**
+     * @brief Take one record (consumer)
+     */
+    bool pop(LQAUpdate& update);
+};
+
+} // namespace ale
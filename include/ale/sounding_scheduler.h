@@ -0,0 +1,200 @@
+/**
+ * @file sounding_scheduler.h
+ * @brief Multi-channel sounding scheduler
+ *
+ * Decides when and on which channels to sound. Replaces the fixed
+ * per-channel interval check with:
+ *  - Jittered due times, so soundings spread out in time and stations
+ *    sharing a scan list do not key up together
+ *  - Batching of due channels (plus nearly-due ones pulled forward)
+ *    into one back-to-back transmission
+ *  - Priority = staleness x value, so old LQA on good channels is
+ *    refreshed first
+ *  - A call-activity histogram; soundings are held off during periods
+ *    when calls are likely unless a channel is badly overdue
+ *
+ * Clean-room implementation from MIL-STD-188-141B specification.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ale {
+
+class LQAAnalyzer;
+
+/**
+ * @brief Configuration for sounding scheduler
+ */
+struct SchedulerConfig {
+    uint32_t interval_ms = 300000;          ///< Nominal per-channel sounding interval
+    float jitter_fraction = 0.1f;           ///< +/- spread applied to each due time
+    uint32_t max_batch = 4;                 ///< Channels per back-to-back batch
+    float pull_forward = 0.75f;             ///< Staleness at which a channel may join a batch early
+    uint32_t activity_bin_ms = 900000;      ///< Call histogram bin width (15 minutes)
+    uint32_t activity_period_ms = 86400000; ///< Call histogram period (1 day)
+    float busy_likelihood = 0.5f;           ///< Relative call activity that holds off sounding
+    float max_staleness = 2.0f;             ///< Staleness that overrides the hold-off
+    std::string self_address;               ///< Own address; seeds the jitter so stations differ
+    uint32_t seed = 0;                      ///< Jitter random seed (0 = derive from self_address)
+};
+
+/**
+ * @brief One channel selected for sounding
+ */
+struct ScheduledSounding {
+    uint32_t frequency_hz;    ///< Channel frequency
+    float priority;           ///< staleness x value
+    float staleness;          ///< Age of LQA data in sounding intervals
+    
+    ScheduledSounding() : frequency_hz(0), priority(0.0f), staleness(0.0f) {}
+};
+
+/**
+ * @brief Batch of soundings to transmit back to back
+ */
+struct SoundingBatch {
+    uint32_t start_ms;                        ///< Planned start time
+    std::vector<ScheduledSounding> channels;  ///< Channels, highest priority first
+    bool held_off;                            ///< Due channels held off for call activity
+    
+    SoundingBatch() : start_ms(0), held_off(false) {}
+    
+    bool empty() const { return channels.empty(); }
+};
+
+/**
+ * @brief Sounding scheduler
+ *
+ * Usage:
+ * @code
+ * SchedulerConfig config;
+ * config.self_address = "K6ABC";
+ * SoundingScheduler scheduler(config);
+ * scheduler.add_channel(7073000);
+ * scheduler.add_channel(14107000, 2.0f);   // Preferred channel
+ *
+ * // Main loop
+ * SoundingBatch batch = scheduler.plan(now_ms);
+ * for (const auto& s : batch.channels) {
+ *     radio.tune(s.frequency_hz);
+ *     state_machine.send_sounding();
+ * }
+ * scheduler.mark_batch_sounded(batch, now_ms);
+ * @endcode
+ */
+class SoundingScheduler {
+public:
+    explicit SoundingScheduler(const SchedulerConfig& config = SchedulerConfig());
+    
+    /**
+     * @brief Set configuration (reseeds jitter generator)
+     */
+    void set_config(const SchedulerConfig& config);
+    
+    /**
+     * @brief Get current configuration
+     */
+    SchedulerConfig get_config() const;
+    
+    /**
+     * @brief Add channel to schedule (due immediately)
+     * @param frequency_hz Channel frequency
+     * @param value Relative importance (1.0 = normal)
+     */
+    void add_channel(uint32_t frequency_hz, float value = 1.0f);
+    
+    /**
+     * @brief Remove channel from schedule
+     * @return true if channel was scheduled
+     */
+    bool remove_channel(uint32_t frequency_hz);
+    
+    /**
+     * @brief Number of scheduled channels
+     */
+    size_t get_channel_count() const;
+    
+    /**
+     * @brief Update channel LQA score and freshness
+     *
+     * Fresh LQA from any source (received sounding or call) postpones
+     * the channel's next sounding.
+     *
+     * @param frequency_hz Channel frequency
+     * @param score Aggregate LQA score (0-31)
+     * @param last_update_ms Time of latest LQA data
+     */
+    void update_channel_quality(uint32_t frequency_hz, float score, uint32_t last_update_ms);
+    
+    /**
+     * @brief Pull channel scores and freshness from analyzer
+     *
+     * Channels known to the analyzer but not yet scheduled are added
+     * with value 1.0.
+     */
+    void sync_from_analyzer(const LQAAnalyzer& analyzer);
+    
+    /**
+     * @brief Record a call heard or placed (feeds activity histogram)
+     */
+    void record_call_activity(uint32_t time_ms);
+    
+    /**
+     * @brief Relative call activity at a time of period (0.0-1.0)
+     */
+    float call_likelihood(uint32_t time_ms) const;
+    
+    /**
+     * @brief Plan the next sounding batch
+     * @param now_ms Current time
+     * @return Batch to transmit now (empty if nothing due)
+     */
+    SoundingBatch plan(uint32_t now_ms) const;
+    
+    /**
+     * @brief Record sounding sent on a channel and schedule the next one
+     */
+    void mark_sounded(uint32_t frequency_hz, uint32_t time_ms);
+    
+    /**
+     * @brief Record every channel of a batch as sounded
+     */
+    void mark_batch_sounded(const SoundingBatch& batch, uint32_t time_ms);
+    
+    /**
+     * @brief Earliest due time over all channels
+     * @param now_ms Current time (returned if something is already due)
+     */
+    uint32_t next_due_ms(uint32_t now_ms) const;
+    
+private:
+    /**
+     * @brief Per-channel schedule state
+     */
+    struct ChannelSchedule {
+        uint32_t frequency_hz;
+        float value;
+        float score;
+        uint32_t last_refresh_ms;   ///< Latest sounding sent or LQA received
+        uint32_t due_ms;            ///< Jittered next sounding time
+        bool refreshed;             ///< false until first sounding/LQA
+    };
+    
+    ChannelSchedule* find_channel(uint32_t frequency_hz);
+    float staleness(const ChannelSchedule& channel, uint32_t now_ms) const;
+    float priority(const ChannelSchedule& channel, uint32_t now_ms) const;
+    uint32_t jittered_interval();
+    void refresh(ChannelSchedule& channel, uint32_t time_ms);
+    
+    SchedulerConfig config_;                     ///< Configuration
+    std::vector<ChannelSchedule> channels_;      ///< Scheduled channels
+    std::vector<uint32_t> activity_bins_;        ///< Call histogram
+    uint32_t rng_state_;                         ///< Jitter generator state
+};
+
+} // namespace ale
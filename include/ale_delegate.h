@@ -0,0 +1,117 @@
+/**
+ * \file ale_delegate.h
+ * \brief Non-owning callback delegate (function pointer + context)
+ *
+ * A Delegate is two words: an opaque object pointer and a stub function
+ * that casts it back and makes a direct call. Binding never allocates and
+ * invoking is a single indirect call, unlike std::function which may
+ * heap-allocate captures and adds a type-erased dispatch layer.
+ *
+ * The delegate does not own its target: the bound object (or callable)
+ * must outlive every call through the delegate.
+ */
+
+#pragma once
+
+#include <utility>
+
+namespace ale {
+
+template <typename Signature>
+class Delegate;
+
+/**
+ * \class Delegate
+ * Lightweight callback bound to a free function, member function or
+ * externally owned callable
+ *
+ * Usage:
+ * \code
+ * struct Radio { void tune(const Channel& ch); };
+ * Radio radio;
+ * auto d = Delegate<void(const Channel&)>::from_method<Radio, &Radio::tune>(&radio);
+ * d(channel);   // direct call to radio.tune(channel)
+ * \endcode
+ */
+template <typename R, typename... Args>
+class Delegate<R(Args...)> {
+public:
+    using Stub = R (*)(void*, Args...);
+
+    constexpr Delegate() : object(nullptr), stub(nullptr) {}
+
+    /**
+     * Bind raw context pointer and stub (C-style callback)
+     */
+    constexpr Delegate(void* context, Stub function) : object(context), stub(function) {}
+
+    /**
+     * Bind free function known at compile time
+     */
+    template <R (*Function)(Args...)>
+    static Delegate from_function() {
+        return Delegate(nullptr, &function_stub<Function>);
+    }
+
+    /**
+     * Bind member function of an object
+     */
+    template <typename T, R (T::*Method)(Args...)>
+    static Delegate from_method(T* instance) {
+        return Delegate(instance, &method_stub<T, Method>);
+    }
+
+    /**
+     * Bind const member function of an object
+     */
+    template <typename T, R (T::*Method)(Args...) const>
+    static Delegate from_method(const T* instance) {
+        return Delegate(const_cast<T*>(instance), &const_method_stub<T, Method>);
+    }
+
+    /**
+     * Bind callable object (e.g. lambda) owned by the caller
+     */
+    template <typename F>
+    static Delegate from_callable(F& callable) {
+        return Delegate(&callable, &callable_stub<F>);
+    }
+
+    R operator()(Args... args) const {
+        return stub(object, std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const { return stub != nullptr; }
+
+    bool operator==(const Delegate& other) const {
+        return object == other.object && stub == other.stub;
+    }
+
+    bool operator!=(const Delegate& other) const { return !(*this == other); }
+
+private:
+    void* object;
+    Stub stub;
+
+    template <R (*Function)(Args...)>
+    static R function_stub(void*, Args... args) {
+        return Function(std::forward<Args>(args)...);
+    }
+
+    template <typename T, R (T::*Method)(Args...)>
+    static R method_stub(void* instance, Args... args) {
+        return (static_cast<T*>(instance)->*Method)(std::forward<Args>(args)...);
+    }
+
+    template <typename T, R (T::*Method)(Args...) const>
+    static R const_method_stub(void* instance, Args... args) {
+        return (static_cast<const T*>(instance)->*Method)(std::forward<Args>(args)...);
+    }
+
+    template <typename F>
+    static R callable_stub(void* callable, Args... args) {
+        return (*static_cast<F*>(callable))(std::forward<Args>(args)...);
+    }
+};
+
+} // namespace ale
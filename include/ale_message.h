@@ -3,6 +3,9 @@
  * \brief ALE message assembly and call type recognition
  * 
  * Assembles ALE words into complete messages and determines call type.
+ * Word order is checked by a table-driven automaton (WordSequenceValidator)
+ * one word at a time, so illegal sequences are dropped on the first bad
+ * word and a call completes as soon as its terminator arrives.
  * 
  * Specification: MIL-STD-188-141B Appendix A
  */
@@ -43,11 +46,86 @@ struct ALEMessage {
     std::vector<std::string> data_content;      ///< Data words
     std::vector<ALEWord> words;                 ///< All received words
     uint32_t start_time_ms;                     ///< First word timestamp
+    SampleTime start_sample;                    ///< First word sample time
     uint32_t duration_ms;                       ///< Message duration
     bool complete;                              ///< Message fully received
     
     ALEMessage() : call_type(CallType::UNKNOWN), start_time_ms(0), 
-                   duration_ms(0), complete(false) {}
+                   start_sample(SAMPLE_TIME_NONE), duration_ms(0), complete(false) {}
+};
+
+/**
+ * \enum SequenceState
+ * States of the word-sequence grammar automaton
+ */
+enum class SequenceState : uint8_t {
+    START = 0,      ///< No words accepted yet
+    THRU,           ///< Routing section (THRU address)
+    THRU_EXT,       ///< THRU address extended by DATA/REP
+    TO,             ///< Calling cycle, individual address
+    TO_EXT,         ///< TO address extended by DATA/REP
+    TWS,            ///< Calling cycle, net address
+    TWS_EXT,        ///< TWS address extended by DATA/REP
+    MESSAGE,        ///< Message section (CMD + DATA/REP)
+    SOUNDING,       ///< Accept: TIS sounding
+    INDIVIDUAL,     ///< Accept: TO ... FROM/TIS
+    NET,            ///< Accept: TWS ... FROM/TIS
+    AMD,            ///< Accept: calling cycle + message section + FROM/TIS
+    REJECT,         ///< Illegal word order
+    COUNT
+};
+
+/**
+ * \class WordSequenceValidator
+ * DFA over word preambles enforcing MIL-STD-188-141B sequence rules
+ * 
+ * Grammar (DATA/REP extend the preceding address, REP repeats it):
+ *   [THRU...] (TO... | TWS...) [CMD [DATA|REP|CMD]...] (FROM | TIS)
+ *   TIS                                          (sounding)
+ * 
+ * Transitions come from a constexpr [state][preamble] table; feeding a
+ * word is a single lookup. Accept and REJECT states are absorbing-to-reject,
+ * so any word after a terminator starts a new sequence.
+ */
+class WordSequenceValidator {
+public:
+    WordSequenceValidator() : current(SequenceState::START) {}
+    
+    /**
+     * Advance automaton by one word
+     * \param type Word preamble
+     * \return New state
+     */
+    SequenceState feed(WordType type) {
+        current = transition(current, type);
+        return current;
+    }
+    
+    /**
+     * Table lookup without changing state
+     */
+    static SequenceState transition(SequenceState state, WordType type);
+    
+    /**
+     * Check if a word of this type may begin a sequence
+     */
+    static bool can_start(WordType type) {
+        return transition(SequenceState::START, type) != SequenceState::REJECT;
+    }
+    
+    SequenceState state() const { return current; }
+    bool is_complete() const { return call_type() != CallType::UNKNOWN; }
+    bool is_rejected() const { return current == SequenceState::REJECT; }
+    
+    /**
+     * Call type of accepted sequence (UNKNOWN until complete)
+     */
+    CallType call_type() const;
+    
+    void reset() { current = SequenceState::START; }
+    
+private:
+    SequenceState current;
 };
 
 /**
@@ -60,7 +138,10 @@ public:
     
     /**
      * Add received word to assembler
-     * Automatically assembles into messages when sequence complete
+     * Automatically assembles into messages when sequence complete.
+     * A word that breaks the sequence grammar discards the partial
+     * message; if the word can itself begin a sequence, assembly
+     * restarts from it.
      * 
      * \param word Decoded ALE word
      * \return true if message complete (available via get_message())
@@ -90,22 +171,41 @@ public:
      */
     void set_timeout(uint32_t timeout_ms) { word_timeout_ms = timeout_ms; }
     
+    /**
+     * Serialize timeout and partially assembled words
+     */
+    void save_snapshot(SnapshotWriter& writer) const;
+    
+    /**
+     * Restore from snapshot by replaying saved words
+     * \param reader Snapshot reader
+     * \param time_shift_ms Added to saved word timestamps (clock rebase)
+     * \return false if snapshot section is truncated (assembler reset)
+     */
+    bool restore_snapshot(SnapshotReader& reader, uint32_t time_shift_ms = 0);
+    
 private:
     std::vector<ALEWord> current_words;
     ALEMessage current_message;
     bool active;
     uint32_t last_word_time_ms;
     uint32_t word_timeout_ms;
+    WordSequenceValidator validator;
+    
+    /**
+     * Determine call type of accepted sequence
+     */
+    CallType determine_call_type() const { return validator.call_type(); }
     
     /**
-     * Determine call type from word sequence
+     * Check if word sequence reached a terminator
      */
-    CallType determine_call_type(const std::vector<ALEWord>& words);
+    bool is_sequence_complete() const { return validator.is_complete(); }
     
     /**
-     * Check if word sequence is complete
+     * Begin a new message at the given first word's time
      */
-    bool is_sequence_complete(const std::vector<ALEWord>& words);
+    void start_message(const ALEWord& first_word);
     
     /**
      * Extract addresses from words
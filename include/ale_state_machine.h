@@ -7,14 +7,20 @@
  *  - Initiating outbound calls
  *  - Link handshake and establishment
  *  - Sounding/LQA operations
+ *  - Listen-before-transmit channel occupancy check
+ *  - Binary snapshot/restore of link state for fast restart
  * 
  * Specification: MIL-STD-188-141B Appendix A
  */
 
 #pragma once
 
+#include "ale_delegate.h"
 #include "ale_message.h"
+#include "channel_occupancy.h"
 #include "ale_word.h"
+#include "snapshot.h"
+#include "sample_clock.h"
 #include <cstdint>
 #include <vector>
 #include <string>
@@ -53,6 +59,10 @@ enum class ALEEvent {
     ERROR_OCCURRED      ///< Error condition
 };
 
+constexpr uint32_t ALE_STATE_COUNT = 7;    ///< Number of ALEState values
+constexpr uint32_t ALE_EVENT_COUNT = 10;   ///< Number of ALEEvent values
+constexpr uint32_t LINK_SNAPSHOT_VERSION = 1;  ///< Snapshot format version
+
 /**
  * \struct Channel
  * Radio channel definition
@@ -100,12 +110,51 @@ struct LinkQuality {
                     total_words(0), timestamp_ms(0) {}
 };
 
+/**
+ * \struct LBTConfig
+ * Listen-before-transmit policy for calls and soundings
+ */
+struct LBTConfig {
+    bool enabled;                   ///< Listen before every call/sounding
+    OccupancyConfig occupancy;      ///< Listen window and thresholds
+    uint32_t defer_ms;              ///< Back-off before re-listening when no channel is clear
+    uint32_t max_attempts;          ///< Busy windows before the transmission is abandoned
+    bool hop_on_busy;               ///< Move to next-best clear channel instead of deferring
+    
+    LBTConfig() : enabled(false), defer_ms(500), max_attempts(4), hop_on_busy(true) {}
+};
+
+/**
+ * \struct LBTStats
+ * Listen-before-transmit counters
+ */
+struct LBTStats {
+    uint32_t clear_windows;         ///< Windows that found the channel clear
+    uint32_t busy_windows;          ///< Windows that found the channel busy
+    uint32_t channel_hops;          ///< Moves to another channel after busy
+    uint32_t deferrals;             ///< Back-offs with no clear channel
+    uint32_t abandoned;             ///< Transmissions given up
+    
+    LBTStats() : clear_windows(0), busy_windows(0), channel_hops(0),
+                 deferrals(0), abandoned(0) {}
+};
+
 /**
  * \class ALEStateMachine
  * Core ALE state machine implementing MIL-STD-188-141B procedures
+ * 
+ * Legal (state, event) -> state transitions live in a constexpr table
+ * checked at compile time; per-state enter/exit/update actions are
+ * dispatched through a member-function table, so the event path is one
+ * lookup and direct calls. Hooks can be bound as Delegates (no heap, no
+ * std::function); the std::function setters remain for existing callers.
  */
 class ALEStateMachine {
 public:
+    using StateChangeHandler = Delegate<void(ALEState, ALEState)>;
+    using TransmitHandler = Delegate<void(const ALEWord&)>;
+    using ChannelHandler = Delegate<void(const Channel&)>;
+    
     ALEStateMachine();
     
     /**
@@ -137,6 +186,15 @@ public:
      */
     static const char* event_name(ALEEvent event);
     
+    /**
+     * Look up transition table
+     * \param state Current state
+     * \param event Event to apply
+     * \param next [out] Target state if transition is legal
+     * \return true if event causes a transition from state
+     */
+    static bool lookup_transition(ALEState state, ALEEvent event, ALEState& next);
+    
     /**
      * Configure scanning
      * \param config Scan configuration
@@ -186,6 +244,79 @@ public:
      */
     bool send_sounding();
     
+    /**
+     * Configure listen-before-transmit
+     * With LBT enabled, initiate_call/initiate_net_call/send_sounding
+     * queue the transmission and return true; it is keyed from update()
+     * once a listen window finds the channel clear.
+     */
+    void configure_lbt(const LBTConfig& config);
+    
+    /**
+     * Feed one frame of demodulator band energy (e.g. per symbol)
+     * Only used while a listen window is open.
+     */
+    void report_band_energy(const BandEnergy& energy);
+    
+    /**
+     * Check if a call or sounding is waiting for a clear channel
+     */
+    bool is_transmit_pending() const { return pending_tx != PendingTx::NONE; }
+    
+    /**
+     * Cancel a queued call or sounding
+     */
+    void cancel_pending_transmit();
+    
+    const LBTStats& get_lbt_stats() const { return lbt_stats; }
+    const OccupancyResult& get_last_occupancy() const { return last_occupancy; }
+    
+    /**
+     * Encode link state snapshot
+     * Covers state, scan list and position, per-channel quality, address
+     * book, active call and partially assembled message. A transmission
+     * queued for listen-before-transmit is not saved.
+     * \param output [out] Framed snapshot
+     */
+    void save_snapshot(std::vector<uint8_t>& output) const;
+    
+    /**
+     * Restore link state from snapshot
+     * Saved timestamps are rebased so elapsed times (link timeout, dwell,
+     * word timeout) carry over to the new clock. The channel callback is
+     * invoked to retune the radio; the state callback is not.
+     * \param data Framed snapshot (e.g. MappedFile::data())
+     * \param length Snapshot length
+     * \param now_ms Current time on the new clock
+     * \return false if snapshot is invalid (state unchanged)
+     */
+    bool restore_snapshot(const uint8_t* data, size_t length, uint32_t now_ms);
+    
+    /**
+     * Write snapshot to file atomically
+     */
+    bool save_snapshot_file(const std::string& path) const;
+    
+    /**
+     * Memory-map snapshot file and restore from it
+     */
+    bool load_snapshot_file(const std::string& path, uint32_t now_ms);
+    
+    /**
+     * Submit a snapshot to a background persister from update()
+     * \param persister Started persister (nullptr disables)
+     * \param interval_ms Minimum time between snapshots
+     */
+    void enable_periodic_snapshot(SnapshotPersister* persister, uint32_t interval_ms);
+    
+    /**
+     * Schedule transmitted words on a shared sample clock
+     * Words keyed together are stamped back to back from the clock's
+     * current sample (ALEWord::sample_time).
+     * \param clock Capture/playback clock (nullptr: words carry no sample time)
+     */
+    void set_sample_clock(const SampleClock* clock) { sample_clock = clock; }
+    
     /**
      * Process received word
      * \param word Received ALE word
@@ -210,6 +341,7 @@ public:
      */
     void set_state_callback(std::function<void(ALEState, ALEState)> callback) {
         state_callback = callback;
+        state_handler = StateChangeHandler();
     }
     
     /**
@@ -218,6 +350,7 @@ public:
      */
     void set_transmit_callback(std::function<void(const ALEWord&)> callback) {
         transmit_callback = callback;
+        transmit_handler = TransmitHandler();
     }
     
     /**
@@ -226,6 +359,31 @@ public:
      */
     void set_channel_callback(std::function<void(const Channel&)> callback) {
         channel_callback = callback;
+        channel_handler = ChannelHandler();
+    }
+    
+    /**
+     * Bind state change delegate (replaces set_state_callback)
+     */
+    void set_state_handler(StateChangeHandler handler) {
+        state_handler = handler;
+        state_callback = nullptr;
+    }
+    
+    /**
+     * Bind word transmit delegate (replaces set_transmit_callback)
+     */
+    void set_transmit_handler(TransmitHandler handler) {
+        transmit_handler = handler;
+        transmit_callback = nullptr;
+    }
+    
+    /**
+     * Bind channel change delegate (replaces set_channel_callback)
+     */
+    void set_channel_handler(ChannelHandler handler) {
+        channel_handler = handler;
+        channel_callback = nullptr;
     }
     
 private:
@@ -248,19 +406,59 @@ private:
     uint32_t state_entry_time_ms;       ///< Time entered current state
     uint32_t last_scan_hop_time_ms;     ///< Last channel hop time
     uint32_t current_time_ms;           ///< Current time
+    const SampleClock* sample_clock;    ///< Transmit scheduling clock (optional)
     
     // LQA tracking
     std::vector<LinkQuality> channel_quality; ///< Quality per channel
     
-    // Callbacks
+    // Listen before transmit
+    enum class PendingTx : uint8_t { NONE, CALL, NET_CALL, SOUNDING };
+    LBTConfig lbt_config;
+    LBTStats lbt_stats;
+    ChannelOccupancyDetector occupancy;
+    OccupancyResult last_occupancy;
+    PendingTx pending_tx;                ///< Transmission waiting for clear channel
+    std::string pending_address;         ///< Destination of pending call
+    uint32_t pending_attempts;           ///< Busy windows so far
+    uint32_t pending_resume_ms;          ///< End of back-off (when deferred)
+    bool pending_deferred;               ///< Backing off before next window
+    std::vector<uint8_t> busy_channels;  ///< Channels found busy this attempt
+    
+    // Periodic snapshot
+    SnapshotPersister* snapshot_persister;
+    uint32_t snapshot_interval_ms;
+    uint32_t last_snapshot_ms;
+    
+    // Callbacks (delegate takes precedence; std::function kept for compatibility)
+    StateChangeHandler state_handler;
+    TransmitHandler transmit_handler;
+    ChannelHandler channel_handler;
     std::function<void(ALEState, ALEState)> state_callback;
     std::function<void(const ALEWord&)> transmit_callback;
     std::function<void(const Channel&)> channel_callback;
     
+    // Per-state actions, indexed by ALEState
+    using StateHandler = void (ALEStateMachine::*)();
+    struct StateActions {
+        StateHandler on_enter;
+        StateHandler on_exit;
+        StateHandler on_update;
+    };
+    static const StateActions state_actions[ALE_STATE_COUNT];
+    
     // State machine internals
     void enter_state(ALEState new_state);
     void exit_state(ALEState old_state);
     bool transition_to(ALEState new_state);
+    void notify_state_change(ALEState from, ALEState to);
+    void notify_channel(const Channel& channel);
+    
+    // Entry/exit actions
+    void enter_scanning();
+    void enter_call_timer();
+    void enter_linked();
+    void enter_sounding();
+    void exit_linked();
     
     // State handlers
     void handle_idle();
@@ -278,8 +476,19 @@ private:
     bool check_link_timeout();
     bool check_scan_dwell_timeout();
     
+    // Listen before transmit
+    void begin_listen(PendingTx kind, const std::string& address);
+    void service_listen();
+    bool hop_to_clear_channel();
+    bool execute_transmit(PendingTx kind, const std::string& address);
+    
+    // Snapshot
+    void service_snapshot();
+    
     // Call management
+    bool start_call(const std::string& to_addr, bool is_net);
     void build_call_words(const std::string& to_addr, bool is_net);
+    SampleTime transmit_sample_time(uint32_t word_index) const;  // nth word keyed now
     void transmit_word(const ALEWord& word);
 };
 
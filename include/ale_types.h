@@ -56,6 +56,10 @@ constexpr uint32_t VOTE_THRESHOLD_BAD = 25;        ///< Threshold for bad symbol
 using ComplexFloat = std::complex<float>;
 using ComplexDouble = std::complex<double>;
 
+/// Audio sample clock: samples since capture start (64-bit, never wraps)
+using SampleTime = uint64_t;
+constexpr SampleTime SAMPLE_TIME_NONE = UINT64_MAX;  ///< No sample time known
+
 /**
  * \enum PreambleType
  * Word preamble types per MIL-STD-188-141B
@@ -80,7 +84,7 @@ struct Symbol {
     uint8_t bits[BITS_PER_SYMBOL];      ///< 3-bit symbol value (0-7)
     float magnitude;                     ///< Peak magnitude from FFT
     float signal_to_noise;               ///< SNR estimate
-    uint32_t sample_index;               ///< Sample number when detected
+    SampleTime sample_index;             ///< Sample number when detected
 };
 
 /**
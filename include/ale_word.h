@@ -18,6 +18,9 @@
 
 namespace ale {
 
+class SnapshotWriter;
+class SnapshotReader;
+
 /**
  * \enum WordType
  * Preamble types per MIL-STD-188-141B Table A-II
@@ -45,9 +48,10 @@ struct ALEWord {
     uint8_t fec_errors;               ///< Golay errors corrected
     bool valid;                       ///< Word passed FEC and validation
     uint32_t timestamp_ms;            ///< Reception timestamp
+    SampleTime sample_time;           ///< First sample of the word (SAMPLE_TIME_NONE if unknown)
     
     ALEWord() : type(WordType::UNKNOWN), raw_payload(0), fec_errors(0), 
-                valid(false), timestamp_ms(0) {
+                valid(false), timestamp_ms(0), sample_time(SAMPLE_TIME_NONE) {
         address[0] = address[1] = address[2] = address[3] = '\0';
     }
 };
@@ -66,9 +70,11 @@ public:
      * 
      * \param symbols Array of 49 detected symbols (0-7)
      * \param output [out] Decoded ALE word
+     * \param sample_time Sample time of the word's first sample, stored in output
      * \return true if parsing successful, false on error
      */
-    bool parse_word(const uint8_t symbols[SYMBOLS_PER_WORD], ALEWord& output);
+    bool parse_word(const uint8_t symbols[SYMBOLS_PER_WORD], ALEWord& output,
+                    SampleTime sample_time = SAMPLE_TIME_NONE);
     
     /**
      * Parse from raw 24-bit word (after FEC)
@@ -188,6 +194,17 @@ public:
      */
     static bool match_wildcard(const std::string& pattern, const std::string& address);
     
+    /**
+     * Serialize self address, stations and nets
+     */
+    void save_snapshot(SnapshotWriter& writer) const;
+    
+    /**
+     * Replace contents from snapshot
+     * \return false if snapshot section is truncated (book unchanged)
+     */
+    bool restore_snapshot(SnapshotReader& reader);
+    
 private:
     std::string self_address;
     std::vector<std::pair<std::string, std::string>> stations;  // address, name
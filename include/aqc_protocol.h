@@ -117,8 +117,9 @@ struct AQCCallProbe {
     std::string term_address;   ///< Terminator (calling station)
     DataElements de;            ///< Data elements
     uint32_t timestamp_ms;      ///< Reception time
+    SampleTime sample_time;     ///< Reception sample time (first word)
     
-    AQCCallProbe() : timestamp_ms(0) {}
+    AQCCallProbe() : timestamp_ms(0), sample_time(SAMPLE_TIME_NONE) {}
 };
 
 /**
@@ -133,10 +134,11 @@ struct AQCCallHandshake {
     bool ack_this_flag;         ///< Acknowledge this call
     uint8_t slot_position;      ///< Assigned slot (0-7)
     uint32_t timestamp_ms;      ///< Reception time
+    SampleTime sample_time;     ///< Reception sample time (first word)
     
     AQCCallHandshake() : crc_status(CRCStatus::NOT_APPLICABLE), 
                          ack_this_flag(false), slot_position(0), 
-                         timestamp_ms(0) {}
+                         timestamp_ms(0), sample_time(SAMPLE_TIME_NONE) {}
 };
 
 /**
@@ -152,10 +154,11 @@ struct AQCInlink {
     bool net_address_flag;      ///< Net call flag
     uint8_t slot_position;      ///< Response slot
     uint32_t timestamp_ms;      ///< Reception time
+    SampleTime sample_time;     ///< Reception sample time (first word)
     
     AQCInlink() : crc_status(CRCStatus::NOT_APPLICABLE), 
                   ack_this_flag(false), net_address_flag(false), 
-                  slot_position(0), timestamp_ms(0) {}
+                  slot_position(0), timestamp_ms(0), sample_time(SAMPLE_TIME_NONE) {}
 };
 
 /**
@@ -167,9 +170,10 @@ struct AQCOrderwire {
     CRCStatus crc_status;       ///< CRC validation result
     uint16_t calculated_crc;    ///< CRC value
     uint32_t timestamp_ms;      ///< Reception time
+    SampleTime sample_time;     ///< Reception sample time (first word)
     
     AQCOrderwire() : crc_status(CRCStatus::NOT_APPLICABLE), 
-                     calculated_crc(0), timestamp_ms(0) {}
+                     calculated_crc(0), timestamp_ms(0), sample_time(SAMPLE_TIME_NONE) {}
 };
 
 // ============================================================================
@@ -320,6 +324,14 @@ public:
      */
     static uint32_t calculate_slot_time(uint8_t slot_number, uint32_t base_time_ms);
     
+    /**
+     * Calculate slot timing on the sample clock
+     * \param slot_number Slot position (0-7)
+     * \param base_sample Base sample time (e.g. end of the received call)
+     * \return Sample time at which the slot starts
+     */
+    static SampleTime calculate_slot_sample(uint8_t slot_number, SampleTime base_sample);
+    
     /**
      * Assign slot based on address hash
      * Distributes stations across slots to reduce collisions
@@ -338,6 +350,8 @@ public:
 private:
     static constexpr uint32_t SLOT_DURATION_MS = 200;  ///< 200ms per slot
     static constexpr uint8_t NUM_SLOTS = 8;            ///< 8 slots total
+    static constexpr SampleTime SLOT_DURATION_SAMPLES =
+        static_cast<SampleTime>(SLOT_DURATION_MS) * SAMPLE_RATE_HZ / 1000;
 };
 
 } // namespace aqc
@@ -0,0 +1,138 @@
+/**
+ * \file channel_occupancy.h
+ * \brief Listen-before-transmit channel occupancy detection
+ *
+ * Accumulates per-frame in-band energy from the FFT demodulator over a
+ * short listen window and decides whether the channel is in use before
+ * a call or sounding is keyed:
+ *  - A frame is "active" when the mean in-band magnitude exceeds the
+ *    out-of-band noise floor by a threshold (and an absolute minimum)
+ *  - Active frames with a high peak-to-mean ratio look like FSK/data
+ *    tones; active frames with a flat spectrum look like voice
+ *  - The channel is busy when the active fraction of the window
+ *    exceeds a configurable limit
+ *
+ * Specification: MIL-STD-188-141B Appendix A (listen before transmit)
+ */
+
+#pragma once
+
+#include "fft_demodulator.h"
+#include <cstdint>
+
+namespace ale {
+
+/**
+ * \enum ChannelActivity
+ * Dominant activity seen during a listen window
+ */
+enum class ChannelActivity {
+    CLEAR,      ///< No significant in-band energy
+    DATA,       ///< Tonal energy (ALE/FSK/data modem)
+    VOICE       ///< Wideband energy (voice or other analog traffic)
+};
+
+/**
+ * \struct OccupancyConfig
+ * Listen window and detection thresholds
+ */
+struct OccupancyConfig {
+    uint32_t window_ms;         ///< Listen window before transmit
+    float threshold_db;         ///< In-band level over noise floor for an active frame
+    float min_magnitude;        ///< Absolute in-band level below which a frame is idle
+    float busy_fraction;        ///< Fraction of active frames that marks channel busy
+    float tonal_ratio;          ///< Peak-to-mean ratio separating data from voice
+    
+    OccupancyConfig() : window_ms(100), threshold_db(6.0f), min_magnitude(1.0f),
+                        busy_fraction(0.2f), tonal_ratio(3.0f) {}
+};
+
+/**
+ * \struct OccupancyResult
+ * Outcome of one listen window
+ */
+struct OccupancyResult {
+    bool busy;                  ///< Channel judged in use
+    ChannelActivity activity;   ///< Dominant activity type
+    uint32_t frames;            ///< Frames measured in window
+    uint32_t active_frames;     ///< Frames above threshold
+    float mean_level_db;        ///< Mean in-band level over noise floor (dB)
+    
+    OccupancyResult() : busy(false), activity(ChannelActivity::CLEAR), frames(0),
+                        active_frames(0), mean_level_db(0.0f) {}
+};
+
+/**
+ * \class ChannelOccupancyDetector
+ * Decide channel busy/clear from demodulator band energy
+ *
+ * Usage:
+ * \code
+ * ChannelOccupancyDetector lbt;
+ * lbt.start(now_ms);
+ * // per FFT frame or symbol:
+ * lbt.add_measurement(demod.measure_band_energy());
+ * if (lbt.window_complete(now_ms)) {
+ *     OccupancyResult r = lbt.result();
+ * }
+ * \endcode
+ */
+class ChannelOccupancyDetector {
+public:
+    ChannelOccupancyDetector();
+    explicit ChannelOccupancyDetector(const OccupancyConfig& config);
+    
+    /**
+     * Begin a new listen window (clears accumulated frames)
+     * \param current_time_ms Window start time
+     */
+    void start(uint32_t current_time_ms);
+    
+    /**
+     * Add one frame of band energy to the current window
+     */
+    void add_measurement(const BandEnergy& energy);
+    
+    /**
+     * Check if the listen window has elapsed
+     */
+    bool window_complete(uint32_t current_time_ms) const;
+    
+    /**
+     * Evaluate the current window
+     * A window with no measurements is reported clear: without a
+     * demodulator feed there is nothing to defer on.
+     */
+    OccupancyResult result() const;
+    
+    /**
+     * Check if a window is in progress
+     */
+    bool is_listening() const { return listening; }
+    
+    /**
+     * Stop listening and clear the window
+     */
+    void reset();
+    
+    void set_config(const OccupancyConfig& cfg) { config = cfg; }
+    const OccupancyConfig& get_config() const { return config; }
+    
+    /**
+     * Get activity name
+     */
+    static const char* activity_name(ChannelActivity activity);
+    
+private:
+    OccupancyConfig config;
+    bool listening;
+    uint32_t window_start_ms;
+    
+    // Window accumulators
+    uint32_t frames;
+    uint32_t active_frames;
+    uint32_t tonal_frames;
+    float level_db_sum;
+};
+
+} // namespace ale
@@ -0,0 +1,119 @@
+/**
+ * \file dbm_protocol.h
+ * \brief Data Block Message (DBM) mode with deep interleaving
+ *
+ * Implements MIL-STD-188-141B DBM-style block transfer on top of the
+ * Extended Golay (24,12) codec and the 24-bit word layer:
+ *  - Message bytes framed with length and CRC-16
+ *  - Whole block Golay-encoded in one batch (12 info bits per codeword)
+ *  - Codewords written row-wise into an N x 24 bit matrix and read out
+ *    column-wise, so a burst of up to 3N consecutive bit errors leaves
+ *    at most 3 errors in any codeword
+ *  - Output is N interleaved 24-bit transmission words, sent with the
+ *    same 49-symbol word modulator as ordinary ALE words
+ *
+ * Interleave indexing is table-driven: the permutation for a given block
+ * size is computed once and reused for every subsequent block.
+ *
+ * Specification: MIL-STD-188-141B Appendix A (Data Block Message)
+ */
+ 
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace ale {
+
+// DBM block framing
+constexpr uint32_t DBM_LENGTH_BYTES = 2;           ///< Message length prefix
+constexpr uint32_t DBM_CRC_BYTES = 2;              ///< CRC-16 suffix
+constexpr uint32_t DBM_MAX_MESSAGE_BYTES = 4096;   ///< Largest single DBM block
+constexpr uint32_t DBM_WORD_BITS = 24;             ///< Bits per transmission word
+
+/**
+ * \struct DBMStats
+ * Decode statistics for one DBM block
+ */
+struct DBMStats {
+    uint32_t codewords;         ///< Golay codewords in block
+    uint32_t bits_corrected;    ///< Total bit errors corrected
+    uint32_t uncorrectable;     ///< Codewords Golay could not correct
+    bool crc_valid;             ///< CRC-16 check result
+    
+    DBMStats() : codewords(0), bits_corrected(0), uncorrectable(0),
+                 crc_valid(false) {}
+};
+
+/**
+ * \class DBMCodec
+ * Encode/decode Data Block Messages
+ *
+ * Usage:
+ * \code
+ * DBMCodec codec;
+ * std::vector<uint32_t> words;
+ * codec.encode(data, length, words);   // transmit words[0..N-1]
+ *
+ * std::vector<uint8_t> message;
+ * DBMStats stats;
+ * if (codec.decode(received_words, message, &stats)) { ... }
+ * \endcode
+ */
+class DBMCodec {
+public:
+    DBMCodec();
+    
+    /**
+     * Encode message into interleaved 24-bit transmission words
+     *
+     * \param data Message bytes
+     * \param length Message length (max DBM_MAX_MESSAGE_BYTES)
+     * \param words [out] Interleaved transmission words (one per codeword)
+     * \return true if encoded, false if message too long
+     */
+    bool encode(const uint8_t* data, size_t length, std::vector<uint32_t>& words);
+    
+    /**
+     * Deinterleave, Golay-correct and CRC-check received words
+     *
+     * \param words Received 24-bit transmission words (whole block)
+     * \param data [out] Recovered message bytes
+     * \param stats [out] Optional decode statistics, may be nullptr
+     * \return true if block decoded and CRC valid
+     */
+    bool decode(const std::vector<uint32_t>& words, std::vector<uint8_t>& data,
+                DBMStats* stats = nullptr);
+                
+    /**
+     * Number of Golay codewords (= transmission words) for a message
+     * \param length Message length in bytes
+     * \return Codeword count for the framed block
+     */
+    static size_t codewords_for_length(size_t length);
+    
+    /**
+     * Compute CRC-16 over DBM block contents
+     * Polynomial: 0x1021 (CCITT), initial value 0xFFFF
+     */
+    static uint16_t calculate_crc16(const uint8_t* data, size_t length);
+    
+private:
+    // Interleave table: transmitted bit position -> codeword matrix bit
+    std::vector<uint32_t> interleave_table;
+    size_t table_codewords;
+    
+    // Scratch buffers reused between blocks
+    std::vector<uint8_t> bit_buffer;
+    std::vector<uint8_t> matrix_buffer;
+    std::vector<uint16_t> info_buffer;
+    std::vector<uint32_t> codeword_buffer;
+    
+    /**
+     * Build (or reuse) interleave table for block of N codewords
+     */
+    const std::vector<uint32_t>& get_interleave_table(size_t codewords);
+};
+
+} // namespace ale
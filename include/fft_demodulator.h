@@ -19,6 +19,41 @@
 
 namespace ale {
 
+/**
+ * \struct BandEnergy
+ * In-band energy snapshot of one FFT frame, used for channel occupancy
+ */
+struct BandEnergy {
+    float in_band_mean;     ///< Mean magnitude over ALE tone bins
+    float in_band_peak;     ///< Largest magnitude over ALE tone bins
+    float noise_floor;      ///< Minimum magnitude outside the ALE band
+    
+    BandEnergy() : in_band_mean(0.0f), in_band_peak(0.0f), noise_floor(0.0f) {}
+    
+    /**
+     * Peak-to-mean ratio: high for single FSK tones, low for wideband
+     * signals such as voice
+     */
+    float peak_to_mean() const {
+        return (in_band_mean > 0.0f) ? (in_band_peak / in_band_mean) : 0.0f;
+    }
+    
+    /**
+     * In-band level over the noise floor (dB)
+     */
+    float level_db() const;
+    
+    /**
+     * Active (busy) frame: clearly above both the noise floor and an
+     * absolute minimum. Shared by listen-before-transmit and channel
+     * statistics so both judge a frame the same way.
+     * \param level_db level_db() of this frame
+     */
+    bool is_active(float level_db, float threshold_db, float min_magnitude) const {
+        return level_db >= threshold_db && in_band_mean >= min_magnitude;
+    }
+};
+
 class FFTDemodulator {
 public:
     FFTDemodulator();
@@ -43,15 +78,40 @@ public:
      */
     void reset();
     
+    /**
+     * Sample time of the next sample to be processed
+     */
+    SampleTime get_sample_time() const { return sample_offset + sample_count; }
+    
+    /**
+     * Align the sample clock without disturbing symbol timing
+     * \param sample_time Sample time of the next sample to be processed
+     *                    (e.g. the capture clock's count before this buffer)
+     */
+    void set_sample_time(SampleTime sample_time) { sample_offset = sample_time - sample_count; }
+    
     /**
      * Get current FFT magnitude array
      * \return Reference to magnitudes [FFT_SIZE]
      */
     const std::array<float, FFT_SIZE>& get_fft_magnitudes() const;
     
+    /**
+     * Measure in-band energy of the current FFT frame
+     * \return Band energy snapshot for occupancy detection
+     */
+    BandEnergy measure_band_energy() const;
+    
+    /**
+     * Measure in-band energy of a magnitude array
+     * \param magnitudes FFT magnitudes [FFT_SIZE]
+     */
+    static BandEnergy measure_band_energy(const std::array<float, FFT_SIZE>& magnitudes);
+    
 private:
     FFTBuffer fft_buffer;
-    uint32_t sample_count;
+    SampleTime sample_count;            // Samples processed since reset
+    SampleTime sample_offset;           // Sample time of sample_count 0
     uint32_t samples_per_symbol;        // = 8000 / 125 = 64
     
     std::array<float, FFT_SIZE> mag_history[SYMBOLS_PER_WORD];
@@ -66,7 +126,7 @@ private:
     /**
      * Estimate noise floor from magnitude array
      */
-    float estimate_noise_floor(const std::array<float, FFT_SIZE>& magnitudes);
+    static float estimate_noise_floor(const std::array<float, FFT_SIZE>& magnitudes);
     
     /**
      * Compute signal-to-noise ratio
@@ -0,0 +1,116 @@
+/**
+ * \file fs1052_airtime.h
+ * \brief On-air time and throughput model for FS-1052 transmissions
+ *
+ * Models a MIL-STD-188-110A serial-tone modem carrying FS-1052 frames:
+ * - Each transmission starts with a synchronisation preamble
+ *   (0.6 s short interleaver, 4.8 s long)
+ * - Data is coded in whole interleaver blocks (0.6 s / 4.8 s); the
+ *   receiver decodes a bit only once its block is complete
+ * - The end-of-message marker and flush pad the last block
+ * - Every change of direction costs a radio/modem turnaround
+ *
+ * Frames queued back to back share one preamble, so a series costs
+ * far less than the same frames sent one at a time. Frame sizes come
+ * from FrameFormatter so the model follows the wire format.
+ *
+ * The mode (rate and interleaver) is fixed per model so each query is
+ * a few integer operations; 75 bps uses the same block timing as the
+ * faster rates.
+ */
+
+#ifndef FS1052_AIRTIME_H
+#define FS1052_AIRTIME_H
+
+#include "fs1052_protocol.h"
+#include <cstdint>
+
+namespace fs1052 {
+
+constexpr uint32_t AIRTIME_EOM_BITS = 32;              ///< End-of-message marker
+constexpr uint32_t AIRTIME_DEFAULT_TURNAROUND_MS = 500; ///< TX/RX switch and modem sync
+
+/**
+ * Airtime model for one modem mode
+ */
+class AirtimeModel {
+public:
+    AirtimeModel();
+    
+    /**
+     * Set modem data rate and interleaver
+     */
+    void set_mode(DataRate rate, InterleaverLength interleaver);
+    
+    /**
+     * Set time to change direction (ms)
+     */
+    void set_turnaround_ms(uint32_t turnaround_ms) { m_turnaround_ms = turnaround_ms; }
+    
+    DataRate data_rate() const { return m_rate; }
+    InterleaverLength interleaver() const { return m_interleaver; }
+    uint32_t turnaround_ms() const { return m_turnaround_ms; }
+    uint32_t preamble_ms() const { return m_preamble_ms; }
+    uint32_t block_ms() const { return m_block_ms; }
+    uint32_t bits_per_block() const { return m_bits_per_block; }
+    
+    /**
+     * Time from the start of the preamble until the first bytes of a
+     * transmission can be decoded (end of the interleaver block holding
+     * the last bit)
+     */
+    uint32_t data_end_ms(uint32_t bytes) const;
+    
+    /**
+     * Duration of one transmission carrying bytes, preamble to flush
+     */
+    uint32_t transmission_ms(uint32_t bytes) const;
+    
+    /**
+     * Data frame sent on its own
+     */
+    uint32_t data_frame_ms(uint16_t data_length) const;
+    
+    /**
+     * Control frame sent on its own
+     */
+    uint32_t control_frame_ms(const ControlFrame& frame) const;
+    
+    /**
+     * Series of equal data frames in one transmission
+     */
+    uint32_t series_ms(uint32_t frames, uint16_t data_length) const;
+    
+    /**
+     * One exchange: turnaround, our transmission, turnaround, the peer's reply
+     */
+    uint32_t cycle_ms(uint32_t series_bytes, uint32_t reply_bytes) const;
+    
+    /**
+     * Most data frames whose transmission fits window_ms (0 if not even one)
+     */
+    uint32_t max_frames(uint32_t window_ms, uint16_t data_length) const;
+    
+    /**
+     * Payload throughput of repeated exchanges (bps)
+     * \param payload_bytes User data per cycle
+     * \param series_bytes Frame bytes we send per cycle
+     * \param reply_bytes Frame bytes the peer sends back per cycle
+     */
+    uint32_t expected_goodput_bps(uint32_t payload_bytes, uint32_t series_bytes,
+                                  uint32_t reply_bytes) const;
+    
+private:
+    DataRate m_rate;
+    InterleaverLength m_interleaver;
+    uint32_t m_turnaround_ms;
+    uint32_t m_preamble_ms;
+    uint32_t m_block_ms;
+    uint32_t m_bits_per_block;
+    
+    uint32_t blocks_ms(uint64_t bits) const;
+};
+
+} // namespace fs1052
+
+#endif // FS1052_AIRTIME_H
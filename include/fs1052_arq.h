@@ -19,6 +19,8 @@
 #define FS1052_ARQ_H
 
 #include "fs1052_protocol.h"
+#include "fs1052_airtime.h"
+#include "fs1052_burst.h"
 #include <vector>
 #include <queue>
 #include <cstdint>
@@ -67,6 +69,11 @@ struct DataBlock {
     bool acknowledged;          ///< Has been ACKed
     uint8_t retransmit_count;   ///< Number of retransmissions
     uint32_t timestamp;         ///< When block was sent (ms)
+    uint32_t tx_end_time;       ///< When its interleaver block left the modem (ms)
+    uint32_t series_end_time;   ///< When the transmission carrying it ended (ms)
+    uint32_t repair_end_time;   ///< When its series' repair blocks were sent (0 if none)
+    bool sent;                  ///< Transmitted at least once
+    bool retransmit_pending;    ///< Queued for retransmission
 };
 
 /**
@@ -82,6 +89,73 @@ struct ARQStats {
     uint32_t timeouts;
     uint32_t crc_errors;
     uint32_t sequence_errors;
+    uint32_t rtt_samples;           ///< ACKs used for RTT estimation
+    uint32_t retransmits_skipped;   ///< Unacked blocks left in flight at timeout
+    uint32_t messages_compressed;   ///< Messages sent as a compressed stream
+    uint32_t compression_bypassed;  ///< Messages sent raw (incompressible or too short)
+    uint32_t bytes_saved;           ///< Payload bytes saved by compression
+    uint32_t decompress_errors;     ///< Received compressed streams that failed to decode
+    uint32_t repair_blocks_sent;    ///< Erasure-code repair blocks transmitted
+    uint32_t blocks_recovered;      ///< Lost blocks rebuilt from repair blocks
+    uint32_t bursts_sent;           ///< Series sent as one coalesced transmission
+    uint32_t heralds_received;      ///< Series heralds seen
+};
+
+/**
+ * Round-trip time estimator (Jacobson/Karels, RFC 6298 style)
+ * 
+ * Keeps smoothed RTT and mean deviation in milliseconds and derives the
+ * retransmission timeout RTO = SRTT + max(G, 4 * RTTVAR). Each timeout
+ * doubles the RTO (exponential backoff) until a new valid sample arrives.
+ * Callers apply Karn's rule: never sample a retransmitted block.
+ */
+class RTTEstimator {
+public:
+    RTTEstimator();
+    
+    /**
+     * Set RTO used before the first sample
+     */
+    void set_initial_timeout(uint32_t timeout_ms);
+    
+    /**
+     * Set RTO clamp (also caps backoff)
+     */
+    void set_limits(uint32_t min_timeout_ms, uint32_t max_timeout_ms);
+    
+    /**
+     * Add RTT measurement (clears backoff)
+     */
+    void add_sample(uint32_t rtt_ms);
+    
+    /**
+     * Double timeout after an expiry
+     */
+    void backoff();
+    
+    /**
+     * Forget samples and backoff
+     */
+    void reset();
+    
+    /**
+     * Current retransmission timeout including backoff
+     */
+    uint32_t timeout_ms() const;
+    
+    bool has_sample() const { return m_has_sample; }
+    uint32_t srtt_ms() const { return m_srtt; }
+    uint32_t rttvar_ms() const { return m_rttvar; }
+    uint8_t backoff_count() const { return m_backoff; }
+    
+private:
+    uint32_t m_srtt;            ///< Smoothed RTT
+    uint32_t m_rttvar;          ///< RTT mean deviation
+    uint32_t m_initial_timeout; ///< RTO before first sample
+    uint32_t m_min_timeout;
+    uint32_t m_max_timeout;
+    uint8_t m_backoff;          ///< Consecutive timeouts
+    bool m_has_sample;
 };
 
 /**
@@ -95,11 +169,21 @@ using ErrorCallback = std::function<void(const char* error_msg)>;
  * Variable ARQ State Machine
  * 
  * Implements FED-STD-1052 Variable ARQ mode with:
- * - Selective repeat ARQ
+ * - Selective repeat ARQ (bitmap gaps retransmitted without waiting)
  * - Automatic retransmission
- * - Timeout handling
+ * - Adaptive ACK timeout from measured RTT with exponential backoff
  * - Flow control
  * - Rate adaptation
+ * - Optional payload compression, negotiated through the
+ *   EXT_FUNC_COMPRESSION extension bit carried in ACKs
+ * - Optional Reed-Solomon repair blocks per series, so the receiver
+ *   can rebuild lost blocks without another ACK/retransmit round
+ * - Sends scheduled with AirtimeModel: frames sent back to back share
+ *   one preamble, and ACK deadlines run from the end of the
+ *   transmission, since a half-duplex peer cannot answer earlier
+ * - Optional burst transmission: a herald and the series' data frames
+ *   handed to the PHY as one buffer (or I/O vector). Received bursts
+ *   are split and answered with a single ACK.
  */
 class VariableARQ {
 public:
@@ -130,6 +214,13 @@ public:
      */
     bool start_transmission(const uint8_t* data, uint32_t length);
     
+    /**
+     * Start transmission of a message held in several buffers
+     * The pieces are copied straight into data blocks (no staging
+     * buffer), except when compression needs them in one piece.
+     */
+    bool start_transmission(const FrameSegment* segments, int count);
+    
     /**
      * Handle received frame
      */
@@ -153,8 +244,25 @@ public:
     
     /**
      * Set ACK timeout (ms)
+     * Used until the first RTT sample; afterwards the timeout adapts
+     * to the measured round-trip time.
+     */
+    void set_ack_timeout(uint32_t timeout_ms) { m_rtt.set_initial_timeout(timeout_ms); }
+    
+    /**
+     * Set bounds for the adaptive ACK timeout (ms)
+     */
+    void set_ack_timeout_limits(uint32_t min_ms, uint32_t max_ms) { m_rtt.set_limits(min_ms, max_ms); }
+    
+    /**
+     * Current ACK timeout (ms), including backoff
      */
-    void set_ack_timeout(uint32_t timeout_ms) { m_ack_timeout = timeout_ms; }
+    uint32_t get_ack_timeout() const { return m_rtt.timeout_ms(); }
+    
+    /**
+     * Get round-trip time estimator
+     */
+    const RTTEstimator& get_rtt_estimator() const { return m_rtt; }
     
     /**
      * Set maximum retransmissions
@@ -176,6 +284,92 @@ public:
      */
     DataRate get_data_rate() const { return m_data_rate; }
     
+    /**
+     * Set interleaver for data frames
+     */
+    void set_interleaver(InterleaverLength interleaver);
+    
+    InterleaverLength get_interleaver() const { return m_airtime.interleaver(); }
+    
+    /**
+     * Set radio turnaround before each transmission from idle (ms)
+     */
+    void set_turnaround_ms(uint32_t turnaround_ms) { m_airtime.set_turnaround_ms(turnaround_ms); }
+    
+    /**
+     * Limit the airtime of one series (ms, 0 = window size only)
+     * Keeps a series, including the repair blocks that follow it,
+     * inside the peer's turnaround/link timeout; at least one block is
+     * always sent.
+     */
+    void set_max_series_ms(uint32_t max_ms) { m_max_series_ms = max_ms; }
+    
+    uint32_t get_max_series_ms() const { return m_max_series_ms; }
+    
+    /**
+     * Send each series as one transmission
+     * A T3 herald (rate, interleaver, block size, frame count) and the
+     * series' data and repair frames are formatted back to back into a
+     * preallocated buffer and passed to the TX callback in one call.
+     */
+    void enable_burst_transmission(bool enable) { m_burst_enabled = enable; }
+    
+    bool is_burst_transmission() const { return m_burst_enabled; }
+    
+    /**
+     * Hand bursts to a scatter-gather sink instead of the TX callback
+     * Block payloads are referenced, not copied; segments are valid for
+     * the duration of the call. Implies burst transmission; nullptr
+     * returns to the TX callback.
+     */
+    void set_gather_callback(GatherCallback callback);
+    
+    /**
+     * Airtime model for the current rate and interleaver
+     */
+    const AirtimeModel& get_airtime_model() const { return m_airtime; }
+    
+    /**
+     * Goodput the airtime model predicts for full series at the current
+     * settings with no losses (bps)
+     */
+    uint32_t expected_goodput_bps() const;
+    
+    /**
+     * Goodput of the current transfer: bytes acknowledged over time
+     * from start_transmission() to the last ACK (or now) (bps)
+     */
+    uint32_t achieved_goodput_bps() const;
+    
+    /**
+     * Enable payload compression
+     * Advertised to the peer in our ACKs; outgoing messages are compressed
+     * only once the peer has advertised it too.
+     */
+    void enable_compression(bool enable) { m_compression_enabled = enable; }
+    
+    /**
+     * Override peer compression capability (e.g. agreed at link setup)
+     */
+    void set_peer_compression(bool supported) { m_peer_compression = supported; }
+    
+    /**
+     * Send erasure-code repair blocks
+     * \param repair_blocks Repair blocks per series (0 disables)
+     * \param series_length Data blocks per series (0 = window size)
+     * 
+     * Any series_length of the series_length + repair_blocks frames
+     * rebuild the series. Blocks shrink by the repair header so a repair
+     * block still fits one frame. A gap is not retransmitted until the
+     * series' repair blocks have had their chance.
+     */
+    void set_repair_blocks(uint8_t repair_blocks, uint8_t series_length = 0);
+    
+    uint8_t get_repair_blocks() const { return m_repair_blocks; }
+    
+    bool is_compression_enabled() const { return m_compression_enabled; }
+    bool peer_supports_compression() const { return m_peer_compression; }
+    
     /**
      * Check if transfer is complete
      */
@@ -183,8 +377,25 @@ public:
     
     /**
      * Get received data (for RX side)
+     * Decompressed message once a compressed stream is complete
+     */
+    const std::vector<uint8_t>& get_received_data() const
+    {
+        return m_rx_decoded_valid ? m_rx_decoded : m_rx_buffer;
+    }
+    
+    /**
+     * Bytes of get_received_data() known to be complete: the prefix
+     * received without gaps (a compressed stream counts once decoded)
+     */
+    uint32_t get_received_contiguous() const;
+    
+    /**
+     * Number of messages whose reception has started
+     * Data frames carry a toggle that alternates per message; a frame
+     * with the other toggle starts a new message and discards the last.
      */
-    const std::vector<uint8_t>& get_received_data() const { return m_rx_buffer; }
+    uint32_t get_rx_message_count() const { return m_rx_messages; }
 
 private:
     // State machine
@@ -208,11 +419,54 @@ private:
     bool m_rx_bitmap[256];                  ///< Received sequence bitmap
     uint8_t m_expected_sequence;            ///< Next expected sequence
     uint32_t m_rx_msg_length;               ///< Expected message length
+    uint32_t m_rx_unique_bytes;             ///< Payload bytes received (no duplicates)
+    bool m_rx_compressed;                   ///< Sender flagged a compressed stream
+    bool m_rx_decoded_valid;                ///< m_rx_decoded holds the message
+    std::vector<uint8_t> m_rx_decoded;      ///< Decompressed message
+    uint32_t m_rx_contiguous;               ///< Bytes received without gaps from offset 0
+    uint16_t m_rx_contiguous_blocks;        ///< Blocks covering m_rx_contiguous
+    uint32_t m_rx_messages;                 ///< Messages started
+    bool m_rx_started;                      ///< A message is being received
+    bool m_rx_toggle;                       ///< Its message toggle
+    
+    // Compression
+    bool m_compression_enabled;             ///< Local capability
+    bool m_peer_compression;                ///< Peer advertised capability
+    bool m_tx_compressed;                   ///< Current TX blocks are compressed
+    bool m_tx_toggle;                       ///< Message toggle of current TX blocks
+    
+    // Erasure coding
+    struct RepairSeries {
+        uint8_t first_sequence;
+        uint8_t data_blocks;                ///< k
+        uint8_t repair_blocks;              ///< m
+        uint16_t symbol_length;
+        std::vector<std::vector<uint8_t>> repair;  ///< By repair index, empty until received
+        bool complete;
+    };
+    uint8_t m_repair_blocks;                ///< Repair blocks per series (TX)
+    uint8_t m_repair_series_length;         ///< Data blocks per series (TX, 0 = window)
+    std::vector<RepairSeries> m_rx_series;  ///< Series with repair blocks seen (RX)
+    uint32_t m_rx_block_offset[256];        ///< Offset of each received sequence
+    uint16_t m_rx_block_length[256];        ///< Length of each received sequence
     
     // Timing
-    uint32_t m_last_tx_time;                ///< Last transmission time
-    uint32_t m_ack_timeout;                 ///< ACK timeout (ms)
-    uint32_t m_wait_start_time;             ///< When WAIT_ACK started
+    uint32_t m_last_tx_time;                ///< Current time (latest update())
+    uint32_t m_tx_busy_until;               ///< End of queued transmission
+    uint32_t m_burst_start;                 ///< Preamble start of that transmission
+    uint32_t m_burst_bytes;                 ///< Frame bytes queued in it
+    std::vector<size_t> m_burst_blocks;     ///< Blocks carried by it
+    uint32_t m_tx_start_time;               ///< start_transmission() time
+    uint32_t m_tx_complete_time;            ///< Last block acknowledged
+    RTTEstimator m_rtt;                     ///< Adaptive ACK timeout
+    AirtimeModel m_airtime;                 ///< Frame timing at current mode
+    uint32_t m_max_series_ms;               ///< Series airtime limit (0 = none)
+    
+    // Burst transmission
+    bool m_burst_enabled;                   ///< Coalesce each series
+    GatherCallback m_gather_callback;       ///< Scatter-gather sink (optional)
+    BurstBuilder m_burst;                   ///< Series being built
+    DataFrame m_tx_header;                  ///< Reused data frame header fields
     
     // Parameters
     DataRate m_data_rate;                   ///< Current data rate
@@ -233,19 +487,40 @@ private:
     void transition_to(ARQState new_state);
     void send_next_blocks();
     void send_block(uint8_t sequence);
+    int transmit_data_frame(const DataFrame& frame, const uint8_t* payload);
+    void flush_burst();
+    ControlFrame make_herald_frame(int frames) const;
+    bool receive_frame(const uint8_t* frame, size_t length);
     void send_ack();
+    ControlFrame make_ack_frame() const;
     void send_nak(uint8_t sequence);
     void process_ack(const ControlFrame& frame);
     void process_data_frame(const DataFrame& frame);
+    bool store_block(uint8_t sequence, uint32_t offset, const uint8_t* data,
+                     uint16_t length, bool compressed);
+    void send_repair_blocks(size_t first_index, size_t count);
+    void process_repair_frame(const DataFrame& frame);
+    void try_recover_series(RepairSeries& series);
+    uint32_t loss_deadline(const DataBlock& block) const;
+    uint32_t ack_deadline(const DataBlock& block) const;
     void check_timeouts(uint32_t current_time);
+    void queue_retransmit(DataBlock& block);
+    void start_retransmit();
+    bool has_unsent_blocks() const;
     bool all_blocks_acked() const;
+    uint32_t schedule_frame(int frame_length);
+    uint16_t tx_block_size() const;
+    uint32_t repair_frame_bytes() const;
     void report_error(const char* msg);
     
     // Block management
     void create_blocks(const uint8_t* data, uint32_t length);
+    void create_blocks(const FrameSegment* segments, int count);
     void mark_block_acked(uint8_t sequence);
     DataBlock* find_block(uint8_t sequence);
     void reassemble_data();
+    void decode_compressed_stream();
+    void clear_rx_message();
 };
 
 /**
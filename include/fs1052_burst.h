@@ -0,0 +1,139 @@
+/**
+ * \file fs1052_burst.h
+ * \brief Series builder: one transmission for a control frame and its data frames
+ *
+ * Formats the frames of a series back to back into one preallocated
+ * buffer so the PHY gets a single transmission instead of one callback
+ * per frame. The receiver splits the burst again with
+ * FrameParser::frame_length().
+ *
+ * Two output forms:
+ * - Contiguous: every frame copied into the buffer (data()/size())
+ * - Scatter-gather: headers and CRCs live in the buffer, payloads are
+ *   referenced where they already are (segments()), for PHYs that can
+ *   write an I/O vector
+ *
+ * A control frame (e.g. a herald announcing the series) can be put in
+ * front once the series is complete, into room kept at the start of
+ * the buffer. The buffer keeps its capacity across clear() calls.
+ */
+
+#ifndef FS1052_BURST_H
+#define FS1052_BURST_H
+
+#include "fs1052_protocol.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace fs1052 {
+
+/**
+ * Piece of a burst for scatter-gather output
+ */
+struct FrameSegment {
+    const uint8_t* data;
+    size_t length;
+};
+
+/**
+ * Callback taking one burst as an I/O vector
+ */
+using GatherCallback = std::function<void(const FrameSegment* segments, int count)>;
+
+/**
+ * Series builder
+ */
+class BurstBuilder {
+public:
+    /**
+     * \param capacity Bytes of frames to preallocate for
+     * \param gather Reference payloads instead of copying them
+     */
+    explicit BurstBuilder(size_t capacity = 0, bool gather = false);
+    
+    /**
+     * Select scatter-gather output for frames added from now on
+     */
+    void set_gather(bool gather) { m_gather = gather; }
+    bool is_gather() const { return m_gather; }
+    
+    /**
+     * Preallocate for bytes of frames
+     */
+    void reserve(size_t bytes);
+    
+    /**
+     * Start a new burst (capacity kept)
+     */
+    void clear();
+    
+    /**
+     * Append control frame
+     * \return false if it could not be formatted
+     */
+    bool add_control_frame(const ControlFrame& frame);
+    
+    /**
+     * Append data frame, copying frame.data
+     */
+    bool add_data_frame(const DataFrame& frame);
+    
+    /**
+     * Append data frame whose payload lives elsewhere
+     * \param header Frame fields (data[] not used; data_length is)
+     * \param payload data_length bytes, referenced in gather mode until
+     *        the burst has been sent
+     */
+    bool add_data_frame(const DataFrame& header, const uint8_t* payload);
+    
+    /**
+     * Put a control frame in front of the frames added so far
+     * \return false if formatting failed or one is already there
+     */
+    bool prepend_control_frame(const ControlFrame& frame);
+    
+    bool empty() const { return m_frames == 0; }
+    int frame_count() const { return m_frames; }
+    
+    /**
+     * Total bytes on air
+     */
+    size_t size() const { return m_size; }
+    
+    /**
+     * Contiguous burst (not in gather mode)
+     */
+    const uint8_t* data() const { return m_buffer.data() + m_start; }
+    
+    /**
+     * Burst as an I/O vector (both modes; one segment when contiguous)
+     */
+    const std::vector<FrameSegment>& segments();
+    
+private:
+    // Buffer-relative while building, so the buffer may grow
+    struct Piece {
+        const uint8_t* external;    ///< Payload outside the buffer, or nullptr
+        size_t offset;              ///< Offset in buffer when not external
+        size_t length;
+    };
+    
+    std::vector<uint8_t> m_buffer;
+    std::vector<Piece> m_pieces;
+    std::vector<FrameSegment> m_segments;
+    size_t m_start;                 ///< First byte of the burst
+    size_t m_used;                  ///< End of buffer contents
+    size_t m_size;
+    int m_frames;
+    bool m_gather;
+    bool m_prepended;
+    
+    uint8_t* append_space(size_t length);
+    bool copy_data_frame(const DataFrame& header, const uint8_t* payload);
+};
+
+} // namespace fs1052
+
+#endif // FS1052_BURST_H
@@ -0,0 +1,94 @@
+/**
+ * \file fs1052_compress.h
+ * \brief Payload compression for FS-1052 transfers
+ *
+ * Byte-oriented LZ77 codec (LZ4-style token format) with a built-in
+ * static dictionary tuned for text and log traffic. The dictionary acts
+ * as pre-loaded history, so even short messages find matches.
+ *
+ * A quick entropy estimate skips data that is already compressed or
+ * encrypted; output that would not be smaller is never used.
+ *
+ * Compressed stream layout:
+ * - Method byte (COMPRESS_METHOD_LZ_DICT)
+ * - Original length (LEB128 varint)
+ * - Payload length (LEB128 varint)
+ * - Token payload
+ *
+ * Token format (repeated):
+ * - Token byte: high nibble literal count, low nibble match length - 4
+ *   (15 = extended by following bytes, 255 = continue)
+ * - Literals
+ * - Match offset (2 bytes little-endian, counted back into
+ *   dictionary + output), then match length extension
+ * The final token carries literals only.
+ */
+
+#ifndef FS1052_COMPRESS_H
+#define FS1052_COMPRESS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace fs1052 {
+
+constexpr uint8_t COMPRESS_METHOD_LZ_DICT = 1;   ///< LZ77 + static dictionary
+constexpr uint32_t COMPRESS_MIN_LENGTH = 16;     ///< Shorter messages are sent as-is
+constexpr float COMPRESS_MAX_ENTROPY = 7.5f;     ///< Bits/byte above which data is skipped
+
+/**
+ * Payload compressor/decompressor
+ */
+class PayloadCompressor {
+public:
+    /**
+     * Estimate Shannon entropy (bits per byte) from a sample of the data
+     * \param data Input bytes
+     * \param length Input length
+     * \return 0.0 (constant) to 8.0 (random)
+     */
+    static float estimate_entropy(const uint8_t* data, size_t length);
+    
+    /**
+     * Check whether compression is worth attempting
+     * (long enough and entropy below COMPRESS_MAX_ENTROPY)
+     */
+    static bool should_compress(const uint8_t* data, size_t length);
+    
+    /**
+     * Compress to a self-describing stream
+     * \param data Input bytes
+     * \param length Input length
+     * \param output [out] Compressed stream
+     * \return true if output is smaller than input (output valid)
+     */
+    static bool compress(const uint8_t* data, size_t length, std::vector<uint8_t>& output);
+    
+    /**
+     * Total stream length from its header
+     * \param stream Start of compressed stream
+     * \param available Bytes available
+     * \return Header + payload length, or 0 if header incomplete/invalid
+     */
+    static size_t stream_length(const uint8_t* stream, size_t available);
+    
+    /**
+     * Decompress a complete stream
+     * \param stream Compressed stream
+     * \param length Stream length
+     * \param output [out] Original bytes
+     * \return true if stream is valid and fully decoded
+     */
+    static bool decompress(const uint8_t* stream, size_t length, std::vector<uint8_t>& output);
+    
+    /**
+     * Built-in static dictionary
+     */
+    static const uint8_t* dictionary();
+    static size_t dictionary_size();
+};
+
+} // namespace fs1052
+
+#endif // FS1052_COMPRESS_H
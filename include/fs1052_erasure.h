@@ -0,0 +1,89 @@
+/**
+ * \file fs1052_erasure.h
+ * \brief Reed-Solomon erasure coding for FS-1052 data series
+ *
+ * Systematic MDS erasure code over GF(2^8) (polynomial 0x11D). A series
+ * of k data blocks is extended with m repair blocks; any k of the k+m
+ * blocks reconstruct the series. The generator is the identity over a
+ * Cauchy matrix C[j][i] = 1 / (x_j + y_i), x_j = k + j, y_i = i, whose
+ * square submatrices are all invertible (k + m <= 256).
+ *
+ * Region arithmetic (dst ^= c * src) uses SSSE3 PSHUFB nibble tables
+ * when the CPU supports it, with a portable table-driven fallback.
+ */
+
+#ifndef FS1052_ERASURE_H
+#define FS1052_ERASURE_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace fs1052 {
+
+constexpr int ERASURE_MAX_BLOCKS = 256;   ///< k + m limit for GF(2^8)
+
+/**
+ * GF(2^8) arithmetic
+ */
+class GF256 {
+public:
+    static uint8_t mul(uint8_t a, uint8_t b);
+    static uint8_t inv(uint8_t a);   ///< a != 0
+    
+    /**
+     * dst[i] ^= c * src[i], SIMD when available
+     */
+    static void mul_add_region(uint8_t* dst, const uint8_t* src, uint8_t c, size_t length);
+    
+    /**
+     * Portable implementation of mul_add_region
+     */
+    static void mul_add_region_scalar(uint8_t* dst, const uint8_t* src, uint8_t c, size_t length);
+    
+    /**
+     * Check if the SIMD region path is in use
+     */
+    static bool simd_available();
+};
+
+/**
+ * Systematic Reed-Solomon erasure coder
+ *
+ * All blocks in a series have the same length; callers pad short blocks.
+ */
+class ErasureCoder {
+public:
+    /**
+     * Compute repair blocks
+     * \param data k data blocks
+     * \param k Number of data blocks
+     * \param repair [out] m repair blocks (length bytes each)
+     * \param m Number of repair blocks
+     * \param length Block length
+     * \return false if k/m out of range
+     */
+    static bool encode(const uint8_t* const* data, int k,
+                       uint8_t* const* repair, int m, size_t length);
+    
+    /**
+     * Rebuild missing data blocks in place
+     * \param blocks k+m block pointers: data blocks first, then repair
+     * \param present Which of the k+m blocks were received
+     * \param k Number of data blocks
+     * \param m Number of repair blocks
+     * \param length Block length
+     * \return true if all data blocks are present afterwards
+     *         (false if fewer than k blocks were received)
+     */
+    static bool decode(uint8_t* const* blocks, const bool* present,
+                       int k, int m, size_t length);
+    
+    /**
+     * Coefficient of data block i in repair block j
+     */
+    static uint8_t coefficient(int k, int j, int i);
+};
+
+} // namespace fs1052
+
+#endif // FS1052_ERASURE_H
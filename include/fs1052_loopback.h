@@ -0,0 +1,176 @@
+/**
+ * \file fs1052_loopback.h
+ * \brief Loopback PHY for FS-1052 testing between processes
+ *
+ * Stands in for the HF modem: frames travel between two processes over
+ * Unix datagram sockets, delayed as if sent over a half-duplex radio
+ * link. Emulates:
+ * - Data rate (frames queue back to back, each taking its airtime)
+ * - Propagation/modem latency
+ * - Transmitter key-up turnaround when starting from idle
+ * - Half duplex: a transmission waits until frames already on their
+ *   way from the peer have arrived; frames that still overlap one of
+ *   ours (both ends keyed up at once) are lost
+ * - Random frame loss and bit corruption
+ *
+ * Time can run faster than real time (time_scale); now_ms() returns
+ * the emulated clock to feed VariableARQ::update().
+ *
+ * A burst (VariableARQ burst transmission) travels as one datagram of
+ * up to 64 KB and is timed, lost or corrupted as one transmission;
+ * scatter-gather bursts are sent with sendmsg() without being copied.
+ *
+ * Each datagram carries [magic:2][reserved:2][delay_us:4][airtime_us:4]
+ * (little-endian, real microseconds) ahead of the frame, so no clock is
+ * shared between the two processes.
+ *
+ * Not available on Windows (open() fails).
+ */
+
+#ifndef FS1052_LOOPBACK_H
+#define FS1052_LOOPBACK_H
+
+#include "fs1052_arq.h"
+#include <cstdint>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace fs1052 {
+
+/**
+ * Emulated channel parameters (emulated time)
+ */
+struct LoopbackConfig {
+    uint32_t bit_rate_bps;      ///< Modem data rate
+    uint32_t latency_ms;        ///< End of transmission to end of reception
+    uint32_t turnaround_ms;     ///< Key-up delay before a transmission from idle
+    float loss_rate;            ///< Probability a frame is lost (0-1)
+    float corruption_rate;      ///< Probability a delivered frame has a bit error (0-1)
+    float time_scale;           ///< Emulated seconds per real second
+    uint32_t seed;              ///< Loss/corruption RNG seed
+    
+    LoopbackConfig() : bit_rate_bps(2400), latency_ms(50), turnaround_ms(200),
+                       loss_rate(0.0f), corruption_rate(0.0f), time_scale(1.0f),
+                       seed(1052) {}
+};
+
+/**
+ * Loopback PHY statistics
+ */
+struct LoopbackStats {
+    uint32_t frames_sent;
+    uint32_t frames_received;
+    uint32_t frames_dropped;    ///< Lost by loss emulation
+    uint32_t frames_corrupted;  ///< Delivered with an injected bit error
+    uint32_t frames_collided;   ///< Arrived while we were transmitting
+    uint32_t send_errors;       ///< Socket errors (e.g. peer not bound yet)
+    uint64_t bytes_sent;
+    uint64_t bytes_received;
+};
+
+/**
+ * Unix datagram loopback PHY
+ */
+class LoopbackPHY {
+public:
+    LoopbackPHY();
+    ~LoopbackPHY();
+    
+    LoopbackPHY(const LoopbackPHY&) = delete;
+    LoopbackPHY& operator=(const LoopbackPHY&) = delete;
+    
+    /**
+     * Bind local socket and set peer address
+     * \param local_path Socket path to bind (removed first if present)
+     * \param peer_path Socket path of the other endpoint
+     * \return true on success
+     */
+    bool open(const std::string& local_path, const std::string& peer_path);
+    
+    /**
+     * Close socket and remove its path
+     */
+    void close();
+    
+    bool is_open() const { return m_fd >= 0; }
+    
+    /**
+     * Set channel parameters (takes effect for the next frame)
+     */
+    void set_config(const LoopbackConfig& config);
+    const LoopbackConfig& get_config() const { return m_config; }
+    
+    /**
+     * Transmit frame to peer
+     */
+    void transmit(const uint8_t* frame, int length);
+    
+    /**
+     * Transmit one burst given as an I/O vector
+     */
+    void transmit(const FrameSegment* segments, int count);
+    
+    /**
+     * Callback for VariableARQ::init
+     */
+    FrameCallback tx_callback();
+    
+    /**
+     * Callback for VariableARQ::set_gather_callback
+     */
+    GatherCallback gather_callback();
+    
+    /**
+     * Deliver frames whose emulated reception has completed
+     * \param max_wait_ms Longest real time to block waiting for one
+     * \param rx_callback Called for each delivered frame
+     * \return Number of frames delivered
+     */
+    int poll(uint32_t max_wait_ms, const FrameCallback& rx_callback);
+    
+    /**
+     * Emulated time since open() (ms)
+     */
+    uint32_t now_ms() const;
+    
+    /**
+     * Check if our transmitter is still sending queued frames
+     */
+    bool is_transmitting() const;
+    
+    const LoopbackStats& get_stats() const { return m_stats; }
+    
+private:
+    struct PendingFrame {
+        uint64_t release_us;    ///< Real time reception completes
+        uint32_t airtime_us;
+        std::vector<uint8_t> data;
+        
+        bool operator>(const PendingFrame& other) const { return release_us > other.release_us; }
+    };
+    
+    int m_fd;
+    std::string m_local_path;
+    std::string m_peer_path;
+    LoopbackConfig m_config;
+    LoopbackStats m_stats;
+    std::mt19937 m_rng;
+    
+    uint64_t m_epoch_us;        ///< Real clock at open()
+    uint64_t m_burst_start_us;  ///< Start of current transmission burst
+    uint64_t m_busy_until_us;   ///< End of queued transmission
+    uint64_t m_rx_busy_until_us;  ///< End of the peer's queued frames
+    std::vector<uint8_t> m_datagram;  ///< Send/receive buffer
+    
+    std::priority_queue<PendingFrame, std::vector<PendingFrame>, std::greater<PendingFrame>> m_pending;
+    
+    uint64_t real_now_us() const;
+    uint64_t to_real_us(uint64_t emulated_us) const;
+    void receive_datagrams();
+};
+
+} // namespace fs1052
+
+#endif // FS1052_LOOPBACK_H
@@ -33,6 +33,23 @@ constexpr uint8_t PROTOCOL_VERSION = 0;
 constexpr uint16_t MAX_DATA_BLOCK_LENGTH = 1023;
 constexpr uint8_t ACK_MAP_SIZE = 32;          ///< 256 bits / 8 = 32 bytes
 constexpr uint8_t MAX_SEQUENCE_NUMBER = 255;
+constexpr size_t DATA_FRAME_HEADER_LENGTH = 9;  ///< Flags, interleaver, sequence, offset, length
+constexpr size_t FRAME_CRC_LENGTH = 4;
+constexpr size_t MAX_CONTROL_FRAME_LENGTH = 107; ///< Long addresses, every optional field
+
+// Control frame ack/nak byte: bits 0-1 AckNakType, bits 2-5 field presence
+constexpr uint8_t CTRL_FIELD_BITMAP = 0x04;     ///< ACK bitmap follows
+constexpr uint8_t CTRL_FIELD_HERALD = 0x08;     ///< Herald fields follow
+constexpr uint8_t CTRL_FIELD_MESSAGE = 0x10;    ///< Message fields follow
+constexpr uint8_t CTRL_FIELD_EXTENSION = 0x20;  ///< Extension function bits follow
+
+// Extension function bits (ControlFrame::function_bits[0])
+constexpr uint32_t EXT_FUNC_COMPRESSION = 0x00000001;  ///< Payload compression supported
+
+// Data frame header byte, formerly reserved bits 2-3
+constexpr uint8_t DATA_FLAG_COMPRESSED = 0x04;  ///< Payload is part of a compressed stream
+constexpr uint8_t DATA_FLAG_REPAIR = 0x08;      ///< Payload is an erasure-code repair block
+constexpr uint8_t DATA_FLAG_TOGGLE = 0x80;      ///< Message toggle, in the interleaver byte
 
 // ============================================================================
 // ARQ Modes per FED-STD-1052
@@ -207,7 +224,7 @@ struct ControlFrame {
     uint32_t tx_msg_next_byte_pos;  ///< Next byte position to send
     uint32_t rx_msg_next_byte_pos;  ///< Next byte position expected
     
-    // Extension functions (future use)
+    // Extension functions (EXT_FUNC_* capability bits)
     bool extension_function_present;
     uint32_t function_bits[2];
     
@@ -245,7 +262,7 @@ struct ControlFrame {
  * - Header: Data rate, interleaver
  * - Sequence: Block number (0-255)
  * - Offset: Byte position in message
- * - Payload: Up to 1023 bytes
+ * - Payload: Up to 1023 bytes (compressed stream or repair block when flagged)
  * - CRC-32: Error detection
  */
 struct DataFrame {
@@ -257,6 +274,9 @@ struct DataFrame {
     // Sequence and position
     uint8_t sequence_number;        ///< Block sequence (0-255, wraps)
     uint32_t msg_byte_offset;       ///< Position in message
+    bool compressed;                ///< Offsets refer to the compressed stream
+    bool repair;                    ///< Repair block for the series starting at sequence_number
+    bool message_toggle;            ///< Alternates from one message to the next
     
     // Payload
     uint16_t data_length;           ///< Actual bytes in this block
@@ -268,8 +288,8 @@ struct DataFrame {
     DataFrame() : data_rate_format(DataRateFormat::ABSOLUTE),
                   data_rate(static_cast<uint8_t>(DataRate::BPS_2400)),
                   interleaver_length(InterleaverLength::LONG),
-                  sequence_number(0), msg_byte_offset(0),
-                  data_length(0), crc32(0) {
+                  sequence_number(0), msg_byte_offset(0), compressed(false), repair(false),
+                  message_toggle(false), data_length(0), crc32(0) {
         memset(data, 0, sizeof(data));
     }
 };
@@ -302,6 +322,27 @@ public:
      */
     static int format_data_frame(const DataFrame& frame, uint8_t* buffer, size_t buffer_size);
     
+    /**
+     * Format data frame header only (payload and CRC follow separately)
+     * \param frame Data frame structure (data[] not used)
+     * \param buffer [out] At least DATA_FRAME_HEADER_LENGTH bytes
+     * \return DATA_FRAME_HEADER_LENGTH
+     */
+    static size_t format_data_header(const DataFrame& frame, uint8_t* buffer);
+    
+    /**
+     * Length format_control_frame() will produce, without formatting
+     * \param frame Control frame structure
+     * \return Frame length in bytes (CRC included)
+     */
+    static size_t control_frame_length(const ControlFrame& frame);
+    
+    /**
+     * Length of a formatted data frame carrying data_length bytes
+     * \return Frame length in bytes (header and CRC included)
+     */
+    static size_t data_frame_length(uint16_t data_length);
+    
     /**
      * Calculate CRC-32 per FED-STD-1003A
      * \param data Input data
@@ -310,6 +351,13 @@ public:
      */
     static uint32_t calculate_crc32(const uint8_t* data, size_t length);
     
+    /**
+     * Continue CRC-32 over data that follows earlier bytes
+     * \param previous CRC of the earlier bytes
+     * \return CRC of earlier bytes followed by data
+     */
+    static uint32_t calculate_crc32(const uint8_t* data, size_t length, uint32_t previous);
+    
     /**
      * Append CRC-32 to frame
      * \param buffer Frame buffer
@@ -361,6 +409,16 @@ public:
      * \return Frame type
      */
     static FrameType detect_frame_type(const uint8_t* buffer);
+    
+    /**
+     * Length of the frame at the start of a buffer holding several
+     * frames back to back (a burst)
+     * \param buffer Input buffer
+     * \param length Bytes available
+     * \return Frame length, or 0 if truncated or not self-delimiting
+     *         (control frame without field presence flags)
+     */
+    static size_t frame_length(const uint8_t* buffer, size_t length);
 };
 
 // ============================================================================
@@ -0,0 +1,288 @@
+/**
+ * \file fs1052_sis.h
+ * \brief Subnetwork interface server: local clients sharing one FS-1052 link
+ *
+ * A STANAG 5066-style subnetwork interface (see docs/STANAG_5066.md)
+ * over a Unix domain SOCK_SEQPACKET socket, so each primitive is one
+ * packet. Client applications bind a service access point (SAP 0-15)
+ * and exchange S_DATA primitives; the server multiplexes them onto the
+ * link:
+ * - Outbound: requests are queued by priority (0-15, 15 most urgent)
+ *   and combined into one ARQ message per transfer. Each request is
+ *   received into a pooled buffer and handed to VariableARQ as one
+ *   segment of that message, so client data is copied once, into the
+ *   data blocks. S_DATA_CONFIRM follows the peer's acknowledgment.
+ * - Inbound: the peer's ARQ message is split and each piece delivered
+ *   to the client bound to its destination SAP straight from the ARQ
+ *   receive buffer (sendmsg() I/O vector, no copy).
+ * - Flow control: a client may have client_window requests queued or
+ *   in flight; beyond that its socket is not read, so the kernel holds
+ *   the client back.
+ *
+ * Two VariableARQ engines share the PHY: one sends our messages, the
+ * other receives the peer's. Data frames and bursts go to the
+ * receiving engine, ACKs to the sending one.
+ *
+ * Primitive: [version:4|type:4][length:16 big-endian][payload]. Not
+ * available on Windows (open()/connect() fail).
+ */
+
+#ifndef FS1052_SIS_H
+#define FS1052_SIS_H
+
+#include "fs1052_arq.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace fs1052 {
+
+constexpr uint8_t SIS_VERSION = 1;
+constexpr size_t SIS_HEADER_LENGTH = 3;
+constexpr uint8_t SIS_MAX_SAP = 15;
+constexpr uint8_t SIS_PRIORITY_LEVELS = 16;
+constexpr uint16_t SIS_DEFAULT_MTU = 4096;
+
+/**
+ * Primitive types
+ */
+enum class SISPrimitive : uint8_t {
+    BIND_REQUEST = 0x01,        ///< [sap][rank]
+    UNBIND_REQUEST = 0x02,      ///< (empty)
+    BIND_ACCEPTED = 0x03,       ///< [sap][mtu:16][window]
+    BIND_REJECTED = 0x04,       ///< [reason]
+    UNBIND_INDICATION = 0x05,   ///< [reason]
+    DATA = 0x08,                ///< Request [dest sap][priority][ref:16] data,
+                                ///< indication [source sap][priority] data
+    DATA_CONFIRM = 0x09,        ///< [ref:16]
+    DATA_REJECTED = 0x0A        ///< [ref:16][reason]
+};
+
+/**
+ * Rejection and unbind reasons
+ */
+enum class SISReason : uint8_t {
+    NONE = 0,
+    SAP_IN_USE = 1,
+    INVALID_SAP = 2,
+    TOO_MANY_CLIENTS = 3,
+    NOT_BOUND = 4,
+    TOO_LARGE = 5,
+    LINK_FAILED = 6,
+    MALFORMED = 7,
+    ALREADY_BOUND = 8
+};
+
+/**
+ * Server settings (set before open())
+ */
+struct SISConfig {
+    uint16_t mtu;               ///< Largest client message
+    uint8_t client_window;      ///< Requests a client may have queued or in flight
+    uint32_t max_batch_bytes;   ///< Client data combined into one ARQ message
+    int max_clients;
+    
+    SISConfig() : mtu(SIS_DEFAULT_MTU), client_window(4), max_batch_bytes(8 * MAX_DATA_BLOCK_LENGTH),
+                  max_clients(16) {}
+};
+
+/**
+ * Server statistics
+ */
+struct SISStats {
+    uint32_t clients_accepted;
+    uint32_t binds_rejected;
+    uint32_t requests_received;
+    uint32_t requests_confirmed;
+    uint32_t requests_rejected;
+    uint32_t batches_sent;
+    uint32_t batches_received;
+    uint32_t indications_delivered;
+    uint32_t indications_dropped;   ///< No client bound to the destination SAP
+    uint64_t bytes_from_clients;
+    uint64_t bytes_to_clients;
+};
+
+/**
+ * Primitive received by a client
+ */
+struct SISMessage {
+    SISPrimitive type;
+    uint8_t sap;                ///< Bound SAP, or source SAP of data
+    uint8_t priority;
+    uint16_t ref;               ///< Request reference (confirm/reject)
+    uint16_t mtu;               ///< BIND_ACCEPTED
+    uint8_t window;             ///< BIND_ACCEPTED
+    SISReason reason;
+    std::vector<uint8_t> data;
+    
+    SISMessage() : type(SISPrimitive::DATA), sap(0), priority(0), ref(0), mtu(0), window(0),
+                   reason(SISReason::NONE) {}
+};
+
+/**
+ * Primitive header coding
+ */
+size_t sis_format_header(SISPrimitive type, uint16_t payload_length, uint8_t* buffer);
+bool sis_parse_header(const uint8_t* buffer, size_t length, SISPrimitive& type,
+                      uint16_t& payload_length);
+
+/**
+ * Subnetwork interface server
+ */
+class SISServer {
+public:
+    SISServer();
+    ~SISServer();
+    
+    SISServer(const SISServer&) = delete;
+    SISServer& operator=(const SISServer&) = delete;
+    
+    void set_config(const SISConfig& config) { m_config = config; }
+    const SISConfig& get_config() const { return m_config; }
+    
+    /**
+     * Listen for clients and attach to the PHY
+     * \param path Socket path (removed first if present)
+     * \param phy_tx Frame transmit callback of the PHY
+     */
+    bool open(const std::string& path, FrameCallback phy_tx);
+    
+    /**
+     * Disconnect clients and stop listening
+     */
+    void close();
+    
+    bool is_open() const { return m_listen_fd >= 0; }
+    
+    /**
+     * Engine sending our messages (configure rate, window, bursts...)
+     */
+    VariableARQ& tx_arq() { return m_tx_arq; }
+    
+    /**
+     * Engine receiving the peer's messages
+     */
+    VariableARQ& rx_arq() { return m_rx_arq; }
+    
+    /**
+     * Frame from the PHY
+     */
+    void handle_received_frame(const uint8_t* frame, int length);
+    
+    /**
+     * Accept clients, read their requests, drive both ARQ engines and
+     * deliver confirms and indications (does not block)
+     */
+    void update(uint32_t now_ms);
+    
+    /**
+     * Block until a client or new connection needs attention
+     * \return true if update() has work
+     */
+    bool wait(uint32_t max_wait_ms);
+    
+    size_t client_count() const { return m_clients.size(); }
+    size_t queued_requests() const;
+    bool is_sending() const { return !m_in_flight.empty(); }
+    
+    const SISStats& get_stats() const { return m_stats; }
+    
+private:
+    struct Client {
+        int fd;
+        int sap;                    ///< -1 when not bound
+        uint8_t rank;
+        uint8_t outstanding;        ///< Requests queued or in flight
+    };
+    
+    struct Request {
+        uint32_t client;            ///< Client id
+        uint8_t source_sap;
+        uint8_t dest_sap;
+        uint8_t priority;
+        uint16_t ref;
+        std::vector<uint8_t> buffer;    ///< Packet as received, pooled
+        size_t data_offset;
+        size_t data_length;
+    };
+    
+    SISConfig m_config;
+    int m_listen_fd;
+    std::string m_path;
+    uint32_t m_next_client;
+    std::map<uint32_t, Client> m_clients;
+    uint32_t m_sap_owner[SIS_MAX_SAP + 1];  ///< Client id per SAP, 0 = free
+    
+    VariableARQ m_tx_arq;
+    VariableARQ m_rx_arq;
+    std::deque<Request> m_queue[SIS_PRIORITY_LEVELS];
+    std::vector<Request> m_in_flight;
+    std::vector<std::vector<uint8_t>> m_buffer_pool;
+    uint8_t m_batch_header[8];
+    uint32_t m_rx_delivered;            ///< RX message count already delivered
+    
+    SISStats m_stats;
+    
+    void accept_clients();
+    void read_client(uint32_t id);
+    void handle_primitive(uint32_t id, std::vector<uint8_t>& packet, size_t length);
+    void drop_client(uint32_t id);
+    void send_primitive(int fd, SISPrimitive type, const uint8_t* payload, uint16_t length);
+    void reject_request(uint32_t id, uint16_t ref, SISReason reason);
+    void start_batch();
+    void check_batch();
+    void finish_batch(bool delivered);
+    void deliver_received();
+    std::vector<uint8_t> take_buffer();
+    void release_buffer(std::vector<uint8_t>&& buffer);
+};
+
+/**
+ * Client side of the subnetwork interface
+ * All calls are non-blocking except receive() with a timeout.
+ */
+class SISClient {
+public:
+    SISClient();
+    ~SISClient();
+    
+    SISClient(const SISClient&) = delete;
+    SISClient& operator=(const SISClient&) = delete;
+    
+    bool connect(const std::string& path);
+    void close();
+    bool is_connected() const { return m_fd >= 0; }
+    
+    /**
+     * Ask to bind SAP (answer arrives as BIND_ACCEPTED/BIND_REJECTED)
+     * \param rank Highest priority the client may use (0-15)
+     */
+    bool bind(uint8_t sap, uint8_t rank);
+    
+    bool unbind();
+    
+    /**
+     * Submit data for dest_sap at the peer (answered by DATA_CONFIRM or
+     * DATA_REJECTED carrying ref)
+     */
+    bool send_data(uint8_t dest_sap, uint8_t priority, uint16_t ref,
+                   const uint8_t* data, uint16_t length);
+                   
+    /**
+     * Wait for the next primitive from the server
+     * \return false on timeout or disconnect
+     */
+    bool receive(SISMessage& message, uint32_t timeout_ms);
+    
+private:
+    int m_fd;
+    std::vector<uint8_t> m_buffer;
+};
+
+} // namespace fs1052
+
+#endif // FS1052_SIS_H
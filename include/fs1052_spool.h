@@ -0,0 +1,229 @@
+/**
+ * \file fs1052_spool.h
+ * \brief Persistent store-and-forward spool for outbound FS-1052 messages
+ *
+ * Holds messages for a gateway while links are down and feeds them to
+ * VariableARQ sessions as links come up:
+ * - Durable: each message is appended to a segment file and fsync'd
+ *   before enqueue() returns; delivery and expiry append a small
+ *   "done" record. A torn record at the end of the last segment (crash
+ *   mid-write) is cut off on open.
+ * - Segments roll over at a size limit and are deleted once every
+ *   message in them (and in all older segments) is done.
+ * - An index checkpoint (spool.idx, written atomically) lists pending
+ *   messages so open() only replays records written after it.
+ * - Payloads are read through read-only mappings of the segments.
+ * - Per-destination queues ordered by priority (tx_msg_priority 0-15,
+ *   15 most urgent), first in first out within a priority.
+ * - Optional time to live; expired messages are never handed out.
+ * - Dedupe: enqueueing a message identical (destination, priority,
+ *   payload) to one still pending returns the pending message's id.
+ *
+ * Times are caller-supplied milliseconds on a clock that survives
+ * restarts (e.g. Unix time). Not available on Windows (open() fails).
+ */
+
+#ifndef FS1052_SPOOL_H
+#define FS1052_SPOOL_H
+
+#include "fs1052_arq.h"
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ale {
+class MappedFile;
+}
+
+namespace fs1052 {
+
+constexpr uint8_t SPOOL_PRIORITY_LEVELS = 16;                  ///< tx_msg_priority range
+constexpr uint32_t SPOOL_DEFAULT_SEGMENT_BYTES = 1024 * 1024;  ///< Segment roll-over size
+
+/**
+ * Pending message (payload read separately)
+ */
+struct SpoolEntry {
+    uint64_t id;                ///< Spool-wide, increasing in enqueue order
+    std::string destination;
+    uint8_t priority;           ///< 0-15, 15 most urgent
+    uint64_t created_ms;
+    uint64_t expires_ms;        ///< 0 = never
+    uint32_t length;            ///< Payload bytes
+    
+    SpoolEntry() : id(0), priority(0), created_ms(0), expires_ms(0), length(0) {}
+};
+
+/**
+ * Spool statistics (since open)
+ */
+struct SpoolStats {
+    uint32_t messages_enqueued;
+    uint32_t duplicates;            ///< enqueue() calls answered by a pending copy
+    uint32_t messages_completed;
+    uint32_t messages_cancelled;
+    uint32_t messages_expired;
+    uint32_t records_replayed;      ///< Records read back by open()
+    uint32_t corrupt_records;       ///< Torn or damaged records cut off by open()
+    uint32_t segments_deleted;
+    uint32_t write_errors;
+    uint64_t bytes_written;
+};
+
+/**
+ * Persistent priority message spool
+ */
+class MessageSpool {
+public:
+    MessageSpool();
+    ~MessageSpool();
+    
+    MessageSpool(const MessageSpool&) = delete;
+    MessageSpool& operator=(const MessageSpool&) = delete;
+    
+    /**
+     * Open spool directory (created if missing) and recover its contents
+     * \return true on success
+     */
+    bool open(const std::string& directory);
+    
+    /**
+     * Write index checkpoint and close
+     */
+    void close();
+    
+    bool is_open() const { return m_fd >= 0; }
+    
+    /**
+     * Size at which a new segment is started
+     */
+    void set_segment_bytes(uint32_t bytes) { m_segment_bytes = bytes; }
+    
+    /**
+     * fsync after every record (default on). Off trades durability of
+     * the last few records for throughput.
+     */
+    void set_sync(bool sync) { m_sync = sync; }
+    
+    /**
+     * Store message
+     * \param ttl_ms Time to live (0 = never expires)
+     * \return Message id (that of the pending duplicate, if any), 0 on error
+     */
+    uint64_t enqueue(const std::string& destination, const uint8_t* data, uint32_t length,
+                     uint8_t priority, uint64_t now_ms, uint64_t ttl_ms = 0);
+                     
+    /**
+     * Most urgent unexpired message for destination (not removed)
+     * \return false if none
+     */
+    bool peek(const std::string& destination, uint64_t now_ms, SpoolEntry& entry);
+    
+    /**
+     * Most urgent unexpired message for any destination, oldest first
+     * among equal priorities
+     */
+    bool peek_any(uint64_t now_ms, SpoolEntry& entry);
+    
+    /**
+     * Copy payload of a pending message
+     */
+    bool read(uint64_t id, std::vector<uint8_t>& payload);
+    
+    /**
+     * Start the next message for destination on an ARQ session
+     * The message stays spooled until complete() is called for it.
+     * \return Message id, 0 if nothing is pending or the session refused it
+     */
+    uint64_t start_next(VariableARQ& arq, const std::string& destination, uint64_t now_ms);
+    
+    /**
+     * Message delivered: remove it durably
+     */
+    bool complete(uint64_t id);
+    
+    /**
+     * Drop message without delivering it
+     */
+    bool cancel(uint64_t id);
+    
+    /**
+     * Remove every message whose time to live has run out
+     * \return Number of messages expired
+     */
+    size_t expire(uint64_t now_ms);
+    
+    /**
+     * Write index checkpoint (also done on segment roll-over and close)
+     */
+    bool checkpoint();
+    
+    size_t pending() const { return m_messages.size(); }
+    size_t pending(const std::string& destination) const;
+    
+    /**
+     * Destinations with pending messages
+     */
+    std::vector<std::string> destinations() const;
+    
+    /**
+     * Number of segment files on disk
+     */
+    size_t segment_count() const { return m_segments.size(); }
+    
+    const SpoolStats& get_stats() const { return m_stats; }
+    
+private:
+    struct Message {
+        SpoolEntry entry;
+        uint32_t segment;           ///< Segment number holding the payload
+        uint32_t payload_offset;    ///< Payload position in that segment
+        uint64_t digest;            ///< Dedupe key
+    };
+    
+    struct Segment {
+        uint32_t live;              ///< Pending messages stored in it
+        uint32_t size;              ///< Bytes written
+    };
+    
+    // Message ids per priority; done ids are skipped lazily
+    struct DestinationQueue {
+        std::deque<uint64_t> fifo[SPOOL_PRIORITY_LEVELS];
+        size_t count;
+        
+        DestinationQueue() : count(0) {}
+    };
+    
+    std::string m_directory;
+    int m_fd;                       ///< Active (last) segment
+    uint32_t m_segment_bytes;
+    bool m_sync;
+    uint64_t m_next_id;
+    SpoolStats m_stats;
+    
+    std::map<uint32_t, Segment> m_segments;
+    std::unordered_map<uint64_t, Message> m_messages;
+    std::unordered_map<uint64_t, uint64_t> m_digests;       ///< Digest -> id
+    std::map<std::string, DestinationQueue> m_queues;
+    std::map<uint32_t, std::unique_ptr<ale::MappedFile>> m_maps;
+    
+    std::string segment_path(uint32_t segment) const;
+    std::string index_path() const;
+    bool load_index(uint32_t& segment, uint32_t& offset);
+    bool replay_segment(uint32_t segment, uint32_t offset, bool last);
+    void apply_message(const Message& message);
+    void apply_done(uint64_t id);
+    bool open_segment(uint32_t segment);
+    bool append_record(const std::vector<uint8_t>& body, uint32_t& body_offset);
+    bool finish(uint64_t id, uint8_t reason);
+    bool next_in_queue(DestinationQueue& queue, uint64_t now_ms, uint64_t& id);
+    void delete_drained_segments();
+};
+
+} // namespace fs1052
+
+#endif // FS1052_SPOOL_H
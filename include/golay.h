@@ -3,7 +3,9 @@
  * \brief Extended Golay (24,12) FEC encoder/decoder
  * 
  * Table-driven implementation of Extended Golay error-correcting code.
- * Corrects up to 3 bit errors per 24-bit codeword.
+ * Corrects up to 3 bit errors per 24-bit codeword, or more when the
+ * positions of unreliable bits are known (errors-and-erasures decoding).
+ * Large batches are decoded bit-sliced, 64 codewords at a time.
  * 
  * Specification: MIL-STD-188-141B
  *  - Code: Extended Golay (24,12)
@@ -15,7 +17,9 @@
 #pragma once
 
 #include <cstdint>
+#include <cstddef>
 #include <array>
+#include <mutex>
 
 namespace ale {
 
@@ -40,6 +44,103 @@ public:
      */
     static uint8_t decode(uint32_t codeword, uint16_t& output);
     
+    /**
+     * Most erasures decode_with_erasures() accepts (minimum distance - 1)
+     */
+    static constexpr uint32_t MAX_ERASURES = 7;
+    
+    /**
+     * Decode codeword with known-unreliable bit positions (erasures)
+     * Corrects any e errors and s erasures with 2e + s <= 7: up to 3
+     * errors without erasures, or up to 7 erasures without errors.
+     * Erased bits may hold any value.
+     * 
+     * \param codeword 24-bit received codeword
+     * \param erasures Mask of erased bit positions (bit n = codeword bit n)
+     * \param output [out] 12-bit decoded information
+     * \return Errors corrected plus erasures filled (0-7), or 0xFF if uncorrectable
+     */
+    static uint8_t decode_with_erasures(uint32_t codeword, uint32_t erasures, uint16_t& output);
+    
+    /**
+     * Encode a block of 12-bit information words
+     * Batched form of encode() for block codes built on Golay (e.g. DBM).
+     * 
+     * \param info Array of 12-bit information words
+     * \param codewords [out] Array of 24-bit codewords (same length)
+     * \param count Number of words to encode
+     */
+    static void encode_block(const uint16_t* info, uint32_t* codewords, size_t count);
+    
+    /**
+     * Decode and correct a block of 24-bit codewords
+     * Full groups of SLICE_WIDTH words are decoded with decode_sliced().
+     * 
+     * \param codewords Array of received 24-bit codewords
+     * \param info [out] Array of 12-bit decoded information words
+     * \param errors [out] Optional per-word error counts (0-3, or 0xFF), may be nullptr
+     * \param count Number of codewords to decode
+     * \return Number of uncorrectable codewords in the block
+     */
+    static uint32_t decode_block(const uint32_t* codewords, uint16_t* info,
+                                 uint8_t* errors, size_t count);
+                                 
+    /**
+     * Decode a block of codewords with per-word erasure masks
+     * 
+     * \param codewords Array of received 24-bit codewords
+     * \param erasures Array of erasure masks (same length)
+     * \param info [out] Array of 12-bit decoded information words
+     * \param errors [out] Optional per-word results of decode_with_erasures(), may be nullptr
+     * \param count Number of codewords to decode
+     * \return Number of uncorrectable codewords in the block
+     */
+    static uint32_t decode_block_with_erasures(const uint32_t* codewords, const uint32_t* erasures,
+                                               uint16_t* info, uint8_t* errors, size_t count);
+                                               
+    /**
+     * Codewords per bit-sliced group (one per bit of a uint64_t plane)
+     */
+    static constexpr size_t SLICE_WIDTH = 64;
+    
+    /**
+     * Transpose up to 64 codewords into 24 bit planes
+     * Bit n of planes[k] is bit k of codewords[n]; lanes past count are zero.
+     * 
+     * \param codewords Array of 24-bit codewords
+     * \param count Number of codewords (at most SLICE_WIDTH)
+     * \param planes [out] 24 bit planes
+     */
+    static void to_bit_planes(const uint32_t* codewords, size_t count, uint64_t planes[24]);
+    
+    /**
+     * Transpose 24 bit planes back into codewords (inverse of to_bit_planes())
+     * 
+     * \param planes 24 bit planes
+     * \param codewords [out] Array of 24-bit codewords
+     * \param count Number of codewords (at most SLICE_WIDTH)
+     */
+    static void from_bit_planes(const uint64_t planes[24], uint32_t* codewords, size_t count);
+    
+    /**
+     * Encode 64 codewords held as bit planes
+     * Computes parity planes 0-11 from information planes 12-23.
+     * 
+     * \param planes [in,out] 24 bit planes
+     */
+    static void encode_sliced(uint64_t planes[24]);
+    
+    /**
+     * Decode and correct 64 codewords held as bit planes
+     * Same results as decode() for every lane, using only bitwise
+     * operations across the planes (no per-word table lookups).
+     * Uncorrectable lanes are left unchanged.
+     * 
+     * \param planes [in,out] 24 bit planes, corrected in place
+     * \return Mask of lanes that were uncorrectable
+     */
+    static uint64_t decode_sliced(uint64_t planes[24]);
+    
     /**
      * Extract information bits from codeword (no error correction)
      * 
@@ -77,10 +178,11 @@ private:
     
     /**
      * Initialize syndrome table once at startup
+     * Run through std::call_once so concurrent first decodes don't race.
      */
     static bool init_syndrome_table();
     
-    static bool syndrome_table_initialized;
+    static std::once_flag syndrome_table_once;
 };
 
 } // namespace ale
@@ -0,0 +1,275 @@
+/**
+ * \file sample_clock.h
+ * \brief Shared 64-bit sample clock for the receive and transmit paths
+ *
+ * The audio device is the timebase: every time on the audio path is a
+ * SampleTime, the number of samples since capture started. Symbols,
+ * words, messages, AQC frames and scheduled transmit words all carry one,
+ * so they can be compared exactly and never wrap (2^64 samples at 8 kHz
+ * is 73 million years).
+ *
+ * SampleClock converts sample times to the host monotonic clock (for
+ * timers and latency measurement) and to wall time (for logs and the
+ * archive) from an anchor: one sample time paired with the monotonic and
+ * wall clock readings taken at the same moment, usually when capture
+ * starts. Conversions use the clock's sample rate, which defaults to the
+ * nominal SAMPLE_RATE_HZ and can be replaced by a measured rate.
+ *
+ * Sound card crystals are typically tens of ppm off, so with the nominal
+ * rate the mapping drifts by seconds per day. ClockDriftEstimator
+ * measures the actual rate against the monotonic clock and retunes the
+ * SampleClock. Driving the protocol timers from the audio clock, e.g.
+ * update(clock.to_timer_ms(clock.now())), then keeps dwell, slot and
+ * word timing consistent with each other and with host time.
+ */
+
+#pragma once
+
+#include "ale_types.h"
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace ale {
+
+/**
+ * \class SampleClock
+ * Sample counter with monotonic and wall time conversion
+ *
+ * advance() may be called from the capture thread while other threads
+ * call now(); anchoring and rate changes must not race with conversions.
+ */
+class SampleClock {
+public:
+    /**
+     * \param sample_rate_hz Rate used for conversions
+     */
+    explicit SampleClock(double sample_rate_hz = SAMPLE_RATE_HZ);
+    
+    SampleClock(const SampleClock&) = delete;
+    SampleClock& operator=(const SampleClock&) = delete;
+    
+    /**
+     * Pair a sample time with monotonic and wall clock readings
+     * \param sample Sample time
+     * \param monotonic_ns Monotonic clock at that sample (ns)
+     * \param wall_ms Wall clock at that sample (ms since the Unix epoch)
+     */
+    void anchor(SampleTime sample, int64_t monotonic_ns, int64_t wall_ms);
+    
+    /**
+     * Anchor a sample time to the host clocks as read now
+     * Call from the capture callback with the time of the buffer just read.
+     */
+    void anchor_now(SampleTime sample);
+    
+    /**
+     * Count captured samples
+     * \param samples Samples just captured
+     * \return Sample time after them
+     */
+    SampleTime advance(uint32_t samples) {
+        return position.fetch_add(samples, std::memory_order_relaxed) + samples;
+    }
+    
+    /**
+     * Samples captured so far
+     */
+    SampleTime now() const { return position.load(std::memory_order_relaxed); }
+    
+    /**
+     * Restart counting (anchor is kept)
+     */
+    void reset(SampleTime sample = 0) { position.store(sample, std::memory_order_relaxed); }
+    
+    double get_sample_rate() const { return sample_rate_hz; }
+    
+    /**
+     * Change the conversion rate
+     * The clock is re-anchored at now(), so times converted before and
+     * after the change agree at the current sample.
+     */
+    void set_sample_rate(double hz);
+    
+    /**
+     * Re-anchor to a measured mapping
+     * The offset between wall and monotonic time is kept.
+     * \param sample Sample time
+     * \param monotonic_ns Monotonic clock at that sample (ns)
+     * \param hz Measured sample rate
+     */
+    void retune(SampleTime sample, int64_t monotonic_ns, double hz);
+    
+    /**
+     * Sample time to monotonic clock (ns)
+     */
+    int64_t to_monotonic_ns(SampleTime sample) const;
+    
+    /**
+     * Sample time to wall clock (ms since the Unix epoch)
+     */
+    int64_t to_wall_ms(SampleTime sample) const;
+    
+    /**
+     * Sample time to the 32-bit millisecond clock used by the protocol
+     * timers (monotonic, wraps after ~49 days like ALEWord::timestamp_ms)
+     */
+    uint32_t to_timer_ms(SampleTime sample) const;
+    
+    /**
+     * Monotonic clock (ns) to sample time, clamped at sample 0
+     */
+    SampleTime from_monotonic_ns(int64_t monotonic_ns) const;
+    
+    /**
+     * Wall clock (ms since the Unix epoch) to sample time, clamped at 0
+     */
+    SampleTime from_wall_ms(int64_t wall_ms) const;
+    
+    /**
+     * Time from a sample until the monotonic clock reading (ns)
+     * \param sample Capture time of an event (e.g. a word's last symbol)
+     * \param monotonic_ns When it was handled
+     */
+    int64_t latency_ns(SampleTime sample, int64_t monotonic_ns) const {
+        return monotonic_ns - to_monotonic_ns(sample);
+    }
+    
+    /**
+     * Host monotonic clock (ns)
+     */
+    static int64_t monotonic_now_ns();
+    
+    /**
+     * Host wall clock (ms since the Unix epoch)
+     */
+    static int64_t wall_now_ms();
+    
+    /**
+     * Duration conversions at the nominal SAMPLE_RATE_HZ
+     */
+    static constexpr SampleTime ms_to_samples(uint64_t ms) {
+        return ms * SAMPLE_RATE_HZ / 1000;
+    }
+    static constexpr uint64_t samples_to_ms(SampleTime samples) {
+        return samples * 1000 / SAMPLE_RATE_HZ;
+    }
+    
+private:
+    std::atomic<SampleTime> position;
+    double sample_rate_hz;
+    SampleTime anchor_sample;
+    int64_t anchor_monotonic_ns;
+    int64_t anchor_wall_ms;
+};
+
+/**
+ * \struct DriftConfig
+ * Clock drift estimator parameters
+ */
+struct DriftConfig {
+    uint32_t bucket_samples;        ///< Observations per bucket are reduced to the least delayed one
+    uint32_t window_buckets;        ///< Buckets in the regression window
+    uint32_t lock_buckets;          ///< Buckets needed before the estimate is used
+    int64_t max_step_ns;            ///< Larger deviation from the fit restarts estimation
+    
+    DriftConfig() : bucket_samples(2 * SAMPLE_RATE_HZ), window_buckets(300),
+                    lock_buckets(30), max_step_ns(20000000) {}
+};
+
+/**
+ * \class ClockDriftEstimator
+ * Measures the audio sample rate against the host monotonic clock
+ *
+ * Feed it the capture clock and the monotonic time each buffer arrived.
+ * Callback latency only ever delays arrival, so each bucket keeps its
+ * earliest observation relative to the nominal rate; a least-squares
+ * line through the bucket minima over the window gives the rate and the
+ * sample-to-monotonic mapping. A deviation above max_step_ns (dropped
+ * samples, device restart, suspend) restarts estimation.
+ */
+class ClockDriftEstimator {
+public:
+    explicit ClockDriftEstimator(double nominal_rate_hz = SAMPLE_RATE_HZ);
+    
+    void configure(const DriftConfig& config);
+    const DriftConfig& get_config() const { return config; }
+    
+    /**
+     * Add an observation
+     * \param sample Sample time at the end of the captured buffer
+     * \param monotonic_ns Monotonic clock when the buffer was delivered
+     */
+    void observe(SampleTime sample, int64_t monotonic_ns);
+    
+    /**
+     * Enough history for a usable estimate
+     */
+    bool is_locked() const { return fitted && buckets.size() >= config.lock_buckets; }
+    
+    /**
+     * Measured rate (nominal until locked)
+     */
+    double get_sample_rate() const;
+    
+    /**
+     * Measured rate error, parts per million (positive: sound card fast)
+     */
+    double get_ppm() const;
+    
+    /**
+     * RMS deviation of the bucket minima from the fit (ns)
+     */
+    double get_residual_ns() const { return residual_ns; }
+    
+    /**
+     * Times estimation restarted after a step
+     */
+    uint32_t get_restarts() const { return restarts; }
+    
+    /**
+     * Fitted monotonic time of a sample (ns), valid once locked
+     */
+    int64_t predict_monotonic_ns(SampleTime sample) const;
+    
+    /**
+     * Retune a clock to the measured rate and mapping
+     * \return false (clock unchanged) until locked
+     */
+    bool compensate(SampleClock& clock) const;
+    
+    /**
+     * Discard all history
+     */
+    void reset();
+    
+private:
+    struct Bucket {
+        SampleTime sample;
+        int64_t monotonic_ns;
+    };
+    
+    DriftConfig config;
+    double nominal_rate_hz;
+    double nominal_ns_per_sample;
+    
+    std::vector<Bucket> buckets;        ///< Completed bucket minima, oldest first
+    Bucket current;                     ///< Earliest observation in the open bucket
+    SampleTime current_index;           ///< Open bucket number
+    bool current_valid;
+    
+    // Fit: offset from the nominal line through origin = slope * dx + intercept
+    bool fitted;
+    Bucket origin;
+    double slope_ns_per_sample;
+    double intercept_ns;
+    double residual_ns;
+    uint32_t restarts;
+    
+    // Offset of an observation from the nominal line through origin
+    double nominal_offset_ns(const Bucket& point) const;
+    void close_bucket();
+    void fit();
+};
+
+} // namespace ale
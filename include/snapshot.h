@@ -0,0 +1,215 @@
+/**
+ * \file snapshot.h
+ * \brief Binary state snapshots: encoding, memory-mapped loading, atomic
+ *        and background persistence
+ *
+ * Used to bring link-layer state back in milliseconds after a restart:
+ *  - SnapshotWriter/SnapshotReader: compact little-endian encoding with
+ *    bounds-checked reads (a truncated or corrupt file never over-reads)
+ *  - Framing: magic, version, payload length and CRC-32 around the payload
+ *  - MappedFile: read-only memory mapping of a snapshot on startup
+ *    (falls back to a heap copy where mmap is unavailable)
+ *  - write_file_atomic: write to temp file, fsync, rename over target,
+ *    fsync the directory, so a crash mid-write leaves the previous
+ *    snapshot intact
+ *  - SnapshotPersister: background thread that writes the latest
+ *    submitted snapshot, keeping file I/O off the real-time path
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ale {
+
+constexpr uint32_t SNAPSHOT_MAGIC = 0x50414E53;     ///< "SNAP" little-endian
+constexpr uint32_t SNAPSHOT_HEADER_BYTES = 16;      ///< magic, version, length, CRC
+
+/**
+ * \class SnapshotWriter
+ * Append-only little-endian encoder
+ */
+class SnapshotWriter {
+public:
+    void put_u8(uint8_t value);
+    void put_u16(uint16_t value);
+    void put_u32(uint32_t value);
+    void put_u64(uint64_t value);
+    void put_f32(float value);
+    void put_bool(bool value) { put_u8(value ? 1 : 0); }
+    
+    /**
+     * Length-prefixed (u16) string
+     */
+    void put_string(const std::string& value);
+    
+    void put_bytes(const uint8_t* data, size_t length);
+    
+    const std::vector<uint8_t>& data() const { return buffer; }
+    size_t size() const { return buffer.size(); }
+    void clear() { buffer.clear(); }
+    
+    /**
+     * Wrap payload in snapshot header
+     * \param version Caller's format version
+     * \param output [out] Framed snapshot
+     */
+    void finish(uint32_t version, std::vector<uint8_t>& output) const;
+    
+private:
+    std::vector<uint8_t> buffer;
+};
+
+/**
+ * \class SnapshotReader
+ * Bounds-checked little-endian decoder
+ *
+ * Any read past the end sets the failed flag and returns zero; callers
+ * check ok() once after decoding a section.
+ */
+class SnapshotReader {
+public:
+    SnapshotReader(const uint8_t* data, size_t length)
+        : data(data), length(length), offset(0), failed(false) {}
+        
+    /**
+     * Validate snapshot header and return a reader over its payload
+     * \param data Framed snapshot
+     * \param length Snapshot length
+     * \param version Expected format version
+     * \param payload [out] Reader positioned at payload start
+     * \return true if magic, version, length and CRC all match
+     */
+    static bool open(const uint8_t* data, size_t length, uint32_t version,
+                     SnapshotReader& payload);
+                     
+    uint8_t get_u8();
+    uint16_t get_u16();
+    uint32_t get_u32();
+    uint64_t get_u64();
+    float get_f32();
+    bool get_bool() { return get_u8() != 0; }
+    std::string get_string();
+    
+    bool ok() const { return !failed; }
+    size_t remaining() const { return length - offset; }
+    
+private:
+    const uint8_t* data;
+    size_t length;
+    size_t offset;
+    bool failed;
+    
+    bool need(size_t bytes);
+};
+
+/**
+ * \class MappedFile
+ * Read-only view of a whole file
+ */
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+    
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    
+    /**
+     * Map file
+     * \param path File path
+     * \return true if mapped (empty files fail)
+     */
+    bool open(const std::string& path);
+    
+    void close();
+    
+    const uint8_t* data() const { return view; }
+    size_t size() const { return view_size; }
+    bool is_open() const { return view != nullptr; }
+    
+private:
+    const uint8_t* view;
+    size_t view_size;
+    bool mapped;                  ///< true if view is an mmap region
+    std::vector<uint8_t> fallback;
+};
+
+/**
+ * Write file atomically (temp file + fsync + rename + directory fsync)
+ * \return true if target now holds the new contents
+ */
+bool write_file_atomic(const std::string& path, const uint8_t* data, size_t length);
+
+/**
+ * CRC-32 (IEEE 802.3, reflected 0xEDB88320)
+ */
+uint32_t snapshot_crc32(const uint8_t* data, size_t length);
+
+/**
+ * \class SnapshotPersister
+ * Background writer for periodic snapshots
+ *
+ * submit() hands over an encoded snapshot and returns immediately; the
+ * worker writes only the most recent one, so a slow disk coalesces
+ * snapshots instead of queueing them.
+ */
+class SnapshotPersister {
+public:
+    SnapshotPersister();
+    ~SnapshotPersister();
+    
+    SnapshotPersister(const SnapshotPersister&) = delete;
+    SnapshotPersister& operator=(const SnapshotPersister&) = delete;
+    
+    /**
+     * Start worker thread
+     * \param path Snapshot file path
+     */
+    void start(const std::string& path);
+    
+    /**
+     * Stop worker after writing any pending snapshot
+     * start() and stop() belong to one owning thread; flush(), submit()
+     * and the getters may be called from any thread.
+     */
+    void stop();
+    
+    /**
+     * Queue snapshot for writing (replaces any unwritten one)
+     */
+    void submit(std::vector<uint8_t>&& snapshot);
+    
+    /**
+     * Block until the pending snapshot (if any) is on disk
+     */
+    void flush();
+    
+    bool is_running() const;
+    uint32_t get_write_count() const;
+    uint32_t get_error_count() const;
+    
+private:
+    std::string path;
+    std::thread worker;
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    std::vector<uint8_t> pending;
+    bool has_pending;
+    bool writing;
+    bool running;
+    bool stopping;
+    uint32_t write_count;
+    uint32_t error_count;
+    
+    void run();
+};
+
+} // namespace ale
@@ -43,9 +43,10 @@ public:
     
     /**
      * Majority voting for triple-redundant bit
-     * Combines 3 copies of same bit for error correction
+     * Combines 3 copies of same bit for error correction. Copies from
+     * failed symbols (0xFF) do not vote; a tie gives 0.
      * 
-     * \param bits Array of 3 bit values
+     * \param bits Array of 3 bit values (0, 1, or 0xFF if unknown)
      * \return Final bit value (0 or 1)
      */
     static uint8_t majority_vote(const uint8_t bits[3]);
@@ -60,6 +61,20 @@ public:
     static uint32_t decode_word_with_voting(const uint8_t symbols[SYMBOLS_PER_WORD],
                                             uint32_t& output_word);
     
+    /**
+     * Decode word using triple redundancy voting, marking unreliable bits
+     * A bit is erased when fewer than two of its copies agree (copies
+     * disagree or come from failed symbols). Feed the mask to
+     * Golay::decode_with_erasures().
+     * 
+     * \param symbols Detected symbols (same layout as decode_word_with_voting())
+     * \param output_word [out] 24-bit decoded word (erased bits by plurality, else 0)
+     * \param erasures [out] Mask of erased bits
+     * \return Number of bits whose copies were not unanimous
+     */
+    static uint32_t decode_word_with_erasures(const uint8_t symbols[SYMBOLS_PER_WORD],
+                                              uint32_t& output_word, uint32_t& erasures);
+                                              
 private:
     // Lookup table: FFT bin -> symbol value
     // Bins 6-22 (every 2): 6->0, 8->1, 10->2, 12->3, 14->4, 16->5, 18->6, 20->7, 22->0xFF
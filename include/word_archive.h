@@ -0,0 +1,242 @@
+/**
+ * \file word_archive.h
+ * \brief Indexed archive of decoded ALE words and messages
+ *
+ * Long-running receivers append every decoded word and assembled message;
+ * network management asks questions like "all calls from station X on
+ * 7 MHz last week" without rescanning raw logs:
+ *  - Records are collected in an in-memory segment and sealed into a
+ *    segment file once it is full (or on flush()/close()), written
+ *    atomically and framed with a CRC like snapshots
+ *  - Segments are columnar with fixed-width columns (time, frequency,
+ *    type, payload, addresses), sorted by time, so a time range is a
+ *    binary search and any row is read directly from the mapped file
+ *  - Each segment carries an inverted index: address dictionary and,
+ *    per address, the rows it appears in (with its role: FROM/TIS or
+ *    TO/TWS/THRU)
+ *  - open() maps existing segments and keeps only their time and
+ *    frequency bounds and dictionaries in memory; a query skips every
+ *    segment whose bounds or dictionary rule it out
+ *
+ * Times are caller-supplied milliseconds on a clock that survives
+ * restarts (e.g. Unix time). Records not yet sealed are lost on a crash;
+ * call flush() at whatever interval that loss is acceptable.
+ * Not available on Windows (open() fails).
+ */
+
+#pragma once
+
+#include "ale_word.h"
+#include "ale_message.h"
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ale {
+
+class MappedFile;
+
+constexpr uint32_t ARCHIVE_DEFAULT_SEGMENT_RECORDS = 65536;  ///< Rows per sealed segment
+
+/**
+ * \enum ArchiveRole
+ * Which address of a record a query matches
+ */
+enum class ArchiveRole : uint8_t {
+    ANY,            ///< Caller or called station
+    FROM,           ///< Message FROM address, or FROM/TIS word
+    TO              ///< Message TO address, or TO/TWS/THRU word
+};
+
+/**
+ * \struct ArchiveRecord
+ * One archived word or message
+ */
+struct ArchiveRecord {
+    uint64_t time_ms;                       ///< Reception time
+    uint32_t frequency_hz;                  ///< Channel it was received on
+    bool is_message;                        ///< Message record (else word record)
+    WordType word_type;                     ///< Word: preamble
+    uint32_t raw_payload;                   ///< Word: raw 21-bit payload
+    uint8_t fec_errors;                     ///< Word: Golay errors corrected
+    bool valid;                             ///< Word: passed FEC and validation
+    CallType call_type;                     ///< Message: call type
+    uint32_t duration_ms;                   ///< Message: duration
+    uint8_t word_count;                     ///< Message: words received (saturates at 255)
+    std::string from_address;               ///< FROM/TIS address, if any
+    std::vector<std::string> to_addresses;  ///< TO/TWS/THRU addresses, if any
+    
+    ArchiveRecord() : time_ms(0), frequency_hz(0), is_message(false),
+                      word_type(WordType::UNKNOWN), raw_payload(0), fec_errors(0),
+                      valid(false), call_type(CallType::UNKNOWN), duration_ms(0),
+                      word_count(0) {}
+};
+
+/**
+ * \struct ArchiveQuery
+ * Record filter; all conditions must hold
+ */
+struct ArchiveQuery {
+    std::string address;            ///< Station address (empty: any)
+    ArchiveRole role;               ///< Address role to match
+    uint64_t start_ms;              ///< Time range [start_ms, end_ms)
+    uint64_t end_ms;
+    uint32_t min_frequency_hz;      ///< Frequency range, inclusive
+    uint32_t max_frequency_hz;
+    bool include_words;
+    bool include_messages;
+    size_t max_results;             ///< 0 = unlimited (earliest results kept)
+    
+    ArchiveQuery() : role(ArchiveRole::ANY), start_ms(0), end_ms(UINT64_MAX),
+                     min_frequency_hz(0), max_frequency_hz(UINT32_MAX),
+                     include_words(true), include_messages(true), max_results(0) {}
+};
+
+/**
+ * \class WordArchive
+ * Append-only, indexed archive of words and messages
+ */
+class WordArchive {
+public:
+    WordArchive();
+    ~WordArchive();
+    
+    WordArchive(const WordArchive&) = delete;
+    WordArchive& operator=(const WordArchive&) = delete;
+    
+    /**
+     * Open archive directory (created if missing) and map its segments
+     * \return true on success
+     */
+    bool open(const std::string& directory);
+    
+    /**
+     * Seal pending records and close
+     */
+    void close();
+    
+    bool is_open() const { return !directory.empty(); }
+    
+    /**
+     * Records per segment (sealed automatically when reached, at most 2^30)
+     */
+    void set_segment_records(uint32_t records) {
+        segment_records = std::min<uint32_t>(std::max<uint32_t>(records, 1), 1U << 30);
+    }
+    
+    /**
+     * Archive a decoded word
+     * Address words (TO, TWS, THRU, FROM, TIS) are indexed by address.
+     * \param word Decoded word (its own timestamp is not used)
+     * \param frequency_hz Channel
+     * \param time_ms Reception time
+     * \return false if the archive is not open or a segment write failed
+     */
+    bool append_word(const ALEWord& word, uint32_t frequency_hz, uint64_t time_ms);
+    
+    /**
+     * Archive an assembled message, indexed by its FROM and TO addresses
+     */
+    bool append_message(const ALEMessage& message, uint32_t frequency_hz, uint64_t time_ms);
+    
+    /**
+     * Seal pending records into a segment file
+     * \return true if nothing was pending or the segment was written
+     */
+    bool flush();
+    
+    /**
+     * Find records, in time order
+     * \param query Filter
+     * \param results [out] Matching records
+     * \return Number of results
+     */
+    size_t query(const ArchiveQuery& query, std::vector<ArchiveRecord>& results) const;
+    
+    /**
+     * Number of records matching a query (no records are built)
+     */
+    size_t count(const ArchiveQuery& query) const;
+    
+    size_t segment_count() const { return segments.size(); }
+    size_t pending_records() const { return pending.rows.size(); }
+    uint64_t record_count() const;
+    
+private:
+    // Address reference: dictionary id, FROM role in the top bit
+    static constexpr uint16_t ROLE_FROM = 0x8000;
+    static constexpr uint16_t MAX_ADDRESSES = 0x7FFF;
+    
+    struct PendingRow {
+        uint64_t time_ms;
+        uint32_t frequency_hz;
+        uint8_t kind;                       ///< Message flag | word or call type
+        uint8_t info;                       ///< Word: errors | valid; message: word count
+        uint32_t payload;                   ///< Word: raw payload; message: duration
+        std::vector<uint16_t> addresses;    ///< References into pending dictionary
+    };
+    
+    struct PendingSegment {
+        std::vector<PendingRow> rows;
+        std::vector<std::string> addresses;
+        std::unordered_map<std::string, uint16_t> address_ids;
+        std::set<uint32_t> frequencies;
+        uint64_t min_time_ms;
+        uint64_t max_time_ms;
+    };
+    
+    // Sealed segment: bounds and dictionaries in memory, columns mapped
+    struct Segment {
+        std::unique_ptr<MappedFile> file;
+        uint64_t base_time_ms;
+        uint64_t max_time_ms;
+        uint32_t min_frequency_hz;
+        uint32_t max_frequency_hz;
+        uint32_t rows;
+        std::vector<uint32_t> frequencies;
+        std::unordered_map<std::string, uint16_t> address_ids;
+        std::vector<std::string> addresses;
+        const uint8_t* time_column;         ///< u32 offset from base_time_ms
+        const uint8_t* frequency_column;    ///< u16 frequency id
+        const uint8_t* kind_column;         ///< u8
+        const uint8_t* info_column;         ///< u8
+        const uint8_t* payload_column;      ///< u32
+        const uint8_t* reference_offsets;   ///< u32 per row, plus end
+        const uint8_t* references;          ///< u16 address references
+        const uint8_t* posting_offsets;     ///< u32 per address, plus end
+        const uint8_t* postings;            ///< u32 row << 1 | FROM role
+        
+        Segment();
+        ~Segment();
+    };
+    
+    std::string directory;
+    uint32_t segment_records;
+    uint32_t next_segment;
+    std::map<uint32_t, Segment> segments;
+    PendingSegment pending;
+    
+    std::string segment_path(uint32_t number) const;
+    bool load_segment(uint32_t number);
+    bool append_row(PendingRow& row, const std::vector<std::string>& from,
+                    const std::vector<std::string>& to);
+    uint16_t pending_address(const std::string& address);
+    
+    // visit(time_ms, segment or nullptr for pending, row) per match
+    template <typename Visit>
+    void scan(const ArchiveQuery& query, Visit& visit) const;
+    template <typename Visit>
+    void scan_segment(const Segment& segment, const ArchiveQuery& query, Visit& visit) const;
+    template <typename Visit>
+    void scan_pending(const ArchiveQuery& query, Visit& visit) const;
+    
+    ArchiveRecord segment_record(const Segment& segment, uint32_t row) const;
+    ArchiveRecord pending_record(const PendingRow& row) const;
+};
+
+} // namespace ale
@@ -0,0 +1,157 @@
+/**
+ * @file channel_stats.cpp
+ * @brief Implementation of per-channel occupancy and noise statistics
+ */
+
+#include "ale/channel_stats.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace ale {
+
+ChannelStats::ChannelStats()
+    : cached_frequency_(0), cached_channel_(nullptr) {
+}
+
+void ChannelStats::set_config(const ChannelStatsConfig& config) {
+    config_ = config;
+    config_.bucket_ms = std::max<uint32_t>(config_.bucket_ms, 1);
+    config_.bucket_count = std::max<uint32_t>(config_.bucket_count, 1);
+    config_.noise_bin_db = std::max(config_.noise_bin_db, 0.01f);
+    clear();
+}
+
+void ChannelStats::add_measurement(uint32_t frequency_hz, const BandEnergy& energy,
+                                   uint32_t now_ms) {
+    if (!cached_channel_ || cached_frequency_ != frequency_hz) {
+        auto result = channels_.emplace(frequency_hz, Channel());
+        Channel& created = result.first->second;
+        if (result.second) {
+            created.buckets.resize(config_.bucket_count);
+            for (auto& bucket : created.buckets) {
+                std::memset(&bucket, 0, sizeof(bucket));
+                bucket.epoch = UINT32_MAX;
+                bucket.peak_level_db = -std::numeric_limits<float>::infinity();
+            }
+            created.busy = false;
+            created.last_measurement_ms = 0;
+        }
+        cached_frequency_ = frequency_hz;
+        cached_channel_ = &created;
+    }
+    Channel& channel = *cached_channel_;
+    
+    uint32_t epoch = now_ms / config_.bucket_ms;
+    Bucket& bucket = channel.buckets[epoch % config_.bucket_count];
+    if (bucket.epoch != epoch) {
+        // Reuse the slot of bucket_count buckets ago
+        std::memset(&bucket, 0, sizeof(bucket));
+        bucket.epoch = epoch;
+        bucket.peak_level_db = -std::numeric_limits<float>::infinity();
+    }
+    
+    float level_db = energy.level_db();
+    bool busy = energy.is_active(level_db, config_.threshold_db, config_.min_magnitude);
+    
+    bucket.frames++;
+    if (busy) {
+        bucket.busy_frames++;
+        if (energy.peak_to_mean() >= config_.tonal_ratio) {
+            bucket.tonal_frames++;
+        }
+        if (!channel.busy) {
+            bucket.events++;
+        }
+    }
+    bucket.peak_level_db = std::max(bucket.peak_level_db, level_db);
+    channel.busy = busy;
+    channel.last_measurement_ms = now_ms;
+    
+    float noise_db = 20.0f * std::log10(std::max(energy.noise_floor, 0.001f));
+    int bin = static_cast<int>((noise_db - config_.noise_min_db) / config_.noise_bin_db);
+    bin = std::min(std::max(bin, 0), CHANNEL_STATS_NOISE_BINS - 1);
+    bucket.noise[bin]++;
+}
+
+ChannelStatsSummary ChannelStats::get_summary(uint32_t frequency_hz, uint32_t window_ms,
+                                              uint32_t now_ms) const {
+    ChannelStatsSummary summary;
+    summary.frequency_hz = frequency_hz;
+    
+    auto it = channels_.find(frequency_hz);
+    if (it == channels_.end()) {
+        return summary;
+    }
+    const Channel& channel = it->second;
+    summary.last_measurement_ms = channel.last_measurement_ms;
+    
+    uint32_t now_epoch = now_ms / config_.bucket_ms;
+    uint32_t span = window_ms / config_.bucket_ms + (window_ms % config_.bucket_ms != 0 ? 1 : 0);
+    span = std::min(std::max<uint32_t>(span, 1), config_.bucket_count);
+    
+    uint32_t busy_frames = 0;
+    uint32_t tonal_frames = 0;
+    uint32_t noise[CHANNEL_STATS_NOISE_BINS] = {};
+    float peak_level_db = -std::numeric_limits<float>::infinity();
+    for (const auto& bucket : channel.buckets) {
+        // Buckets of the last span epochs, up to and including now
+        if (bucket.epoch == UINT32_MAX || now_epoch - bucket.epoch >= span) {
+            continue;
+        }
+        summary.frames += bucket.frames;
+        busy_frames += bucket.busy_frames;
+        tonal_frames += bucket.tonal_frames;
+        summary.events += bucket.events;
+        peak_level_db = std::max(peak_level_db, bucket.peak_level_db);
+        for (int bin = 0; bin < CHANNEL_STATS_NOISE_BINS; bin++) {
+            noise[bin] += bucket.noise[bin];
+        }
+    }
+    if (summary.frames == 0) {
+        return summary;
+    }
+    
+    summary.peak_level_db = peak_level_db;
+    summary.busy_fraction = static_cast<float>(busy_frames) / summary.frames;
+    summary.tonal_fraction = busy_frames > 0 ? static_cast<float>(tonal_frames) / busy_frames
+                                             : 0.0f;
+    summary.noise_p10_db = noise_percentile(noise, summary.frames, 0.1f);
+    summary.noise_p50_db = noise_percentile(noise, summary.frames, 0.5f);
+    summary.noise_p90_db = noise_percentile(noise, summary.frames, 0.9f);
+    return summary;
+}
+
+std::vector<ChannelStatsSummary> ChannelStats::get_all_summaries(uint32_t window_ms,
+                                                                 uint32_t now_ms) const {
+    std::vector<ChannelStatsSummary> summaries;
+    summaries.reserve(channels_.size());
+    for (const auto& pair : channels_) {
+        summaries.push_back(get_summary(pair.first, window_ms, now_ms));
+    }
+    return summaries;
+}
+
+void ChannelStats::clear() {
+    channels_.clear();
+    cached_frequency_ = 0;
+    cached_channel_ = nullptr;
+}
+
+float ChannelStats::noise_percentile(const uint32_t* histogram, uint32_t total,
+                                     float fraction) const {
+    uint32_t target = static_cast<uint32_t>(std::ceil(total * fraction));
+    target = std::max<uint32_t>(target, 1);
+    uint32_t count = 0;
+    int bin = 0;
+    for (; bin < CHANNEL_STATS_NOISE_BINS - 1; bin++) {
+        count += histogram[bin];
+        if (count >= target) {
+            break;
+        }
+    }
+    return config_.noise_min_db + (bin + 0.5f) * config_.noise_bin_db;
+}
+
+} // namespace ale
@@ -0,0 +1,248 @@
+/**
+ * \file sample_clock.cpp
+ * \brief Implementation of the shared sample clock
+ */
+
+#include "sample_clock.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace ale {
+
+SampleClock::SampleClock(double sample_rate)
+    : position(0), sample_rate_hz(sample_rate),
+      anchor_sample(0), anchor_monotonic_ns(0), anchor_wall_ms(0) {}
+
+void SampleClock::anchor(SampleTime sample, int64_t monotonic_ns, int64_t wall_ms) {
+    anchor_sample = sample;
+    anchor_monotonic_ns = monotonic_ns;
+    anchor_wall_ms = wall_ms;
+}
+
+void SampleClock::anchor_now(SampleTime sample) {
+    anchor(sample, monotonic_now_ns(), wall_now_ms());
+}
+
+void SampleClock::set_sample_rate(double hz) {
+    if (hz <= 0.0) {
+        return;
+    }
+    
+    SampleTime sample = now();
+    int64_t monotonic_ns = to_monotonic_ns(sample);
+    int64_t wall_ms = to_wall_ms(sample);
+    sample_rate_hz = hz;
+    anchor(sample, monotonic_ns, wall_ms);
+}
+
+void SampleClock::retune(SampleTime sample, int64_t monotonic_ns, double hz) {
+    if (hz <= 0.0) {
+        return;
+    }
+    
+    int64_t wall_ms = anchor_wall_ms + (monotonic_ns - anchor_monotonic_ns) / 1000000;
+    sample_rate_hz = hz;
+    anchor(sample, monotonic_ns, wall_ms);
+}
+
+int64_t SampleClock::to_monotonic_ns(SampleTime sample) const {
+    // Signed offset from the anchor; long double keeps sub-ns precision
+    // for offsets of years
+    long double offset = (sample >= anchor_sample)
+        ? static_cast<long double>(sample - anchor_sample)
+        : -static_cast<long double>(anchor_sample - sample);
+    return anchor_monotonic_ns + std::llround(offset * 1e9L / sample_rate_hz);
+}
+
+int64_t SampleClock::to_wall_ms(SampleTime sample) const {
+    int64_t elapsed_ns = to_monotonic_ns(sample) - anchor_monotonic_ns;
+    return anchor_wall_ms + elapsed_ns / 1000000;
+}
+
+uint32_t SampleClock::to_timer_ms(SampleTime sample) const {
+    return static_cast<uint32_t>(to_monotonic_ns(sample) / 1000000);
+}
+
+SampleTime SampleClock::from_monotonic_ns(int64_t monotonic_ns) const {
+    long double offset = static_cast<long double>(monotonic_ns - anchor_monotonic_ns) *
+                         sample_rate_hz / 1e9L;
+    long double sample = static_cast<long double>(anchor_sample) + offset;
+    if (sample <= 0.0L) {
+        return 0;
+    }
+    return static_cast<SampleTime>(std::llround(sample));
+}
+
+SampleTime SampleClock::from_wall_ms(int64_t wall_ms) const {
+    return from_monotonic_ns(anchor_monotonic_ns + (wall_ms - anchor_wall_ms) * 1000000);
+}
+
+int64_t SampleClock::monotonic_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t SampleClock::wall_now_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// ============================================================================
+// ClockDriftEstimator Implementation
+// ============================================================================
+
+ClockDriftEstimator::ClockDriftEstimator(double nominal_rate)
+    : nominal_rate_hz(nominal_rate), nominal_ns_per_sample(1e9 / nominal_rate),
+      current{0, 0}, current_index(0), current_valid(false), fitted(false),
+      origin{0, 0}, slope_ns_per_sample(0.0), intercept_ns(0.0), residual_ns(0.0),
+      restarts(0) {}
+
+void ClockDriftEstimator::configure(const DriftConfig& new_config) {
+    config = new_config;
+    config.bucket_samples = std::max<uint32_t>(config.bucket_samples, 1);
+    config.window_buckets = std::max<uint32_t>(config.window_buckets, 2);
+    config.lock_buckets = std::min(std::max<uint32_t>(config.lock_buckets, 2),
+                                   config.window_buckets);
+    reset();
+}
+
+void ClockDriftEstimator::reset() {
+    buckets.clear();
+    current_valid = false;
+    fitted = false;
+    slope_ns_per_sample = 0.0;
+    intercept_ns = 0.0;
+    residual_ns = 0.0;
+}
+
+void ClockDriftEstimator::observe(SampleTime sample, int64_t monotonic_ns) {
+    SampleTime index = sample / config.bucket_samples;
+    Bucket point = {sample, monotonic_ns};
+    
+    if (current_valid && index < current_index) {
+        // Capture clock went backwards (device restarted)
+        reset();
+        restarts++;
+    } else if (current_valid && index != current_index) {
+        close_bucket();
+    }
+    
+    if (!current_valid) {
+        current = point;
+        current_index = index;
+        current_valid = true;
+        return;
+    }
+    
+    // Keep the least delayed observation: lowest offset from the nominal line
+    double delta_ns = static_cast<double>(point.monotonic_ns - current.monotonic_ns) -
+                      static_cast<double>(point.sample - current.sample) * nominal_ns_per_sample;
+    if (delta_ns < 0.0) {
+        current = point;
+    }
+}
+
+double ClockDriftEstimator::nominal_offset_ns(const Bucket& point) const {
+    double dx = (point.sample >= origin.sample)
+        ? static_cast<double>(point.sample - origin.sample)
+        : -static_cast<double>(origin.sample - point.sample);
+    return static_cast<double>(point.monotonic_ns - origin.monotonic_ns) -
+           dx * nominal_ns_per_sample;
+}
+
+void ClockDriftEstimator::close_bucket() {
+    current_valid = false;
+    
+    if (fitted) {
+        double predicted = static_cast<double>(predict_monotonic_ns(current.sample));
+        if (std::fabs(static_cast<double>(current.monotonic_ns) - predicted) >
+            static_cast<double>(config.max_step_ns)) {
+            // Samples dropped or the host clock jumped: old history no
+            // longer describes this mapping
+            reset();
+            restarts++;
+        }
+    }
+    
+    buckets.push_back(current);
+    if (buckets.size() > config.window_buckets) {
+        buckets.erase(buckets.begin());
+    }
+    fit();
+}
+
+void ClockDriftEstimator::fit() {
+    if (buckets.size() < 2) {
+        fitted = false;
+        return;
+    }
+    
+    origin = buckets.front();
+    
+    // Centered least squares of nominal offset against sample offset
+    double mean_x = 0.0;
+    double mean_y = 0.0;
+    for (const auto& bucket : buckets) {
+        mean_x += static_cast<double>(bucket.sample - origin.sample);
+        mean_y += nominal_offset_ns(bucket);
+    }
+    mean_x /= buckets.size();
+    mean_y /= buckets.size();
+    
+    double sxx = 0.0;
+    double sxy = 0.0;
+    for (const auto& bucket : buckets) {
+        double dx = static_cast<double>(bucket.sample - origin.sample) - mean_x;
+        double dy = nominal_offset_ns(bucket) - mean_y;
+        sxx += dx * dx;
+        sxy += dx * dy;
+    }
+    if (sxx <= 0.0) {
+        fitted = false;
+        return;
+    }
+    
+    slope_ns_per_sample = sxy / sxx;
+    intercept_ns = mean_y - slope_ns_per_sample * mean_x;
+    
+    double sum_squares = 0.0;
+    for (const auto& bucket : buckets) {
+        double x = static_cast<double>(bucket.sample - origin.sample);
+        double error = nominal_offset_ns(bucket) - (slope_ns_per_sample * x + intercept_ns);
+        sum_squares += error * error;
+    }
+    residual_ns = std::sqrt(sum_squares / buckets.size());
+    fitted = true;
+}
+
+double ClockDriftEstimator::get_sample_rate() const {
+    if (!is_locked()) {
+        return nominal_rate_hz;
+    }
+    return 1e9 / (nominal_ns_per_sample + slope_ns_per_sample);
+}
+
+double ClockDriftEstimator::get_ppm() const {
+    return (get_sample_rate() / nominal_rate_hz - 1.0) * 1e6;
+}
+
+int64_t ClockDriftEstimator::predict_monotonic_ns(SampleTime sample) const {
+    double dx = (sample >= origin.sample)
+        ? static_cast<double>(sample - origin.sample)
+        : -static_cast<double>(origin.sample - sample);
+    double offset = dx * (nominal_ns_per_sample + slope_ns_per_sample) + intercept_ns;
+    return origin.monotonic_ns + std::llround(offset);
+}
+
+bool ClockDriftEstimator::compensate(SampleClock& clock) const {
+    if (!is_locked()) {
+        return false;
+    }
+    
+    SampleTime sample = buckets.back().sample;
+    clock.retune(sample, predict_monotonic_ns(sample), get_sample_rate());
+    return true;
+}
+
+} // namespace ale
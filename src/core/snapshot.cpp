@@ -0,0 +1,428 @@
+/**
+ * \file snapshot.cpp
+ * \brief Implementation of binary state snapshots
+ */
+
+#include "snapshot.h"
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ale {
+
+// ============================================================================
+// CRC-32
+// ============================================================================
+
+static constexpr std::array<uint32_t, 256> make_crc32_table() {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+        }
+        table[i] = crc;
+    }
+    return table;
+}
+
+static constexpr std::array<uint32_t, 256> CRC32_TABLE = make_crc32_table();
+
+static_assert(CRC32_TABLE[1] == 0x77073096u, "CRC-32 table mismatch");
+
+uint32_t snapshot_crc32(const uint8_t* data, size_t length) {
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < length; i++) {
+        crc = CRC32_TABLE[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+// ============================================================================
+// SnapshotWriter
+// ============================================================================
+
+void SnapshotWriter::put_u8(uint8_t value) {
+    buffer.push_back(value);
+}
+
+void SnapshotWriter::put_u16(uint16_t value) {
+    buffer.push_back(static_cast<uint8_t>(value));
+    buffer.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+void SnapshotWriter::put_u32(uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        buffer.push_back(static_cast<uint8_t>(value >> shift));
+    }
+}
+
+void SnapshotWriter::put_u64(uint64_t value) {
+    put_u32(static_cast<uint32_t>(value));
+    put_u32(static_cast<uint32_t>(value >> 32));
+}
+
+void SnapshotWriter::put_f32(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    put_u32(bits);
+}
+
+void SnapshotWriter::put_string(const std::string& value) {
+    size_t length = value.size() > 0xFFFF ? 0xFFFF : value.size();
+    put_u16(static_cast<uint16_t>(length));
+    put_bytes(reinterpret_cast<const uint8_t*>(value.data()), length);
+}
+
+void SnapshotWriter::put_bytes(const uint8_t* data, size_t length) {
+    buffer.insert(buffer.end(), data, data + length);
+}
+
+void SnapshotWriter::finish(uint32_t version, std::vector<uint8_t>& output) const {
+    SnapshotWriter header;
+    header.put_u32(SNAPSHOT_MAGIC);
+    header.put_u32(version);
+    header.put_u32(static_cast<uint32_t>(buffer.size()));
+    header.put_u32(snapshot_crc32(buffer.data(), buffer.size()));
+    
+    output.clear();
+    output.reserve(SNAPSHOT_HEADER_BYTES + buffer.size());
+    output.insert(output.end(), header.buffer.begin(), header.buffer.end());
+    output.insert(output.end(), buffer.begin(), buffer.end());
+}
+
+// ============================================================================
+// SnapshotReader
+// ============================================================================
+
+bool SnapshotReader::open(const uint8_t* data, size_t length, uint32_t version,
+                          SnapshotReader& payload) {
+    if (!data || length < SNAPSHOT_HEADER_BYTES) {
+        return false;
+    }
+    
+    SnapshotReader header(data, SNAPSHOT_HEADER_BYTES);
+    if (header.get_u32() != SNAPSHOT_MAGIC || header.get_u32() != version) {
+        return false;
+    }
+    
+    uint32_t payload_length = header.get_u32();
+    uint32_t crc = header.get_u32();
+    if (payload_length != length - SNAPSHOT_HEADER_BYTES) {
+        return false;
+    }
+    
+    const uint8_t* body = data + SNAPSHOT_HEADER_BYTES;
+    if (snapshot_crc32(body, payload_length) != crc) {
+        return false;
+    }
+    
+    payload = SnapshotReader(body, payload_length);
+    return true;
+}
+
+bool SnapshotReader::need(size_t bytes) {
+    if (failed || length - offset < bytes) {
+        failed = true;
+        return false;
+    }
+    return true;
+}
+
+uint8_t SnapshotReader::get_u8() {
+    if (!need(1)) return 0;
+    return data[offset++];
+}
+
+uint16_t SnapshotReader::get_u16() {
+    if (!need(2)) return 0;
+    uint16_t value = static_cast<uint16_t>(data[offset] | (data[offset + 1] << 8));
+    offset += 2;
+    return value;
+}
+
+uint32_t SnapshotReader::get_u32() {
+    if (!need(4)) return 0;
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++) {
+        value |= static_cast<uint32_t>(data[offset + i]) << (8 * i);
+    }
+    offset += 4;
+    return value;
+}
+
+uint64_t SnapshotReader::get_u64() {
+    uint64_t low = get_u32();
+    uint64_t high = get_u32();
+    return low | (high << 32);
+}
+
+float SnapshotReader::get_f32() {
+    uint32_t bits = get_u32();
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+std::string SnapshotReader::get_string() {
+    uint16_t length = get_u16();
+    if (!need(length)) return std::string();
+    std::string value(reinterpret_cast<const char*>(data + offset), length);
+    offset += length;
+    return value;
+}
+
+// ============================================================================
+// MappedFile
+// ============================================================================
+
+MappedFile::MappedFile()
+    : view(nullptr), view_size(0), mapped(false) {
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& path) {
+    close();
+
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+    
+    void* region = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // Mapping stays valid after close
+    
+    if (region != MAP_FAILED) {
+        view = static_cast<const uint8_t*>(region);
+        view_size = static_cast<size_t>(info.st_size);
+        mapped = true;
+        return true;
+    }
+#endif
+    
+    // No mmap: read whole file into memory
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        return false;
+    }
+    
+    std::streamoff size = file.tellg();
+    if (size <= 0) {
+        return false;
+    }
+    
+    fallback.resize(static_cast<size_t>(size));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(fallback.data()), size);
+    if (!file) {
+        fallback.clear();
+        return false;
+    }
+    
+    view = fallback.data();
+    view_size = fallback.size();
+    return true;
+}
+
+void MappedFile::close() {
+#ifndef _WIN32
+    if (mapped && view) {
+        munmap(const_cast<uint8_t*>(view), view_size);
+    }
+#endif
+    view = nullptr;
+    view_size = 0;
+    mapped = false;
+    fallback.clear();
+}
+
+// ============================================================================
+// Atomic file write
+// ============================================================================
+
+bool write_file_atomic(const std::string& path, const uint8_t* data, size_t length) {
+    std::string temp_path = path + ".tmp";
+
+#ifndef _WIN32
+    int fd = ::open(temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    
+    size_t written = 0;
+    while (written < length) {
+        ssize_t n = ::write(fd, data + written, length - written);
+        if (n <= 0) {
+            ::close(fd);
+            ::unlink(temp_path.c_str());
+            return false;
+        }
+        written += static_cast<size_t>(n);
+    }
+    
+    // Contents must be durable before the rename makes them visible
+    if (fsync(fd) != 0) {
+        ::close(fd);
+        ::unlink(temp_path.c_str());
+        return false;
+    }
+    ::close(fd);
+#else
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(length));
+        if (!file) {
+            std::remove(temp_path.c_str());
+            return false;
+        }
+    }
+    std::remove(path.c_str());  // rename() does not replace on Windows
+#endif
+    
+    if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+        std::remove(temp_path.c_str());
+        return false;
+    }
+    
+#ifndef _WIN32
+    // The rename is only durable once the directory entry is on disk
+    size_t slash = path.find_last_of('/');
+    std::string directory = (slash == std::string::npos) ? "." :
+                            (slash == 0) ? "/" : path.substr(0, slash);
+    int dir_fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+    if (dir_fd < 0) {
+        return false;
+    }
+    bool synced = (fsync(dir_fd) == 0);
+    ::close(dir_fd);
+    return synced;
+#else
+    return true;
+#endif
+}
+
+// ============================================================================
+// SnapshotPersister
+// ============================================================================
+
+SnapshotPersister::SnapshotPersister()
+    : has_pending(false), writing(false), running(false), stopping(false),
+      write_count(0), error_count(0) {
+}
+
+SnapshotPersister::~SnapshotPersister() {
+    stop();
+}
+
+void SnapshotPersister::start(const std::string& snapshot_path) {
+    stop();
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    path = snapshot_path;
+    stopping = false;
+    running = true;
+    worker = std::thread(&SnapshotPersister::run, this);
+}
+
+void SnapshotPersister::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running) {
+            return;
+        }
+        stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+    idle.notify_all();
+}
+
+bool SnapshotPersister::is_running() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return running;
+}
+
+void SnapshotPersister::submit(std::vector<uint8_t>&& snapshot) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending = std::move(snapshot);
+        has_pending = true;
+    }
+    wake.notify_one();
+}
+
+void SnapshotPersister::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this] { return !running || (!has_pending && !writing); });
+}
+
+uint32_t SnapshotPersister::get_write_count() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return write_count;
+}
+
+uint32_t SnapshotPersister::get_error_count() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return error_count;
+}
+
+void SnapshotPersister::run() {
+    std::vector<uint8_t> snapshot;
+    std::unique_lock<std::mutex> lock(mutex);
+    
+    while (true) {
+        wake.wait(lock, [this] { return has_pending || stopping; });
+        
+        if (has_pending) {
+            snapshot.swap(pending);
+            has_pending = false;
+            writing = true;
+            
+            lock.unlock();
+            bool ok = write_file_atomic(path, snapshot.data(), snapshot.size());
+            lock.lock();
+            
+            writing = false;
+            if (ok) {
+                write_count++;
+            } else {
+                error_count++;
+            }
+        }
+        
+        if (!has_pending) {
+            idle.notify_all();
+            if (stopping) {
+                break;
+            }
+        }
+    }
+}
+
+} // namespace ale
@@ -0,0 +1,101 @@
+/**
+ * \file airtime.cpp
+ * \brief FS-1052 airtime model implementation
+ */
+
+#include "fs1052_airtime.h"
+
+namespace fs1052 {
+
+// MIL-STD-188-110A serial tone: preamble and interleaver block lengths
+static const uint32_t SHORT_INTERLEAVER_MS = 600;
+static const uint32_t LONG_INTERLEAVER_MS = 4800;
+static const uint32_t SHORT_PREAMBLE_MS = 600;     // 3 x 200 ms frames
+static const uint32_t LONG_PREAMBLE_MS = 4800;     // 24 x 200 ms frames
+
+AirtimeModel::AirtimeModel()
+    : m_rate(DataRate::BPS_2400)
+    , m_interleaver(InterleaverLength::SHORT)
+    , m_turnaround_ms(AIRTIME_DEFAULT_TURNAROUND_MS)
+    , m_preamble_ms(0)
+    , m_block_ms(0)
+    , m_bits_per_block(0)
+{
+    set_mode(m_rate, m_interleaver);
+}
+
+void AirtimeModel::set_mode(DataRate rate, InterleaverLength interleaver)
+{
+    m_rate = rate;
+    m_interleaver = interleaver;
+    
+    bool is_long = interleaver == InterleaverLength::LONG;
+    m_preamble_ms = is_long ? LONG_PREAMBLE_MS : SHORT_PREAMBLE_MS;
+    m_block_ms = is_long ? LONG_INTERLEAVER_MS : SHORT_INTERLEAVER_MS;
+    m_bits_per_block = static_cast<uint32_t>(data_rate_to_bps(rate)) * m_block_ms / 1000;
+}
+
+uint32_t AirtimeModel::blocks_ms(uint64_t bits) const
+{
+    if (m_bits_per_block == 0) {
+        return 0;
+    }
+    uint64_t blocks = (bits + m_bits_per_block - 1) / m_bits_per_block;
+    return static_cast<uint32_t>(blocks * m_block_ms);
+}
+
+uint32_t AirtimeModel::data_end_ms(uint32_t bytes) const
+{
+    return m_preamble_ms + blocks_ms(static_cast<uint64_t>(bytes) * 8);
+}
+
+uint32_t AirtimeModel::transmission_ms(uint32_t bytes) const
+{
+    return m_preamble_ms + blocks_ms(static_cast<uint64_t>(bytes) * 8 + AIRTIME_EOM_BITS);
+}
+
+uint32_t AirtimeModel::data_frame_ms(uint16_t data_length) const
+{
+    return transmission_ms(static_cast<uint32_t>(FrameFormatter::data_frame_length(data_length)));
+}
+
+uint32_t AirtimeModel::control_frame_ms(const ControlFrame& frame) const
+{
+    return transmission_ms(static_cast<uint32_t>(FrameFormatter::control_frame_length(frame)));
+}
+
+uint32_t AirtimeModel::series_ms(uint32_t frames, uint16_t data_length) const
+{
+    return transmission_ms(frames * static_cast<uint32_t>(FrameFormatter::data_frame_length(data_length)));
+}
+
+uint32_t AirtimeModel::cycle_ms(uint32_t series_bytes, uint32_t reply_bytes) const
+{
+    return 2 * m_turnaround_ms + transmission_ms(series_bytes) + transmission_ms(reply_bytes);
+}
+
+uint32_t AirtimeModel::max_frames(uint32_t window_ms, uint16_t data_length) const
+{
+    if (window_ms < m_preamble_ms || m_block_ms == 0) {
+        return 0;
+    }
+    
+    uint64_t bits = static_cast<uint64_t>((window_ms - m_preamble_ms) / m_block_ms) * m_bits_per_block;
+    if (bits < AIRTIME_EOM_BITS) {
+        return 0;
+    }
+    uint64_t frame_bits = FrameFormatter::data_frame_length(data_length) * 8;
+    return static_cast<uint32_t>((bits - AIRTIME_EOM_BITS) / frame_bits);
+}
+
+uint32_t AirtimeModel::expected_goodput_bps(uint32_t payload_bytes, uint32_t series_bytes,
+                                            uint32_t reply_bytes) const
+{
+    uint32_t cycle = cycle_ms(series_bytes, reply_bytes);
+    if (cycle == 0 || m_bits_per_block == 0) {
+        return 0;
+    }
+    return static_cast<uint32_t>(static_cast<uint64_t>(payload_bytes) * 8000 / cycle);
+}
+
+} // namespace fs1052
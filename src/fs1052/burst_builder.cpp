@@ -0,0 +1,167 @@
+/**
+ * \file burst_builder.cpp
+ * \brief FS-1052 series builder implementation
+ */
+
+#include "fs1052_burst.h"
+#include <algorithm>
+
+namespace fs1052 {
+
+// Room kept in front of the first frame for prepend_control_frame()
+static const size_t HEAD_ROOM = 128;
+static_assert(HEAD_ROOM >= MAX_CONTROL_FRAME_LENGTH, "head room must fit any control frame");
+
+BurstBuilder::BurstBuilder(size_t capacity, bool gather)
+    : m_start(HEAD_ROOM)
+    , m_used(HEAD_ROOM)
+    , m_size(0)
+    , m_frames(0)
+    , m_gather(gather)
+    , m_prepended(false)
+{
+    reserve(capacity);
+}
+
+void BurstBuilder::reserve(size_t bytes)
+{
+    if (HEAD_ROOM + bytes > m_buffer.size()) {
+        m_buffer.resize(HEAD_ROOM + bytes);
+    }
+}
+
+void BurstBuilder::clear()
+{
+    m_pieces.clear();
+    m_segments.clear();
+    m_start = HEAD_ROOM;
+    m_used = HEAD_ROOM;
+    m_size = 0;
+    m_frames = 0;
+    m_prepended = false;
+}
+
+uint8_t* BurstBuilder::append_space(size_t length)
+{
+    if (m_used + length > m_buffer.size()) {
+        m_buffer.resize(std::max(m_used + length, 2 * m_buffer.size()));
+    }
+    
+    size_t offset = m_used;
+    m_used += length;
+    
+    // Extend the previous piece when it ends here
+    if (!m_pieces.empty() && !m_pieces.back().external &&
+        m_pieces.back().offset + m_pieces.back().length == offset) {
+        m_pieces.back().length += length;
+    } else {
+        m_pieces.push_back({nullptr, offset, length});
+    }
+    return &m_buffer[offset];
+}
+
+bool BurstBuilder::add_control_frame(const ControlFrame& frame)
+{
+    uint8_t formatted[256];
+    int length = FrameFormatter::format_control_frame(frame, formatted, sizeof(formatted));
+    if (length <= 0) {
+        return false;
+    }
+    
+    memcpy(append_space(length), formatted, length);
+    m_size += length;
+    m_frames++;
+    return true;
+}
+
+bool BurstBuilder::add_data_frame(const DataFrame& frame)
+{
+    return copy_data_frame(frame, frame.data);
+}
+
+bool BurstBuilder::copy_data_frame(const DataFrame& header, const uint8_t* payload)
+{
+    if (header.data_length > MAX_DATA_BLOCK_LENGTH) {
+        return false;
+    }
+    
+    size_t length = FrameFormatter::data_frame_length(header.data_length);
+    uint8_t* p = append_space(length);
+    size_t index = FrameFormatter::format_data_header(header, p);
+    memcpy(p + index, payload, header.data_length);
+    FrameFormatter::append_crc32(p, index + header.data_length);
+    
+    m_size += length;
+    m_frames++;
+    return true;
+}
+
+bool BurstBuilder::add_data_frame(const DataFrame& header, const uint8_t* payload)
+{
+    if (!m_gather) {
+        return copy_data_frame(header, payload);
+    }
+    if (header.data_length > MAX_DATA_BLOCK_LENGTH) {
+        return false;
+    }
+    
+    // Header and CRC in the buffer, payload referenced in place
+    uint8_t* p = append_space(DATA_FRAME_HEADER_LENGTH);
+    FrameFormatter::format_data_header(header, p);
+    uint32_t crc = FrameFormatter::calculate_crc32(p, DATA_FRAME_HEADER_LENGTH);
+    crc = FrameFormatter::calculate_crc32(payload, header.data_length, crc);
+    
+    if (header.data_length > 0) {
+        m_pieces.push_back({payload, 0, header.data_length});
+    }
+    
+    p = append_space(FRAME_CRC_LENGTH);
+    p[0] = (crc >> 24) & 0xFF;
+    p[1] = (crc >> 16) & 0xFF;
+    p[2] = (crc >> 8) & 0xFF;
+    p[3] = crc & 0xFF;
+    
+    m_size += FrameFormatter::data_frame_length(header.data_length);
+    m_frames++;
+    return true;
+}
+
+bool BurstBuilder::prepend_control_frame(const ControlFrame& frame)
+{
+    if (m_prepended) {
+        return false;
+    }
+    
+    uint8_t formatted[256];
+    int length = FrameFormatter::format_control_frame(frame, formatted, sizeof(formatted));
+    if (length <= 0 || static_cast<size_t>(length) > m_start) {
+        return false;
+    }
+    
+    m_start -= length;
+    memcpy(&m_buffer[m_start], formatted, length);
+    if (!m_pieces.empty() && !m_pieces.front().external &&
+        m_pieces.front().offset == m_start + length) {
+        m_pieces.front().offset = m_start;
+        m_pieces.front().length += length;
+    } else {
+        m_pieces.insert(m_pieces.begin(), {nullptr, m_start, static_cast<size_t>(length)});
+    }
+    
+    m_size += length;
+    m_frames++;
+    m_prepended = true;
+    return true;
+}
+
+const std::vector<FrameSegment>& BurstBuilder::segments()
+{
+    m_segments.clear();
+    for (const auto& piece : m_pieces) {
+        const uint8_t* data = piece.external ? piece.external : m_buffer.data() + piece.offset;
+        m_segments.push_back({data, piece.length});
+    }
+    return m_segments;
+}
+
+} // namespace fs1052
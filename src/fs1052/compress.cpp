@@ -0,0 +1,346 @@
+/**
+ * \file compress.cpp
+ * \brief FS-1052 payload compression implementation
+ */
+
+#include "fs1052_compress.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace fs1052 {
+
+// Static dictionary: common English words, message/log vocabulary and
+// formatting. Later entries are closer to the data and matched first.
+static const char DICTIONARY[] =
+    "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ abcdefghijklmnopqrstuvwxyz\r\n"
+    "January February March April May June July August September October "
+    "November December Monday Tuesday Wednesday Thursday Friday Saturday Sunday "
+    "UTC GMT Z 00:00:00 2024-01-01T 2025- 2026- "
+    "http://https://www..com .org .net .mil .gov /api/v1/ .txt .log .json .xml "
+    "{\"id\": \"type\": \"name\": \"time\": \"status\": \"value\": \"data\": "
+    "true, false, null, [], {}, "
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?> </message> <message> "
+    "kernel: daemon: systemd[1]: sshd[ cron[ started stopped restarting "
+    "connection established connection closed connection refused timed out "
+    "failed to open file not found permission denied no such file or directory "
+    "DEBUG: INFO: NOTICE: WARNING: WARN: ERROR: CRITICAL: FATAL: "
+    "[DEBUG] [INFO] [WARN] [ERROR] "
+    "frequency channel station net call sounding link quality LQA SNR BER "
+    "kHz MHz dB bps baud USB LSB ALE HF radio operator message received "
+    "transmit receive acknowledge retransmit timeout position report "
+    "latitude longitude altitude heading speed course grid "
+    "ROGER WILCO OVER OUT SAY AGAIN BREAK FLASH IMMEDIATE PRIORITY ROUTINE "
+    "UNCLASSIFIED FOR OFFICIAL USE ONLY SUBJECT: FROM: TO: INFO: DTG "
+    "Subject: From: To: Date: Re: Fwd: Dear Regards Thanks Thank you "
+    "please would could should about after again also because before "
+    "being between during each from have into more most other over "
+    "same some such than that their them then there these they this "
+    "those through under until very what when where which while will "
+    "with would your you are was were been has had not but all any "
+    "can her his our out who how its may new now one two see way "
+    "of the to the in the for the on the at the and the is the "
+    " the  and  of  to  in  is  for  that  with  on  as  at  by  it  be  an ";
+
+static const size_t DICTIONARY_SIZE = sizeof(DICTIONARY) - 1;
+
+static const uint32_t MIN_MATCH = 4;
+static const size_t MAX_EXPANSION = 255;  // Output bytes per stream byte (length extension)
+static const uint32_t MAX_OFFSET = 65535;
+static const uint32_t HASH_BITS = 13;
+static const size_t ENTROPY_SAMPLE = 4096;
+
+const uint8_t* PayloadCompressor::dictionary()
+{
+    return reinterpret_cast<const uint8_t*>(DICTIONARY);
+}
+
+size_t PayloadCompressor::dictionary_size()
+{
+    return DICTIONARY_SIZE;
+}
+
+float PayloadCompressor::estimate_entropy(const uint8_t* data, size_t length)
+{
+    if (length == 0) {
+        return 0.0f;
+    }
+    
+    // Evenly spaced sample keeps the estimate cheap on large messages
+    size_t samples = std::min(length, ENTROPY_SAMPLE);
+    size_t stride = length / samples;
+    
+    uint32_t histogram[256] = {0};
+    for (size_t i = 0; i < samples; i++) {
+        histogram[data[i * stride]]++;
+    }
+    
+    float entropy = 0.0f;
+    for (uint32_t count : histogram) {
+        if (count) {
+            float p = static_cast<float>(count) / samples;
+            entropy -= p * std::log2(p);
+        }
+    }
+    return entropy;
+}
+
+bool PayloadCompressor::should_compress(const uint8_t* data, size_t length)
+{
+    if (length < COMPRESS_MIN_LENGTH) {
+        return false;
+    }
+    
+    // A small sample cannot show more than log2(samples) bits of entropy,
+    // so scale the threshold for short messages
+    size_t samples = std::min(length, ENTROPY_SAMPLE);
+    float limit = std::min(COMPRESS_MAX_ENTROPY,
+                           0.9f * std::log2(static_cast<float>(samples)));
+    return estimate_entropy(data, length) < limit;
+}
+
+// ============================================================================
+// Stream helpers
+// ============================================================================
+
+static void put_varint(std::vector<uint8_t>& out, size_t value)
+{
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+static bool get_varint(const uint8_t* in, size_t length, size_t& pos, size_t& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (pos >= length) {
+            return false;
+        }
+        uint8_t byte = in[pos++];
+        value |= static_cast<size_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void put_length(std::vector<uint8_t>& out, size_t extra)
+{
+    while (extra >= 255) {
+        out.push_back(255);
+        extra -= 255;
+    }
+    out.push_back(static_cast<uint8_t>(extra));
+}
+
+static bool get_length(const uint8_t* in, size_t length, size_t& pos, size_t& value)
+{
+    uint8_t byte;
+    do {
+        if (pos >= length) {
+            return false;
+        }
+        byte = in[pos++];
+        value += byte;
+    } while (byte == 255);
+    return true;
+}
+
+static uint32_t hash4(const uint8_t* p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return (v * 2654435761u) >> (32 - HASH_BITS);
+}
+
+static void emit_sequence(std::vector<uint8_t>& out, const uint8_t* literals,
+                          size_t literal_count, size_t offset, size_t match_length)
+{
+    size_t match_code = match_length ? match_length - MIN_MATCH : 0;
+    uint8_t token = static_cast<uint8_t>((std::min<size_t>(literal_count, 15) << 4) |
+                                         std::min<size_t>(match_code, 15));
+    out.push_back(token);
+    
+    if (literal_count >= 15) {
+        put_length(out, literal_count - 15);
+    }
+    out.insert(out.end(), literals, literals + literal_count);
+    
+    if (match_length) {
+        out.push_back(static_cast<uint8_t>(offset));
+        out.push_back(static_cast<uint8_t>(offset >> 8));
+        if (match_code >= 15) {
+            put_length(out, match_code - 15);
+        }
+    }
+}
+
+// ============================================================================
+// Compression
+// ============================================================================
+
+bool PayloadCompressor::compress(const uint8_t* data, size_t length, std::vector<uint8_t>& output)
+{
+    output.clear();
+    if (length == 0) {
+        return false;
+    }
+    
+    // Dictionary and input in one window, so matches may reach into either
+    std::vector<uint8_t> window(DICTIONARY_SIZE + length);
+    memcpy(window.data(), DICTIONARY, DICTIONARY_SIZE);
+    memcpy(window.data() + DICTIONARY_SIZE, data, length);
+    
+    std::vector<int32_t> table(1u << HASH_BITS, -1);
+    const uint8_t* base = window.data();
+    size_t end = window.size();
+    
+    for (size_t i = 0; i + MIN_MATCH <= DICTIONARY_SIZE; i++) {
+        table[hash4(base + i)] = static_cast<int32_t>(i);
+    }
+    
+    std::vector<uint8_t> payload;
+    payload.reserve(length);
+    
+    size_t pos = DICTIONARY_SIZE;
+    size_t anchor = pos;
+    
+    while (pos + MIN_MATCH <= end) {
+        uint32_t h = hash4(base + pos);
+        int32_t candidate = table[h];
+        table[h] = static_cast<int32_t>(pos);
+        
+        if (candidate < 0 || pos - candidate > MAX_OFFSET ||
+            memcmp(base + candidate, base + pos, MIN_MATCH) != 0) {
+            pos++;
+            continue;
+        }
+        
+        size_t match_length = MIN_MATCH;
+        while (pos + match_length < end &&
+               base[candidate + match_length] == base[pos + match_length]) {
+            match_length++;
+        }
+        
+        emit_sequence(payload, base + anchor, pos - anchor, pos - candidate, match_length);
+        
+        // Index positions inside the match so later data can refer to them
+        size_t match_end = pos + match_length;
+        for (size_t i = pos + 1; i + MIN_MATCH <= end && i < match_end; i++) {
+            table[hash4(base + i)] = static_cast<int32_t>(i);
+        }
+        pos = match_end;
+        anchor = pos;
+    }
+    
+    emit_sequence(payload, base + anchor, end - anchor, 0, 0);
+    
+    output.push_back(COMPRESS_METHOD_LZ_DICT);
+    put_varint(output, length);
+    put_varint(output, payload.size());
+    output.insert(output.end(), payload.begin(), payload.end());
+    
+    if (output.size() >= length) {
+        output.clear();
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// Decompression
+// ============================================================================
+
+size_t PayloadCompressor::stream_length(const uint8_t* stream, size_t available)
+{
+    size_t pos = 1;
+    size_t original = 0;
+    size_t payload = 0;
+    if (available < 1 || stream[0] != COMPRESS_METHOD_LZ_DICT ||
+        !get_varint(stream, available, pos, original) ||
+        !get_varint(stream, available, pos, payload)) {
+        return 0;
+    }
+    return pos + payload;
+}
+
+bool PayloadCompressor::decompress(const uint8_t* stream, size_t length, std::vector<uint8_t>& output)
+{
+    output.clear();
+    
+    size_t pos = 1;
+    size_t original = 0;
+    size_t payload = 0;
+    if (length < 1 || stream[0] != COMPRESS_METHOD_LZ_DICT ||
+        !get_varint(stream, length, pos, original) ||
+        !get_varint(stream, length, pos, payload) ||
+        pos + payload != length) {
+        return false;
+    }
+    
+    // The declared length comes from the peer: no stream byte expands to
+    // more than MAX_EXPANSION output bytes, so anything larger is bogus
+    // and must be rejected before it sizes an allocation
+    if (original > payload * MAX_EXPANSION + DICTIONARY_SIZE) {
+        return false;
+    }
+    
+    // Decode into dictionary + output so offsets index one history
+    std::vector<uint8_t> history(DICTIONARY, DICTIONARY + DICTIONARY_SIZE);
+    history.reserve(DICTIONARY_SIZE + original);
+    size_t limit = DICTIONARY_SIZE + original;
+    
+    while (pos < length) {
+        uint8_t token = stream[pos++];
+        
+        size_t literal_count = token >> 4;
+        if (literal_count == 15 && !get_length(stream, length, pos, literal_count)) {
+            return false;
+        }
+        if (literal_count > length - pos || history.size() + literal_count > limit) {
+            return false;
+        }
+        history.insert(history.end(), stream + pos, stream + pos + literal_count);
+        pos += literal_count;
+        
+        if (pos == length) {
+            break;  // Final literal-only sequence
+        }
+        
+        if (length - pos < 2) {
+            return false;
+        }
+        size_t offset = stream[pos] | (stream[pos + 1] << 8);
+        pos += 2;
+        
+        size_t match_length = token & 0x0F;
+        if (match_length == 15 && !get_length(stream, length, pos, match_length)) {
+            return false;
+        }
+        match_length += MIN_MATCH;
+        
+        if (offset == 0 || offset > history.size() ||
+            history.size() + match_length > limit) {
+            return false;
+        }
+        
+        // Byte-wise copy: overlapping matches repeat recent output
+        size_t from = history.size() - offset;
+        for (size_t i = 0; i < match_length; i++) {
+            history.push_back(history[from + i]);
+        }
+    }
+    
+    if (history.size() != limit) {
+        return false;
+    }
+    
+    output.assign(history.begin() + DICTIONARY_SIZE, history.end());
+    return true;
+}
+
+} // namespace fs1052
@@ -0,0 +1,248 @@
+/**
+ * \file erasure.cpp
+ * \brief Reed-Solomon erasure coding implementation
+ */
+
+#include "fs1052_erasure.h"
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define FS1052_GF_SSSE3 1
+#include <immintrin.h>
+#endif
+
+namespace fs1052 {
+
+// ============================================================================
+// GF(2^8) tables
+// ============================================================================
+
+static constexpr uint16_t GF_POLYNOMIAL = 0x11D;
+
+struct GFTables {
+    uint8_t exp[512];   // Doubled so exp[log a + log b] needs no modulo
+    uint8_t log[256];
+    
+    constexpr GFTables() : exp(), log() {
+        uint16_t x = 1;
+        for (int i = 0; i < 255; i++) {
+            exp[i] = static_cast<uint8_t>(x);
+            exp[i + 255] = static_cast<uint8_t>(x);
+            log[x] = static_cast<uint8_t>(i);
+            x <<= 1;
+            if (x & 0x100) {
+                x ^= GF_POLYNOMIAL;
+            }
+        }
+        exp[510] = exp[0];
+        exp[511] = exp[1];
+    }
+};
+
+static constexpr GFTables GF;
+
+uint8_t GF256::mul(uint8_t a, uint8_t b)
+{
+    if (a == 0 || b == 0) {
+        return 0;
+    }
+    return GF.exp[GF.log[a] + GF.log[b]];
+}
+
+uint8_t GF256::inv(uint8_t a)
+{
+    return GF.exp[255 - GF.log[a]];
+}
+
+void GF256::mul_add_region_scalar(uint8_t* dst, const uint8_t* src, uint8_t c, size_t length)
+{
+    if (c == 0) {
+        return;
+    }
+    if (c == 1) {
+        for (size_t i = 0; i < length; i++) {
+            dst[i] ^= src[i];
+        }
+        return;
+    }
+    
+    // One product row per call: cheaper than log/exp per byte
+    uint8_t row[256];
+    for (int x = 0; x < 256; x++) {
+        row[x] = mul(c, static_cast<uint8_t>(x));
+    }
+    for (size_t i = 0; i < length; i++) {
+        dst[i] ^= row[src[i]];
+    }
+}
+
+#ifdef FS1052_GF_SSSE3
+
+// c * x = c * (x & 0x0F) ^ c * (x & 0xF0): two 16-entry lookups per byte
+__attribute__((target("ssse3")))
+static void mul_add_region_ssse3(uint8_t* dst, const uint8_t* src, uint8_t c, size_t length)
+{
+    alignas(16) uint8_t low[16];
+    alignas(16) uint8_t high[16];
+    for (int x = 0; x < 16; x++) {
+        low[x] = GF256::mul(c, static_cast<uint8_t>(x));
+        high[x] = GF256::mul(c, static_cast<uint8_t>(x << 4));
+    }
+    
+    const __m128i low_table = _mm_load_si128(reinterpret_cast<const __m128i*>(low));
+    const __m128i high_table = _mm_load_si128(reinterpret_cast<const __m128i*>(high));
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        __m128i lo = _mm_shuffle_epi8(low_table, _mm_and_si128(s, mask));
+        __m128i hi = _mm_shuffle_epi8(high_table, _mm_and_si128(_mm_srli_epi64(s, 4), mask));
+        d = _mm_xor_si128(d, _mm_xor_si128(lo, hi));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), d);
+    }
+    for (; i < length; i++) {
+        dst[i] ^= low[src[i] & 0x0F] ^ high[src[i] >> 4];
+    }
+}
+
+#endif
+
+bool GF256::simd_available()
+{
+#ifdef FS1052_GF_SSSE3
+    static const bool available = __builtin_cpu_supports("ssse3");
+    return available;
+#else
+    return false;
+#endif
+}
+
+void GF256::mul_add_region(uint8_t* dst, const uint8_t* src, uint8_t c, size_t length)
+{
+#ifdef FS1052_GF_SSSE3
+    if (c > 1 && simd_available()) {
+        mul_add_region_ssse3(dst, src, c, length);
+        return;
+    }
+#endif
+    mul_add_region_scalar(dst, src, c, length);
+}
+
+// ============================================================================
+// Erasure coder
+// ============================================================================
+
+uint8_t ErasureCoder::coefficient(int k, int j, int i)
+{
+    return GF256::inv(static_cast<uint8_t>((k + j) ^ i));
+}
+
+bool ErasureCoder::encode(const uint8_t* const* data, int k,
+                          uint8_t* const* repair, int m, size_t length)
+{
+    if (k < 1 || m < 0 || k + m > ERASURE_MAX_BLOCKS) {
+        return false;
+    }
+    
+    for (int j = 0; j < m; j++) {
+        memset(repair[j], 0, length);
+        for (int i = 0; i < k; i++) {
+            GF256::mul_add_region(repair[j], data[i], coefficient(k, j, i), length);
+        }
+    }
+    return true;
+}
+
+bool ErasureCoder::decode(uint8_t* const* blocks, const bool* present,
+                          int k, int m, size_t length)
+{
+    if (k < 1 || m < 0 || k + m > ERASURE_MAX_BLOCKS) {
+        return false;
+    }
+    
+    std::vector<int> missing;
+    for (int i = 0; i < k; i++) {
+        if (!present[i]) {
+            missing.push_back(i);
+        }
+    }
+    if (missing.empty()) {
+        return true;
+    }
+    
+    // Use the first k received blocks: received data rows plus enough
+    // repair rows to replace the missing ones
+    std::vector<int> rows;
+    for (int i = 0; i < k; i++) {
+        if (present[i]) {
+            rows.push_back(i);
+        }
+    }
+    for (int j = 0; j < m && rows.size() < static_cast<size_t>(k); j++) {
+        if (present[k + j]) {
+            rows.push_back(k + j);
+        }
+    }
+    if (rows.size() < static_cast<size_t>(k)) {
+        return false;
+    }
+    
+    // Generator rows for the received blocks, then invert (Gauss-Jordan)
+    std::vector<uint8_t> a(k * k, 0);
+    std::vector<uint8_t> b(k * k, 0);
+    for (int r = 0; r < k; r++) {
+        int row = rows[r];
+        for (int c = 0; c < k; c++) {
+            a[r * k + c] = (row < k) ? (row == c) : coefficient(k, row - k, c);
+        }
+        b[r * k + r] = 1;
+    }
+    
+    for (int col = 0; col < k; col++) {
+        int pivot = col;
+        while (pivot < k && a[pivot * k + col] == 0) {
+            pivot++;
+        }
+        if (pivot == k) {
+            return false;  // Cannot happen for a Cauchy generator
+        }
+        if (pivot != col) {
+            for (int c = 0; c < k; c++) {
+                std::swap(a[col * k + c], a[pivot * k + c]);
+                std::swap(b[col * k + c], b[pivot * k + c]);
+            }
+        }
+        
+        uint8_t scale = GF256::inv(a[col * k + col]);
+        for (int c = 0; c < k; c++) {
+            a[col * k + c] = GF256::mul(a[col * k + c], scale);
+            b[col * k + c] = GF256::mul(b[col * k + c], scale);
+        }
+        
+        for (int r = 0; r < k; r++) {
+            uint8_t factor = a[r * k + col];
+            if (r == col || factor == 0) {
+                continue;
+            }
+            for (int c = 0; c < k; c++) {
+                a[r * k + c] ^= GF256::mul(factor, a[col * k + c]);
+                b[r * k + c] ^= GF256::mul(factor, b[col * k + c]);
+            }
+        }
+    }
+    
+    // Missing data block i = sum over received rows of inverse[i][r] * block
+    for (int i : missing) {
+        memset(blocks[i], 0, length);
+        for (int r = 0; r < k; r++) {
+            GF256::mul_add_region(blocks[i], blocks[rows[r]], b[i * k + r], length);
+        }
+    }
+    return true;
+}
+
+} // namespace fs1052
@@ -30,7 +30,11 @@ static uint32_t crc32_byte(uint8_t data, uint32_t crc) {
 }
 
 uint32_t FrameFormatter::calculate_crc32(const uint8_t* data, size_t length) {
-    uint32_t crc = 0xFFFFFFFF;  // Initial value
+    return calculate_crc32(data, length, 0);
+}
+
+uint32_t FrameFormatter::calculate_crc32(const uint8_t* data, size_t length, uint32_t previous) {
+    uint32_t crc = ~previous;  // Initial value 0xFFFFFFFF when starting
     
     for (size_t i = 0; i < length; i++) {
         crc = crc32_byte(data[i], crc);
@@ -55,6 +59,33 @@ size_t FrameFormatter::append_crc32(uint8_t* buffer, size_t length) {
 // Control Frame Formatting
 // ============================================================================
 
+// ACK bitmap only for T2/T3/T4 frames with DATA_ACK
+static bool control_bitmap_present(const ControlFrame& frame) {
+    return (frame.frame_type == FrameType::T2_CONTROL ||
+            frame.frame_type == FrameType::T3_CONTROL ||
+            frame.frame_type == FrameType::T4_CONTROL) &&
+           (frame.ack_nak_type == AckNakType::DATA_ACK) &&
+           (frame.address_mode == AddressMode::SHORT_2_BYTE);
+}
+
+size_t FrameFormatter::control_frame_length(const ControlFrame& frame) {
+    // Header, addresses, link management (3), ACK/NAK and field flags
+    size_t length = 1;
+    length += (frame.address_mode == AddressMode::SHORT_2_BYTE) ? 4 : 36;
+    length += 3 + 1;
+    
+    if (control_bitmap_present(frame)) length += ACK_MAP_SIZE;
+    if (frame.herald_present) length += 5;
+    if (frame.message_present) length += 17;
+    if (frame.extension_function_present) length += 8;
+    
+    return length + FRAME_CRC_LENGTH;
+}
+
+size_t FrameFormatter::data_frame_length(uint16_t data_length) {
+    return DATA_FRAME_HEADER_LENGTH + data_length + FRAME_CRC_LENGTH;
+}
+
 int FrameFormatter::format_control_frame(const ControlFrame& frame, uint8_t* buffer, size_t buffer_size) {
     if (buffer_size < 256) {
         return -1;  // Insufficient buffer
@@ -115,26 +146,26 @@ int FrameFormatter::format_control_frame(const ControlFrame& frame, uint8_t* buf
     buffer[index++] = frame.link_timeout & 0xFF;
     
     // Data transfer fields
+    bool bitmap_present = control_bitmap_present(frame);
+    
+    // Bits 0-1: ACK/NAK type, bits 2-5: which optional fields follow
     buffer[index] = static_cast<uint8_t>(frame.ack_nak_type) & 0x03;
+    if (bitmap_present) buffer[index] |= CTRL_FIELD_BITMAP;
+    if (frame.herald_present) buffer[index] |= CTRL_FIELD_HERALD;
+    if (frame.message_present) buffer[index] |= CTRL_FIELD_MESSAGE;
+    if (frame.extension_function_present) buffer[index] |= CTRL_FIELD_EXTENSION;
     index++;
     
-    // ACK bitmap (for T2/T3 frames with DATA_ACK)
-    if ((frame.frame_type == FrameType::T2_CONTROL || 
-         frame.frame_type == FrameType::T3_CONTROL ||
-         frame.frame_type == FrameType::T4_CONTROL) &&
-        (frame.ack_nak_type == AckNakType::DATA_ACK)) {
+    if (bitmap_present) {
+        // Copy bitmap
+        memcpy(&buffer[index], frame.bit_map, ACK_MAP_SIZE);
         
-        if (frame.address_mode == AddressMode::SHORT_2_BYTE) {
-            // Copy bitmap
-            memcpy(&buffer[index], frame.bit_map, ACK_MAP_SIZE);
-            
-            // Set flow control bit in last byte if needed
-            if (frame.flow_control) {
-                buffer[index + ACK_MAP_SIZE - 1] |= 0x80;
-            }
-            
-            index += ACK_MAP_SIZE;
+        // Set flow control bit in last byte if needed
+        if (frame.flow_control) {
+            buffer[index + ACK_MAP_SIZE - 1] |= 0x80;
         }
+        
+        index += ACK_MAP_SIZE;
     }
     
     // Herald fields (if present)
@@ -201,21 +232,39 @@ int FrameFormatter::format_data_frame(const DataFrame& frame, uint8_t* buffer, s
         return -1;  // Insufficient buffer
     }
     
+    size_t index = format_data_header(frame, buffer);
+    
+    // Data payload
+    memcpy(&buffer[index], frame.data, frame.data_length);
+    index += frame.data_length;
+    
+    // Append CRC-32
+    index = append_crc32(buffer, index);
+    
+    return static_cast<int>(index);
+}
+
+size_t FrameFormatter::format_data_header(const DataFrame& frame, uint8_t* buffer) {
     size_t index = 0;
     
     // Byte 0: Header byte
     // Bit 0: Sync mismatch (always 1)
     // Bit 1: Data frame indicator (0 for data)
-    // Bits 2-3: Reserved
+    // Bit 2: Compressed payload
+    // Bit 3: Repair block
     // Bits 4-6: Data rate (format depends on bit 7)
     // Bit 7: Data rate format
     buffer[index] = 0x01;  // Sync mismatch bit
     buffer[index] |= (static_cast<uint8_t>(frame.data_rate_format) << 7);
     buffer[index] |= (frame.data_rate & 0x07) << 4;
+    if (frame.compressed) buffer[index] |= DATA_FLAG_COMPRESSED;
+    if (frame.repair) buffer[index] |= DATA_FLAG_REPAIR;
     index++;
     
-    // Interleaver length
-    buffer[index++] = static_cast<uint8_t>(frame.interleaver_length);
+    // Interleaver length, message toggle in the top bit
+    buffer[index] = static_cast<uint8_t>(frame.interleaver_length);
+    if (frame.message_toggle) buffer[index] |= DATA_FLAG_TOGGLE;
+    index++;
     
     // Sequence number
     buffer[index++] = frame.sequence_number;
@@ -230,14 +279,7 @@ int FrameFormatter::format_data_frame(const DataFrame& frame, uint8_t* buffer, s
     buffer[index++] = (frame.data_length >> 8) & 0xFF;
     buffer[index++] = frame.data_length & 0xFF;
     
-    // Data payload
-    memcpy(&buffer[index], frame.data, frame.data_length);
-    index += frame.data_length;
-    
-    // Append CRC-32
-    index = append_crc32(buffer, index);
-    
-    return static_cast<int>(index);
+    return index;
 }
 
 // ============================================================================
@@ -254,6 +296,38 @@ FrameType FrameParser::detect_frame_type(const uint8_t* buffer) {
     }
 }
 
+size_t FrameParser::frame_length(const uint8_t* buffer, size_t length) {
+    if (length < 1) {
+        return 0;
+    }
+    
+    size_t frame_length;
+    if (detect_frame_type(buffer) == FrameType::DATA) {
+        if (length < DATA_FRAME_HEADER_LENGTH) {
+            return 0;
+        }
+        uint16_t data_length = (static_cast<uint16_t>(buffer[7]) << 8) | buffer[8];
+        frame_length = FrameFormatter::data_frame_length(data_length);
+    } else {
+        // Header, addresses and link management, then the field flags
+        size_t index = 1 + ((buffer[0] & 0x80) ? 36 : 4) + 3;
+        if (length <= index) {
+            return 0;
+        }
+        uint8_t fields = buffer[index++];
+        if (!(fields & (CTRL_FIELD_BITMAP | CTRL_FIELD_HERALD | CTRL_FIELD_MESSAGE | CTRL_FIELD_EXTENSION))) {
+            return 0;
+        }
+        if (fields & CTRL_FIELD_BITMAP) index += ACK_MAP_SIZE;
+        if (fields & CTRL_FIELD_HERALD) index += 5;
+        if (fields & CTRL_FIELD_MESSAGE) index += 17;
+        if (fields & CTRL_FIELD_EXTENSION) index += 8;
+        frame_length = index + FRAME_CRC_LENGTH;
+    }
+    
+    return frame_length <= length ? frame_length : 0;
+}
+
 bool FrameParser::validate_crc32(const uint8_t* buffer, size_t length) {
     if (length < 4) {
         return false;
@@ -271,6 +345,13 @@ bool FrameParser::validate_crc32(const uint8_t* buffer, size_t length) {
     return (calculated_crc == received_crc);
 }
 
+static uint32_t read_u32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) |
+           (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) |
+           static_cast<uint32_t>(p[3]);
+}
+
 bool FrameParser::parse_control_frame(const uint8_t* buffer, size_t length, ControlFrame& frame) {
     if (length < 10) {
         return false;  // Too short
@@ -317,22 +398,62 @@ bool FrameParser::parse_control_frame(const uint8_t* buffer, size_t length, Cont
     
     // Parse data transfer fields
     if (index >= length - 4) return false;
+    uint8_t fields = buffer[index];
     frame.ack_nak_type = static_cast<AckNakType>(buffer[index++] & 0x03);
     
-    // Parse bitmap if present (simplified - check remaining length)
-    if (index + ACK_MAP_SIZE <= length - 4) {
-        if (frame.address_mode == AddressMode::SHORT_2_BYTE) {
-            memcpy(frame.bit_map, &buffer[index], ACK_MAP_SIZE);
-            frame.flow_control = (buffer[index + ACK_MAP_SIZE - 1] & 0x80) != 0;
-            index += ACK_MAP_SIZE;
-        }
+    size_t end = length - 4;
+    bool bitmap_present;
+    if (fields & (CTRL_FIELD_BITMAP | CTRL_FIELD_HERALD | CTRL_FIELD_MESSAGE | CTRL_FIELD_EXTENSION)) {
+        bitmap_present = (fields & CTRL_FIELD_BITMAP) != 0;
+        frame.herald_present = (fields & CTRL_FIELD_HERALD) != 0;
+        frame.message_present = (fields & CTRL_FIELD_MESSAGE) != 0;
+        frame.extension_function_present = (fields & CTRL_FIELD_EXTENSION) != 0;
+    } else {
+        // No presence flags (older peer): bitmap inferred from remaining length
+        bitmap_present = frame.address_mode == AddressMode::SHORT_2_BYTE &&
+                         index + ACK_MAP_SIZE <= end;
+        frame.herald_present = false;
+        frame.message_present = false;
+        frame.extension_function_present = false;
     }
     
-    // Herald and message fields parsing would continue here
-    // Simplified for now - mark as not present
-    frame.herald_present = false;
-    frame.message_present = false;
-    frame.extension_function_present = false;
+    if (bitmap_present) {
+        if (index + ACK_MAP_SIZE > end) return false;
+        memcpy(frame.bit_map, &buffer[index], ACK_MAP_SIZE);
+        frame.flow_control = (buffer[index + ACK_MAP_SIZE - 1] & 0x80) != 0;
+        index += ACK_MAP_SIZE;
+    }
+    
+    // Herald fields
+    if (frame.herald_present) {
+        if (index + 5 > end) return false;
+        frame.data_rate_format = static_cast<DataRateFormat>((buffer[index] >> 7) & 0x01);
+        frame.data_rate = buffer[index] & 0x07;
+        frame.interleaver_length = static_cast<InterleaverLength>(buffer[index + 1]);
+        frame.bytes_in_data_frames = (static_cast<uint16_t>(buffer[index + 2]) << 8) | buffer[index + 3];
+        frame.frames_in_next_series = buffer[index + 4];
+        index += 5;
+    }
+    
+    // Message fields
+    if (frame.message_present) {
+        if (index + 17 > end) return false;
+        frame.tx_msg_size = read_u32(&buffer[index]);
+        frame.tx_msg_id = (static_cast<uint16_t>(buffer[index + 4]) << 8) | buffer[index + 5];
+        frame.tx_con_id = (static_cast<uint16_t>(buffer[index + 6]) << 8) | buffer[index + 7];
+        frame.tx_msg_priority = buffer[index + 8];
+        frame.tx_msg_next_byte_pos = read_u32(&buffer[index + 9]);
+        frame.rx_msg_next_byte_pos = read_u32(&buffer[index + 13]);
+        index += 17;
+    }
+    
+    // Extension function fields
+    if (frame.extension_function_present) {
+        if (index + 8 > end) return false;
+        frame.function_bits[0] = read_u32(&buffer[index]);
+        frame.function_bits[1] = read_u32(&buffer[index + 4]);
+        index += 8;
+    }
     
     return true;
 }
@@ -352,10 +473,14 @@ bool FrameParser::parse_data_frame(const uint8_t* buffer, size_t length, DataFra
     // Parse header
     frame.data_rate_format = static_cast<DataRateFormat>((buffer[index] >> 7) & 0x01);
     frame.data_rate = (buffer[index] >> 4) & 0x07;
+    frame.compressed = (buffer[index] & DATA_FLAG_COMPRESSED) != 0;
+    frame.repair = (buffer[index] & DATA_FLAG_REPAIR) != 0;
     index++;
     
-    // Interleaver length
-    frame.interleaver_length = static_cast<InterleaverLength>(buffer[index++]);
+    // Interleaver length and message toggle
+    frame.interleaver_length = static_cast<InterleaverLength>(buffer[index] & ~DATA_FLAG_TOGGLE);
+    frame.message_toggle = (buffer[index] & DATA_FLAG_TOGGLE) != 0;
+    index++;
     
     // Sequence number
     frame.sequence_number = buffer[index++];
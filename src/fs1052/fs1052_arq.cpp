@@ -4,8 +4,11 @@
  */
 
 #include "fs1052_arq.h"
+#include "fs1052_compress.h"
+#include "fs1052_erasure.h"
 #include <cstring>
 #include <algorithm>
+#include <memory>
 
 namespace fs1052 {
 
@@ -14,6 +17,98 @@ static const uint32_t DEFAULT_ACK_TIMEOUT = 5000;  // 5 seconds
 static const uint8_t DEFAULT_MAX_RETRANSMITS = 3;
 static const uint8_t DEFAULT_WINDOW_SIZE = 16;
 
+// RTT estimator parameters
+static const uint32_t DEFAULT_MIN_TIMEOUT = 1000;   // Below HF modem turnaround
+static const uint32_t DEFAULT_MAX_TIMEOUT = 60000;
+static const uint32_t TIMER_GRANULARITY = 100;      // update() tick resolution
+static const uint8_t MAX_BACKOFF = 6;               // 64x
+
+// Repair block payload: [k][m][index] then a coded symbol. Each data
+// block is coded as [offset:4][length:2][data, zero padded] so lost
+// blocks come back with their position.
+static const uint16_t REPAIR_HEADER_SIZE = 3;
+static const uint16_t REPAIR_SYMBOL_HEADER = 6;
+static const uint16_t REPAIR_DATA_BLOCK_LENGTH =
+    MAX_DATA_BLOCK_LENGTH - REPAIR_HEADER_SIZE - REPAIR_SYMBOL_HEADER;
+
+// Wrap-safe "a is after b"
+static bool time_after(uint32_t a, uint32_t b)
+{
+    return static_cast<int32_t>(a - b) > 0;
+}
+
+// ============================================================================
+// RTTEstimator
+// ============================================================================
+
+RTTEstimator::RTTEstimator()
+    : m_srtt(0)
+    , m_rttvar(0)
+    , m_initial_timeout(DEFAULT_ACK_TIMEOUT)
+    , m_min_timeout(DEFAULT_MIN_TIMEOUT)
+    , m_max_timeout(DEFAULT_MAX_TIMEOUT)
+    , m_backoff(0)
+    , m_has_sample(false)
+{
+}
+
+void RTTEstimator::set_initial_timeout(uint32_t timeout_ms)
+{
+    m_initial_timeout = timeout_ms;
+}
+
+void RTTEstimator::set_limits(uint32_t min_timeout_ms, uint32_t max_timeout_ms)
+{
+    m_min_timeout = min_timeout_ms;
+    m_max_timeout = std::max(min_timeout_ms, max_timeout_ms);
+}
+
+void RTTEstimator::add_sample(uint32_t rtt_ms)
+{
+    if (!m_has_sample) {
+        m_srtt = rtt_ms;
+        m_rttvar = rtt_ms / 2;
+        m_has_sample = true;
+    } else {
+        // RTTVAR <- 3/4 RTTVAR + 1/4 |SRTT - R|, then SRTT <- 7/8 SRTT + 1/8 R
+        uint32_t delta = (m_srtt > rtt_ms) ? m_srtt - rtt_ms : rtt_ms - m_srtt;
+        m_rttvar = (3 * m_rttvar + delta) / 4;
+        m_srtt = (7 * m_srtt + rtt_ms) / 8;
+    }
+    m_backoff = 0;
+}
+
+void RTTEstimator::backoff()
+{
+    if (m_backoff < MAX_BACKOFF) {
+        m_backoff++;
+    }
+}
+
+void RTTEstimator::reset()
+{
+    m_srtt = 0;
+    m_rttvar = 0;
+    m_backoff = 0;
+    m_has_sample = false;
+}
+
+uint32_t RTTEstimator::timeout_ms() const
+{
+    uint32_t rto = m_initial_timeout;
+    if (m_has_sample) {
+        rto = m_srtt + std::max(TIMER_GRANULARITY, 4 * m_rttvar);
+        rto = std::max(rto, m_min_timeout);
+    }
+    
+    uint64_t backed_off = static_cast<uint64_t>(rto) << m_backoff;
+    return static_cast<uint32_t>(std::min<uint64_t>(backed_off, m_max_timeout));
+}
+
+// ============================================================================
+// VariableARQ
+// ============================================================================
+
 VariableARQ::VariableARQ()
     : m_state(ARQState::IDLE)
     , m_prev_state(ARQState::IDLE)
@@ -22,14 +117,35 @@ VariableARQ::VariableARQ()
     , m_window_size(DEFAULT_WINDOW_SIZE)
     , m_expected_sequence(0)
     , m_rx_msg_length(0)
+    , m_rx_unique_bytes(0)
+    , m_rx_compressed(false)
+    , m_rx_decoded_valid(false)
+    , m_rx_contiguous(0)
+    , m_rx_contiguous_blocks(0)
+    , m_rx_messages(0)
+    , m_rx_started(false)
+    , m_rx_toggle(false)
+    , m_compression_enabled(false)
+    , m_peer_compression(false)
+    , m_tx_compressed(false)
+    , m_tx_toggle(false)
+    , m_repair_blocks(0)
+    , m_repair_series_length(0)
     , m_last_tx_time(0)
-    , m_ack_timeout(DEFAULT_ACK_TIMEOUT)
-    , m_wait_start_time(0)
+    , m_tx_busy_until(0)
+    , m_burst_start(0)
+    , m_burst_bytes(0)
+    , m_tx_start_time(0)
+    , m_tx_complete_time(0)
+    , m_max_series_ms(0)
+    , m_burst_enabled(false)
     , m_data_rate(DataRate::BPS_2400)
     , m_max_retransmits(DEFAULT_MAX_RETRANSMITS)
 {
     memset(&m_stats, 0, sizeof(m_stats));
     memset(m_rx_bitmap, 0, sizeof(m_rx_bitmap));
+    memset(m_rx_block_offset, 0, sizeof(m_rx_block_offset));
+    memset(m_rx_block_length, 0, sizeof(m_rx_block_length));
 }
 
 void VariableARQ::init(FrameCallback tx_callback,
@@ -48,12 +164,31 @@ void VariableARQ::reset()
     while (!m_retransmit_queue.empty()) {
         m_retransmit_queue.pop();
     }
-    m_rx_buffer.clear();
+    clear_rx_message();
+    m_rx_started = false;
+    m_tx_compressed = false;
     m_next_tx_sequence = 0;
     m_window_base = 0;
+    m_tx_busy_until = m_last_tx_time;
+    m_burst_bytes = 0;
+    m_burst_blocks.clear();
+    m_burst.clear();
+    m_rtt.reset();
+    memset(&m_stats, 0, sizeof(m_stats));
+}
+
+void VariableARQ::clear_rx_message()
+{
+    m_rx_buffer.clear();
+    m_rx_decoded.clear();
+    m_rx_unique_bytes = 0;
+    m_rx_compressed = false;
+    m_rx_decoded_valid = false;
+    m_rx_contiguous = 0;
+    m_rx_contiguous_blocks = 0;
+    m_rx_series.clear();
     m_expected_sequence = 0;
     memset(m_rx_bitmap, 0, sizeof(m_rx_bitmap));
-    memset(&m_stats, 0, sizeof(m_stats));
 }
 
 void VariableARQ::process_event(ARQEvent event)
@@ -113,7 +248,6 @@ void VariableARQ::handle_tx_data(ARQEvent event)
                 process_event(ARQEvent::TRANSFER_COMPLETE);
             } else {
                 transition_to(ARQState::WAIT_ACK);
-                m_wait_start_time = m_last_tx_time;
             }
             break;
         case ARQEvent::TRANSFER_COMPLETE:
@@ -134,19 +268,20 @@ void VariableARQ::handle_wait_ack(ARQEvent event)
             if (all_blocks_acked()) {
                 transition_to(ARQState::IDLE);
             } else if (!m_retransmit_queue.empty()) {
-                transition_to(ARQState::RETRANSMIT);
-            } else {
+                start_retransmit();
+            } else if (has_unsent_blocks()) {
                 transition_to(ARQState::TX_DATA);
                 send_next_blocks();
             }
+            // Otherwise keep waiting for blocks still in flight
             break;
         case ARQEvent::NAK_RECEIVED:
             m_stats.naks_received++;
-            transition_to(ARQState::RETRANSMIT);
+            start_retransmit();
             break;
         case ARQEvent::TIMEOUT:
             m_stats.timeouts++;
-            transition_to(ARQState::RETRANSMIT);
+            start_retransmit();
             break;
         case ARQEvent::ERROR_EVENT:
             transition_to(ARQState::ERROR);
@@ -195,8 +330,12 @@ void VariableARQ::handle_retransmit(ARQEvent event)
                 m_retransmit_queue.pop();
                 
                 DataBlock* block = find_block(seq);
+                if (block) {
+                    block->retransmit_pending = false;
+                }
                 if (block && !block->acknowledged) {
                     if (block->retransmit_count >= m_max_retransmits) {
+                        flush_burst();
                         report_error("Max retransmissions exceeded");
                         transition_to(ARQState::ERROR);
                         return;
@@ -206,8 +345,8 @@ void VariableARQ::handle_retransmit(ARQEvent event)
                     m_stats.blocks_retransmitted++;
                 }
             }
+            flush_burst();
             transition_to(ARQState::WAIT_ACK);
-            m_wait_start_time = m_last_tx_time;
             break;
         default:
             break;
@@ -226,7 +365,64 @@ bool VariableARQ::start_transmission(const uint8_t* data, uint32_t length)
         return false;
     }
     
+    // Compress per message when both ends support it and the data is
+    // not already dense; a stream that would not shrink is sent raw
+    std::vector<uint8_t> packed;
+    m_tx_compressed = false;
+    if (m_compression_enabled && m_peer_compression) {
+        if (PayloadCompressor::should_compress(data, length) &&
+            PayloadCompressor::compress(data, length, packed)) {
+            m_stats.messages_compressed++;
+            m_stats.bytes_saved += length - static_cast<uint32_t>(packed.size());
+            data = packed.data();
+            length = static_cast<uint32_t>(packed.size());
+            m_tx_compressed = true;
+        } else {
+            m_stats.compression_bypassed++;
+        }
+    }
+    
     create_blocks(data, length);
+    m_tx_start_time = m_last_tx_time;
+    m_tx_complete_time = m_last_tx_time;
+    process_event(ARQEvent::START_TX);
+    return true;
+}
+
+bool VariableARQ::start_transmission(const FrameSegment* segments, int count)
+{
+    uint32_t length = 0;
+    for (int i = 0; i < count; i++) {
+        length += static_cast<uint32_t>(segments[i].length);
+    }
+    
+    // Compression works on one buffer
+    if (count != 1 && m_compression_enabled && m_peer_compression) {
+        std::vector<uint8_t> flat;
+        flat.reserve(length);
+        for (int i = 0; i < count; i++) {
+            flat.insert(flat.end(), segments[i].data, segments[i].data + segments[i].length);
+        }
+        return start_transmission(flat.data(), length);
+    }
+    if (count == 1) {
+        return start_transmission(segments[0].data, length);
+    }
+    
+    if (m_state != ARQState::IDLE) {
+        report_error("Cannot start transmission: not in IDLE state");
+        return false;
+    }
+    
+    if (!m_tx_callback) {
+        report_error("No TX callback configured");
+        return false;
+    }
+    
+    m_tx_compressed = false;
+    create_blocks(segments, count);
+    m_tx_start_time = m_last_tx_time;
+    m_tx_complete_time = m_last_tx_time;
     process_event(ARQEvent::START_TX);
     return true;
 }
@@ -237,27 +433,74 @@ void VariableARQ::handle_received_frame(const uint8_t* frame, int length)
         return;
     }
     
+    // A burst carries several frames back to back: take them in turn
+    // and answer the whole transmission with one ACK
+    size_t total = static_cast<size_t>(length);
+    bool data_received = false;
+    size_t first = FrameParser::frame_length(frame, total);
+    if (first > 0 && first < total) {
+        size_t offset = 0;
+        while (offset < total) {
+            size_t frame_length = FrameParser::frame_length(frame + offset, total - offset);
+            if (frame_length == 0) {
+                frame_length = total - offset;  // Not self-delimiting: the rest
+            }
+            data_received |= receive_frame(frame + offset, frame_length);
+            offset += frame_length;
+        }
+    } else {
+        data_received = receive_frame(frame, total);
+    }
+    
+    if (data_received) {
+        process_event(ARQEvent::FRAME_RECEIVED);
+        
+        // Acknowledge every good frame or burst, duplicates included: a
+        // duplicate means our previous ACK was lost
+        send_ack();
+    }
+}
+
+bool VariableARQ::receive_frame(const uint8_t* frame, size_t length)
+{
     FrameType type = FrameParser::detect_frame_type(frame);
     
     if (type == FrameType::DATA) {
         // Data frame
         DataFrame df;
         if (FrameParser::parse_data_frame(frame, length, df)) {
+            // The other toggle means the sender has moved on to its next
+            // message; frames of the last one can no longer follow
+            if (!m_rx_started || df.message_toggle != m_rx_toggle) {
+                clear_rx_message();
+                m_rx_started = true;
+                m_rx_toggle = df.message_toggle;
+                m_rx_messages++;
+            }
             process_data_frame(df);
             m_stats.blocks_received++;
-            process_event(ARQEvent::FRAME_RECEIVED);
-        } else {
-            m_stats.crc_errors++;
+            return true;
         }
+        m_stats.crc_errors++;
     } else if (type != FrameType::NO_FRAME) {
-        // Control frame (ACK/NAK)
+        // Control frame (ACK/NAK, or the herald leading a burst)
         ControlFrame cf;
         if (FrameParser::parse_control_frame(frame, length, cf)) {
+            if (cf.herald_present && cf.ack_nak_type == AckNakType::NULL_ACK) {
+                m_stats.heralds_received++;
+                return false;
+            }
+            if (cf.extension_function_present) {
+                m_peer_compression = (cf.function_bits[0] & EXT_FUNC_COMPRESSION) != 0;
+            }
             process_ack(cf);
             m_stats.acks_received++;
             process_event(ARQEvent::ACK_RECEIVED);
+        } else {
+            m_stats.crc_errors++;
         }
     }
+    return false;
 }
 
 void VariableARQ::update(uint32_t current_time_ms)
@@ -269,9 +512,92 @@ void VariableARQ::update(uint32_t current_time_ms)
     }
 }
 
+void VariableARQ::set_repair_blocks(uint8_t repair_blocks, uint8_t series_length)
+{
+    m_repair_blocks = repair_blocks;
+    m_repair_series_length = series_length;
+}
+
 void VariableARQ::set_data_rate(DataRate rate)
 {
     m_data_rate = rate;
+    m_airtime.set_mode(rate, m_airtime.interleaver());
+}
+
+void VariableARQ::set_interleaver(InterleaverLength interleaver)
+{
+    m_airtime.set_mode(m_data_rate, interleaver);
+}
+
+void VariableARQ::set_gather_callback(GatherCallback callback)
+{
+    m_gather_callback = callback;
+    m_burst.set_gather(static_cast<bool>(m_gather_callback));
+    if (m_gather_callback) {
+        m_burst_enabled = true;
+    }
+}
+
+uint32_t VariableARQ::expected_goodput_bps() const
+{
+    uint16_t block_size = tx_block_size();
+    uint32_t frames = m_window_size;
+    if (m_max_series_ms) {
+        frames = std::min(frames, std::max<uint32_t>(1, m_airtime.max_frames(m_max_series_ms, block_size)));
+    }
+    if (frames == 0) {
+        return 0;
+    }
+    
+    // Repair blocks share the series airtime limit: drop data blocks
+    // until the series and its repair blocks fit
+    uint32_t frame_bytes = static_cast<uint32_t>(FrameFormatter::data_frame_length(block_size));
+    uint32_t series_length = m_repair_series_length ? m_repair_series_length : m_window_size;
+    uint32_t series_bytes;
+    uint32_t frames_sent;
+    for (;;) {
+        uint32_t series_count = m_repair_blocks > 0 ? (frames + series_length - 1) / series_length : 0;
+        series_bytes = frames * frame_bytes + series_count * repair_frame_bytes();
+        frames_sent = frames + series_count * m_repair_blocks;
+        if (!m_max_series_ms || frames == 1 ||
+            m_airtime.transmission_ms(series_bytes) <= m_max_series_ms) {
+            break;
+        }
+        frames--;
+    }
+    
+    // The receiver acknowledges every frame, or every burst
+    uint32_t acks = m_burst_enabled ? 1 : frames_sent;
+    uint32_t reply_bytes = acks * static_cast<uint32_t>(FrameFormatter::control_frame_length(make_ack_frame()));
+    if (m_burst_enabled) {
+        series_bytes += static_cast<uint32_t>(FrameFormatter::control_frame_length(make_herald_frame(frames_sent)));
+    }
+    return m_airtime.expected_goodput_bps(frames * block_size, series_bytes, reply_bytes);
+}
+
+uint32_t VariableARQ::achieved_goodput_bps() const
+{
+    uint32_t bytes = 0;
+    for (const auto& block : m_tx_blocks) {
+        if (block.acknowledged) {
+            bytes += block.length;
+        }
+    }
+    
+    uint32_t end = (bytes > 0 && all_blocks_acked()) ? m_tx_complete_time : m_last_tx_time;
+    uint32_t elapsed = end - m_tx_start_time;
+    if (elapsed == 0) {
+        return 0;
+    }
+    return static_cast<uint32_t>(static_cast<uint64_t>(bytes) * 8000 / elapsed);
+}
+
+uint32_t VariableARQ::get_received_contiguous() const
+{
+    if (m_rx_compressed) {
+        return m_rx_decoded_valid ? static_cast<uint32_t>(m_rx_decoded.size()) : 0;
+    }
+    return m_rx_contiguous;
 }
 
 bool VariableARQ::is_transfer_complete() const
@@ -300,6 +626,10 @@ void VariableARQ::transition_to(ARQState new_state)
 void VariableARQ::send_next_blocks()
 {
     int sent = 0;
+    if (m_burst_enabled) {
+        size_t frames = m_window_size + (m_repair_blocks ? m_window_size : 0);
+        m_burst.reserve(frames * FrameFormatter::data_frame_length(MAX_DATA_BLOCK_LENGTH));
+    }
     
     // Send up to window_size blocks
     while (sent < m_window_size && m_next_tx_sequence < m_tx_blocks.size()) {
@@ -307,16 +637,36 @@ void VariableARQ::send_next_blocks()
         DataBlock* block = find_block(seq);
         
         if (block && !block->acknowledged) {
+            // Keep the whole transmission, including the repair blocks
+            // that close this block's series, inside the airtime limit
+            uint32_t queued = time_after(m_tx_busy_until, m_last_tx_time) ? m_burst_bytes : 0;
+            uint32_t frame_bytes = static_cast<uint32_t>(FrameFormatter::data_frame_length(block->length));
+            if (m_max_series_ms > 0 && sent > 0 &&
+                m_airtime.transmission_ms(queued + frame_bytes + repair_frame_bytes()) > m_max_series_ms) {
+                break;
+            }
+            
             send_block(seq);
             sent++;
         }
         
+        // Series complete: follow it with its repair blocks
+        if (m_repair_blocks > 0) {
+            size_t index = m_next_tx_sequence;
+            size_t series_length = m_repair_series_length ? m_repair_series_length : m_window_size;
+            size_t first = index - index % series_length;
+            if (index + 1 == first + series_length || index + 1 == m_tx_blocks.size()) {
+                send_repair_blocks(first, index + 1 - first);
+            }
+        }
+        
         m_next_tx_sequence++;
         if (m_next_tx_sequence >= 256) {
             m_next_tx_sequence = 0;
         }
     }
     
+    flush_burst();
     if (sent > 0) {
         process_event(ARQEvent::FRAME_SENT);
     }
@@ -329,38 +679,118 @@ void VariableARQ::send_block(uint8_t sequence)
         return;
     }
     
-    // Build data frame
-    DataFrame frame;
+    // Build data frame header; the payload stays in the block
+    DataFrame& frame = m_tx_header;
     frame.data_rate_format = DataRateFormat::ABSOLUTE;
     frame.data_rate = static_cast<uint8_t>(m_data_rate);
-    frame.interleaver_length = InterleaverLength::SHORT;
+    frame.interleaver_length = m_airtime.interleaver();
     frame.sequence_number = block->sequence;
     frame.msg_byte_offset = block->offset;
+    frame.compressed = m_tx_compressed;
+    frame.message_toggle = m_tx_toggle;
+    frame.repair = false;
     frame.data_length = block->length;
-    memcpy(frame.data, block->data, block->length);
     
-    // Format and send
-    uint8_t buffer[1200];
-    int length = FrameFormatter::format_data_frame(frame, buffer, sizeof(buffer));
+    int length = transmit_data_frame(frame, block->data);
     
     if (length > 0) {
-        m_tx_callback(buffer, length);
         block->timestamp = m_last_tx_time;
+        block->tx_end_time = schedule_frame(length);
+        block->series_end_time = m_tx_busy_until;
+        block->repair_end_time = 0;
+        m_burst_blocks.push_back(static_cast<size_t>(block - m_tx_blocks.data()));
+        block->sent = true;
         m_stats.blocks_sent++;
     }
 }
 
+int VariableARQ::transmit_data_frame(const DataFrame& frame, const uint8_t* payload)
+{
+    if (m_burst_enabled) {
+        // The herald leads the series; book its airtime with the first frame
+        if (m_burst.empty()) {
+            schedule_frame(static_cast<int>(FrameFormatter::control_frame_length(make_herald_frame(1))));
+        }
+        
+        // Block payloads stay put until the burst is flushed and may be
+        // referenced; anything else (payload == nullptr) is copied
+        bool added = payload ? m_burst.add_data_frame(frame, payload) : m_burst.add_data_frame(frame);
+        return added ? static_cast<int>(FrameFormatter::data_frame_length(frame.data_length)) : 0;
+    }
+    
+    // Format and send
+    uint8_t buffer[1200];
+    size_t index = FrameFormatter::format_data_header(frame, buffer);
+    memcpy(&buffer[index], payload ? payload : frame.data, frame.data_length);
+    int length = static_cast<int>(FrameFormatter::append_crc32(buffer, index + frame.data_length));
+    m_tx_callback(buffer, length);
+    return length;
+}
+
+void VariableARQ::flush_burst()
+{
+    if (m_burst.empty()) {
+        return;
+    }
+    
+    m_burst.prepend_control_frame(make_herald_frame(m_burst.frame_count()));
+    if (m_gather_callback) {
+        const std::vector<FrameSegment>& segments = m_burst.segments();
+        m_gather_callback(segments.data(), static_cast<int>(segments.size()));
+    } else {
+        m_tx_callback(m_burst.data(), static_cast<int>(m_burst.size()));
+    }
+    m_stats.bursts_sent++;
+    m_burst.clear();
+}
+
+ControlFrame VariableARQ::make_herald_frame(int frames) const
+{
+    ControlFrame frame;
+    frame.protocol_version = PROTOCOL_VERSION;
+    frame.arq_mode = ARQMode::VARIABLE_ARQ;
+    frame.frame_type = FrameType::T3_CONTROL;
+    frame.ack_nak_type = AckNakType::NULL_ACK;
+    frame.herald_present = true;
+    frame.data_rate_format = DataRateFormat::ABSOLUTE;
+    frame.data_rate = static_cast<uint8_t>(m_data_rate);
+    frame.interleaver_length = m_airtime.interleaver();
+    frame.bytes_in_data_frames = tx_block_size();
+    frame.frames_in_next_series = static_cast<uint8_t>(std::min(frames, 255));
+    return frame;
+}
+
 void VariableARQ::send_ack()
 {
     if (!m_tx_callback) {
         return;
     }
     
+    ControlFrame frame = make_ack_frame();
+    uint8_t buffer[256];
+    int length = FrameFormatter::format_control_frame(frame, buffer, sizeof(buffer));
+    
+    if (length > 0) {
+        m_tx_callback(buffer, length);
+        m_stats.acks_sent++;
+        process_event(ARQEvent::FRAME_SENT);
+    }
+}
+
+ControlFrame VariableARQ::make_ack_frame() const
+{
     ControlFrame frame;
     frame.protocol_version = PROTOCOL_VERSION;
     frame.arq_mode = ARQMode::VARIABLE_ARQ;
+    frame.frame_type = FrameType::T2_CONTROL;  // Carries the bitmap
     frame.ack_nak_type = AckNakType::DATA_ACK;
     
+    // Advertise our capabilities
+    if (m_compression_enabled) {
+        frame.extension_function_present = true;
+        frame.function_bits[0] |= EXT_FUNC_COMPRESSION;
+    }
+    
     // Build ACK bitmap
     for (int i = 0; i < 256; i++) {
         if (m_rx_bitmap[i]) {
@@ -369,15 +799,7 @@ void VariableARQ::send_ack()
             frame.bit_map[byte_idx] |= (1 << bit_idx);
         }
     }
-    
-    uint8_t buffer[256];
-    int length = FrameFormatter::format_control_frame(frame, buffer, sizeof(buffer));
-    
-    if (length > 0) {
-        m_tx_callback(buffer, length);
-        m_stats.acks_sent++;
-        process_event(ARQEvent::FRAME_SENT);
-    }
+    return frame;
 }
 
 void VariableARQ::send_nak(uint8_t sequence)
@@ -392,38 +814,68 @@ void VariableARQ::process_ack(const ControlFrame& frame)
         return;
     }
     
-    // Process ACK bitmap
+    // Process ACK bitmap, remembering the latest-sent block it newly covers
+    DataBlock* newest = nullptr;
     for (int i = 0; i < 256; i++) {
         int byte_idx = i / 8;
         int bit_idx = i % 8;
         bool acked = (frame.bit_map[byte_idx] & (1 << bit_idx)) != 0;
         
-        if (acked) {
-            mark_block_acked(i);
+        DataBlock* block = acked ? find_block(i) : nullptr;
+        if (block && block->sent && !block->acknowledged) {
+            block->acknowledged = true;
+            if (!newest || time_after(block->tx_end_time, newest->tx_end_time)) {
+                newest = block;
+            }
         }
     }
-}
-
-void VariableARQ::process_data_frame(const DataFrame& frame)
-{
-    uint8_t seq = frame.sequence_number;
     
-    // Check for duplicates
-    if (m_rx_bitmap[seq]) {
-        // Already received, ignore
-        return;
+    if (!newest) {
+        return;  // Nothing new (duplicate or stale ACK)
+    }
+    if (all_blocks_acked()) {
+        m_tx_complete_time = m_last_tx_time;
     }
     
-    // Mark as received
-    m_rx_bitmap[seq] = true;
-    
-    // Store data
-    uint32_t offset = frame.msg_byte_offset;
-    if (offset + frame.data_length > m_rx_buffer.size()) {
-        m_rx_buffer.resize(offset + frame.data_length);
+    // RTT sample: end of the transmission carrying that block to ACK
+    // receipt. Airtime is excluded so samples do not depend on series
+    // size or rate. Karn's rule: a retransmitted block's ACK is ambiguous.
+    if (newest->retransmit_count == 0) {
+        uint32_t rtt = time_after(m_last_tx_time, newest->series_end_time)
+                           ? m_last_tx_time - newest->series_end_time : 0;
+        m_rtt.add_sample(rtt);
+        m_stats.rtt_samples++;
     }
     
-    memcpy(&m_rx_buffer[offset], frame.data, frame.data_length);
+    // Selective repeat: anything sent before a block the receiver got,
+    // but missing from its bitmap, was lost; resend without waiting.
+    // Blocks covered by repair blocks sent after that are not lost yet.
+    for (auto& block : m_tx_blocks) {
+        if (block.sent && !block.acknowledged &&
+            time_after(newest->tx_end_time, loss_deadline(block))) {
+            queue_retransmit(block);
+        }
+    }
+}
+
+void VariableARQ::process_data_frame(const DataFrame& frame)
+{
+    if (frame.repair) {
+        process_repair_frame(frame);
+    } else {
+        uint8_t seq = frame.sequence_number;
+        if (!store_block(seq, frame.msg_byte_offset, frame.data, frame.data_length, frame.compressed)) {
+            // Already received, ignore
+            return;
+        }
+        
+        // A late data block may complete a series with its repair blocks
+        for (auto& series : m_rx_series) {
+            if (static_cast<uint8_t>(seq - series.first_sequence) < series.data_blocks) {
+                try_recover_series(series);
+            }
+        }
+    }
     
     // Check if all blocks received
     bool all_received = true;
@@ -443,19 +895,151 @@ void VariableARQ::process_data_frame(const DataFrame& frame)
     }
 }
 
+bool VariableARQ::store_block(uint8_t sequence, uint32_t offset, const uint8_t* data,
+                              uint16_t length, bool compressed)
+{
+    // Check for duplicates
+    if (m_rx_bitmap[sequence]) {
+        return false;
+    }
+    
+    // Mark as received
+    m_rx_bitmap[sequence] = true;
+    m_rx_block_offset[sequence] = offset;
+    m_rx_block_length[sequence] = length;
+    
+    // Store data
+    if (offset + length > m_rx_buffer.size()) {
+        m_rx_buffer.resize(offset + length);
+    }
+    
+    memcpy(&m_rx_buffer[offset], data, length);
+    m_rx_unique_bytes += length;
+    
+    // Blocks are numbered in offset order from the start of the message
+    while (m_rx_contiguous_blocks < 256) {
+        uint8_t next = static_cast<uint8_t>(m_rx_contiguous_blocks);
+        if (!m_rx_bitmap[next] || m_rx_block_offset[next] != m_rx_contiguous) {
+            break;
+        }
+        m_rx_contiguous += m_rx_block_length[next];
+        m_rx_contiguous_blocks++;
+    }
+    
+    if (compressed) {
+        m_rx_compressed = true;
+    }
+    if (m_rx_compressed && !m_rx_decoded_valid) {
+        decode_compressed_stream();
+    }
+    return true;
+}
+
 void VariableARQ::check_timeouts(uint32_t current_time)
 {
-    if (current_time - m_wait_start_time > m_ack_timeout) {
-        // Timeout - queue all unacked blocks for retransmit
-        for (const auto& block : m_tx_blocks) {
-            if (!block.acknowledged) {
-                m_retransmit_queue.push(block.sequence);
-            }
+    // Each block's ACK is due one timeout after the transmission that
+    // carried it (and its repair blocks) ended
+    uint32_t timeout = m_rtt.timeout_ms();
+    bool expired = false;
+    for (const auto& block : m_tx_blocks) {
+        if (block.sent && !block.acknowledged &&
+            time_after(current_time, ack_deadline(block) + timeout)) {
+            expired = true;
+            break;
+        }
+    }
+    
+    if (!expired) {
+        return;
+    }
+    
+    // Resend only overdue blocks; later ones may still be acknowledged
+    for (auto& block : m_tx_blocks) {
+        if (!block.sent || block.acknowledged) {
+            continue;
+        }
+        if (time_after(current_time, ack_deadline(block) + timeout)) {
+            queue_retransmit(block);
+        } else {
+            m_stats.retransmits_skipped++;
         }
-        process_event(ARQEvent::TIMEOUT);
+    }
+    
+    m_rtt.backoff();
+    process_event(ARQEvent::TIMEOUT);
+}
+
+void VariableARQ::queue_retransmit(DataBlock& block)
+{
+    if (!block.retransmit_pending) {
+        block.retransmit_pending = true;
+        m_retransmit_queue.push(block.sequence);
     }
 }
 
+void VariableARQ::start_retransmit()
+{
+    transition_to(ARQState::RETRANSMIT);
+    process_event(ARQEvent::DATA_READY);
+}
+
+bool VariableARQ::has_unsent_blocks() const
+{
+    for (const auto& block : m_tx_blocks) {
+        if (!block.sent) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t VariableARQ::schedule_frame(int frame_length)
+{
+    // Frames queue back to back in one transmission while the modem is
+    // still sending; from idle a new one starts after the turnaround
+    if (!time_after(m_tx_busy_until, m_last_tx_time)) {
+        m_burst_start = m_last_tx_time + m_airtime.turnaround_ms();
+        m_burst_bytes = 0;
+        m_burst_blocks.clear();
+    }
+    m_burst_bytes += static_cast<uint32_t>(frame_length);
+    m_tx_busy_until = m_burst_start + m_airtime.transmission_ms(m_burst_bytes);
+    
+    // A longer transmission delays the peer's answer to all of it
+    for (size_t index : m_burst_blocks) {
+        m_tx_blocks[index].series_end_time = m_tx_busy_until;
+    }
+    return m_burst_start + m_airtime.data_end_ms(m_burst_bytes);
+}
+
+uint16_t VariableARQ::tx_block_size() const
+{
+    // Leave room for the repair header so repair blocks fit one frame
+    return m_repair_blocks ? REPAIR_DATA_BLOCK_LENGTH : MAX_DATA_BLOCK_LENGTH;
+}
+
+uint32_t VariableARQ::repair_frame_bytes() const
+{
+    // Repair blocks of one series, each at most a full frame
+    return m_repair_blocks * static_cast<uint32_t>(FrameFormatter::data_frame_length(MAX_DATA_BLOCK_LENGTH));
+}
+
+uint32_t VariableARQ::loss_deadline(const DataBlock& block) const
+{
+    // Not lost until its series' repair blocks have gone out too
+    if (block.repair_end_time && time_after(block.repair_end_time, block.tx_end_time)) {
+        return block.repair_end_time;
+    }
+    return block.tx_end_time;
+}
+
+uint32_t VariableARQ::ack_deadline(const DataBlock& block) const
+{
+    // A half-duplex peer answers only after our transmission ends
+    uint32_t deadline = loss_deadline(block);
+    return time_after(block.series_end_time, deadline) ? block.series_end_time : deadline;
+}
+
 bool VariableARQ::all_blocks_acked() const
 {
     for (const auto& block : m_tx_blocks) {
@@ -474,32 +1058,60 @@ void VariableARQ::report_error(const char* msg)
 }
 
 void VariableARQ::create_blocks(const uint8_t* data, uint32_t length)
+{
+    FrameSegment segment = {data, length};
+    create_blocks(&segment, 1);
+}
+
+void VariableARQ::create_blocks(const FrameSegment* segments, int count)
 {
     m_tx_blocks.clear();
+    m_burst_blocks.clear();
     m_next_tx_sequence = 0;
     m_window_base = 0;
+    m_tx_toggle = !m_tx_toggle;
+    
+    uint16_t block_size = tx_block_size();
     
     uint32_t offset = 0;
     uint8_t seq = 0;
+    int index = 0;
+    size_t used = 0;    // Bytes of segments[index] already in blocks
     
-    while (offset < length) {
+    while (index < count) {
         DataBlock block;
         block.sequence = seq;
         block.offset = offset;
-        block.length = std::min(static_cast<uint32_t>(MAX_DATA_BLOCK_LENGTH), 
-                                length - offset);
-        memcpy(block.data, data + offset, block.length);
+        block.length = 0;
+        
+        // Fill the block from as many segments as it spans
+        while (block.length < block_size && index < count) {
+            size_t take = std::min<size_t>(block_size - block.length, segments[index].length - used);
+            memcpy(block.data + block.length, segments[index].data + used, take);
+            block.length = static_cast<uint16_t>(block.length + take);
+            used += take;
+            if (used == segments[index].length) {
+                index++;
+                used = 0;
+            }
+        }
+        if (block.length == 0) {
+            break;
+        }
+        
         block.acknowledged = false;
         block.retransmit_count = 0;
         block.timestamp = 0;
+        block.tx_end_time = 0;
+        block.series_end_time = 0;
+        block.repair_end_time = 0;
+        block.sent = false;
+        block.retransmit_pending = false;
         
         m_tx_blocks.push_back(block);
         
         offset += block.length;
         seq++;
-        if (seq >= 256) {
-            seq = 0;
-        }
     }
 }
 
@@ -527,6 +1139,228 @@ void VariableARQ::reassemble_data()
     // Just verify integrity
 }
 
+// ============================================================================
+// Erasure coding
+// ============================================================================
+
+void VariableARQ::send_repair_blocks(size_t first_index, size_t count)
+{
+    if (!m_tx_callback || count == 0) {
+        return;
+    }
+    
+    uint16_t max_length = 0;
+    for (size_t i = 0; i < count; i++) {
+        max_length = std::max(max_length, m_tx_blocks[first_index + i].length);
+    }
+    size_t symbol_length = REPAIR_SYMBOL_HEADER + max_length;
+    
+    std::vector<std::vector<uint8_t>> symbols(count, std::vector<uint8_t>(symbol_length, 0));
+    std::vector<const uint8_t*> data(count);
+    for (size_t i = 0; i < count; i++) {
+        const DataBlock& block = m_tx_blocks[first_index + i];
+        uint8_t* symbol = symbols[i].data();
+        symbol[0] = (block.offset >> 24) & 0xFF;
+        symbol[1] = (block.offset >> 16) & 0xFF;
+        symbol[2] = (block.offset >> 8) & 0xFF;
+        symbol[3] = block.offset & 0xFF;
+        symbol[4] = (block.length >> 8) & 0xFF;
+        symbol[5] = block.length & 0xFF;
+        memcpy(symbol + REPAIR_SYMBOL_HEADER, block.data, block.length);
+        data[i] = symbol;
+    }
+    
+    std::vector<std::vector<uint8_t>> repair(m_repair_blocks, std::vector<uint8_t>(symbol_length));
+    std::vector<uint8_t*> repair_ptrs(m_repair_blocks);
+    for (int j = 0; j < m_repair_blocks; j++) {
+        repair_ptrs[j] = repair[j].data();
+    }
+    if (!ErasureCoder::encode(data.data(), static_cast<int>(count),
+                              repair_ptrs.data(), m_repair_blocks, symbol_length)) {
+        return;
+    }
+    
+    for (int j = 0; j < m_repair_blocks; j++) {
+        DataFrame frame;
+        frame.data_rate_format = DataRateFormat::ABSOLUTE;
+        frame.data_rate = static_cast<uint8_t>(m_data_rate);
+        frame.interleaver_length = m_airtime.interleaver();
+        frame.sequence_number = m_tx_blocks[first_index].sequence;
+        frame.compressed = m_tx_compressed;
+        frame.message_toggle = m_tx_toggle;
+        frame.repair = true;
+        frame.data_length = static_cast<uint16_t>(REPAIR_HEADER_SIZE + symbol_length);
+        frame.data[0] = static_cast<uint8_t>(count);
+        frame.data[1] = m_repair_blocks;
+        frame.data[2] = static_cast<uint8_t>(j);
+        memcpy(frame.data + REPAIR_HEADER_SIZE, repair[j].data(), symbol_length);
+        
+        int length = transmit_data_frame(frame, nullptr);
+        if (length > 0) {
+            uint32_t end = schedule_frame(length);
+            for (size_t i = 0; i < count; i++) {
+                m_tx_blocks[first_index + i].repair_end_time = end;
+            }
+            m_stats.repair_blocks_sent++;
+        }
+    }
+}
+
+void VariableARQ::process_repair_frame(const DataFrame& frame)
+{
+    if (frame.data_length <= REPAIR_HEADER_SIZE + REPAIR_SYMBOL_HEADER) {
+        return;
+    }
+    
+    uint8_t k = frame.data[0];
+    uint8_t m = frame.data[1];
+    uint8_t index = frame.data[2];
+    uint16_t symbol_length = frame.data_length - REPAIR_HEADER_SIZE;
+    if (k == 0 || index >= m || k + m > ERASURE_MAX_BLOCKS) {
+        return;
+    }
+    
+    RepairSeries* series = nullptr;
+    for (auto& s : m_rx_series) {
+        if (s.first_sequence == frame.sequence_number) {
+            series = &s;
+            break;
+        }
+    }
+    if (!series) {
+        RepairSeries s;
+        s.first_sequence = frame.sequence_number;
+        s.data_blocks = k;
+        s.repair_blocks = m;
+        s.symbol_length = symbol_length;
+        s.repair.resize(m);
+        s.complete = false;
+        m_rx_series.push_back(std::move(s));
+        series = &m_rx_series.back();
+    }
+    
+    if (series->data_blocks != k || series->repair_blocks != m ||
+        series->symbol_length != symbol_length) {
+        return;  // Inconsistent with earlier repair blocks
+    }
+    
+    if (frame.compressed) {
+        m_rx_compressed = true;
+    }
+    
+    if (series->repair[index].empty()) {
+        series->repair[index].assign(frame.data + REPAIR_HEADER_SIZE,
+                                     frame.data + frame.data_length);
+        try_recover_series(*series);
+    }
+}
+
+void VariableARQ::try_recover_series(RepairSeries& series)
+{
+    if (series.complete) {
+        return;
+    }
+    
+    int k = series.data_blocks;
+    int m = series.repair_blocks;
+    int available = 0;
+    int missing = 0;
+    for (int i = 0; i < k; i++) {
+        if (m_rx_bitmap[static_cast<uint8_t>(series.first_sequence + i)]) {
+            available++;
+        } else {
+            missing++;
+        }
+    }
+    for (int j = 0; j < m; j++) {
+        if (!series.repair[j].empty()) {
+            available++;
+        }
+    }
+    
+    if (missing == 0) {
+        series.complete = true;
+        return;
+    }
+    if (available < k) {
+        return;  // Wait for more blocks (or the retransmission)
+    }
+    
+    // Rebuild coded symbols for the blocks we have
+    size_t length = series.symbol_length;
+    std::vector<std::vector<uint8_t>> symbols(k, std::vector<uint8_t>(length, 0));
+    std::vector<uint8_t*> blocks(k + m);
+    std::unique_ptr<bool[]> present(new bool[k + m]());
+    for (int i = 0; i < k; i++) {
+        uint8_t seq = static_cast<uint8_t>(series.first_sequence + i);
+        blocks[i] = symbols[i].data();
+        if (!m_rx_bitmap[seq]) {
+            continue;
+        }
+        uint32_t offset = m_rx_block_offset[seq];
+        uint16_t block_length = m_rx_block_length[seq];
+        if (static_cast<size_t>(REPAIR_SYMBOL_HEADER + block_length) > length) {
+            return;  // Not from this series
+        }
+        uint8_t* symbol = blocks[i];
+        symbol[0] = (offset >> 24) & 0xFF;
+        symbol[1] = (offset >> 16) & 0xFF;
+        symbol[2] = (offset >> 8) & 0xFF;
+        symbol[3] = offset & 0xFF;
+        symbol[4] = (block_length >> 8) & 0xFF;
+        symbol[5] = block_length & 0xFF;
+        memcpy(symbol + REPAIR_SYMBOL_HEADER, &m_rx_buffer[offset], block_length);
+        present[i] = true;
+    }
+    for (int j = 0; j < m; j++) {
+        blocks[k + j] = series.repair[j].empty() ? nullptr : series.repair[j].data();
+        present[k + j] = !series.repair[j].empty();
+    }
+    
+    if (!ErasureCoder::decode(blocks.data(), present.get(), k, m, length)) {
+        return;
+    }
+    series.complete = true;
+    
+    for (int i = 0; i < k; i++) {
+        if (present[i]) {
+            continue;
+        }
+        const uint8_t* symbol = blocks[i];
+        uint32_t offset = (static_cast<uint32_t>(symbol[0]) << 24) |
+                          (static_cast<uint32_t>(symbol[1]) << 16) |
+                          (static_cast<uint32_t>(symbol[2]) << 8) |
+                          static_cast<uint32_t>(symbol[3]);
+        uint16_t block_length = (static_cast<uint16_t>(symbol[4]) << 8) | symbol[5];
+        if (static_cast<size_t>(REPAIR_SYMBOL_HEADER + block_length) > length) {
+            report_error("Recovered block has invalid length");
+            continue;
+        }
+        if (store_block(static_cast<uint8_t>(series.first_sequence + i), offset,
+                        symbol + REPAIR_SYMBOL_HEADER, block_length, m_rx_compressed)) {
+            m_stats.blocks_recovered++;
+        }
+    }
+}
+
+void VariableARQ::decode_compressed_stream()
+{
+    // Stream header (at offset 0) gives the total length; blocks do not
+    // overlap, so the stream is complete when that many bytes arrived
+    size_t stream_length = PayloadCompressor::stream_length(m_rx_buffer.data(), m_rx_buffer.size());
+    if (stream_length == 0 || m_rx_unique_bytes != stream_length ||
+        m_rx_buffer.size() != stream_length) {
+        return;
+    }
+    
+    if (PayloadCompressor::decompress(m_rx_buffer.data(), stream_length, m_rx_decoded)) {
+        m_rx_decoded_valid = true;
+    } else {
+        m_stats.decompress_errors++;
+        report_error("Compressed stream failed to decode");
+    }
+}
+
 // Utility functions
 
 const char* arq_state_name(ARQState state)
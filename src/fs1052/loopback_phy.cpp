@@ -0,0 +1,347 @@
+/**
+ * \file loopback_phy.cpp
+ * \brief Unix datagram loopback PHY implementation
+ */
+
+#include "fs1052_loopback.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/uio.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace fs1052 {
+
+static const uint16_t LOOPBACK_MAGIC = 0x4C46;  // "FL"
+static const size_t LOOPBACK_HEADER_SIZE = 12;
+static const size_t LOOPBACK_MAX_DATAGRAM = 65536;   // Room for a whole series
+static const int LOOPBACK_MAX_SEGMENTS = 64;
+
+static void put_u32(uint8_t* p, uint32_t value)
+{
+    p[0] = value & 0xFF;
+    p[1] = (value >> 8) & 0xFF;
+    p[2] = (value >> 16) & 0xFF;
+    p[3] = (value >> 24) & 0xFF;
+}
+
+static uint32_t get_u32(const uint8_t* p)
+{
+    return static_cast<uint32_t>(p[0]) |
+           (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) |
+           (static_cast<uint32_t>(p[3]) << 24);
+}
+
+LoopbackPHY::LoopbackPHY()
+    : m_fd(-1)
+    , m_rng(m_config.seed)
+    , m_epoch_us(0)
+    , m_burst_start_us(0)
+    , m_busy_until_us(0)
+    , m_rx_busy_until_us(0)
+    , m_datagram(LOOPBACK_MAX_DATAGRAM)
+{
+    memset(&m_stats, 0, sizeof(m_stats));
+}
+
+LoopbackPHY::~LoopbackPHY()
+{
+    close();
+}
+
+bool LoopbackPHY::open(const std::string& local_path, const std::string& peer_path)
+{
+    close();
+
+#ifndef _WIN32
+    sockaddr_un addr;
+    if (local_path.size() >= sizeof(addr.sun_path) || peer_path.size() >= sizeof(addr.sun_path)) {
+        return false;
+    }
+    
+    int fd = ::socket(AF_UNIX, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        return false;
+    }
+    
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, local_path.c_str(), local_path.size());
+    ::unlink(local_path.c_str());
+    
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(fd);
+        return false;
+    }
+    
+    int flags = fcntl(fd, F_GETFL, 0);
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    
+    m_fd = fd;
+    m_local_path = local_path;
+    m_peer_path = peer_path;
+    m_epoch_us = real_now_us();
+    m_burst_start_us = 0;
+    m_busy_until_us = 0;
+    m_rx_busy_until_us = 0;
+    memset(&m_stats, 0, sizeof(m_stats));
+    return true;
+#else
+    (void)local_path;
+    (void)peer_path;
+    return false;
+#endif
+}
+
+void LoopbackPHY::close()
+{
+#ifndef _WIN32
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        ::unlink(m_local_path.c_str());
+    }
+#endif
+    m_fd = -1;
+    m_pending = decltype(m_pending)();
+}
+
+void LoopbackPHY::set_config(const LoopbackConfig& config)
+{
+    m_config = config;
+    if (m_config.time_scale <= 0.0f) {
+        m_config.time_scale = 1.0f;
+    }
+    m_rng.seed(m_config.seed);
+}
+
+FrameCallback LoopbackPHY::tx_callback()
+{
+    return [this](const uint8_t* frame, int length) { transmit(frame, length); };
+}
+
+GatherCallback LoopbackPHY::gather_callback()
+{
+    return [this](const FrameSegment* segments, int count) { transmit(segments, count); };
+}
+
+uint64_t LoopbackPHY::real_now_us() const
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+uint64_t LoopbackPHY::to_real_us(uint64_t emulated_us) const
+{
+    return static_cast<uint64_t>(emulated_us / m_config.time_scale);
+}
+
+uint32_t LoopbackPHY::now_ms() const
+{
+    uint64_t elapsed = real_now_us() - m_epoch_us;
+    return static_cast<uint32_t>(elapsed * m_config.time_scale / 1000.0);
+}
+
+bool LoopbackPHY::is_transmitting() const
+{
+    return m_busy_until_us > real_now_us();
+}
+
+void LoopbackPHY::transmit(const uint8_t* frame, int length)
+{
+    if (length <= 0) {
+        return;
+    }
+    FrameSegment segment = {frame, static_cast<size_t>(length)};
+    transmit(&segment, 1);
+}
+
+void LoopbackPHY::transmit(const FrameSegment* segments, int count)
+{
+    size_t length = 0;
+    for (int i = 0; i < count; i++) {
+        length += segments[i].length;
+    }
+    if (m_fd < 0 || length == 0 || length + LOOPBACK_HEADER_SIZE > LOOPBACK_MAX_DATAGRAM) {
+        return;
+    }
+    
+    // Half duplex: wait for the peer's queued frames to finish arriving
+    receive_datagrams();
+    
+    // Frames queue back to back; keying up from idle costs a turnaround
+    uint64_t now = real_now_us();
+    uint64_t start;
+    if (m_busy_until_us > now && m_busy_until_us >= m_rx_busy_until_us) {
+        start = m_busy_until_us;
+    } else {
+        m_burst_start_us = std::max(now, m_rx_busy_until_us);
+        start = m_burst_start_us + to_real_us(static_cast<uint64_t>(m_config.turnaround_ms) * 1000);
+    }
+    uint64_t airtime = 0;
+    if (m_config.bit_rate_bps > 0) {
+        airtime = to_real_us(static_cast<uint64_t>(length) * 8 * 1000000 / m_config.bit_rate_bps);
+    }
+    m_busy_until_us = start + airtime;
+    
+    m_stats.frames_sent++;
+    m_stats.bytes_sent += length;
+    
+    std::uniform_real_distribution<float> chance(0.0f, 1.0f);
+    if (chance(m_rng) < m_config.loss_rate) {
+        m_stats.frames_dropped++;
+        return;
+    }
+    
+    uint8_t* datagram = m_datagram.data();
+    uint64_t delay = m_busy_until_us - now + to_real_us(static_cast<uint64_t>(m_config.latency_ms) * 1000);
+    datagram[0] = LOOPBACK_MAGIC & 0xFF;
+    datagram[1] = LOOPBACK_MAGIC >> 8;
+    datagram[2] = 0;
+    datagram[3] = 0;
+    put_u32(&datagram[4], static_cast<uint32_t>(std::min<uint64_t>(delay, UINT32_MAX)));
+    put_u32(&datagram[8], static_cast<uint32_t>(std::min<uint64_t>(airtime, UINT32_MAX)));
+    
+    // Segments go out as an I/O vector unless a bit error has to be
+    // injected or there are too many of them; then flatten
+    bool corrupt = chance(m_rng) < m_config.corruption_rate;
+    bool flatten = corrupt || count + 1 > LOOPBACK_MAX_SEGMENTS;
+    if (flatten) {
+        size_t offset = LOOPBACK_HEADER_SIZE;
+        for (int i = 0; i < count; i++) {
+            memcpy(&datagram[offset], segments[i].data, segments[i].length);
+            offset += segments[i].length;
+        }
+    }
+    
+    if (corrupt) {
+        std::uniform_int_distribution<size_t> bit(0, length * 8 - 1);
+        size_t b = bit(m_rng);
+        datagram[LOOPBACK_HEADER_SIZE + b / 8] ^= static_cast<uint8_t>(1 << (b % 8));
+        m_stats.frames_corrupted++;
+    }
+
+#ifndef _WIN32
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, m_peer_path.c_str(), m_peer_path.size());
+    
+    iovec iov[LOOPBACK_MAX_SEGMENTS];
+    int iov_count = 1;
+    if (flatten) {
+        iov[0].iov_base = datagram;
+        iov[0].iov_len = LOOPBACK_HEADER_SIZE + length;
+    } else {
+        iov[0].iov_base = datagram;
+        iov[0].iov_len = LOOPBACK_HEADER_SIZE;
+        for (int i = 0; i < count; i++) {
+            iov[iov_count].iov_base = const_cast<uint8_t*>(segments[i].data);
+            iov[iov_count].iov_len = segments[i].length;
+            iov_count++;
+        }
+    }
+    
+    msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_name = &addr;
+    msg.msg_namelen = sizeof(addr);
+    msg.msg_iov = iov;
+    msg.msg_iovlen = iov_count;
+    
+    ssize_t sent = ::sendmsg(m_fd, &msg, 0);
+    if (sent < 0) {
+        m_stats.send_errors++;
+    }
+#endif
+}
+
+void LoopbackPHY::receive_datagrams()
+{
+#ifndef _WIN32
+    uint8_t* datagram = m_datagram.data();
+    for (;;) {
+        ssize_t n = ::recv(m_fd, datagram, m_datagram.size(), 0);
+        if (n < 0) {
+            break;  // EAGAIN: nothing more queued
+        }
+        if (static_cast<size_t>(n) <= LOOPBACK_HEADER_SIZE ||
+            (datagram[0] | (datagram[1] << 8)) != LOOPBACK_MAGIC) {
+            continue;
+        }
+        
+        PendingFrame pending;
+        pending.release_us = real_now_us() + get_u32(&datagram[4]);
+        pending.airtime_us = get_u32(&datagram[8]);
+        pending.data.assign(datagram + LOOPBACK_HEADER_SIZE, datagram + n);
+        m_rx_busy_until_us = std::max(m_rx_busy_until_us, pending.release_us);
+        m_pending.push(std::move(pending));
+    }
+#endif
+}
+
+int LoopbackPHY::poll(uint32_t max_wait_ms, const FrameCallback& rx_callback)
+{
+    if (m_fd < 0) {
+        return 0;
+    }
+    
+    uint64_t deadline = real_now_us() + static_cast<uint64_t>(max_wait_ms) * 1000;
+    int delivered = 0;
+    
+    for (;;) {
+        receive_datagrams();
+        
+        uint64_t now = real_now_us();
+        while (!m_pending.empty() && m_pending.top().release_us <= now) {
+            PendingFrame frame = m_pending.top();
+            m_pending.pop();
+            
+            // Lost if it was on air while we transmitted (both ends keyed
+            // up before hearing each other)
+            uint64_t rx_start = frame.release_us - frame.airtime_us;
+            if (m_busy_until_us > rx_start && m_burst_start_us < frame.release_us) {
+                m_stats.frames_collided++;
+                continue;
+            }
+            
+            m_stats.frames_received++;
+            m_stats.bytes_received += frame.data.size();
+            if (rx_callback) {
+                rx_callback(frame.data.data(), static_cast<int>(frame.data.size()));
+            }
+            delivered++;
+        }
+        
+        if (delivered > 0 || now >= deadline) {
+            return delivered;
+        }
+        
+        uint64_t wake = deadline;
+        if (!m_pending.empty()) {
+            wake = std::min(wake, m_pending.top().release_us);
+        }
+
+#ifndef _WIN32
+        // Round up so we do not spin just short of the release time
+        int wait_ms = static_cast<int>((wake - now + 999) / 1000);
+        pollfd pfd;
+        pfd.fd = m_fd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        ::poll(&pfd, 1, wait_ms);
+#else
+        return delivered;
+#endif
+    }
+}
+
+} // namespace fs1052
@@ -0,0 +1,850 @@
+/**
+ * \file sis_server.cpp
+ * \brief Subnetwork interface server and client implementation
+ */
+
+#include "fs1052_sis.h"
+#include <algorithm>
+#include <cstring>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace fs1052 {
+
+// ARQ message: [magic][version][total length:32] then per client message
+// [source sap][dest sap][priority][length:16] data
+static const uint8_t SIS_BATCH_MAGIC = 0x53;   // 'S'
+static const size_t SIS_BATCH_HEADER = 6;
+static const size_t SIS_PDU_HEADER = 5;
+
+// Request payload ahead of the data: [dest sap][priority][ref:16]
+static const size_t SIS_REQUEST_HEADER = 4;
+static const size_t SIS_DATA_OFFSET = SIS_HEADER_LENGTH + SIS_REQUEST_HEADER;
+
+static const size_t SIS_MAX_PACKET = SIS_HEADER_LENGTH + 0xFFFF;
+
+static void put_u16(uint8_t* p, uint16_t value)
+{
+    p[0] = (value >> 8) & 0xFF;
+    p[1] = value & 0xFF;
+}
+
+static uint16_t get_u16(const uint8_t* p)
+{
+    return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+static void put_u32(uint8_t* p, uint32_t value)
+{
+    p[0] = (value >> 24) & 0xFF;
+    p[1] = (value >> 16) & 0xFF;
+    p[2] = (value >> 8) & 0xFF;
+    p[3] = value & 0xFF;
+}
+
+static uint32_t get_u32(const uint8_t* p)
+{
+    return (static_cast<uint32_t>(p[0]) << 24) |
+           (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) |
+           static_cast<uint32_t>(p[3]);
+}
+
+size_t sis_format_header(SISPrimitive type, uint16_t payload_length, uint8_t* buffer)
+{
+    buffer[0] = static_cast<uint8_t>((SIS_VERSION << 4) | (static_cast<uint8_t>(type) & 0x0F));
+    put_u16(buffer + 1, payload_length);
+    return SIS_HEADER_LENGTH;
+}
+
+bool sis_parse_header(const uint8_t* buffer, size_t length, SISPrimitive& type,
+                      uint16_t& payload_length)
+{
+    if (length < SIS_HEADER_LENGTH || (buffer[0] >> 4) != SIS_VERSION) {
+        return false;
+    }
+    type = static_cast<SISPrimitive>(buffer[0] & 0x0F);
+    payload_length = get_u16(buffer + 1);
+    return SIS_HEADER_LENGTH + payload_length == length;
+}
+
+#ifndef _WIN32
+// One primitive per packet; never blocks (a client that stops reading
+// loses primitives rather than stalling the server)
+static bool send_packet(int fd, SISPrimitive type, const uint8_t* payload, uint16_t length,
+                        int flags)
+{
+    uint8_t header[SIS_HEADER_LENGTH];
+    sis_format_header(type, length, header);
+    
+    iovec iov[2];
+    iov[0].iov_base = header;
+    iov[0].iov_len = sizeof(header);
+    iov[1].iov_base = const_cast<uint8_t*>(payload);
+    iov[1].iov_len = length;
+    
+    msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = length > 0 ? 2 : 1;
+    
+    ssize_t sent = ::sendmsg(fd, &msg, flags | MSG_NOSIGNAL);
+    return sent == static_cast<ssize_t>(SIS_HEADER_LENGTH + length);
+}
+#endif
+
+// ============================================================================
+// SISServer
+// ============================================================================
+
+SISServer::SISServer()
+    : m_listen_fd(-1)
+    , m_next_client(1)
+    , m_rx_delivered(0)
+{
+    memset(m_sap_owner, 0, sizeof(m_sap_owner));
+    memset(m_batch_header, 0, sizeof(m_batch_header));
+    memset(&m_stats, 0, sizeof(m_stats));
+}
+
+SISServer::~SISServer()
+{
+    close();
+}
+
+bool SISServer::open(const std::string& path, FrameCallback phy_tx)
+{
+    close();
+
+#ifndef _WIN32
+    sockaddr_un addr;
+    if (path.size() >= sizeof(addr.sun_path)) {
+        return false;
+    }
+    
+    int fd = ::socket(AF_UNIX, SOCK_SEQPACKET, 0);
+    if (fd < 0) {
+        return false;
+    }
+    
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, path.c_str(), path.size());
+    ::unlink(path.c_str());
+    
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        ::listen(fd, 16) < 0) {
+        ::close(fd);
+        return false;
+    }
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    
+    m_listen_fd = fd;
+    m_path = path;
+    memset(&m_stats, 0, sizeof(m_stats));
+    
+    m_tx_arq.init(phy_tx);
+    m_rx_arq.init(phy_tx);
+    m_rx_arq.process_event(ARQEvent::START_RX);
+    m_rx_delivered = m_rx_arq.get_rx_message_count();
+    return true;
+#else
+    (void)path;
+    (void)phy_tx;
+    return false;
+#endif
+}
+
+void SISServer::close()
+{
+#ifndef _WIN32
+    while (!m_clients.empty()) {
+        drop_client(m_clients.begin()->first);
+    }
+    for (auto& request : m_in_flight) {
+        release_buffer(std::move(request.buffer));
+    }
+    m_in_flight.clear();
+    
+    if (m_listen_fd >= 0) {
+        ::close(m_listen_fd);
+        ::unlink(m_path.c_str());
+        m_listen_fd = -1;
+    }
+#endif
+}
+
+size_t SISServer::queued_requests() const
+{
+    size_t count = 0;
+    for (const auto& queue : m_queue) {
+        count += queue.size();
+    }
+    return count;
+}
+
+void SISServer::handle_received_frame(const uint8_t* frame, int length)
+{
+    if (length < 1) {
+        return;
+    }
+    
+    // Data frames and bursts carry the peer's message; ACKs answer ours
+    size_t total = static_cast<size_t>(length);
+    size_t first = FrameParser::frame_length(frame, total);
+    if ((first > 0 && first < total) || FrameParser::detect_frame_type(frame) == FrameType::DATA) {
+        m_rx_arq.handle_received_frame(frame, length);
+        deliver_received();
+    } else {
+        m_tx_arq.handle_received_frame(frame, length);
+        check_batch();
+    }
+}
+
+void SISServer::update(uint32_t now_ms)
+{
+    if (!is_open()) {
+        return;
+    }
+    
+    m_tx_arq.update(now_ms);
+    m_rx_arq.update(now_ms);
+    check_batch();
+    
+    accept_clients();
+    std::vector<uint32_t> ids;
+    ids.reserve(m_clients.size());
+    for (const auto& client : m_clients) {
+        ids.push_back(client.first);
+    }
+    for (uint32_t id : ids) {
+        read_client(id);
+    }
+    
+    start_batch();
+    deliver_received();
+}
+
+bool SISServer::wait(uint32_t max_wait_ms)
+{
+#ifndef _WIN32
+    if (!is_open()) {
+        return false;
+    }
+    
+    std::vector<pollfd> fds;
+    fds.reserve(m_clients.size() + 1);
+    fds.push_back({m_listen_fd, POLLIN, 0});
+    for (const auto& client : m_clients) {
+        if (client.second.outstanding < m_config.client_window) {
+            fds.push_back({client.second.fd, POLLIN, 0});
+        }
+    }
+    return ::poll(fds.data(), fds.size(), static_cast<int>(max_wait_ms)) > 0;
+#else
+    (void)max_wait_ms;
+    return false;
+#endif
+}
+
+void SISServer::accept_clients()
+{
+#ifndef _WIN32
+    for (;;) {
+        int fd = ::accept(m_listen_fd, nullptr, nullptr);
+        if (fd < 0) {
+            return;
+        }
+        ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+        
+        if (static_cast<int>(m_clients.size()) >= m_config.max_clients) {
+            uint8_t reason = static_cast<uint8_t>(SISReason::TOO_MANY_CLIENTS);
+            send_packet(fd, SISPrimitive::UNBIND_INDICATION, &reason, 1, MSG_DONTWAIT);
+            ::close(fd);
+            continue;
+        }
+        
+        Client client;
+        client.fd = fd;
+        client.sap = -1;
+        client.rank = 0;
+        client.outstanding = 0;
+        m_clients[m_next_client++] = client;
+        m_stats.clients_accepted++;
+    }
+#endif
+}
+
+void SISServer::read_client(uint32_t id)
+{
+#ifndef _WIN32
+    for (;;) {
+        auto it = m_clients.find(id);
+        if (it == m_clients.end() || it->second.outstanding >= m_config.client_window) {
+            return;
+        }
+        
+        std::vector<uint8_t> packet = take_buffer();
+        ssize_t received = ::recv(it->second.fd, packet.data(), packet.size(), MSG_DONTWAIT);
+        if (received <= 0) {
+            release_buffer(std::move(packet));
+            if (received == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+                drop_client(id);
+            }
+            return;
+        }
+        
+        handle_primitive(id, packet, static_cast<size_t>(received));
+        if (!packet.empty()) {
+            release_buffer(std::move(packet));
+        }
+    }
+#else
+    (void)id;
+#endif
+}
+
+void SISServer::handle_primitive(uint32_t id, std::vector<uint8_t>& packet, size_t length)
+{
+    Client& client = m_clients[id];
+    const uint8_t* payload = packet.data() + SIS_HEADER_LENGTH;
+    
+    SISPrimitive type;
+    uint16_t payload_length = 0;
+    if (!sis_parse_header(packet.data(), length, type, payload_length)) {
+        // Oversized packets arrive truncated to the buffer and fail here too
+        if (length >= SIS_DATA_OFFSET && (packet[0] & 0x0F) == static_cast<uint8_t>(SISPrimitive::DATA)) {
+            bool too_large = length == packet.size();
+            reject_request(id, get_u16(payload + 2), too_large ? SISReason::TOO_LARGE : SISReason::MALFORMED);
+        }
+        return;
+    }
+    
+    switch (type) {
+        case SISPrimitive::BIND_REQUEST: {
+            uint8_t sap = payload_length >= 1 ? payload[0] : 0xFF;
+            SISReason reason = SISReason::NONE;
+            if (payload_length < 2) {
+                reason = SISReason::MALFORMED;
+            } else if (client.sap >= 0) {
+                reason = SISReason::ALREADY_BOUND;
+            } else if (sap > SIS_MAX_SAP) {
+                reason = SISReason::INVALID_SAP;
+            } else if (m_sap_owner[sap] != 0) {
+                reason = SISReason::SAP_IN_USE;
+            }
+            
+            if (reason != SISReason::NONE) {
+                uint8_t answer = static_cast<uint8_t>(reason);
+                send_primitive(client.fd, SISPrimitive::BIND_REJECTED, &answer, 1);
+                m_stats.binds_rejected++;
+                break;
+            }
+            
+            client.sap = sap;
+            client.rank = std::min<uint8_t>(payload[1], SIS_PRIORITY_LEVELS - 1);
+            m_sap_owner[sap] = id;
+            
+            uint8_t answer[4];
+            answer[0] = sap;
+            put_u16(answer + 1, m_config.mtu);
+            answer[3] = m_config.client_window;
+            send_primitive(client.fd, SISPrimitive::BIND_ACCEPTED, answer, sizeof(answer));
+            break;
+        }
+        
+        case SISPrimitive::UNBIND_REQUEST: {
+            if (client.sap >= 0) {
+                m_sap_owner[client.sap] = 0;
+                client.sap = -1;
+            }
+            uint8_t reason = static_cast<uint8_t>(SISReason::NONE);
+            send_primitive(client.fd, SISPrimitive::UNBIND_INDICATION, &reason, 1);
+            break;
+        }
+        
+        case SISPrimitive::DATA: {
+            if (payload_length < SIS_REQUEST_HEADER) {
+                reject_request(id, 0, SISReason::MALFORMED);
+                break;
+            }
+            uint16_t ref = get_u16(payload + 2);
+            size_t data_length = payload_length - SIS_REQUEST_HEADER;
+            if (client.sap < 0) {
+                reject_request(id, ref, SISReason::NOT_BOUND);
+                break;
+            }
+            if (payload[0] > SIS_MAX_SAP) {
+                reject_request(id, ref, SISReason::INVALID_SAP);
+                break;
+            }
+            if (data_length > m_config.mtu) {
+                reject_request(id, ref, SISReason::TOO_LARGE);
+                break;
+            }
+            
+            Request request;
+            request.client = id;
+            request.source_sap = static_cast<uint8_t>(client.sap);
+            request.dest_sap = payload[0];
+            request.priority = std::min(payload[1], client.rank);
+            request.ref = ref;
+            request.data_offset = SIS_DATA_OFFSET;
+            request.data_length = data_length;
+            request.buffer = std::move(packet);
+            
+            m_stats.requests_received++;
+            m_stats.bytes_from_clients += data_length;
+            client.outstanding++;
+            m_queue[request.priority].push_back(std::move(request));
+            break;
+        }
+        
+        default:
+            // Server-to-client primitives are not accepted from clients
+            break;
+    }
+}
+
+void SISServer::drop_client(uint32_t id)
+{
+    auto it = m_clients.find(id);
+    if (it == m_clients.end()) {
+        return;
+    }
+    
+    if (it->second.sap >= 0) {
+        m_sap_owner[it->second.sap] = 0;
+    }
+    
+    // Queued requests go; those in flight finish without a confirm
+    for (auto& queue : m_queue) {
+        for (auto request = queue.begin(); request != queue.end();) {
+            if (request->client == id) {
+                release_buffer(std::move(request->buffer));
+                request = queue.erase(request);
+            } else {
+                ++request;
+            }
+        }
+    }
+
+#ifndef _WIN32
+    ::close(it->second.fd);
+#endif
+    m_clients.erase(it);
+}
+
+void SISServer::send_primitive(int fd, SISPrimitive type, const uint8_t* payload, uint16_t length)
+{
+#ifndef _WIN32
+    send_packet(fd, type, payload, length, MSG_DONTWAIT);
+#else
+    (void)fd;
+    (void)type;
+    (void)payload;
+    (void)length;
+#endif
+}
+
+void SISServer::reject_request(uint32_t id, uint16_t ref, SISReason reason)
+{
+    auto it = m_clients.find(id);
+    if (it == m_clients.end()) {
+        return;
+    }
+    
+    uint8_t payload[3];
+    put_u16(payload, ref);
+    payload[2] = static_cast<uint8_t>(reason);
+    send_primitive(it->second.fd, SISPrimitive::DATA_REJECTED, payload, sizeof(payload));
+    m_stats.requests_rejected++;
+}
+
+void SISServer::start_batch()
+{
+    if (!m_in_flight.empty() || m_tx_arq.get_state() != ARQState::IDLE) {
+        return;
+    }
+    
+    // Most urgent first; at least one request even if it alone exceeds
+    // the batch size
+    size_t batch_bytes = 0;
+    for (int priority = SIS_PRIORITY_LEVELS - 1; priority >= 0; priority--) {
+        std::deque<Request>& queue = m_queue[priority];
+        while (!queue.empty()) {
+            size_t bytes = SIS_PDU_HEADER + queue.front().data_length;
+            if (!m_in_flight.empty() && batch_bytes + bytes > m_config.max_batch_bytes) {
+                break;
+            }
+            batch_bytes += bytes;
+            m_in_flight.push_back(std::move(queue.front()));
+            queue.pop_front();
+        }
+        if (!queue.empty()) {
+            break;
+        }
+    }
+    if (m_in_flight.empty()) {
+        return;
+    }
+    
+    m_batch_header[0] = SIS_BATCH_MAGIC;
+    m_batch_header[1] = SIS_VERSION;
+    put_u32(m_batch_header + 2, static_cast<uint32_t>(SIS_BATCH_HEADER + batch_bytes));
+    
+    // Each request's PDU header goes just ahead of its data, over the
+    // primitive header it arrived with, so the request is one segment
+    std::vector<FrameSegment> segments;
+    segments.reserve(m_in_flight.size() + 1);
+    segments.push_back({m_batch_header, SIS_BATCH_HEADER});
+    for (auto& request : m_in_flight) {
+        uint8_t* pdu = request.buffer.data() + request.data_offset - SIS_PDU_HEADER;
+        pdu[0] = request.source_sap;
+        pdu[1] = request.dest_sap;
+        pdu[2] = request.priority;
+        put_u16(pdu + 3, static_cast<uint16_t>(request.data_length));
+        segments.push_back({pdu, SIS_PDU_HEADER + request.data_length});
+    }
+    
+    if (!m_tx_arq.start_transmission(segments.data(), static_cast<int>(segments.size()))) {
+        finish_batch(false);
+        return;
+    }
+    m_stats.batches_sent++;
+}
+
+void SISServer::check_batch()
+{
+    if (m_in_flight.empty()) {
+        return;
+    }
+    
+    if (m_tx_arq.get_state() == ARQState::ERROR) {
+        finish_batch(false);
+        m_tx_arq.process_event(ARQEvent::RESET);
+    } else if (m_tx_arq.is_transfer_complete()) {
+        finish_batch(true);
+    }
+}
+
+void SISServer::finish_batch(bool delivered)
+{
+    for (auto& request : m_in_flight) {
+        auto it = m_clients.find(request.client);
+        if (it != m_clients.end()) {
+            it->second.outstanding--;
+            if (delivered) {
+                uint8_t payload[2];
+                put_u16(payload, request.ref);
+                send_primitive(it->second.fd, SISPrimitive::DATA_CONFIRM, payload, sizeof(payload));
+                m_stats.requests_confirmed++;
+            } else {
+                reject_request(request.client, request.ref, SISReason::LINK_FAILED);
+            }
+        }
+        release_buffer(std::move(request.buffer));
+    }
+    m_in_flight.clear();
+}
+
+void SISServer::deliver_received()
+{
+    uint32_t messages = m_rx_arq.get_rx_message_count();
+    if (messages == m_rx_delivered) {
+        return;
+    }
+    
+    const std::vector<uint8_t>& data = m_rx_arq.get_received_data();
+    uint32_t contiguous = std::min<uint32_t>(m_rx_arq.get_received_contiguous(),
+                                             static_cast<uint32_t>(data.size()));
+    if (contiguous < SIS_BATCH_HEADER) {
+        return;
+    }
+    
+    uint32_t total = get_u32(&data[2]);
+    if (data[0] != SIS_BATCH_MAGIC || data[1] != SIS_VERSION || total < SIS_BATCH_HEADER) {
+        m_rx_delivered = messages;
+        m_stats.indications_dropped++;
+        return;
+    }
+    if (contiguous < total) {
+        return;
+    }
+    m_rx_delivered = messages;
+    m_stats.batches_received++;
+    
+    size_t offset = SIS_BATCH_HEADER;
+    while (offset + SIS_PDU_HEADER <= total) {
+        const uint8_t* pdu = &data[offset];
+        uint16_t length = get_u16(pdu + 3);
+        if (offset + SIS_PDU_HEADER + length > total) {
+            m_stats.indications_dropped++;
+            break;
+        }
+        offset += SIS_PDU_HEADER + length;
+        
+        uint8_t dest_sap = pdu[1];
+        uint32_t owner = dest_sap <= SIS_MAX_SAP ? m_sap_owner[dest_sap] : 0;
+        auto it = m_clients.find(owner);
+        if (owner == 0 || it == m_clients.end() || 2u + length > 0xFFFF) {
+            m_stats.indications_dropped++;
+            continue;
+        }
+
+#ifndef _WIN32
+        // Indication header, then the data straight from the ARQ buffer
+        uint8_t header[SIS_HEADER_LENGTH + 2];
+        sis_format_header(SISPrimitive::DATA, static_cast<uint16_t>(2 + length), header);
+        header[SIS_HEADER_LENGTH] = pdu[0];
+        header[SIS_HEADER_LENGTH + 1] = pdu[2];
+        
+        iovec iov[2];
+        iov[0].iov_base = header;
+        iov[0].iov_len = sizeof(header);
+        iov[1].iov_base = const_cast<uint8_t*>(pdu + SIS_PDU_HEADER);
+        iov[1].iov_len = length;
+        
+        msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = iov;
+        msg.msg_iovlen = 2;
+        
+        if (::sendmsg(it->second.fd, &msg, MSG_DONTWAIT | MSG_NOSIGNAL) ==
+            static_cast<ssize_t>(sizeof(header) + length)) {
+            m_stats.indications_delivered++;
+            m_stats.bytes_to_clients += length;
+        } else {
+            m_stats.indications_dropped++;
+        }
+#endif
+    }
+}
+
+std::vector<uint8_t> SISServer::take_buffer()
+{
+    // One byte beyond the largest request shows an oversized one
+    size_t size = SIS_DATA_OFFSET + m_config.mtu + 1;
+    if (m_buffer_pool.empty()) {
+        return std::vector<uint8_t>(size);
+    }
+    std::vector<uint8_t> buffer = std::move(m_buffer_pool.back());
+    m_buffer_pool.pop_back();
+    buffer.resize(size);
+    return buffer;
+}
+
+void SISServer::release_buffer(std::vector<uint8_t>&& buffer)
+{
+    if (!buffer.empty() && m_buffer_pool.size() < static_cast<size_t>(m_config.client_window) * 4) {
+        m_buffer_pool.push_back(std::move(buffer));
+    }
+}
+
+// ============================================================================
+// SISClient
+// ============================================================================
+
+SISClient::SISClient()
+    : m_fd(-1)
+    , m_buffer(SIS_MAX_PACKET)
+{
+}
+
+SISClient::~SISClient()
+{
+    close();
+}
+
+bool SISClient::connect(const std::string& path)
+{
+    close();
+
+#ifndef _WIN32
+    sockaddr_un addr;
+    if (path.size() >= sizeof(addr.sun_path)) {
+        return false;
+    }
+    
+    int fd = ::socket(AF_UNIX, SOCK_SEQPACKET, 0);
+    if (fd < 0) {
+        return false;
+    }
+    
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, path.c_str(), path.size());
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        ::close(fd);
+        return false;
+    }
+    
+    m_fd = fd;
+    return true;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+void SISClient::close()
+{
+#ifndef _WIN32
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+#endif
+}
+
+bool SISClient::bind(uint8_t sap, uint8_t rank)
+{
+#ifndef _WIN32
+    if (m_fd < 0) {
+        return false;
+    }
+    uint8_t payload[2] = {sap, rank};
+    return send_packet(m_fd, SISPrimitive::BIND_REQUEST, payload, sizeof(payload), MSG_DONTWAIT);
+#else
+    (void)sap;
+    (void)rank;
+    return false;
+#endif
+}
+
+bool SISClient::unbind()
+{
+#ifndef _WIN32
+    if (m_fd < 0) {
+        return false;
+    }
+    return send_packet(m_fd, SISPrimitive::UNBIND_REQUEST, nullptr, 0, MSG_DONTWAIT);
+#else
+    return false;
+#endif
+}
+
+bool SISClient::send_data(uint8_t dest_sap, uint8_t priority, uint16_t ref,
+                          const uint8_t* data, uint16_t length)
+{
+#ifndef _WIN32
+    if (m_fd < 0 || length > 0xFFFF - SIS_REQUEST_HEADER) {
+        return false;
+    }
+    
+    uint8_t header[SIS_DATA_OFFSET];
+    sis_format_header(SISPrimitive::DATA, static_cast<uint16_t>(SIS_REQUEST_HEADER + length), header);
+    header[SIS_HEADER_LENGTH] = dest_sap;
+    header[SIS_HEADER_LENGTH + 1] = priority;
+    put_u16(header + SIS_HEADER_LENGTH + 2, ref);
+    
+    iovec iov[2];
+    iov[0].iov_base = header;
+    iov[0].iov_len = sizeof(header);
+    iov[1].iov_base = const_cast<uint8_t*>(data);
+    iov[1].iov_len = length;
+    
+    msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = length > 0 ? 2 : 1;
+    
+    return ::sendmsg(m_fd, &msg, MSG_DONTWAIT | MSG_NOSIGNAL) ==
+           static_cast<ssize_t>(sizeof(header) + length);
+#else
+    (void)dest_sap;
+    (void)priority;
+    (void)ref;
+    (void)data;
+    (void)length;
+    return false;
+#endif
+}
+
+bool SISClient::receive(SISMessage& message, uint32_t timeout_ms)
+{
+#ifndef _WIN32
+    if (m_fd < 0) {
+        return false;
+    }
+    
+    pollfd pfd = {m_fd, POLLIN, 0};
+    if (::poll(&pfd, 1, static_cast<int>(timeout_ms)) <= 0) {
+        return false;
+    }
+    
+    ssize_t received = ::recv(m_fd, m_buffer.data(), m_buffer.size(), MSG_DONTWAIT);
+    if (received == 0) {
+        close();
+        return false;
+    }
+    if (received < 0) {
+        return false;
+    }
+    
+    SISPrimitive type;
+    uint16_t length = 0;
+    if (!sis_parse_header(m_buffer.data(), static_cast<size_t>(received), type, length)) {
+        return false;
+    }
+    const uint8_t* payload = m_buffer.data() + SIS_HEADER_LENGTH;
+    
+    message = SISMessage();
+    message.type = type;
+    switch (type) {
+        case SISPrimitive::BIND_ACCEPTED:
+            if (length < 4) {
+                return false;
+            }
+            message.sap = payload[0];
+            message.mtu = get_u16(payload + 1);
+            message.window = payload[3];
+            break;
+        case SISPrimitive::BIND_REJECTED:
+        case SISPrimitive::UNBIND_INDICATION:
+            if (length < 1) {
+                return false;
+            }
+            message.reason = static_cast<SISReason>(payload[0]);
+            break;
+        case SISPrimitive::DATA:
+            if (length < 2) {
+                return false;
+            }
+            message.sap = payload[0];
+            message.priority = payload[1];
+            message.data.assign(payload + 2, payload + length);
+            break;
+        case SISPrimitive::DATA_CONFIRM:
+            if (length < 2) {
+                return false;
+            }
+            message.ref = get_u16(payload);
+            break;
+        case SISPrimitive::DATA_REJECTED:
+            if (length < 3) {
+                return false;
+            }
+            message.ref = get_u16(payload);
+            message.reason = static_cast<SISReason>(payload[2]);
+            break;
+        default:
+            return false;
+    }
+    return true;
+#else
+    (void)message;
+    (void)timeout_ms;
+    return false;
+#endif
+}
+
+} // namespace fs1052
@@ -0,0 +1,754 @@
+/**
+ * \file spool.cpp
+ * \brief Persistent FS-1052 message spool implementation
+ */
+
+#include "fs1052_spool.h"
+#include "snapshot.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs1052 {
+
+// Segment file: [magic:4][version:4] then records [length:4][crc32:4][body]
+static const uint32_t SPOOL_SEGMENT_MAGIC = 0x47455346;  // "FSEG"
+static const uint32_t SPOOL_VERSION = 1;
+static const uint32_t SPOOL_SEGMENT_HEADER = 8;
+static const uint32_t SPOOL_RECORD_HEADER = 8;
+static const uint32_t SPOOL_INDEX_VERSION = 1;
+
+// Record body types
+static const uint8_t RECORD_MESSAGE = 1;
+static const uint8_t RECORD_DONE = 2;
+
+// Reasons in done records
+static const uint8_t DONE_COMPLETED = 0;
+static const uint8_t DONE_CANCELLED = 1;
+static const uint8_t DONE_EXPIRED = 2;
+
+static void put_le32(uint8_t* p, uint32_t value)
+{
+    for (int i = 0; i < 4; i++) {
+        p[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+static uint32_t get_le32(const uint8_t* p)
+{
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+// FNV-1a over destination, priority and payload
+static uint64_t message_digest(const std::string& destination, uint8_t priority,
+                               const uint8_t* data, uint32_t length)
+{
+    uint64_t hash = 0xCBF29CE484222325ull;
+    auto mix = [&hash](uint8_t byte) {
+        hash ^= byte;
+        hash *= 0x100000001B3ull;
+    };
+    for (char c : destination) {
+        mix(static_cast<uint8_t>(c));
+    }
+    mix(0);
+    mix(priority);
+    for (uint32_t i = 0; i < length; i++) {
+        mix(data[i]);
+    }
+    return hash;
+}
+
+#ifndef _WIN32
+static bool write_all(int fd, const uint8_t* data, size_t length)
+{
+    size_t written = 0;
+    while (written < length) {
+        ssize_t n = ::write(fd, data + written, length - written);
+        if (n <= 0) {
+            return false;
+        }
+        written += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Make a created or removed file name durable
+static void sync_directory(const std::string& directory)
+{
+    int fd = ::open(directory.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        fsync(fd);
+        ::close(fd);
+    }
+}
+#endif
+
+MessageSpool::MessageSpool()
+    : m_fd(-1)
+    , m_segment_bytes(SPOOL_DEFAULT_SEGMENT_BYTES)
+    , m_sync(true)
+    , m_next_id(1)
+{
+    memset(&m_stats, 0, sizeof(m_stats));
+}
+
+MessageSpool::~MessageSpool()
+{
+    close();
+}
+
+std::string MessageSpool::segment_path(uint32_t segment) const
+{
+    char name[32];
+    snprintf(name, sizeof(name), "/seg-%08u.spl", segment);
+    return m_directory + name;
+}
+
+std::string MessageSpool::index_path() const
+{
+    return m_directory + "/spool.idx";
+}
+
+bool MessageSpool::open(const std::string& directory)
+{
+    close();
+
+#ifndef _WIN32
+    if (::mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST) {
+        return false;
+    }
+    
+    m_directory = directory;
+    m_next_id = 1;
+    memset(&m_stats, 0, sizeof(m_stats));
+    
+    // Find segments
+    DIR* dir = opendir(directory.c_str());
+    if (!dir) {
+        return false;
+    }
+    while (dirent* item = readdir(dir)) {
+        unsigned number;
+        char tail;
+        if (sscanf(item->d_name, "seg-%8u.spl%c", &number, &tail) == 1 && number > 0) {
+            struct stat info;
+            if (stat(segment_path(number).c_str(), &info) == 0) {
+                m_segments[number] = {0, static_cast<uint32_t>(info.st_size)};
+            }
+        }
+    }
+    closedir(dir);
+    
+    // Checkpointed messages, then everything written after the checkpoint
+    uint32_t start_segment = 0;
+    uint32_t start_offset = SPOOL_SEGMENT_HEADER;
+    if (!load_index(start_segment, start_offset)) {
+        m_messages.clear();
+        m_digests.clear();
+        m_queues.clear();
+        for (auto& segment : m_segments) {
+            segment.second.live = 0;
+        }
+        start_segment = 0;
+        start_offset = SPOOL_SEGMENT_HEADER;
+    }
+    
+    std::vector<uint32_t> replay;
+    for (const auto& segment : m_segments) {
+        if (segment.first >= start_segment) {
+            replay.push_back(segment.first);
+        }
+    }
+    uint32_t last = m_segments.empty() ? 0 : m_segments.rbegin()->first;
+    for (uint32_t segment : replay) {
+        uint32_t offset = segment == start_segment ? start_offset : SPOOL_SEGMENT_HEADER;
+        if (!replay_segment(segment, offset, segment == last)) {
+            close();
+            return false;
+        }
+    }
+    
+    if (!open_segment(last == 0 ? 1 : last)) {
+        close();
+        return false;
+    }
+    delete_drained_segments();
+    return true;
+#else
+    (void)directory;
+    return false;
+#endif
+}
+
+void MessageSpool::close()
+{
+    if (m_fd >= 0) {
+        checkpoint();
+#ifndef _WIN32
+        ::close(m_fd);
+#endif
+    }
+    m_fd = -1;
+    m_segments.clear();
+    m_messages.clear();
+    m_digests.clear();
+    m_queues.clear();
+    m_maps.clear();
+}
+
+bool MessageSpool::load_index(uint32_t& segment, uint32_t& offset)
+{
+    ale::MappedFile file;
+    ale::SnapshotReader reader(nullptr, 0);
+    if (!file.open(index_path()) ||
+        !ale::SnapshotReader::open(file.data(), file.size(), SPOOL_INDEX_VERSION, reader)) {
+        return false;
+    }
+    
+    uint64_t next_id = reader.get_u64();
+    segment = reader.get_u32();
+    offset = reader.get_u32();
+    uint32_t count = reader.get_u32();
+    
+    // The index is only usable if every segment it refers to is intact
+    auto replay = m_segments.find(segment);
+    if (!reader.ok() || replay == m_segments.end() || offset > replay->second.size) {
+        return false;
+    }
+    
+    for (uint32_t i = 0; i < count && reader.ok(); i++) {
+        Message message;
+        message.entry.id = reader.get_u64();
+        message.segment = reader.get_u32();
+        message.payload_offset = reader.get_u32();
+        message.entry.priority = reader.get_u8();
+        message.entry.created_ms = reader.get_u64();
+        message.entry.expires_ms = reader.get_u64();
+        message.digest = reader.get_u64();
+        message.entry.length = reader.get_u32();
+        message.entry.destination = reader.get_string();
+        
+        auto stored = m_segments.find(message.segment);
+        if (!reader.ok() || stored == m_segments.end() ||
+            message.entry.priority >= SPOOL_PRIORITY_LEVELS ||
+            static_cast<uint64_t>(message.payload_offset) + message.entry.length > stored->second.size) {
+            return false;
+        }
+        apply_message(message);
+    }
+    
+    if (!reader.ok()) {
+        return false;
+    }
+    m_next_id = std::max(m_next_id, next_id);
+    return true;
+}
+
+bool MessageSpool::replay_segment(uint32_t segment, uint32_t offset, bool last)
+{
+    std::string path = segment_path(segment);
+    ale::MappedFile file;
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    if (file.open(path)) {
+        data = file.data();
+        size = file.size();
+    }
+    
+    size_t valid = 0;
+    if (size >= SPOOL_SEGMENT_HEADER && get_le32(data) == SPOOL_SEGMENT_MAGIC &&
+        get_le32(data + 4) == SPOOL_VERSION) {
+        valid = std::max<size_t>(offset, SPOOL_SEGMENT_HEADER);
+        
+        while (valid < size) {
+            if (size - valid < SPOOL_RECORD_HEADER) {
+                break;
+            }
+            uint32_t length = get_le32(data + valid);
+            uint32_t crc = get_le32(data + valid + 4);
+            const uint8_t* body = data + valid + SPOOL_RECORD_HEADER;
+            if (length == 0 || length > size - valid - SPOOL_RECORD_HEADER ||
+                ale::snapshot_crc32(body, length) != crc) {
+                break;
+            }
+            
+            ale::SnapshotReader reader(body, length);
+            uint8_t type = reader.get_u8();
+            uint64_t id = reader.get_u64();
+            if (type == RECORD_MESSAGE) {
+                Message message;
+                message.entry.id = id;
+                message.entry.priority = reader.get_u8();
+                message.entry.created_ms = reader.get_u64();
+                message.entry.expires_ms = reader.get_u64();
+                message.digest = reader.get_u64();
+                message.entry.destination = reader.get_string();
+                message.entry.length = reader.get_u32();
+                message.segment = segment;
+                message.payload_offset = static_cast<uint32_t>(valid + SPOOL_RECORD_HEADER + length -
+                                                               message.entry.length);
+                if (!reader.ok() || reader.remaining() != message.entry.length ||
+                    message.entry.priority >= SPOOL_PRIORITY_LEVELS) {
+                    break;
+                }
+                if (m_messages.find(id) == m_messages.end()) {
+                    apply_message(message);
+                }
+            } else if (type == RECORD_DONE && reader.ok()) {
+                apply_done(id);
+            } else {
+                break;
+            }
+            
+            m_next_id = std::max(m_next_id, id + 1);
+            m_stats.records_replayed++;
+            valid += SPOOL_RECORD_HEADER + length;
+        }
+    }
+    file.close();
+    
+    if (valid == size) {
+        m_segments[segment].size = static_cast<uint32_t>(size);
+        return true;
+    }
+    
+    // Damaged tail: records after it cannot be trusted
+    m_stats.corrupt_records++;
+    if (!last) {
+        m_segments[segment].size = static_cast<uint32_t>(valid);
+        return true;
+    }
+
+#ifndef _WIN32
+    // Last segment: cut the torn record off so appends follow good data
+    if (valid == 0) {
+        ::unlink(path.c_str());
+        m_segments.erase(segment);
+        return true;
+    }
+    if (::truncate(path.c_str(), static_cast<off_t>(valid)) != 0) {
+        return false;
+    }
+#endif
+    m_segments[segment].size = static_cast<uint32_t>(valid);
+    return true;
+}
+
+void MessageSpool::apply_message(const Message& message)
+{
+    m_messages[message.entry.id] = message;
+    m_digests[message.digest] = message.entry.id;
+    m_segments[message.segment].live++;
+    
+    DestinationQueue& queue = m_queues[message.entry.destination];
+    queue.fifo[message.entry.priority].push_back(message.entry.id);
+    queue.count++;
+}
+
+void MessageSpool::apply_done(uint64_t id)
+{
+    auto found = m_messages.find(id);
+    if (found == m_messages.end()) {
+        return;
+    }
+    const Message& message = found->second;
+    
+    auto digest = m_digests.find(message.digest);
+    if (digest != m_digests.end() && digest->second == id) {
+        m_digests.erase(digest);
+    }
+    
+    auto segment = m_segments.find(message.segment);
+    if (segment != m_segments.end() && segment->second.live > 0) {
+        segment->second.live--;
+    }
+    
+    // Queue entries go stale and are skipped; drop them all once empty
+    auto queue = m_queues.find(message.entry.destination);
+    if (queue != m_queues.end() && --queue->second.count == 0) {
+        for (auto& fifo : queue->second.fifo) {
+            fifo.clear();
+        }
+    }
+    
+    m_messages.erase(found);
+}
+
+bool MessageSpool::open_segment(uint32_t segment)
+{
+#ifndef _WIN32
+    std::string path = segment_path(segment);
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    
+    auto found = m_segments.find(segment);
+    if (found == m_segments.end() || found->second.size == 0) {
+        uint8_t header[SPOOL_SEGMENT_HEADER];
+        put_le32(header, SPOOL_SEGMENT_MAGIC);
+        put_le32(header + 4, SPOOL_VERSION);
+        if (!write_all(fd, header, sizeof(header)) || fsync(fd) != 0) {
+            ::close(fd);
+            return false;
+        }
+        m_segments[segment] = {0, SPOOL_SEGMENT_HEADER};
+        sync_directory(m_directory);
+    }
+    
+    if (m_fd >= 0) {
+        ::close(m_fd);
+    }
+    m_fd = fd;
+    return true;
+#else
+    (void)segment;
+    return false;
+#endif
+}
+
+bool MessageSpool::append_record(const std::vector<uint8_t>& body, uint32_t& body_offset)
+{
+#ifndef _WIN32
+    uint32_t active = m_segments.rbegin()->first;
+    uint32_t record_length = SPOOL_RECORD_HEADER + static_cast<uint32_t>(body.size());
+    
+    // Roll over to a new segment; the old one becomes read-only
+    if (m_segments[active].size > SPOOL_SEGMENT_HEADER &&
+        m_segments[active].size + record_length > m_segment_bytes) {
+        if (!open_segment(active + 1)) {
+            m_stats.write_errors++;
+            return false;
+        }
+        active++;
+        checkpoint();
+        delete_drained_segments();
+    }
+    
+    uint8_t header[SPOOL_RECORD_HEADER];
+    put_le32(header, static_cast<uint32_t>(body.size()));
+    put_le32(header + 4, ale::snapshot_crc32(body.data(), body.size()));
+    
+    Segment& segment = m_segments[active];
+    if (!write_all(m_fd, header, sizeof(header)) || !write_all(m_fd, body.data(), body.size()) ||
+        (m_sync && fdatasync(m_fd) != 0)) {
+        // Drop any partial record so the next one starts on a boundary
+        if (ftruncate(m_fd, static_cast<off_t>(segment.size)) != 0) {
+            ::close(m_fd);
+            m_fd = -1;
+        }
+        m_stats.write_errors++;
+        return false;
+    }
+    
+    body_offset = segment.size + SPOOL_RECORD_HEADER;
+    segment.size += record_length;
+    m_stats.bytes_written += record_length;
+    return true;
+#else
+    (void)body;
+    (void)body_offset;
+    return false;
+#endif
+}
+
+uint64_t MessageSpool::enqueue(const std::string& destination, const uint8_t* data, uint32_t length,
+                               uint8_t priority, uint64_t now_ms, uint64_t ttl_ms)
+{
+    if (m_fd < 0 || priority >= SPOOL_PRIORITY_LEVELS || destination.empty() ||
+        destination.size() > 0xFFFF || (length > 0 && !data)) {
+        return 0;
+    }
+    
+    uint64_t digest = message_digest(destination, priority, data, length);
+    auto duplicate = m_digests.find(digest);
+    if (duplicate != m_digests.end()) {
+        const SpoolEntry& pending = m_messages[duplicate->second].entry;
+        if (pending.destination == destination && pending.priority == priority &&
+            pending.length == length) {
+            // Digests can collide: only identical payloads are duplicates
+            std::vector<uint8_t> stored;
+            if (read(pending.id, stored) &&
+                (length == 0 || memcmp(stored.data(), data, length) == 0)) {
+                m_stats.duplicates++;
+                return pending.id;
+            }
+        }
+    }
+    
+    Message message;
+    message.entry.id = m_next_id;
+    message.entry.destination = destination;
+    message.entry.priority = priority;
+    message.entry.created_ms = now_ms;
+    message.entry.expires_ms = ttl_ms ? now_ms + ttl_ms : 0;
+    message.entry.length = length;
+    message.digest = digest;
+    
+    ale::SnapshotWriter writer;
+    writer.put_u8(RECORD_MESSAGE);
+    writer.put_u64(message.entry.id);
+    writer.put_u8(priority);
+    writer.put_u64(message.entry.created_ms);
+    writer.put_u64(message.entry.expires_ms);
+    writer.put_u64(digest);
+    writer.put_string(destination);
+    writer.put_u32(length);
+    writer.put_bytes(data, length);
+    
+    uint32_t body_offset;
+    if (!append_record(writer.data(), body_offset)) {
+        return 0;
+    }
+    message.segment = m_segments.rbegin()->first;
+    message.payload_offset = body_offset + static_cast<uint32_t>(writer.size()) - length;
+    
+    m_next_id++;
+    apply_message(message);
+    m_stats.messages_enqueued++;
+    return message.entry.id;
+}
+
+bool MessageSpool::finish(uint64_t id, uint8_t reason)
+{
+    if (m_fd < 0 || m_messages.find(id) == m_messages.end()) {
+        return false;
+    }
+    
+    ale::SnapshotWriter writer;
+    writer.put_u8(RECORD_DONE);
+    writer.put_u64(id);
+    writer.put_u8(reason);
+    
+    uint32_t body_offset;
+    if (!append_record(writer.data(), body_offset)) {
+        return false;
+    }
+    
+    apply_done(id);
+    switch (reason) {
+        case DONE_COMPLETED: m_stats.messages_completed++; break;
+        case DONE_CANCELLED: m_stats.messages_cancelled++; break;
+        default:             m_stats.messages_expired++; break;
+    }
+    delete_drained_segments();
+    return true;
+}
+
+bool MessageSpool::complete(uint64_t id)
+{
+    return finish(id, DONE_COMPLETED);
+}
+
+bool MessageSpool::cancel(uint64_t id)
+{
+    return finish(id, DONE_CANCELLED);
+}
+
+size_t MessageSpool::expire(uint64_t now_ms)
+{
+    std::vector<uint64_t> expired;
+    for (const auto& item : m_messages) {
+        uint64_t expires = item.second.entry.expires_ms;
+        if (expires != 0 && expires <= now_ms) {
+            expired.push_back(item.first);
+        }
+    }
+    
+    size_t count = 0;
+    for (uint64_t id : expired) {
+        if (finish(id, DONE_EXPIRED)) {
+            count++;
+        }
+    }
+    return count;
+}
+
+bool MessageSpool::next_in_queue(DestinationQueue& queue, uint64_t now_ms, uint64_t& id)
+{
+    for (int priority = SPOOL_PRIORITY_LEVELS - 1; priority >= 0; priority--) {
+        std::deque<uint64_t>& fifo = queue.fifo[priority];
+        while (!fifo.empty()) {
+            uint64_t head = fifo.front();
+            auto found = m_messages.find(head);
+            if (found == m_messages.end()) {
+                fifo.pop_front();  // Done since it was queued
+                continue;
+            }
+            uint64_t expires = found->second.entry.expires_ms;
+            if (expires != 0 && expires <= now_ms) {
+                fifo.pop_front();
+                finish(head, DONE_EXPIRED);
+                continue;
+            }
+            id = head;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool MessageSpool::peek(const std::string& destination, uint64_t now_ms, SpoolEntry& entry)
+{
+    auto queue = m_queues.find(destination);
+    uint64_t id;
+    if (queue == m_queues.end() || !next_in_queue(queue->second, now_ms, id)) {
+        return false;
+    }
+    entry = m_messages[id].entry;
+    return true;
+}
+
+bool MessageSpool::peek_any(uint64_t now_ms, SpoolEntry& entry)
+{
+    const SpoolEntry* best = nullptr;
+    for (auto& queue : m_queues) {
+        uint64_t id;
+        if (!next_in_queue(queue.second, now_ms, id)) {
+            continue;
+        }
+        const SpoolEntry& head = m_messages[id].entry;
+        if (!best || head.priority > best->priority ||
+            (head.priority == best->priority && head.id < best->id)) {
+            best = &head;
+        }
+    }
+    
+    if (!best) {
+        return false;
+    }
+    entry = *best;
+    return true;
+}
+
+bool MessageSpool::read(uint64_t id, std::vector<uint8_t>& payload)
+{
+    auto found = m_messages.find(id);
+    if (found == m_messages.end()) {
+        return false;
+    }
+    const Message& message = found->second;
+    size_t end = static_cast<size_t>(message.payload_offset) + message.entry.length;
+    
+    // Map on first use; the active segment is remapped as it grows
+    std::unique_ptr<ale::MappedFile>& map = m_maps[message.segment];
+    if (!map) {
+        map.reset(new ale::MappedFile());
+    }
+    if (!map->is_open() || map->size() < end) {
+        if (!map->open(segment_path(message.segment)) || map->size() < end) {
+            return false;
+        }
+    }
+    
+    payload.assign(map->data() + message.payload_offset, map->data() + end);
+    return true;
+}
+
+uint64_t MessageSpool::start_next(VariableARQ& arq, const std::string& destination, uint64_t now_ms)
+{
+    SpoolEntry entry;
+    std::vector<uint8_t> payload;
+    if (!peek(destination, now_ms, entry) || !read(entry.id, payload)) {
+        return 0;
+    }
+    return arq.start_transmission(payload.data(), entry.length) ? entry.id : 0;
+}
+
+bool MessageSpool::checkpoint()
+{
+    if (m_fd < 0 || m_segments.empty()) {
+        return false;
+    }
+
+#ifndef _WIN32
+    // Records before the replay point must be on disk before the index
+    // says so
+    if (!m_sync && fdatasync(m_fd) != 0) {
+        return false;
+    }
+#endif
+    
+    std::vector<uint64_t> ids;
+    ids.reserve(m_messages.size());
+    for (const auto& item : m_messages) {
+        ids.push_back(item.first);
+    }
+    std::sort(ids.begin(), ids.end());
+    
+    ale::SnapshotWriter writer;
+    writer.put_u64(m_next_id);
+    writer.put_u32(m_segments.rbegin()->first);
+    writer.put_u32(m_segments.rbegin()->second.size);
+    writer.put_u32(static_cast<uint32_t>(ids.size()));
+    for (uint64_t id : ids) {
+        const Message& message = m_messages[id];
+        writer.put_u64(id);
+        writer.put_u32(message.segment);
+        writer.put_u32(message.payload_offset);
+        writer.put_u8(message.entry.priority);
+        writer.put_u64(message.entry.created_ms);
+        writer.put_u64(message.entry.expires_ms);
+        writer.put_u64(message.digest);
+        writer.put_u32(message.entry.length);
+        writer.put_string(message.entry.destination);
+    }
+    
+    std::vector<uint8_t> index;
+    writer.finish(SPOOL_INDEX_VERSION, index);
+    return ale::write_file_atomic(index_path(), index.data(), index.size());
+}
+
+void MessageSpool::delete_drained_segments()
+{
+    // Oldest first only: a done record in a later segment may refer to a
+    // message in an earlier one, so an earlier segment must go first
+    uint32_t active = m_segments.empty() ? 0 : m_segments.rbegin()->first;
+    bool deleted = false;
+    while (!m_segments.empty() && m_segments.begin()->first != active &&
+           m_segments.begin()->second.live == 0) {
+        uint32_t segment = m_segments.begin()->first;
+        m_maps.erase(segment);
+        std::remove(segment_path(segment).c_str());
+        m_segments.erase(m_segments.begin());
+        m_stats.segments_deleted++;
+        deleted = true;
+    }
+
+#ifndef _WIN32
+    if (deleted) {
+        sync_directory(m_directory);
+    }
+#else
+    (void)deleted;
+#endif
+}
+
+size_t MessageSpool::pending(const std::string& destination) const
+{
+    auto queue = m_queues.find(destination);
+    return queue == m_queues.end() ? 0 : queue->second.count;
+}
+
+std::vector<std::string> MessageSpool::destinations() const
+{
+    std::vector<std::string> result;
+    for (const auto& queue : m_queues) {
+        if (queue.second.count > 0) {
+            result.push_back(queue.first);
+        }
+    }
+    return result;
+}
+
+} // namespace fs1052
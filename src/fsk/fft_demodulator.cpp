@@ -12,6 +12,7 @@ namespace ale {
 
 FFTDemodulator::FFTDemodulator()
     : sample_count(0),
+      sample_offset(0),
       samples_per_symbol(SAMPLE_RATE_HZ / SYMBOL_RATE_BAUD),
       mag_history_offset(0) {
     
@@ -22,6 +23,8 @@ FFTDemodulator::FFTDemodulator()
 }
 
 void FFTDemodulator::reset() {
+    // Sample time carries on across a reset
+    sample_offset += sample_count;
     sample_count = 0;
     mag_history_offset = 0;
     fft_buffer.reset();
@@ -35,6 +38,29 @@ const std::array<float, FFT_SIZE>& FFTDemodulator::get_fft_magnitudes() const {
     return fft_buffer.get_magnitudes();
 }
 
+BandEnergy FFTDemodulator::measure_band_energy() const {
+    return measure_band_energy(fft_buffer.get_magnitudes());
+}
+
+BandEnergy FFTDemodulator::measure_band_energy(const std::array<float, FFT_SIZE>& magnitudes) {
+    BandEnergy energy;
+    float sum = 0.0f;
+    
+    for (uint32_t bin = FFT_BIN_OFFSET; bin < FFT_BIN_OFFSET + FFT_BIN_SPAN; ++bin) {
+        sum += magnitudes[bin];
+        energy.in_band_peak = std::max(energy.in_band_peak, magnitudes[bin]);
+    }
+    
+    energy.in_band_mean = sum / FFT_BIN_SPAN;
+    energy.noise_floor = estimate_noise_floor(magnitudes);
+    return energy;
+}
+
+float BandEnergy::level_db() const {
+    float floor = std::max(noise_floor, 0.001f);
+    return 20.0f * std::log10(std::max(in_band_mean, 0.001f) / floor);
+}
+
 std::vector<Symbol> FFTDemodulator::process_audio(const int16_t* samples, uint32_t num_samples) {
     std::vector<Symbol> symbols;
     
@@ -86,7 +112,7 @@ Symbol* FFTDemodulator::process_sample(int16_t sample) {
     
     current_symbol.magnitude = peak_mag;
     current_symbol.signal_to_noise = compute_snr(peak_mag, noise_floor);
-    current_symbol.sample_index = sample_count - 1;
+    current_symbol.sample_index = sample_offset + sample_count - 1;
     
     // Store magnitude history for later word decoding
     mag_history[mag_history_offset] = magnitudes;
@@ -50,10 +50,30 @@ uint8_t SymbolDecoder::bin_to_symbol(uint32_t bin_index) {
 }
 
 uint8_t SymbolDecoder::majority_vote(const uint8_t bits[3]) {
-    // Sum the three bits: 0-3 is the count of 1s
-    uint8_t sum = bits[0] + bits[1] + bits[2];
-    // Majority voting: if 2 or more are 1, output 1, else 0
-    return (sum >= 2) ? 1 : 0;
+    // Count valid copies of each value (0xFF copies are unknown)
+    uint8_t ones = 0;
+    uint8_t zeros = 0;
+    for (int i = 0; i < 3; ++i) {
+        ones += (bits[i] == 1);
+        zeros += (bits[i] == 0);
+    }
+    // Majority voting among the valid copies
+    return (ones > zeros) ? 1 : 0;
+}
+
+// Three copies of a data bit: positions k, k+49, k+98
+static void get_bit_copies(const uint8_t* symbols, uint32_t bit_idx, uint8_t bit_copies[3]) {
+    for (uint32_t rep = 0; rep < SYMBOL_REPETITION; ++rep) {
+        uint32_t sym_idx = bit_idx + rep * SYMBOLS_PER_WORD;
+        uint8_t symbol = symbols[sym_idx];
+        if (symbol >= 8) {
+            bit_copies[rep] = 0xFF;  // Invalid
+        } else {
+            // Symbols contain 3 bits each, so bit_idx within symbol
+            uint8_t bit_in_symbol = bit_idx % BITS_PER_SYMBOL;
+            bit_copies[rep] = (symbol >> bit_in_symbol) & 1;
+        }
+    }
 }
 
 uint32_t SymbolDecoder::decode_word_with_voting(const uint8_t symbols[SYMBOLS_PER_WORD],
@@ -69,24 +89,7 @@ uint32_t SymbolDecoder::decode_word_with_voting(const uint8_t symbols[SYMBOLS_PE
     for (uint32_t bit_idx = 0; bit_idx < WORD_BITS; ++bit_idx) {
         // Get three copies of this bit
         uint8_t bit_copies[3];
-        
-        for (uint32_t rep = 0; rep < SYMBOL_REPETITION; ++rep) {
-            uint32_t sym_idx = bit_idx + rep * SYMBOLS_PER_WORD;
-            if (sym_idx >= SYMBOLS_PER_WORD * SYMBOL_REPETITION) {
-                break;  // Not enough symbols
-            }
-            
-            uint8_t symbol = symbols[sym_idx];
-            if (symbol >= 8) {
-                bit_copies[rep] = 0xFF;  // Invalid
-            } else {
-                // Extract bit at position bit_idx from symbol
-                // Need to convert symbol (0-7) to bit value
-                // Symbols contain 3 bits each, so bit_idx within symbol
-                uint8_t bit_in_symbol = bit_idx % BITS_PER_SYMBOL;
-                bit_copies[rep] = (symbol >> bit_in_symbol) & 1;
-            }
-        }
+        get_bit_copies(symbols, bit_idx, bit_copies);
         
         // Majority vote
         uint8_t final_bit = majority_vote(bit_copies);
@@ -106,4 +109,38 @@ uint32_t SymbolDecoder::decode_word_with_voting(const uint8_t symbols[SYMBOLS_PE
     return errors_corrected;
 }
 
+uint32_t SymbolDecoder::decode_word_with_erasures(const uint8_t symbols[SYMBOLS_PER_WORD],
+                                                  uint32_t& output_word, uint32_t& erasures) {
+    uint32_t word = 0;
+    uint32_t erased = 0;
+    uint32_t errors_corrected = 0;
+    
+    for (uint32_t bit_idx = 0; bit_idx < WORD_BITS; ++bit_idx) {
+        uint8_t bit_copies[3];
+        get_bit_copies(symbols, bit_idx, bit_copies);
+        
+        uint8_t ones = 0;
+        uint8_t zeros = 0;
+        for (int rep = 0; rep < 3; ++rep) {
+            ones += (bit_copies[rep] == 1);
+            zeros += (bit_copies[rep] == 0);
+        }
+        
+        if (ones != 3 && zeros != 3) {
+            errors_corrected++;
+        }
+        
+        // Unreliable unless at least two copies agree
+        if (std::max(ones, zeros) < 2) {
+            erased |= (1U << bit_idx);
+        }
+        
+        word |= static_cast<uint32_t>(ones > zeros) << bit_idx;
+    }
+    
+    output_word = word;
+    erasures = erased;
+    return errors_corrected;
+}
+
 } // namespace ale
@@ -5,6 +5,7 @@
 
 #include "ale_state_machine.h"
 #include <algorithm>
+#include <array>
 #include <cstring>
 
 namespace ale {
@@ -21,10 +22,105 @@ static const char* EVENT_NAMES[] = {
     "SOUNDING_REQUEST", "SOUNDING_COMPLETE", "ERROR_OCCURRED"
 };
 
+// ============================================================================
+// Transition Table
+// ============================================================================
+
+/**
+ * Table entry: target state, or no transition
+ */
+struct TransitionEntry {
+    ALEState target;
+    bool legal;
+};
+
+static constexpr TransitionEntry move_to(ALEState target) { return { target, true }; }
+static constexpr TransitionEntry NONE = { ALEState::IDLE, false };
+
+using TransitionRow = std::array<TransitionEntry, ALE_EVENT_COUNT>;
+
+// Columns: START_SCAN, STOP_SCAN, CALL_REQUEST, CALL_DETECTED, HANDSHAKE_COMPLETE,
+//          LINK_TIMEOUT, LINK_TERMINATED, SOUNDING_REQUEST, SOUNDING_COMPLETE, ERROR_OCCURRED
+static constexpr std::array<TransitionRow, ALE_STATE_COUNT> TRANSITION_TABLE = {{
+    // IDLE
+    {{ move_to(ALEState::SCANNING), NONE, move_to(ALEState::CALLING), NONE, NONE,
+       NONE, NONE, move_to(ALEState::SOUNDING), NONE, move_to(ALEState::ERROR) }},
+    // SCANNING
+    {{ NONE, move_to(ALEState::IDLE), move_to(ALEState::CALLING), move_to(ALEState::HANDSHAKE), NONE,
+       NONE, NONE, NONE, NONE, move_to(ALEState::ERROR) }},
+    // CALLING
+    {{ NONE, NONE, NONE, NONE, move_to(ALEState::LINKED),
+       move_to(ALEState::IDLE), NONE, NONE, NONE, move_to(ALEState::ERROR) }},
+    // HANDSHAKE
+    {{ NONE, NONE, NONE, NONE, move_to(ALEState::LINKED),
+       move_to(ALEState::SCANNING), NONE, NONE, NONE, move_to(ALEState::ERROR) }},
+    // LINKED
+    {{ NONE, NONE, NONE, NONE, NONE,
+       move_to(ALEState::IDLE), move_to(ALEState::IDLE), NONE, NONE, move_to(ALEState::ERROR) }},
+    // SOUNDING
+    {{ NONE, NONE, NONE, NONE, NONE,
+       NONE, NONE, NONE, move_to(ALEState::SCANNING), move_to(ALEState::ERROR) }},
+    // ERROR: restart scanning, anything else resets to IDLE
+    {{ move_to(ALEState::SCANNING), move_to(ALEState::IDLE), move_to(ALEState::IDLE), move_to(ALEState::IDLE),
+       move_to(ALEState::IDLE), move_to(ALEState::IDLE), move_to(ALEState::IDLE), move_to(ALEState::IDLE),
+       move_to(ALEState::IDLE), move_to(ALEState::IDLE) }},
+}};
+
+static constexpr const TransitionEntry& table_entry(ALEState state, ALEEvent event) {
+    return TRANSITION_TABLE[static_cast<size_t>(state)][static_cast<size_t>(event)];
+}
+
+static constexpr bool table_has_no_self_loops() {
+    for (uint32_t s = 0; s < ALE_STATE_COUNT; ++s) {
+        for (uint32_t e = 0; e < ALE_EVENT_COUNT; ++e) {
+            const TransitionEntry& t = TRANSITION_TABLE[s][e];
+            if (t.legal && static_cast<uint32_t>(t.target) == s) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static constexpr bool error_reachable_from_all() {
+    for (uint32_t s = 0; s < ALE_STATE_COUNT; ++s) {
+        if (static_cast<ALEState>(s) == ALEState::ERROR) continue;
+        const TransitionEntry& t = TRANSITION_TABLE[s][static_cast<size_t>(ALEEvent::ERROR_OCCURRED)];
+        if (!t.legal || t.target != ALEState::ERROR) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(static_cast<uint32_t>(ALEState::ERROR) + 1 == ALE_STATE_COUNT,
+              "ALE_STATE_COUNT out of sync with ALEState");
+static_assert(static_cast<uint32_t>(ALEEvent::ERROR_OCCURRED) + 1 == ALE_EVENT_COUNT,
+              "ALE_EVENT_COUNT out of sync with ALEEvent");
+static_assert(table_has_no_self_loops(), "self transitions are not state changes");
+static_assert(error_reachable_from_all(), "ERROR_OCCURRED must reach ERROR from every state");
+static_assert(table_entry(ALEState::SCANNING, ALEEvent::CALL_DETECTED).target == ALEState::HANDSHAKE,
+              "incoming call starts handshake");
+static_assert(table_entry(ALEState::HANDSHAKE, ALEEvent::LINK_TIMEOUT).target == ALEState::SCANNING,
+              "failed handshake resumes scanning");
+static_assert(!table_entry(ALEState::LINKED, ALEEvent::CALL_REQUEST).legal,
+              "no new call while linked");
+              
 // ============================================================================
 // ALEStateMachine Implementation
 // ============================================================================
 
+const ALEStateMachine::StateActions ALEStateMachine::state_actions[ALE_STATE_COUNT] = {
+    // on_enter                            on_exit                         on_update
+    { nullptr,                             nullptr,                        &ALEStateMachine::handle_idle },       // IDLE
+    { &ALEStateMachine::enter_scanning,    nullptr,                        &ALEStateMachine::handle_scanning },   // SCANNING
+    { &ALEStateMachine::enter_call_timer,  nullptr,                        &ALEStateMachine::handle_calling },    // CALLING
+    { &ALEStateMachine::enter_call_timer,  nullptr,                        &ALEStateMachine::handle_handshake },  // HANDSHAKE
+    { &ALEStateMachine::enter_linked,      &ALEStateMachine::exit_linked,  &ALEStateMachine::handle_linked },     // LINKED
+    { &ALEStateMachine::enter_sounding,    nullptr,                        &ALEStateMachine::handle_sounding },   // SOUNDING
+    { nullptr,                             nullptr,                        nullptr },                             // ERROR
+};
+
 ALEStateMachine::ALEStateMachine()
     : current_state(ALEState::IDLE),
       previous_state(ALEState::IDLE),
@@ -32,7 +128,15 @@ ALEStateMachine::ALEStateMachine()
       last_word_time_ms(0),
       state_entry_time_ms(0),
       last_scan_hop_time_ms(0),
-      current_time_ms(0) {
+      current_time_ms(0),
+      sample_clock(nullptr),
+      pending_tx(PendingTx::NONE),
+      pending_attempts(0),
+      pending_resume_ms(0),
+      pending_deferred(false),
+      snapshot_persister(nullptr),
+      snapshot_interval_ms(0),
+      last_snapshot_ms(0) {
 }
 
 const char* ALEStateMachine::state_name(ALEState state) {
@@ -47,81 +151,27 @@ const char* ALEStateMachine::event_name(ALEEvent event) {
     return EVENT_NAMES[index];
 }
 
-bool ALEStateMachine::process_event(ALEEvent event) {
-    ALEState old_state = current_state;
-    
-    // State-specific event handling
-    switch (current_state) {
-        case ALEState::IDLE:
-            if (event == ALEEvent::START_SCAN) {
-                return transition_to(ALEState::SCANNING);
-            }
-            else if (event == ALEEvent::CALL_REQUEST) {
-                return transition_to(ALEState::CALLING);
-            }
-            else if (event == ALEEvent::SOUNDING_REQUEST) {
-                return transition_to(ALEState::SOUNDING);
-            }
-            break;
-            
-        case ALEState::SCANNING:
-            if (event == ALEEvent::STOP_SCAN) {
-                return transition_to(ALEState::IDLE);
-            }
-            else if (event == ALEEvent::CALL_DETECTED) {
-                return transition_to(ALEState::HANDSHAKE);
-            }
-            else if (event == ALEEvent::CALL_REQUEST) {
-                return transition_to(ALEState::CALLING);
-            }
-            break;
-            
-        case ALEState::CALLING:
-            if (event == ALEEvent::HANDSHAKE_COMPLETE) {
-                return transition_to(ALEState::LINKED);
-            }
-            else if (event == ALEEvent::LINK_TIMEOUT) {
-                return transition_to(ALEState::IDLE);
-            }
-            break;
-            
-        case ALEState::HANDSHAKE:
-            if (event == ALEEvent::HANDSHAKE_COMPLETE) {
-                return transition_to(ALEState::LINKED);
-            }
-            else if (event == ALEEvent::LINK_TIMEOUT) {
-                return transition_to(ALEState::SCANNING);
-            }
-            break;
-            
-        case ALEState::LINKED:
-            if (event == ALEEvent::LINK_TERMINATED || event == ALEEvent::LINK_TIMEOUT) {
-                return transition_to(ALEState::IDLE);
-            }
-            break;
-            
-        case ALEState::SOUNDING:
-            if (event == ALEEvent::SOUNDING_COMPLETE) {
-                return transition_to(ALEState::SCANNING);
-            }
-            break;
-            
-        case ALEState::ERROR:
-            if (event == ALEEvent::START_SCAN) {
-                return transition_to(ALEState::SCANNING);
-            }
-            else {
-                return transition_to(ALEState::IDLE);
-            }
-            break;
+bool ALEStateMachine::lookup_transition(ALEState state, ALEEvent event, ALEState& next) {
+    uint32_t s = static_cast<uint32_t>(state);
+    uint32_t e = static_cast<uint32_t>(event);
+    if (s >= ALE_STATE_COUNT || e >= ALE_EVENT_COUNT) {
+        return false;
     }
     
-    // Error event always goes to ERROR state
-    if (event == ALEEvent::ERROR_OCCURRED) {
-        return transition_to(ALEState::ERROR);
+    const TransitionEntry& t = TRANSITION_TABLE[s][e];
+    if (t.legal) {
+        next = t.target;
+    }
+    return t.legal;
+}
+
+bool ALEStateMachine::process_event(ALEEvent event) {
+    ALEState next;
+    if (!lookup_transition(current_state, event, next)) {
+        return false;  // No state change
     }
     
-    return false;  // No state change
+    return transition_to(next);
 }
 
 void ALEStateMachine::update(uint32_t current_time_ms) {
@@ -132,30 +182,19 @@ void ALEStateMachine::update(uint32_t current_time_ms) {
         process_event(ALEEvent::LINK_TIMEOUT);
     }
     
+    // Listen-before-transmit window for a queued call/sounding
+    if (pending_tx != PendingTx::NONE) {
+        service_listen();
+    }
+    
     // State-specific periodic processing
-    switch (current_state) {
-        case ALEState::SCANNING:
-            handle_scanning();
-            break;
-            
-        case ALEState::CALLING:
-            handle_calling();
-            break;
-            
-        case ALEState::HANDSHAKE:
-            handle_handshake();
-            break;
-            
-        case ALEState::LINKED:
-            handle_linked();
-            break;
-            
-        case ALEState::SOUNDING:
-            handle_sounding();
-            break;
-            
-        default:
-            break;
+    StateHandler handler = state_actions[static_cast<uint32_t>(current_state)].on_update;
+    if (handler) {
+        (this->*handler)();
+    }
+    
+    if (snapshot_persister) {
+        service_snapshot();
     }
 }
 
@@ -173,78 +212,89 @@ bool ALEStateMachine::transition_to(ALEState new_state) {
     enter_state(new_state);
     
     // Call state change callback
-    if (state_callback) {
-        state_callback(previous_state, current_state);
-    }
+    notify_state_change(previous_state, current_state);
     
     return true;
 }
 
+void ALEStateMachine::notify_state_change(ALEState from, ALEState to) {
+    if (state_handler) {
+        state_handler(from, to);
+    } else if (state_callback) {
+        state_callback(from, to);
+    }
+}
+
+void ALEStateMachine::notify_channel(const Channel& channel) {
+    if (channel_handler) {
+        channel_handler(channel);
+    } else if (channel_callback) {
+        channel_callback(channel);
+    }
+}
+
 void ALEStateMachine::enter_state(ALEState new_state) {
-    switch (new_state) {
-        case ALEState::SCANNING:
-            // Reset scan position
-            scan_config.channel_index = 0;
-            last_scan_hop_time_ms = current_time_ms;
-            
-            // Set first channel
-            if (!scan_config.scan_list.empty()) {
-                set_channel(0);
-            }
-            break;
-            
-        case ALEState::CALLING:
-            link_start_time_ms = current_time_ms;
-            break;
-            
-        case ALEState::HANDSHAKE:
-            link_start_time_ms = current_time_ms;
-            break;
-            
-        case ALEState::LINKED:
-            link_start_time_ms = current_time_ms;
-            last_word_time_ms = current_time_ms;
-            break;
-            
-        case ALEState::SOUNDING:
-            // Transmit TIS word
-            if (!address_book.get_self_address().empty()) {
-                ALEWord tis_word;
-                tis_word.type = WordType::TIS;
-                std::string self = address_book.get_self_address();
-                strncpy(tis_word.address, self.c_str(), 3);
-                tis_word.valid = true;
-                tis_word.timestamp_ms = current_time_ms;
-                
-                transmit_word(tis_word);
-            }
-            break;
-            
-        default:
-            break;
+    StateHandler handler = state_actions[static_cast<uint32_t>(new_state)].on_enter;
+    if (handler) {
+        (this->*handler)();
     }
 }
 
 void ALEStateMachine::exit_state(ALEState old_state) {
-    switch (old_state) {
-        case ALEState::LINKED:
-            // Clear link state
-            active_call_to.clear();
-            active_call_from.clear();
-            break;
-            
-        default:
-            break;
+    StateHandler handler = state_actions[static_cast<uint32_t>(old_state)].on_exit;
+    if (handler) {
+        (this->*handler)();
+    }
+}
+
+void ALEStateMachine::enter_scanning() {
+    // Reset scan position
+    scan_config.channel_index = 0;
+    last_scan_hop_time_ms = current_time_ms;
+    
+    // Set first channel
+    if (!scan_config.scan_list.empty()) {
+        set_channel(0);
+    }
+}
+
+void ALEStateMachine::enter_call_timer() {
+    link_start_time_ms = current_time_ms;
+}
+
+void ALEStateMachine::enter_linked() {
+    link_start_time_ms = current_time_ms;
+    last_word_time_ms = current_time_ms;
+}
+
+void ALEStateMachine::enter_sounding() {
+    // Transmit TIS word
+    if (!address_book.get_self_address().empty()) {
+        ALEWord tis_word;
+        tis_word.type = WordType::TIS;
+        std::string self = address_book.get_self_address();
+        strncpy(tis_word.address, self.c_str(), 3);
+        tis_word.valid = true;
+        tis_word.timestamp_ms = current_time_ms;
+        tis_word.sample_time = transmit_sample_time(0);
+        
+        transmit_word(tis_word);
     }
 }
 
+void ALEStateMachine::exit_linked() {
+    // Clear link state
+    active_call_to.clear();
+    active_call_from.clear();
+}
+
 void ALEStateMachine::handle_idle() {
     // Nothing to do in IDLE
 }
 
 void ALEStateMachine::handle_scanning() {
-    // Check if it's time to hop to next channel
-    if (check_scan_dwell_timeout()) {
+    // Check if it's time to hop to next channel (hold while listening to transmit)
+    if (pending_tx == PendingTx::NONE && check_scan_dwell_timeout()) {
         hop_to_next_channel();
     }
 }
@@ -298,18 +348,15 @@ bool ALEStateMachine::initiate_call(const std::string& to_address) {
         return false;  // Can't call now
     }
     
-    active_call_to = to_address;
-    active_call_from = address_book.get_self_address();
-    
-    // Transition to CALLING state first
-    bool transitioned = process_event(ALEEvent::CALL_REQUEST);
-    
-    if (transitioned) {
-        // Build and transmit TO + FROM words
-        build_call_words(to_address, false);
+    if (lbt_config.enabled) {
+        if (pending_tx != PendingTx::NONE) {
+            return false;
+        }
+        begin_listen(PendingTx::CALL, to_address);
+        return true;
     }
     
-    return transitioned;
+    return start_call(to_address, false);
 }
 
 bool ALEStateMachine::initiate_net_call(const std::string& net_address) {
@@ -317,15 +364,27 @@ bool ALEStateMachine::initiate_net_call(const std::string& net_address) {
         return false;
     }
     
-    active_call_to = net_address;
+    if (lbt_config.enabled) {
+        if (pending_tx != PendingTx::NONE) {
+            return false;
+        }
+        begin_listen(PendingTx::NET_CALL, net_address);
+        return true;
+    }
+    
+    return start_call(net_address, true);
+}
+
+bool ALEStateMachine::start_call(const std::string& to_addr, bool is_net) {
+    active_call_to = to_addr;
     active_call_from = address_book.get_self_address();
     
     // Transition to CALLING state first
     bool transitioned = process_event(ALEEvent::CALL_REQUEST);
     
     if (transitioned) {
-        // Build and transmit TWS + FROM words
-        build_call_words(net_address, true);
+        // Build and transmit TO/TWS + FROM words
+        build_call_words(to_addr, is_net);
     }
     
     return transitioned;
@@ -348,9 +407,139 @@ bool ALEStateMachine::send_sounding() {
         return false;
     }
     
+    if (lbt_config.enabled) {
+        if (pending_tx != PendingTx::NONE) {
+            return false;
+        }
+        begin_listen(PendingTx::SOUNDING, std::string());
+        return true;
+    }
+    
     return process_event(ALEEvent::SOUNDING_REQUEST);
 }
 
+// ============================================================================
+// Listen Before Transmit
+// ============================================================================
+
+void ALEStateMachine::configure_lbt(const LBTConfig& config) {
+    lbt_config = config;
+    occupancy.set_config(config.occupancy);
+}
+
+void ALEStateMachine::report_band_energy(const BandEnergy& energy) {
+    occupancy.add_measurement(energy);
+}
+
+void ALEStateMachine::cancel_pending_transmit() {
+    pending_tx = PendingTx::NONE;
+    pending_address.clear();
+    pending_deferred = false;
+    occupancy.reset();
+}
+
+void ALEStateMachine::begin_listen(PendingTx kind, const std::string& address) {
+    pending_tx = kind;
+    pending_address = address;
+    pending_attempts = 0;
+    pending_deferred = false;
+    busy_channels.assign(scan_config.scan_list.size(), 0);
+    occupancy.start(current_time_ms);
+}
+
+void ALEStateMachine::service_listen() {
+    // An incoming call or other transition pre-empts the queued transmission
+    if (current_state != ALEState::IDLE && current_state != ALEState::SCANNING) {
+        lbt_stats.abandoned++;
+        cancel_pending_transmit();
+        return;
+    }
+    
+    if (pending_deferred) {
+        if (static_cast<int32_t>(current_time_ms - pending_resume_ms) < 0) {
+            return;  // Still backing off
+        }
+        pending_deferred = false;
+        std::fill(busy_channels.begin(), busy_channels.end(), 0);
+        occupancy.start(current_time_ms);
+        return;
+    }
+    
+    if (!occupancy.window_complete(current_time_ms)) {
+        return;
+    }
+    
+    last_occupancy = occupancy.result();
+    occupancy.reset();
+    
+    if (!last_occupancy.busy) {
+        lbt_stats.clear_windows++;
+        PendingTx kind = pending_tx;
+        std::string address = pending_address;
+        cancel_pending_transmit();
+        execute_transmit(kind, address);
+        return;
+    }
+    
+    lbt_stats.busy_windows++;
+    if (++pending_attempts >= lbt_config.max_attempts) {
+        lbt_stats.abandoned++;
+        cancel_pending_transmit();
+        return;
+    }
+    
+    uint32_t index = scan_config.channel_index;
+    if (index < busy_channels.size()) {
+        busy_channels[index] = 1;
+    }
+    
+    if (lbt_config.hop_on_busy && hop_to_clear_channel()) {
+        lbt_stats.channel_hops++;
+        occupancy.start(current_time_ms);
+        return;
+    }
+    
+    // No untried channel: back off and listen again
+    lbt_stats.deferrals++;
+    pending_deferred = true;
+    pending_resume_ms = current_time_ms + lbt_config.defer_ms;
+}
+
+bool ALEStateMachine::hop_to_clear_channel() {
+    // Next-best channel by LQA among those not found busy this attempt
+    int32_t best = -1;
+    for (size_t i = 0; i < scan_config.scan_list.size() && i < busy_channels.size(); ++i) {
+        if (busy_channels[i]) {
+            continue;
+        }
+        if (best < 0 || scan_config.scan_list[i].lqa_score >
+                        scan_config.scan_list[best].lqa_score) {
+            best = static_cast<int32_t>(i);
+        }
+    }
+    
+    if (best < 0) {
+        return false;
+    }
+    
+    set_channel(static_cast<uint32_t>(best));
+    last_scan_hop_time_ms = current_time_ms;
+    return true;
+}
+
+bool ALEStateMachine::execute_transmit(PendingTx kind, const std::string& address) {
+    switch (kind) {
+        case PendingTx::CALL:
+            return start_call(address, false);
+        case PendingTx::NET_CALL:
+            return start_call(address, true);
+        case PendingTx::SOUNDING:
+            return process_event(ALEEvent::SOUNDING_REQUEST);
+        default:
+            return false;
+    }
+}
+
 void ALEStateMachine::process_received_word(const ALEWord& word) {
     if (!word.valid) {
         return;
@@ -442,9 +631,7 @@ void ALEStateMachine::set_channel(uint32_t index) {
     scan_config.scan_list[index].last_scan_time_ms = current_time_ms;
     
     // Call channel change callback
-    if (channel_callback) {
-        channel_callback(scan_config.scan_list[index]);
-    }
+    notify_channel(scan_config.scan_list[index]);
 }
 
 bool ALEStateMachine::check_link_timeout() {
@@ -487,6 +674,7 @@ void ALEStateMachine::build_call_words(const std::string& to_addr, bool is_net)
     to_word.address[3] = '\0';  // Ensure null termination
     to_word.valid = true;
     to_word.timestamp_ms = current_time_ms;
+    to_word.sample_time = transmit_sample_time(0);
     
     transmit_word(to_word);
     
@@ -498,14 +686,197 @@ void ALEStateMachine::build_call_words(const std::string& to_addr, bool is_net)
     from_word.address[3] = '\0';  // Ensure null termination
     from_word.valid = true;
     from_word.timestamp_ms = current_time_ms + ALETimingConstants::WORD_DURATION_MS;
+    from_word.sample_time = transmit_sample_time(1);
     
     transmit_word(from_word);
 }
 
+SampleTime ALEStateMachine::transmit_sample_time(uint32_t word_index) const {
+    if (!sample_clock) {
+        return SAMPLE_TIME_NONE;
+    }
+    return sample_clock->now() +
+           word_index * SampleClock::ms_to_samples(ALETimingConstants::WORD_DURATION_MS);
+}
+
 void ALEStateMachine::transmit_word(const ALEWord& word) {
-    if (transmit_callback) {
+    if (transmit_handler) {
+        transmit_handler(word);
+    } else if (transmit_callback) {
         transmit_callback(word);
     }
 }
 
+// ============================================================================
+// Snapshot
+// ============================================================================
+
+void ALEStateMachine::save_snapshot(std::vector<uint8_t>& output) const {
+    SnapshotWriter writer;
+    
+    writer.put_u8(static_cast<uint8_t>(current_state));
+    writer.put_u8(static_cast<uint8_t>(previous_state));
+    writer.put_u32(current_time_ms);
+    writer.put_u32(state_entry_time_ms);
+    writer.put_u32(last_scan_hop_time_ms);
+    writer.put_u32(link_start_time_ms);
+    writer.put_u32(last_word_time_ms);
+    writer.put_string(active_call_to);
+    writer.put_string(active_call_from);
+    
+    writer.put_u32(scan_config.dwell_time_ms);
+    writer.put_u32(scan_config.channel_index);
+    writer.put_bool(scan_config.enabled);
+    writer.put_u16(static_cast<uint16_t>(scan_config.scan_list.size()));
+    for (const auto& channel : scan_config.scan_list) {
+        writer.put_u32(channel.frequency_hz);
+        writer.put_string(channel.mode);
+        writer.put_f32(channel.lqa_score);
+        writer.put_u32(channel.last_scan_time_ms);
+        writer.put_u32(channel.call_count);
+    }
+    
+    writer.put_u16(static_cast<uint16_t>(channel_quality.size()));
+    for (const auto& lq : channel_quality) {
+        writer.put_f32(lq.snr_db);
+        writer.put_f32(lq.ber);
+        writer.put_u32(lq.fec_errors);
+        writer.put_u32(lq.total_words);
+        writer.put_u32(lq.timestamp_ms);
+    }
+    
+    address_book.save_snapshot(writer);
+    message_assembler.save_snapshot(writer);
+    
+    writer.finish(LINK_SNAPSHOT_VERSION, output);
+}
+
+bool ALEStateMachine::restore_snapshot(const uint8_t* data, size_t length, uint32_t now_ms) {
+    SnapshotReader reader(nullptr, 0);
+    if (!SnapshotReader::open(data, length, LINK_SNAPSHOT_VERSION, reader)) {
+        return false;
+    }
+    
+    // Decode everything into temporaries; commit only if all of it is valid
+    uint8_t state = reader.get_u8();
+    uint8_t prev_state = reader.get_u8();
+    uint32_t saved_now_ms = reader.get_u32();
+    uint32_t entry_ms = reader.get_u32();
+    uint32_t hop_ms = reader.get_u32();
+    uint32_t link_start_ms = reader.get_u32();
+    uint32_t last_word_ms = reader.get_u32();
+    std::string call_to = reader.get_string();
+    std::string call_from = reader.get_string();
+    
+    // Rebase saved times onto the new clock (wraps like the clock itself)
+    uint32_t shift = now_ms - saved_now_ms;
+    auto rebase = [shift](uint32_t t) { return t ? t + shift : 0; };
+    
+    ScanConfig scan;
+    scan.dwell_time_ms = reader.get_u32();
+    scan.channel_index = reader.get_u32();
+    scan.enabled = reader.get_bool();
+    uint16_t channel_count = reader.get_u16();
+    for (uint16_t i = 0; i < channel_count && reader.ok(); i++) {
+        Channel channel;
+        channel.frequency_hz = reader.get_u32();
+        channel.mode = reader.get_string();
+        channel.lqa_score = reader.get_f32();
+        channel.last_scan_time_ms = rebase(reader.get_u32());
+        channel.call_count = reader.get_u32();
+        scan.scan_list.push_back(channel);
+    }
+    
+    std::vector<LinkQuality> quality;
+    uint16_t quality_count = reader.get_u16();
+    for (uint16_t i = 0; i < quality_count && reader.ok(); i++) {
+        LinkQuality lq;
+        lq.snr_db = reader.get_f32();
+        lq.ber = reader.get_f32();
+        lq.fec_errors = reader.get_u32();
+        lq.total_words = reader.get_u32();
+        lq.timestamp_ms = rebase(reader.get_u32());
+        quality.push_back(lq);
+    }
+    
+    AddressBook book;
+    MessageAssembler assembler;
+    if (!book.restore_snapshot(reader) ||
+        !assembler.restore_snapshot(reader, shift) ||
+        !reader.ok()) {
+        return false;
+    }
+    
+    if (state >= ALE_STATE_COUNT || prev_state >= ALE_STATE_COUNT) {
+        return false;
+    }
+    if (!scan.scan_list.empty() && scan.channel_index >= scan.scan_list.size()) {
+        return false;
+    }
+    
+    current_state = static_cast<ALEState>(state);
+    previous_state = static_cast<ALEState>(prev_state);
+    current_time_ms = now_ms;
+    state_entry_time_ms = entry_ms + shift;
+    last_scan_hop_time_ms = hop_ms + shift;
+    link_start_time_ms = link_start_ms + shift;
+    last_word_time_ms = last_word_ms + shift;
+    active_call_to = call_to;
+    active_call_from = call_from;
+    scan_config = std::move(scan);
+    channel_quality = std::move(quality);
+    address_book = std::move(book);
+    message_assembler = std::move(assembler);
+    
+    // Transient listen-before-transmit state does not survive a restart
+    pending_tx = PendingTx::NONE;
+    pending_address.clear();
+    pending_attempts = 0;
+    pending_deferred = false;
+    busy_channels.clear();
+    occupancy.reset();
+    last_snapshot_ms = now_ms;
+    
+    // Radio comes up on an unknown channel; retune to the restored one
+    const Channel* channel = get_current_channel();
+    if (channel) {
+        notify_channel(*channel);
+    }
+    
+    return true;
+}
+
+bool ALEStateMachine::save_snapshot_file(const std::string& path) const {
+    std::vector<uint8_t> snapshot;
+    save_snapshot(snapshot);
+    return write_file_atomic(path, snapshot.data(), snapshot.size());
+}
+
+bool ALEStateMachine::load_snapshot_file(const std::string& path, uint32_t now_ms) {
+    MappedFile file;
+    if (!file.open(path)) {
+        return false;
+    }
+    return restore_snapshot(file.data(), file.size(), now_ms);
+}
+
+void ALEStateMachine::enable_periodic_snapshot(SnapshotPersister* persister, uint32_t interval_ms) {
+    snapshot_persister = persister;
+    snapshot_interval_ms = interval_ms;
+    last_snapshot_ms = current_time_ms;
+}
+
+void ALEStateMachine::service_snapshot() {
+    if (!snapshot_persister->is_running() ||
+        current_time_ms - last_snapshot_ms < snapshot_interval_ms) {
+        return;
+    }
+    
+    // Encoding is in-memory and cheap; the persister does the file I/O
+    std::vector<uint8_t> snapshot;
+    save_snapshot(snapshot);
+    snapshot_persister->submit(std::move(snapshot));
+    last_snapshot_ms = current_time_ms;
+}
+
 } // namespace ale
@@ -0,0 +1,91 @@
+/**
+ * \file channel_occupancy.cpp
+ * \brief Implementation of listen-before-transmit occupancy detection
+ */
+
+#include "channel_occupancy.h"
+
+namespace ale {
+
+ChannelOccupancyDetector::ChannelOccupancyDetector()
+    : listening(false), window_start_ms(0), frames(0), active_frames(0),
+      tonal_frames(0), level_db_sum(0.0f) {}
+
+ChannelOccupancyDetector::ChannelOccupancyDetector(const OccupancyConfig& config)
+    : ChannelOccupancyDetector() {
+    this->config = config;
+}
+
+void ChannelOccupancyDetector::start(uint32_t current_time_ms) {
+    listening = true;
+    window_start_ms = current_time_ms;
+    frames = 0;
+    active_frames = 0;
+    tonal_frames = 0;
+    level_db_sum = 0.0f;
+}
+
+void ChannelOccupancyDetector::add_measurement(const BandEnergy& energy) {
+    if (!listening) {
+        return;
+    }
+    
+    ++frames;
+    
+    float level_db = energy.level_db();
+    level_db_sum += level_db;
+    
+    if (energy.is_active(level_db, config.threshold_db, config.min_magnitude)) {
+        ++active_frames;
+        if (energy.peak_to_mean() >= config.tonal_ratio) {
+            ++tonal_frames;
+        }
+    }
+}
+
+bool ChannelOccupancyDetector::window_complete(uint32_t current_time_ms) const {
+    return listening && (current_time_ms - window_start_ms) >= config.window_ms;
+}
+
+OccupancyResult ChannelOccupancyDetector::result() const {
+    OccupancyResult r;
+    r.frames = frames;
+    r.active_frames = active_frames;
+    
+    if (frames == 0) {
+        return r;  // No measurements, treat as clear
+    }
+    
+    r.mean_level_db = level_db_sum / frames;
+    
+    float active_fraction = static_cast<float>(active_frames) / frames;
+    r.busy = (active_fraction >= config.busy_fraction) && (active_frames > 0);
+    
+    if (active_frames > 0) {
+        // Majority of active frames decides data vs voice
+        r.activity = (tonal_frames * 2 >= active_frames) ? ChannelActivity::DATA
+                                                         : ChannelActivity::VOICE;
+    }
+    
+    return r;
+}
+
+void ChannelOccupancyDetector::reset() {
+    listening = false;
+    window_start_ms = 0;
+    frames = 0;
+    active_frames = 0;
+    tonal_frames = 0;
+    level_db_sum = 0.0f;
+}
+
+const char* ChannelOccupancyDetector::activity_name(ChannelActivity activity) {
+    switch (activity) {
+        case ChannelActivity::CLEAR: return "CLEAR";
+        case ChannelActivity::DATA:  return "DATA";
+        case ChannelActivity::VOICE: return "VOICE";
+    }
+    return "UNKNOWN";
+}
+
+} // namespace ale
@@ -4,6 +4,7 @@
  */
 
 #include "ale/lqa_analyzer.h"
+#include "ale/sounding_scheduler.h"
 #include <algorithm>
 #include <chrono>
 #include <sstream>
@@ -13,7 +14,8 @@
 namespace ale {
 
 LQAAnalyzer::LQAAnalyzer(LQADatabase* database)
-    : database_(database), sounding_cb_(nullptr) {
+    : database_(database), sounding_cb_(nullptr), scheduler_(nullptr),
+      channel_stats_(nullptr) {
 }
 
 void LQAAnalyzer::set_config(const AnalyzerConfig& config) {
@@ -92,14 +94,18 @@ std::shared_ptr<ChannelRank> LQAAnalyzer::get_best_channel_for_station(
         return nullptr;
     }
     
-    // Find entry with highest score
-    auto best = std::max_element(entries.begin(), entries.end(),
-        [](const LQAEntry& a, const LQAEntry& b) {
-            return a.score < b.score;
-        });
+    // Find entry with highest score, passing over occupied channels
+    uint32_t now = channel_stats_ ? get_current_time_ms() : 0;
+    auto best = entries.end();
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+        if ((best == entries.end() || it->score > best->score) &&
+            !is_channel_occupied(it->frequency_hz, now)) {
+            best = it;
+        }
+    }
     
     // Check if score meets minimum threshold
-    if (best->score < config_.min_acceptable_score) {
+    if (best == entries.end() || best->score < config_.min_acceptable_score) {
         return nullptr;
     }
     
@@ -123,14 +129,18 @@ std::shared_ptr<ChannelRank> LQAAnalyzer::get_best_channel() const {
         return nullptr;
     }
     
-    // Find entry with highest score
-    auto best = std::max_element(all_entries.begin(), all_entries.end(),
-        [](const LQAEntry& a, const LQAEntry& b) {
-            return a.score < b.score;
-        });
+    // Find entry with highest score, passing over occupied channels
+    uint32_t now = channel_stats_ ? get_current_time_ms() : 0;
+    auto best = all_entries.end();
+    for (auto it = all_entries.begin(); it != all_entries.end(); ++it) {
+        if ((best == all_entries.end() || it->score > best->score) &&
+            !is_channel_occupied(it->frequency_hz, now)) {
+            best = it;
+        }
+    }
     
     // Check if score meets minimum threshold
-    if (best->score < config_.min_acceptable_score) {
+    if (best == all_entries.end() || best->score < config_.min_acceptable_score) {
         return nullptr;
     }
     
@@ -161,6 +171,7 @@ std::vector<ChannelRank> LQAAnalyzer::rank_all_channels() const {
     }
     
     // Create ranks
+    uint32_t now = channel_stats_ ? get_current_time_ms() : 0;
     for (const auto& pair : by_frequency) {
         uint32_t freq = pair.first;
         const auto& entries = pair.second;
@@ -180,6 +191,7 @@ std::vector<ChannelRank> LQAAnalyzer::rank_all_channels() const {
             latest_update = std::max(latest_update, update);
         }
         aggregate_score /= entries.size();
+        aggregate_score *= idle_factor(freq, now);
         
         ranks.emplace_back(freq, aggregate_score, best->remote_station, latest_update);
     }
@@ -204,9 +216,11 @@ std::vector<ChannelRank> LQAAnalyzer::rank_channels_for_station(
     
     auto entries = database_->get_entries_for_station(station);
     
+    uint32_t now = channel_stats_ ? get_current_time_ms() : 0;
     for (const auto& entry : entries) {
         uint32_t last_update = std::max(entry.last_contact_ms, entry.last_sounding_ms);
-        ranks.emplace_back(entry.frequency_hz, entry.score, station, last_update);
+        float score = entry.score * idle_factor(entry.frequency_hz, now);
+        ranks.emplace_back(entry.frequency_hz, score, station, last_update);
     }
     
     // Sort by score (highest first)
@@ -291,6 +305,40 @@ void LQAAnalyzer::set_sounding_callback(std::function<void(uint32_t)> callback)
     sounding_cb_ = callback;
 }
 
+void LQAAnalyzer::set_scheduler(SoundingScheduler* scheduler) {
+    scheduler_ = scheduler;
+}
+
+void LQAAnalyzer::set_channel_stats(ChannelStats* stats) {
+    channel_stats_ = stats;
+}
+
+ChannelStatsSummary LQAAnalyzer::get_channel_statistics(uint32_t frequency_hz) const {
+    if (!channel_stats_) {
+        ChannelStatsSummary summary;
+        summary.frequency_hz = frequency_hz;
+        return summary;
+    }
+    return channel_stats_->get_summary(frequency_hz, config_.occupancy_window_ms,
+                                       get_current_time_ms());
+}
+
+bool LQAAnalyzer::is_channel_occupied(uint32_t frequency_hz, uint32_t now_ms) const {
+    if (!channel_stats_) {
+        return false;
+    }
+    auto summary = channel_stats_->get_summary(frequency_hz, config_.occupancy_window_ms, now_ms);
+    return summary.frames > 0 && summary.busy_fraction > config_.max_busy_fraction;
+}
+
+float LQAAnalyzer::idle_factor(uint32_t frequency_hz, uint32_t now_ms) const {
+    if (!channel_stats_) {
+        return 1.0f;
+    }
+    auto summary = channel_stats_->get_summary(frequency_hz, config_.occupancy_window_ms, now_ms);
+    return 1.0f - summary.busy_fraction;
+}
+
 void LQAAnalyzer::update() {
     if (!database_) {
         return;
@@ -300,7 +348,15 @@ void LQAAnalyzer::update() {
     database_->prune_stale_entries();
     
     // Check for automatic sounding
-    if (config_.enable_automatic_sounding && sounding_cb_) {
+    if (config_.enable_automatic_sounding && sounding_cb_ && scheduler_) {
+        uint32_t now = get_current_time_ms();
+        scheduler_->sync_from_analyzer(*this);
+        SoundingBatch batch = scheduler_->plan(now);
+        for (const auto& s : batch.channels) {
+            sounding_cb_(s.frequency_hz);
+        }
+        scheduler_->mark_batch_sounded(batch, now);
+    } else if (config_.enable_automatic_sounding && sounding_cb_) {
         auto channels = get_channels_needing_sounding();
         for (uint32_t freq : channels) {
             sounding_cb_(freq);
@@ -339,7 +395,14 @@ std::string LQAAnalyzer::get_channel_quality_summary(uint32_t frequency_hz) cons
     std::ostringstream oss;
     oss << score_to_quality_level(avg_score)
         << " (SNR: " << std::fixed << std::setprecision(1) << avg_snr << "dB"
-        << ", Score: " << std::fixed << std::setprecision(0) << avg_score << ")";
+        << ", Score: " << std::fixed << std::setprecision(0) << avg_score;
+        
+    auto stats = get_channel_statistics(frequency_hz);
+    if (stats.frames > 0) {
+        oss << ", Busy: " << std::setprecision(0) << stats.busy_fraction * 100.0f << "%"
+            << ", Noise: " << std::setprecision(1) << stats.noise_p50_db << "dB";
+    }
+    oss << ")";
     
     return oss.str();
 }
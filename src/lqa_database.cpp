@@ -8,11 +8,24 @@
 #include <fstream>
 #include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <limits>
 
 namespace ale {
 
+void LQAUpdate::set_station(const std::string& address) {
+    station_length = static_cast<uint8_t>(std::min(address.size(), LQA_UPDATE_STATION_LENGTH));
+    std::memcpy(station, address.data(), station_length);
+}
+
+bool LQAUpdate::same_key(const LQAUpdate& other) const {
+    return frequency_hz == other.frequency_hz && station_length == other.station_length &&
+           std::memcmp(station, other.station, station_length) == 0;
+}
+
 LQADatabase::LQADatabase() {
     // Default configuration already set in LQAConfig struct
+    params_ = make_score_params(config_);
 }
 
 LQADatabase::~LQADatabase() {
@@ -21,6 +34,10 @@ LQADatabase::~LQADatabase() {
 
 void LQADatabase::set_config(const LQAConfig& config) {
     config_ = config;
+    params_ = make_score_params(config_);
+    
+    // Stored scores were computed with the old weights
+    rescore_all();
 }
 
 LQAConfig LQADatabase::get_config() const {
@@ -50,54 +67,31 @@ void LQADatabase::update_entry(uint32_t frequency_hz,
                                int fec_errors,
                                int total_words,
                                uint32_t timestamp_ms) {
-    EntryKey key{frequency_hz, remote_station};
     uint32_t now = (timestamp_ms == 0) ? get_current_time_ms() : timestamp_ms;
     
-    auto it = entries_.find(key);
-    if (it != entries_.end()) {
+    bool created = false;
+    size_t row = find_or_add_row(frequency_hz, remote_station, created);
+    if (!created) {
         // Entry exists - perform time-weighted averaging
-        LQAEntry& entry = it->second;
-        uint32_t old_samples = entry.sample_count;
+        uint32_t old_samples = columns_.sample_count[row];
         
         // Update metrics with time weighting
-        entry.snr_db = time_weighted_average(entry.snr_db, snr_db, old_samples);
-        entry.ber = time_weighted_average(entry.ber, ber, old_samples);
-        entry.fec_errors += fec_errors;
-        entry.total_words += total_words;
-        entry.sample_count++;
-        
-        // Update timestamps
-        if (!remote_station.empty()) {
-            entry.last_contact_ms = now;
-        } else {
-            entry.last_sounding_ms = now;
-        }
-        
-        // Recompute score
-        entry.score = compute_score(entry);
-        
+        columns_.snr_db[row] = time_weighted_average(columns_.snr_db[row], snr_db, old_samples);
+        columns_.ber[row] = time_weighted_average(columns_.ber[row], ber, old_samples);
+        columns_.fec_errors[row] += fec_errors;
+        columns_.total_words[row] += total_words;
+        columns_.sample_count[row]++;
     } else {
-        // Create new entry
-        LQAEntry entry;
-        entry.frequency_hz = frequency_hz;
-        entry.remote_station = remote_station;
-        entry.snr_db = snr_db;
-        entry.ber = ber;
-        entry.fec_errors = fec_errors;
-        entry.total_words = total_words;
-        entry.sample_count = 1;
-        
-        if (!remote_station.empty()) {
-            entry.last_contact_ms = now;
-        } else {
-            entry.last_sounding_ms = now;
-        }
-        
-        // Compute initial score
-        entry.score = compute_score(entry);
-        
-        entries_[key] = entry;
+        // New entry
+        columns_.snr_db[row] = snr_db;
+        columns_.ber[row] = ber;
+        columns_.fec_errors[row] = fec_errors;
+        columns_.total_words[row] = total_words;
+        columns_.sample_count[row] = 1;
     }
+    
+    // Update timestamps and recompute score
+    touch_row(row, remote_station, now);
 }
 
 void LQADatabase::update_entry_extended(uint32_t frequency_hz,
@@ -110,79 +104,126 @@ void LQADatabase::update_entry_extended(uint32_t frequency_hz,
                                        int fec_errors,
                                        int total_words,
                                        uint32_t timestamp_ms) {
-    EntryKey key{frequency_hz, remote_station};
     uint32_t now = (timestamp_ms == 0) ? get_current_time_ms() : timestamp_ms;
     
-    auto it = entries_.find(key);
-    if (it != entries_.end()) {
+    bool created = false;
+    size_t row = find_or_add_row(frequency_hz, remote_station, created);
+    if (!created) {
         // Entry exists - perform time-weighted averaging
-        LQAEntry& entry = it->second;
-        uint32_t old_samples = entry.sample_count;
+        uint32_t old_samples = columns_.sample_count[row];
         
         // Update all metrics with time weighting
-        entry.snr_db = time_weighted_average(entry.snr_db, snr_db, old_samples);
-        entry.ber = time_weighted_average(entry.ber, ber, old_samples);
-        entry.sinad_db = time_weighted_average(entry.sinad_db, sinad_db, old_samples);
-        entry.multipath_score = time_weighted_average(entry.multipath_score, 
-                                                      multipath_score, old_samples);
-        entry.noise_floor_dbm = time_weighted_average(entry.noise_floor_dbm, 
-                                                      noise_floor_dbm, old_samples);
-        entry.fec_errors += fec_errors;
-        entry.total_words += total_words;
-        entry.sample_count++;
-        
-        // Update timestamps
-        if (!remote_station.empty()) {
-            entry.last_contact_ms = now;
-        } else {
-            entry.last_sounding_ms = now;
+        columns_.snr_db[row] = time_weighted_average(columns_.snr_db[row], snr_db, old_samples);
+        columns_.ber[row] = time_weighted_average(columns_.ber[row], ber, old_samples);
+        columns_.sinad_db[row] = time_weighted_average(columns_.sinad_db[row], sinad_db,
+                                                       old_samples);
+        columns_.multipath_score[row] = time_weighted_average(columns_.multipath_score[row],
+                                                              multipath_score, old_samples);
+        columns_.noise_floor_dbm[row] = time_weighted_average(columns_.noise_floor_dbm[row],
+                                                              noise_floor_dbm, old_samples);
+        columns_.fec_errors[row] += fec_errors;
+        columns_.total_words[row] += total_words;
+        columns_.sample_count[row]++;
+    } else {
+        // New entry
+        columns_.snr_db[row] = snr_db;
+        columns_.ber[row] = ber;
+        columns_.sinad_db[row] = sinad_db;
+        columns_.multipath_score[row] = multipath_score;
+        columns_.noise_floor_dbm[row] = noise_floor_dbm;
+        columns_.fec_errors[row] = fec_errors;
+        columns_.total_words[row] = total_words;
+        columns_.sample_count[row] = 1;
+    }
+    
+    // Update timestamps and recompute score
+    touch_row(row, remote_station, now);
+}
+
+bool LQADatabase::merge_entry(const LQAEntry& remote, float weight) {
+    uint32_t remote_activity = std::max(remote.last_contact_ms, remote.last_sounding_ms);
+    if (remote_activity == 0 || weight <= 0.0f) {
+        return false;
+    }
+    
+    bool created = false;
+    size_t row = find_or_add_row(remote.frequency_hz, remote.remote_station, created);
+    if (!created) {
+        // Only news: a table received twice is folded in once
+        if (static_cast<int32_t>(remote_activity - columns_.last_activity_ms[row]) <= 0) {
+            return false;
         }
         
-        // Recompute score
-        entry.score = compute_score(entry);
-        
+        // Like a local update, but the remote observation counts weight
+        // samples instead of one
+        float decay = config_.time_decay_factor;
+        float old_weight = columns_.sample_count[row] * decay;
+        float total_weight = old_weight + weight;
+        columns_.snr_db[row] = (columns_.snr_db[row] * old_weight + remote.snr_db * weight) /
+                               total_weight;
+        columns_.ber[row] = (columns_.ber[row] * old_weight + remote.ber * weight) / total_weight;
+        columns_.sample_count[row]++;
     } else {
-        // Create new entry
-        LQAEntry entry;
-        entry.frequency_hz = frequency_hz;
-        entry.remote_station = remote_station;
-        entry.snr_db = snr_db;
-        entry.ber = ber;
-        entry.sinad_db = sinad_db;
-        entry.multipath_score = multipath_score;
-        entry.noise_floor_dbm = noise_floor_dbm;
-        entry.fec_errors = fec_errors;
-        entry.total_words = total_words;
-        entry.sample_count = 1;
-        
-        if (!remote_station.empty()) {
-            entry.last_contact_ms = now;
-        } else {
-            entry.last_sounding_ms = now;
-        }
+        columns_.snr_db[row] = remote.snr_db;
+        columns_.ber[row] = remote.ber;
+        columns_.sample_count[row] = 1;
+    }
+    if (remote.total_words > 0) {
+        columns_.total_words[row] += std::max(1, static_cast<int>(remote.total_words * weight));
+    }
+    
+    columns_.last_contact_ms[row] = std::max(columns_.last_contact_ms[row], remote.last_contact_ms);
+    columns_.last_sounding_ms[row] = std::max(columns_.last_sounding_ms[row],
+                                              remote.last_sounding_ms);
+    refresh_row(row);
+    return true;
+}
+
+void LQADatabase::apply_updates(const LQAUpdate* updates, size_t count) {
+    uint32_t current_ms = 0;
+    size_t i = 0;
+    while (i < count) {
+        const LQAUpdate& first = updates[i];
+        std::string station = first.get_station();
+        bool created = false;
+        size_t row = find_or_add_row(first.frequency_hz, station, created);
         
-        // Compute initial score
-        entry.score = compute_score(entry);
+        // Run of records for this key: one lookup, one rescore
+        uint32_t now = 0;
+        do {
+            const LQAUpdate& update = updates[i];
+            if (update.timestamp_ms != 0) {
+                now = update.timestamp_ms;
+            } else {
+                if (current_ms == 0) {
+                    current_ms = get_current_time_ms();
+                }
+                now = current_ms;
+            }
+            fold_update(row, created, update);
+            created = false;
+            i++;
+        } while (i < count && updates[i].same_key(first));
         
-        entries_[key] = entry;
+        touch_row(row, station, now);
     }
 }
 
 std::shared_ptr<LQAEntry> LQADatabase::get_entry(uint32_t frequency_hz,
                                                  const std::string& remote_station) const {
     EntryKey key{frequency_hz, remote_station};
-    auto it = entries_.find(key);
-    if (it != entries_.end()) {
-        return std::make_shared<LQAEntry>(it->second);
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        return std::make_shared<LQAEntry>(row_entry(it->second));
     }
     return nullptr;
 }
 
 std::vector<LQAEntry> LQADatabase::get_entries_for_channel(uint32_t frequency_hz) const {
     std::vector<LQAEntry> result;
-    for (const auto& pair : entries_) {
+    for (const auto& pair : index_) {
         if (pair.first.frequency_hz == frequency_hz) {
-            result.push_back(pair.second);
+            result.push_back(row_entry(pair.second));
         }
     }
     return result;
@@ -190,9 +231,9 @@ std::vector<LQAEntry> LQADatabase::get_entries_for_channel(uint32_t frequency_hz
 
 std::vector<LQAEntry> LQADatabase::get_entries_for_station(const std::string& remote_station) const {
     std::vector<LQAEntry> result;
-    for (const auto& pair : entries_) {
+    for (const auto& pair : index_) {
         if (pair.first.remote_station == remote_station) {
-            result.push_back(pair.second);
+            result.push_back(row_entry(pair.second));
         }
     }
     return result;
@@ -200,69 +241,337 @@ std::vector<LQAEntry> LQADatabase::get_entries_for_station(const std::string& re
 
 std::vector<LQAEntry> LQADatabase::get_all_entries() const {
     std::vector<LQAEntry> result;
-    result.reserve(entries_.size());
-    for (const auto& pair : entries_) {
-        result.push_back(pair.second);
+    result.reserve(index_.size());
+    for (const auto& pair : index_) {
+        result.push_back(row_entry(pair.second));
     }
     return result;
 }
 
 int LQADatabase::prune_stale_entries() {
-    uint32_t now = get_current_time_ms();
+    return prune_expired(get_current_time_ms());
+}
+
+int LQADatabase::prune_expired(uint32_t now_ms, size_t limit) {
     int removed = 0;
     
-    auto it = entries_.begin();
-    while (it != entries_.end()) {
-        const LQAEntry& entry = it->second;
-        uint32_t last_activity = std::max(entry.last_contact_ms, entry.last_sounding_ms);
+    while (limit == 0 || static_cast<size_t>(removed) < limit) {
+        long row = top_expiry_row();
+        if (row < 0) {
+            break;
+        }
         
-        if ((now - last_activity) > config_.max_age_ms) {
-            it = entries_.erase(it);
-            removed++;
-        } else {
-            ++it;
+        // Oldest entry still fresh: so is everything else
+        if ((now_ms - columns_.last_activity_ms[row]) <= config_.max_age_ms) {
+            break;
         }
+        
+        std::pop_heap(expiry_.begin(), expiry_.end(), ExpiryLater());
+        expiry_.pop_back();
+        remove_row(static_cast<size_t>(row));
+        removed++;
     }
     
     return removed;
 }
 
+bool LQADatabase::next_expiry(uint32_t& expiry_ms) {
+    long row = top_expiry_row();
+    if (row < 0) {
+        return false;
+    }
+    expiry_ms = columns_.last_activity_ms[row] + config_.max_age_ms + 1;
+    return true;
+}
+
 void LQADatabase::clear() {
-    entries_.clear();
+    columns_ = EntryColumns();
+    index_.clear();
+    expiry_.clear();
 }
 
 float LQADatabase::compute_score(const LQAEntry& entry) const {
+    uint32_t last_activity = std::max(entry.last_contact_ms, entry.last_sounding_ms);
     float score = 0.0f;
+    score_kernel(params_, &entry.snr_db, &entry.ber, &entry.total_words, &last_activity,
+                 get_current_time_ms(), &score, 1);
+    return score;
+}
+
+void LQADatabase::rescore_all(uint32_t now_ms) {
+    uint32_t now = (now_ms == 0) ? get_current_time_ms() : now_ms;
+    score_kernel(params_, columns_.snr_db.data(), columns_.ber.data(),
+                 columns_.total_words.data(), columns_.last_activity_ms.data(), now,
+                 columns_.score.data(), columns_.size());
+}
+
+std::vector<float> LQADatabase::score_all(const LQAConfig& config, uint32_t now_ms) const {
+    uint32_t now = (now_ms == 0) ? get_current_time_ms() : now_ms;
+    std::vector<float> row_scores(columns_.size());
+    score_kernel(make_score_params(config), columns_.snr_db.data(), columns_.ber.data(),
+                 columns_.total_words.data(), columns_.last_activity_ms.data(), now,
+                 row_scores.data(), row_scores.size());
     
-    // SNR component (0-31 scale)
-    // Map SNR dB to 0-31: 0 dB = 0, 31 dB+ = 31
-    float snr_component = std::min(31.0f, std::max(0.0f, entry.snr_db));
-    score += snr_component * config_.snr_weight;
-    
-    // Success rate component (0-31 scale)
-    // Based on BER: 0 BER = 31, high BER = 0
-    float success_rate = 0.0f;
-    if (entry.total_words > 0) {
-        // Convert BER to success rate (1.0 - BER) and scale to 0-31
-        success_rate = (1.0f - std::min(1.0f, entry.ber)) * 31.0f;
+    // Rows are unordered; report in key order
+    std::vector<float> result;
+    result.reserve(index_.size());
+    for (const auto& pair : index_) {
+        result.push_back(row_scores[pair.second]);
+    }
+    return result;
+}
+
+LQADatabase::ScoreParams LQADatabase::make_score_params(const LQAConfig& config) {
+    ScoreParams params;
+    params.snr_weight = config.snr_weight;
+    params.success_weight = config.success_weight;
+    params.recency_weight = config.recency_weight;
+    params.max_age_ms = std::min<uint32_t>(config.max_age_ms,
+                                           std::numeric_limits<int32_t>::max());
+    params.max_age = static_cast<float>(std::max<uint32_t>(params.max_age_ms, 1));
+    return params;
+}
+
+// value if keep, else 0.0f, without a branch
+static inline float keep_if(float value, bool keep) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    bits &= 0u - static_cast<uint32_t>(keep);
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+void LQADatabase::score_kernel(const ScoreParams& params,
+                               const float* snr_db,
+                               const float* ber,
+                               const int* total_words,
+                               const uint32_t* last_activity_ms,
+                               uint32_t now_ms,
+                               float* scores,
+                               size_t count) {
+    // Weighted SNR, success rate and recency, each on a 0-31 scale
+    // (MIL-STD-188-141B). Selects instead of branches so the loop
+    // vectorizes: conditions mask bits, since float arithmetic feeding a
+    // select (or a 0/1 factor) gets sunk into a branch the vectorizer
+    // cannot convert (floating point may trap); for the same reason the
+    // 0-31 scaling is folded into the weights. The age is clamped to max
+    // age before the float conversion, which then fits a signed one.
+    const float snr_weight = params.snr_weight;
+    const float success_weight = 31.0f * params.success_weight;
+    const float recency_weight = 31.0f * params.recency_weight;
+    const uint32_t max_age_ms = params.max_age_ms;
+    const float max_age = params.max_age;
+    for (size_t i = 0; i < count; i++) {
+        float snr = snr_db[i];
+        float error_rate = ber[i];
+        int words = total_words[i];
+        uint32_t last_activity = last_activity_ms[i];
+        
+        // SNR component: 0 dB = 0, 31 dB+ = 31
+        float snr_component = std::min(31.0f, std::max(0.0f, snr));
+        
+        // Success rate component: 0 BER = 1, high BER = 0 (none without words)
+        float success_rate = std::max(0.0f, 1.0f - error_rate);
+        success_rate = keep_if(success_rate, words > 0);
+        
+        // Recency component: recent contact = 1, max age or older = 0
+        // (none without contact)
+        uint32_t age_ms = std::min(now_ms - last_activity, max_age_ms);
+        float age = static_cast<float>(static_cast<int32_t>(age_ms));
+        float recency = keep_if(1.0f - age / max_age, last_activity > 0);
+        
+        float score = snr_component * snr_weight;
+        score += success_rate * success_weight;
+        score += recency * recency_weight;
+        
+        // Clamp to 0-31 range
+        scores[i] = std::min(31.0f, std::max(0.0f, score));
+    }
+}
+
+size_t LQADatabase::find_or_add_row(uint32_t frequency_hz, const std::string& remote_station,
+                                    bool& created) {
+    EntryKey key{frequency_hz, remote_station};
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        created = false;
+        return it->second;
     }
-    score += success_rate * config_.success_weight;
     
-    // Recency component (0-31 scale)
-    // Recent contact = 31, old contact = 0
-    uint32_t now = get_current_time_ms();
-    uint32_t last_activity = std::max(entry.last_contact_ms, entry.last_sounding_ms);
+    LQAEntry entry;
+    entry.frequency_hz = frequency_hz;
+    entry.remote_station = remote_station;
+    add_row(entry);
+    created = true;
+    return columns_.size() - 1;
+}
+
+void LQADatabase::add_row(const LQAEntry& entry) {
+    index_[EntryKey{entry.frequency_hz, entry.remote_station}] = columns_.size();
+    columns_.frequency_hz.push_back(entry.frequency_hz);
+    columns_.remote_station.push_back(entry.remote_station);
+    columns_.snr_db.push_back(entry.snr_db);
+    columns_.ber.push_back(entry.ber);
+    columns_.sinad_db.push_back(entry.sinad_db);
+    columns_.fec_errors.push_back(entry.fec_errors);
+    columns_.total_words.push_back(entry.total_words);
+    columns_.multipath_score.push_back(entry.multipath_score);
+    columns_.noise_floor_dbm.push_back(entry.noise_floor_dbm);
+    columns_.last_sounding_ms.push_back(entry.last_sounding_ms);
+    columns_.last_contact_ms.push_back(entry.last_contact_ms);
+    columns_.last_activity_ms.push_back(std::max(entry.last_contact_ms, entry.last_sounding_ms));
+    columns_.score.push_back(entry.score);
+    columns_.sample_count.push_back(entry.sample_count);
+}
+
+LQAEntry LQADatabase::row_entry(size_t row) const {
+    LQAEntry entry;
+    entry.frequency_hz = columns_.frequency_hz[row];
+    entry.remote_station = columns_.remote_station[row];
+    entry.snr_db = columns_.snr_db[row];
+    entry.ber = columns_.ber[row];
+    entry.sinad_db = columns_.sinad_db[row];
+    entry.fec_errors = columns_.fec_errors[row];
+    entry.total_words = columns_.total_words[row];
+    entry.multipath_score = columns_.multipath_score[row];
+    entry.noise_floor_dbm = columns_.noise_floor_dbm[row];
+    entry.last_sounding_ms = columns_.last_sounding_ms[row];
+    entry.last_contact_ms = columns_.last_contact_ms[row];
+    entry.score = columns_.score[row];
+    entry.sample_count = columns_.sample_count[row];
+    return entry;
+}
+
+void LQADatabase::touch_row(size_t row, const std::string& remote_station, uint32_t now_ms) {
+    if (!remote_station.empty()) {
+        columns_.last_contact_ms[row] = now_ms;
+    } else {
+        columns_.last_sounding_ms[row] = now_ms;
+    }
+    refresh_row(row);
+}
+
+void LQADatabase::refresh_row(size_t row) {
+    uint32_t last_activity = std::max(columns_.last_contact_ms[row],
+                                      columns_.last_sounding_ms[row]);
+    if (last_activity != columns_.last_activity_ms[row]) {
+        columns_.last_activity_ms[row] = last_activity;
+        push_expiry(row);
+    }
     
-    if (last_activity > 0) {
-        uint32_t age_ms = now - last_activity;
-        float age_factor = 1.0f - (static_cast<float>(age_ms) / config_.max_age_ms);
-        age_factor = std::max(0.0f, std::min(1.0f, age_factor));
-        float recency = age_factor * 31.0f;
-        score += recency * config_.recency_weight;
+    // Same kernel as rescore_all(), over one row; recency is aged
+    // against the current time like compute_score(), not the measurement
+    score_kernel(params_, &columns_.snr_db[row], &columns_.ber[row],
+                 &columns_.total_words[row], &columns_.last_activity_ms[row],
+                 get_current_time_ms(), &columns_.score[row], 1);
+}
+
+void LQADatabase::fold_update(size_t row, bool created, const LQAUpdate& update) {
+    bool extended = (update.flags & LQA_UPDATE_EXTENDED) != 0;
+    if (created) {
+        columns_.snr_db[row] = update.snr_db;
+        columns_.ber[row] = update.ber;
+        if (extended) {
+            columns_.sinad_db[row] = update.sinad_db;
+            columns_.multipath_score[row] = update.multipath_score;
+            columns_.noise_floor_dbm[row] = update.noise_floor_dbm;
+        }
+        columns_.fec_errors[row] = update.fec_errors;
+        columns_.total_words[row] = update.total_words;
+        columns_.sample_count[row] = 1;
+        return;
     }
     
-    // Clamp to 0-31 range
-    return std::min(31.0f, std::max(0.0f, score));
+    uint32_t old_samples = columns_.sample_count[row];
+    columns_.snr_db[row] = time_weighted_average(columns_.snr_db[row], update.snr_db, old_samples);
+    columns_.ber[row] = time_weighted_average(columns_.ber[row], update.ber, old_samples);
+    if (extended) {
+        columns_.sinad_db[row] = time_weighted_average(columns_.sinad_db[row], update.sinad_db,
+                                                       old_samples);
+        columns_.multipath_score[row] = time_weighted_average(columns_.multipath_score[row],
+                                                              update.multipath_score, old_samples);
+        columns_.noise_floor_dbm[row] = time_weighted_average(columns_.noise_floor_dbm[row],
+                                                              update.noise_floor_dbm, old_samples);
+    }
+    columns_.fec_errors[row] += update.fec_errors;
+    columns_.total_words[row] += update.total_words;
+    columns_.sample_count[row]++;
+}
+
+void LQADatabase::remove_row(size_t row) {
+    index_.erase(EntryKey{columns_.frequency_hz[row], columns_.remote_station[row]});
+    
+    size_t last = columns_.size() - 1;
+    if (row != last) {
+        columns_.frequency_hz[row] = columns_.frequency_hz[last];
+        columns_.remote_station[row] = std::move(columns_.remote_station[last]);
+        columns_.snr_db[row] = columns_.snr_db[last];
+        columns_.ber[row] = columns_.ber[last];
+        columns_.sinad_db[row] = columns_.sinad_db[last];
+        columns_.fec_errors[row] = columns_.fec_errors[last];
+        columns_.total_words[row] = columns_.total_words[last];
+        columns_.multipath_score[row] = columns_.multipath_score[last];
+        columns_.noise_floor_dbm[row] = columns_.noise_floor_dbm[last];
+        columns_.last_sounding_ms[row] = columns_.last_sounding_ms[last];
+        columns_.last_contact_ms[row] = columns_.last_contact_ms[last];
+        columns_.last_activity_ms[row] = columns_.last_activity_ms[last];
+        columns_.score[row] = columns_.score[last];
+        columns_.sample_count[row] = columns_.sample_count[last];
+        index_[EntryKey{columns_.frequency_hz[row], columns_.remote_station[row]}] = row;
+    }
+    
+    columns_.frequency_hz.pop_back();
+    columns_.remote_station.pop_back();
+    columns_.snr_db.pop_back();
+    columns_.ber.pop_back();
+    columns_.sinad_db.pop_back();
+    columns_.fec_errors.pop_back();
+    columns_.total_words.pop_back();
+    columns_.multipath_score.pop_back();
+    columns_.noise_floor_dbm.pop_back();
+    columns_.last_sounding_ms.pop_back();
+    columns_.last_contact_ms.pop_back();
+    columns_.last_activity_ms.pop_back();
+    columns_.score.pop_back();
+    columns_.sample_count.pop_back();
+}
+
+void LQADatabase::push_expiry(size_t row) {
+    // Superseded items pile up as entries are refreshed; rebuild before
+    // they outnumber the live ones
+    if (expiry_.size() >= 2 * columns_.size() + 64) {
+        rebuild_expiry();
+        return;
+    }
+    
+    EntryKey key{columns_.frequency_hz[row], columns_.remote_station[row]};
+    expiry_.push_back(ExpiryItem{columns_.last_activity_ms[row], key});
+    std::push_heap(expiry_.begin(), expiry_.end(), ExpiryLater());
+}
+
+long LQADatabase::top_expiry_row() {
+    while (!expiry_.empty()) {
+        const ExpiryItem& top = expiry_.front();
+        auto it = index_.find(top.key);
+        if (it != index_.end() && columns_.last_activity_ms[it->second] == top.last_activity_ms) {
+            return static_cast<long>(it->second);
+        }
+        
+        // Entry removed or active since
+        std::pop_heap(expiry_.begin(), expiry_.end(), ExpiryLater());
+        expiry_.pop_back();
+    }
+    return -1;
+}
+
+void LQADatabase::rebuild_expiry() {
+    expiry_.clear();
+    expiry_.reserve(columns_.size());
+    for (size_t row = 0; row < columns_.size(); row++) {
+        EntryKey key{columns_.frequency_hz[row], columns_.remote_station[row]};
+        expiry_.push_back(ExpiryItem{columns_.last_activity_ms[row], key});
+    }
+    std::make_heap(expiry_.begin(), expiry_.end(), ExpiryLater());
 }
 
 bool LQADatabase::save_to_file(const std::string& filepath) const {
@@ -282,12 +591,12 @@ bool LQADatabase::save_to_file(const std::string& filepath) const {
     file.write(reinterpret_cast<const char*>(&config_), sizeof(config_));
     
     // Write entry count
-    uint32_t count = static_cast<uint32_t>(entries_.size());
+    uint32_t count = static_cast<uint32_t>(index_.size());
     file.write(reinterpret_cast<const char*>(&count), sizeof(count));
     
     // Write each entry
-    for (const auto& pair : entries_) {
-        const LQAEntry& entry = pair.second;
+    for (const auto& pair : index_) {
+        const LQAEntry entry = row_entry(pair.second);
         
         // Write frequency
         file.write(reinterpret_cast<const char*>(&entry.frequency_hz), 
@@ -342,13 +651,14 @@ bool LQADatabase::load_from_file(const std::string& filepath) {
     
     // Read config
     file.read(reinterpret_cast<char*>(&config_), sizeof(config_));
+    params_ = make_score_params(config_);
     
     // Read entry count
     uint32_t count;
     file.read(reinterpret_cast<char*>(&count), sizeof(count));
     
     // Clear existing entries
-    entries_.clear();
+    clear();
     
     // Read each entry
     for (uint32_t i = 0; i < count; i++) {
@@ -381,10 +691,12 @@ bool LQADatabase::load_from_file(const std::string& filepath) {
         file.read(reinterpret_cast<char*>(&entry.score), sizeof(entry.score));
         file.read(reinterpret_cast<char*>(&entry.sample_count), sizeof(entry.sample_count));
         
-        // Store entry
-        EntryKey key{entry.frequency_hz, entry.remote_station};
-        entries_[key] = entry;
+        // Store entry (first copy wins if the file repeats a key)
+        if (index_.count(EntryKey{entry.frequency_hz, entry.remote_station}) == 0) {
+            add_row(entry);
+        }
     }
+    rebuild_expiry();
     
     file.close();
     return true;
@@ -401,8 +713,8 @@ bool LQADatabase::export_to_csv(const std::string& filepath) const {
          << "Multipath,Noise_Floor(dBm),Last_Sounding_ms,Last_Contact_ms,Score,Samples\n";
     
     // Write each entry
-    for (const auto& pair : entries_) {
-        const LQAEntry& entry = pair.second;
+    for (const auto& pair : index_) {
+        const LQAEntry entry = row_entry(pair.second);
         file << entry.frequency_hz << ","
              << entry.remote_station << ","
              << entry.snr_db << ","
@@ -423,7 +735,7 @@ bool LQADatabase::export_to_csv(const std::string& filepath) const {
 }
 
 size_t LQADatabase::get_entry_count() const {
-    return entries_.size();
+    return index_.size();
 }
 
 } // namespace ale
@@ -0,0 +1,260 @@
+/**
+ * @file lqa_exchange.cpp
+ * @brief Implementation of LQA table exchange
+ */
+
+#include "ale/lqa_exchange.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+namespace ale {
+
+static const uint8_t EXCHANGE_MAGIC_0 = 'L';
+static const uint8_t EXCHANGE_MAGIC_1 = 'X';
+static const size_t EXCHANGE_HEADER_SIZE = 12;
+
+static const uint8_t EXCHANGE_FLAG_DELTA = 0x01;
+static const uint8_t ENTRY_FLAG_SOUNDING = 0x01;
+
+// SNR: 0.5 dB steps from -30 dB (byte 0) to 97.5 dB (byte 255)
+static const float SNR_OFFSET_DB = 30.0f;
+static const float SNR_STEPS_PER_DB = 2.0f;
+
+// BER: 32 steps per decade from 1 (byte 0) down to 1e-8 and below
+static const float BER_STEPS_PER_DECADE = 32.0f;
+
+// Score: 1/8 steps over 0-31
+static const float SCORE_STEPS = 8.0f;
+
+static void put_u32(std::vector<uint8_t>& out, uint32_t value) {
+    out.push_back((value >> 24) & 0xFF);
+    out.push_back((value >> 16) & 0xFF);
+    out.push_back((value >> 8) & 0xFF);
+    out.push_back(value & 0xFF);
+}
+
+static uint32_t get_u32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) |
+           (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) |
+           static_cast<uint32_t>(p[3]);
+}
+
+static void put_varint(std::vector<uint8_t>& out, uint32_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+static bool get_varint(const uint8_t* data, size_t length, size_t& pos, uint32_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (pos >= length) {
+            return false;
+        }
+        uint8_t byte = data[pos++];
+        value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static uint8_t quantize(float value, float offset, float steps) {
+    float q = std::round((value + offset) * steps);
+    return static_cast<uint8_t>(std::min(255.0f, std::max(0.0f, q)));
+}
+
+static uint8_t quantize_ber(float ber) {
+    if (ber >= 1.0f) {
+        return 0;
+    }
+    if (ber <= 0.0f) {
+        return 255;
+    }
+    return quantize(-std::log10(ber), 0.0f, BER_STEPS_PER_DECADE);
+}
+
+static float dequantize_ber(uint8_t q) {
+    return q == 255 ? 0.0f : std::pow(10.0f, -q / BER_STEPS_PER_DECADE);
+}
+
+LQAExchange::LQAExchange(LQADatabase* database)
+    : database_(database), merge_weight_(0.5f) {
+}
+
+void LQAExchange::set_database(LQADatabase* database) {
+    database_ = database;
+}
+
+void LQAExchange::set_merge_weight(float weight) {
+    merge_weight_ = std::min(1.0f, std::max(0.0f, weight));
+}
+
+std::vector<uint8_t> LQAExchange::encode(uint32_t now_ms, uint32_t since_ms) const {
+    std::vector<LQAEntry> entries;
+    if (database_) {
+        // Key order: by frequency, then station
+        entries = database_->get_all_entries();
+    }
+    
+    // Delta: entries active after since_ms
+    if (since_ms != 0) {
+        entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                     [since_ms](const LQAEntry& entry) {
+                                         uint32_t last = std::max(entry.last_contact_ms,
+                                                                  entry.last_sounding_ms);
+                                         return static_cast<int32_t>(last - since_ms) <= 0;
+                                     }),
+                      entries.end());
+    }
+    
+    std::vector<uint8_t> out;
+    out.reserve(EXCHANGE_HEADER_SIZE + entries.size() * 10);
+    out.push_back(EXCHANGE_MAGIC_0);
+    out.push_back(EXCHANGE_MAGIC_1);
+    out.push_back(LQA_EXCHANGE_VERSION);
+    out.push_back(since_ms != 0 ? EXCHANGE_FLAG_DELTA : 0);
+    put_u32(out, now_ms);
+    put_u32(out, since_ms);
+    
+    // Station table, in order of first use
+    std::map<std::string, uint32_t> station_ids;
+    std::vector<const std::string*> stations;
+    for (const auto& entry : entries) {
+        if (station_ids.emplace(entry.remote_station, static_cast<uint32_t>(stations.size())).second) {
+            stations.push_back(&entry.remote_station);
+        }
+    }
+    put_varint(out, static_cast<uint32_t>(stations.size()));
+    for (const std::string* station : stations) {
+        size_t length = std::min<size_t>(station->size(), 255);
+        out.push_back(static_cast<uint8_t>(length));
+        out.insert(out.end(), station->begin(), station->begin() + length);
+    }
+    
+    put_varint(out, static_cast<uint32_t>(entries.size()));
+    uint32_t previous_hz = 0;
+    for (const auto& entry : entries) {
+        uint32_t last = std::max(entry.last_contact_ms, entry.last_sounding_ms);
+        uint32_t age_ms = static_cast<int32_t>(now_ms - last) > 0 ? now_ms - last : 0;
+        
+        put_varint(out, entry.frequency_hz - previous_hz);
+        previous_hz = entry.frequency_hz;
+        put_varint(out, station_ids[entry.remote_station]);
+        out.push_back(quantize(entry.snr_db, SNR_OFFSET_DB, SNR_STEPS_PER_DB));
+        out.push_back(quantize_ber(entry.ber));
+        out.push_back(quantize(entry.score, 0.0f, SCORE_STEPS));
+        put_varint(out, (age_ms + 500) / 1000);
+        put_varint(out, entry.sample_count);
+        put_varint(out, static_cast<uint32_t>(std::max(0, entry.total_words)));
+        out.push_back(entry.last_sounding_ms > entry.last_contact_ms ? ENTRY_FLAG_SOUNDING : 0);
+    }
+    
+    return out;
+}
+
+bool LQAExchange::decode(const uint8_t* data, size_t length, LQAExchangeTable& table) {
+    if (length < EXCHANGE_HEADER_SIZE || data[0] != EXCHANGE_MAGIC_0 ||
+        data[1] != EXCHANGE_MAGIC_1 || data[2] != LQA_EXCHANGE_VERSION) {
+        return false;
+    }
+    
+    table = LQAExchangeTable();
+    table.sender_time_ms = get_u32(data + 4);
+    table.since_ms = get_u32(data + 8);
+    size_t pos = EXCHANGE_HEADER_SIZE;
+    
+    uint32_t station_count = 0;
+    if (!get_varint(data, length, pos, station_count) || station_count > length - pos) {
+        return false;
+    }
+    std::vector<std::string> stations(station_count);
+    for (auto& station : stations) {
+        if (pos >= length || data[pos] > length - pos - 1) {
+            return false;
+        }
+        size_t station_length = data[pos++];
+        station.assign(reinterpret_cast<const char*>(data + pos), station_length);
+        pos += station_length;
+    }
+    
+    uint32_t entry_count = 0;
+    if (!get_varint(data, length, pos, entry_count) || entry_count > length - pos) {
+        return false;
+    }
+    table.entries.resize(entry_count);
+    uint32_t frequency_hz = 0;
+    for (auto& entry : table.entries) {
+        uint32_t frequency_delta = 0;
+        uint32_t station = 0;
+        if (!get_varint(data, length, pos, frequency_delta) ||
+            !get_varint(data, length, pos, station) || station >= station_count ||
+            length - pos < 3) {
+            return false;
+        }
+        frequency_hz += frequency_delta;
+        entry.frequency_hz = frequency_hz;
+        entry.remote_station = stations[station];
+        entry.snr_db = data[pos++] / SNR_STEPS_PER_DB - SNR_OFFSET_DB;
+        entry.ber = dequantize_ber(data[pos++]);
+        entry.score = data[pos++] / SCORE_STEPS;
+        if (!get_varint(data, length, pos, entry.age_s) ||
+            !get_varint(data, length, pos, entry.sample_count) ||
+            !get_varint(data, length, pos, entry.total_words) ||
+            pos >= length) {
+            return false;
+        }
+        entry.sounding = (data[pos++] & ENTRY_FLAG_SOUNDING) != 0;
+    }
+    
+    return pos == length;
+}
+
+int LQAExchange::merge(const LQAExchangeTable& table,
+                       const std::string& source_station,
+                       const std::string& local_station,
+                       uint32_t now_ms) {
+    if (!database_) {
+        return 0;
+    }
+    
+    // Ages beyond the database max age are stale anyway; clamping them
+    // keeps a large (or hostile) age_s from wrapping into the future
+    uint64_t max_age_ms = std::min<uint64_t>(database_->get_config().max_age_ms, INT32_MAX);
+    
+    int merged = 0;
+    for (const auto& remote : table.entries) {
+        LQAEntry entry;
+        entry.frequency_hz = remote.frequency_hz;
+        entry.remote_station = remote.remote_station;
+        if (!local_station.empty() && remote.remote_station == local_station) {
+            entry.remote_station = source_station;
+        }
+        entry.snr_db = remote.snr_db;
+        entry.ber = remote.ber;
+        entry.total_words = static_cast<int>(std::min<uint32_t>(remote.total_words, 0x7FFFFFFF));
+        entry.sample_count = remote.sample_count;
+        
+        // On the local clock by age
+        uint64_t age_ms = std::min<uint64_t>(static_cast<uint64_t>(remote.age_s) * 1000, max_age_ms);
+        uint32_t activity_ms = now_ms - static_cast<uint32_t>(age_ms);
+        if (remote.sounding) {
+            entry.last_sounding_ms = activity_ms;
+        } else {
+            entry.last_contact_ms = activity_ms;
+        }
+        
+        if (database_->merge_entry(entry, merge_weight_)) {
+            merged++;
+        }
+    }
+    
+    return merged;
+}
+
+} // namespace ale
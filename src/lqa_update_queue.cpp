@@ -0,0 +1,201 @@
+/**
+ * @file lqa_update_queue.cpp
+ * @brief Implementation of LQA update queue
+ */
+
+#include "ale/lqa_update_queue.h"
+#include "ale/lqa_metrics.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace ale {
+
+static uint32_t current_time_ms() {
+    // Same clock as LQADatabase
+    auto now = std::chrono::system_clock::now();
+    auto duration = now.time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
+}
+
+static bool update_key_less(const LQAUpdate& a, const LQAUpdate& b) {
+    if (a.frequency_hz != b.frequency_hz) {
+        return a.frequency_hz < b.frequency_hz;
+    }
+    size_t length = std::min(a.station_length, b.station_length);
+    int order = std::memcmp(a.station, b.station, length);
+    if (order != 0) {
+        return order < 0;
+    }
+    return a.station_length < b.station_length;
+}
+
+LQAUpdateQueue::LQAUpdateQueue(LQADatabase* database, size_t capacity)
+    : database_(database), mask_(0), tail_(0), pushed_(0), dropped_(0), head_(0),
+      applied_(0), batches_(0), keys_(0) {
+    size_t size = 2;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    mask_ = size - 1;
+    
+    slots_.reset(new Slot[size]);
+    for (size_t i = 0; i < size; i++) {
+        slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    batch_.reserve(size);
+}
+
+void LQAUpdateQueue::set_database(LQADatabase* database) {
+    database_ = database;
+}
+
+bool LQAUpdateQueue::push(const LQAUpdate& update) {
+    size_t position = tail_.load(std::memory_order_relaxed);
+    Slot* slot;
+    for (;;) {
+        slot = &slots_[position & mask_];
+        size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+        if (difference == 0) {
+            // Free: claim it
+            if (tail_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            // Still holds the record from one lap ago: full
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            // Another producer claimed it first
+            position = tail_.load(std::memory_order_relaxed);
+        }
+    }
+    
+    slot->update = update;
+    if (slot->update.timestamp_ms == 0) {
+        slot->update.timestamp_ms = current_time_ms();
+    }
+    slot->sequence.store(position + 1, std::memory_order_release);
+    pushed_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool LQAUpdateQueue::push_update(uint32_t frequency_hz,
+                                 const std::string& remote_station,
+                                 float snr_db,
+                                 float ber,
+                                 int fec_errors,
+                                 int total_words,
+                                 uint32_t timestamp_ms) {
+    LQAUpdate update;
+    update.frequency_hz = frequency_hz;
+    update.timestamp_ms = timestamp_ms;
+    update.snr_db = snr_db;
+    update.ber = ber;
+    update.fec_errors = fec_errors;
+    update.total_words = total_words;
+    update.set_station(remote_station);
+    return push(update);
+}
+
+bool LQAUpdateQueue::push_sounding(const std::string& station,
+                                   uint32_t frequency_hz,
+                                   float snr_db,
+                                   float ber,
+                                   uint32_t timestamp_ms) {
+    LQAUpdate update;
+    update.frequency_hz = frequency_hz;
+    update.timestamp_ms = timestamp_ms;
+    update.snr_db = snr_db;
+    update.ber = ber;
+    update.total_words = 1;
+    update.flags = LQA_UPDATE_SOUNDING;
+    update.set_station(station);
+    return push(update);
+}
+
+bool LQAUpdateQueue::push_sounding_extended(const std::string& station,
+                                            uint32_t frequency_hz,
+                                            const MetricsSample& sample) {
+    // Same mapping as LQAAnalyzer::process_sounding_extended()
+    LQAUpdate update;
+    update.frequency_hz = frequency_hz;
+    update.timestamp_ms = sample.timestamp_ms;
+    update.snr_db = sample.snr_db;
+    update.ber = sample.decode_success ? 0.001f : 0.1f;
+    update.sinad_db = sample.snr_db;
+    update.multipath_score = sample.multipath_delay_ms / 10.0f;
+    update.noise_floor_dbm = sample.noise_power_dbm;
+    update.fec_errors = sample.fec_errors_corrected;
+    update.total_words = 1;
+    update.flags = LQA_UPDATE_EXTENDED;
+    update.set_station(station);
+    return push(update);
+}
+
+bool LQAUpdateQueue::pop(LQAUpdate& update) {
+    Slot& slot = slots_[head_ & mask_];
+    if (slot.sequence.load(std::memory_order_acquire) != head_ + 1) {
+        return false;
+    }
+    update = slot.update;
+    
+    // Free for the producer one lap ahead
+    slot.sequence.store(head_ + mask_ + 1, std::memory_order_release);
+    head_++;
+    return true;
+}
+
+size_t LQAUpdateQueue::drain(size_t max_records) {
+    if (max_records == 0 || max_records > capacity()) {
+        max_records = capacity();
+    }
+    
+    batch_.clear();
+    size_t taken = 0;
+    LQAUpdate update;
+    while (taken < max_records && pop(update)) {
+        taken++;
+        if (update.flags & LQA_UPDATE_SOUNDING) {
+            // Channel entry first, as LQAAnalyzer::process_sounding() does
+            LQAUpdate channel = update;
+            channel.station_length = 0;
+            batch_.push_back(channel);
+        }
+        batch_.push_back(update);
+    }
+    if (batch_.empty() || !database_) {
+        return taken;
+    }
+    
+    // Group by key; stable, so each key's records stay in arrival order
+    std::stable_sort(batch_.begin(), batch_.end(), update_key_less);
+    database_->apply_updates(batch_.data(), batch_.size());
+    
+    batches_++;
+    applied_ += batch_.size();
+    for (size_t i = 0; i < batch_.size(); i++) {
+        if (i == 0 || !batch_[i].same_key(batch_[i - 1])) {
+            keys_++;
+        }
+    }
+    return taken;
+}
+
+size_t LQAUpdateQueue::size_approx() const {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    return tail > head_ ? tail - head_ : 0;
+}
+
+LQAUpdateQueueStats LQAUpdateQueue::get_stats() const {
+    LQAUpdateQueueStats stats;
+    stats.pushed = pushed_.load(std::memory_order_relaxed);
+    stats.dropped = dropped_.load(std::memory_order_relaxed);
+    stats.applied = applied_;
+    stats.batches = batches_;
+    stats.keys = keys_;
+    return stats;
+}
+
+} // namespace ale
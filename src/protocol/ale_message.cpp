@@ -4,7 +4,9 @@
  */
 
 #include "ale_message.h"
+#include "snapshot.h"
 #include <algorithm>
+#include <array>
 
 namespace ale {
 
@@ -13,6 +15,100 @@ static const char* CALL_TYPE_NAMES[] = {
     "AMD", "INDIVIDUAL_ACK", "NET_ACK", "UNKNOWN"
 };
 
+// ============================================================================
+// Word Sequence Grammar (DFA)
+// ============================================================================
+
+// Column per preamble value (DATA..REP), plus one for UNKNOWN
+constexpr size_t SEQ_COLUMNS = 9;
+constexpr size_t SEQ_STATES = static_cast<size_t>(SequenceState::COUNT);
+
+using SequenceRow = std::array<SequenceState, SEQ_COLUMNS>;
+
+// Short names keep the table one row per state
+static constexpr SequenceState TH  = SequenceState::THRU;
+static constexpr SequenceState THX = SequenceState::THRU_EXT;
+static constexpr SequenceState TO  = SequenceState::TO;
+static constexpr SequenceState TOX = SequenceState::TO_EXT;
+static constexpr SequenceState TW  = SequenceState::TWS;
+static constexpr SequenceState TWX = SequenceState::TWS_EXT;
+static constexpr SequenceState MSG = SequenceState::MESSAGE;
+static constexpr SequenceState SND = SequenceState::SOUNDING;
+static constexpr SequenceState IND = SequenceState::INDIVIDUAL;
+static constexpr SequenceState NET = SequenceState::NET;
+static constexpr SequenceState AMD = SequenceState::AMD;
+static constexpr SequenceState R   = SequenceState::REJECT;
+
+static constexpr std::array<SequenceRow, SEQ_STATES> SEQUENCE_TABLE = {{
+    // DATA THRU  TO   TWS  FROM  TIS  CMD  REP  UNK
+    {  R,   TH,   TO,  TW,  R,    SND, R,   R,   R },   // START
+    {  THX, TH,   TO,  TW,  R,    R,   R,   TH,  R },   // THRU
+    {  THX, TH,   TO,  TW,  R,    R,   R,   THX, R },   // THRU_EXT
+    {  TOX, R,    TO,  R,   IND,  IND, MSG, TO,  R },   // TO
+    {  TOX, R,    TO,  R,   IND,  IND, MSG, TOX, R },   // TO_EXT
+    {  TWX, R,    R,   TW,  NET,  NET, MSG, TW,  R },   // TWS
+    {  TWX, R,    R,   TW,  NET,  NET, MSG, TWX, R },   // TWS_EXT
+    {  MSG, R,    R,   R,   AMD,  AMD, MSG, MSG, R },   // MESSAGE
+    {  R,   R,    R,   R,   R,    R,   R,   R,   R },   // SOUNDING
+    {  R,   R,    R,   R,   R,    R,   R,   R,   R },   // INDIVIDUAL
+    {  R,   R,    R,   R,   R,    R,   R,   R,   R },   // NET
+    {  R,   R,    R,   R,   R,    R,   R,   R,   R },   // AMD
+    {  R,   R,    R,   R,   R,    R,   R,   R,   R },   // REJECT
+}};
+
+static constexpr SequenceState seq_next(SequenceState state, WordType type) {
+    size_t column = static_cast<uint8_t>(type);
+    if (column >= SEQ_COLUMNS) column = SEQ_COLUMNS - 1;  // UNKNOWN
+    return SEQUENCE_TABLE[static_cast<size_t>(state)][column];
+}
+
+static constexpr bool seq_row_rejects_all(SequenceState state) {
+    for (size_t c = 0; c < SEQ_COLUMNS; ++c) {
+        if (SEQUENCE_TABLE[static_cast<size_t>(state)][c] != SequenceState::REJECT) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Spot-check the table against the grammar at compile time
+static_assert(seq_next(SequenceState::START, WordType::TIS) == SequenceState::SOUNDING,
+              "TIS alone is a sounding");
+static_assert(seq_next(SequenceState::START, WordType::FROM) == SequenceState::REJECT,
+              "sequence cannot start with FROM");
+static_assert(seq_next(SequenceState::START, WordType::DATA) == SequenceState::REJECT,
+              "sequence cannot start with an extension word");
+static_assert(seq_next(SequenceState::TO, WordType::FROM) == SequenceState::INDIVIDUAL,
+              "TO + FROM is an individual call");
+static_assert(seq_next(SequenceState::TWS_EXT, WordType::FROM) == SequenceState::NET,
+              "TWS + DATA + FROM is a net call");
+static_assert(seq_next(SequenceState::TO, WordType::TWS) == SequenceState::REJECT,
+              "individual and net addresses cannot be mixed");
+static_assert(seq_next(SequenceState::MESSAGE, WordType::TIS) == SequenceState::AMD,
+              "message section ends at terminator");
+static_assert(seq_next(SequenceState::THRU, WordType::UNKNOWN) == SequenceState::REJECT,
+              "unknown preamble rejects");
+static_assert(seq_row_rejects_all(SequenceState::SOUNDING) &&
+              seq_row_rejects_all(SequenceState::INDIVIDUAL) &&
+              seq_row_rejects_all(SequenceState::NET) &&
+              seq_row_rejects_all(SequenceState::AMD) &&
+              seq_row_rejects_all(SequenceState::REJECT),
+              "accept states take no further words");
+              
+SequenceState WordSequenceValidator::transition(SequenceState state, WordType type) {
+    return seq_next(state, type);
+}
+
+CallType WordSequenceValidator::call_type() const {
+    switch (current) {
+        case SequenceState::SOUNDING:   return CallType::SOUNDING;
+        case SequenceState::INDIVIDUAL: return CallType::INDIVIDUAL;
+        case SequenceState::NET:        return CallType::NET;
+        case SequenceState::AMD:        return CallType::AMD;
+        default:                        return CallType::UNKNOWN;
+    }
+}
+
 // ============================================================================
 // MessageAssembler Implementation
 // ============================================================================
@@ -34,19 +130,28 @@ bool MessageAssembler::add_word(const ALEWord& word) {
     
     // Start new message or add to existing
     if (!active) {
-        current_message.start_time_ms = current_time;
-        active = true;
+        start_message(word);
+    }
+    
+    // Advance grammar; an illegal word drops the partial sequence
+    if (validator.feed(word.type) == SequenceState::REJECT) {
+        reset();
+        if (!WordSequenceValidator::can_start(word.type)) {
+            return false;  // Garbage, keep listening for a valid start
+        }
+        start_message(word);
+        validator.feed(word.type);
     }
     
     current_words.push_back(word);
     last_word_time_ms = current_time;
     
     // Check if sequence is complete
-    if (is_sequence_complete(current_words)) {
+    if (is_sequence_complete()) {
         // Finalize message
         current_message.words = current_words;
         current_message.duration_ms = current_time - current_message.start_time_ms;
-        current_message.call_type = determine_call_type(current_words);
+        current_message.call_type = determine_call_type();
         current_message.complete = true;
         
         extract_addresses(current_words, current_message);
@@ -73,56 +178,60 @@ void MessageAssembler::reset() {
     current_message = ALEMessage();
     active = false;
     last_word_time_ms = 0;
+    validator.reset();
 }
 
-CallType MessageAssembler::determine_call_type(const std::vector<ALEWord>& words) {
-    return CallTypeDetector::detect(words);
+void MessageAssembler::save_snapshot(SnapshotWriter& writer) const {
+    writer.put_u32(word_timeout_ms);
+    writer.put_u16(static_cast<uint16_t>(current_words.size()));
+    for (const auto& word : current_words) {
+        writer.put_u8(static_cast<uint8_t>(word.type));
+        writer.put_u32(word.raw_payload);
+        writer.put_u8(word.fec_errors);
+        writer.put_u32(word.timestamp_ms);
+        writer.put_bytes(reinterpret_cast<const uint8_t*>(word.address), 3);
+    }
 }
 
-bool MessageAssembler::is_sequence_complete(const std::vector<ALEWord>& words) {
-    if (words.empty()) {
-        return false;
-    }
+bool MessageAssembler::restore_snapshot(SnapshotReader& reader, uint32_t time_shift_ms) {
+    reset();
     
-    // Minimum complete sequence: TIS (sounding) or TO+FROM (individual call)
-    if (words.size() < 1) {
-        return false;
-    }
+    uint32_t timeout_ms = reader.get_u32();
+    uint16_t word_count = reader.get_u16();
     
-    // Check for common complete patterns
-    bool has_to = false;
-    bool has_from = false;
-    bool has_tis = false;
-    
-    for (const auto& word : words) {
-        switch (word.type) {
-            case WordType::TO:
-            case WordType::TWS:
-                has_to = true;
-                break;
-            case WordType::FROM:
-                has_from = true;
-                break;
-            case WordType::TIS:
-                has_tis = true;
-                break;
-            default:
-                break;
+    std::vector<ALEWord> words;
+    for (uint16_t i = 0; i < word_count && reader.ok(); i++) {
+        ALEWord word;
+        word.type = static_cast<WordType>(reader.get_u8());
+        word.raw_payload = reader.get_u32();
+        word.fec_errors = reader.get_u8();
+        word.timestamp_ms = reader.get_u32() + time_shift_ms;
+        // Sample times count the previous capture; they are not saved and
+        // restored words have none
+        for (int c = 0; c < 3; c++) {
+            word.address[c] = static_cast<char>(reader.get_u8());
         }
+        word.valid = true;
+        words.push_back(word);
     }
     
-    // Sounding is complete with just TIS
-    if (has_tis) {
-        return true;
+    if (!reader.ok()) {
+        return false;
     }
     
-    // Individual/net call is complete with TO + FROM
-    if (has_to && has_from) {
-        return true;
+    // Saved words were all accepted in order, so replaying them rebuilds
+    // validator state and any completed-but-unread message exactly
+    word_timeout_ms = timeout_ms;
+    for (const auto& word : words) {
+        add_word(word);
     }
-    
-    // Otherwise, wait for more words
-    return false;
+    return true;
+}
+
+void MessageAssembler::start_message(const ALEWord& first_word) {
+    current_message.start_time_ms = first_word.timestamp_ms;
+    current_message.start_sample = first_word.sample_time;
+    active = true;
 }
 
 void MessageAssembler::extract_addresses(const std::vector<ALEWord>& words, ALEMessage& msg) {
@@ -6,6 +6,7 @@
 #include "ale_word.h"
 #include "symbol_decoder.h"
 #include "golay.h"
+#include "snapshot.h"
 #include <cstring>
 #include <cctype>
 #include <algorithm>
@@ -24,15 +25,21 @@ static const char ALE_ASCII_64[] =
 
 WordParser::WordParser() : last_timestamp_ms(0) {}
 
-bool WordParser::parse_word(const uint8_t symbols[SYMBOLS_PER_WORD], ALEWord& output) {
-    // Step 1: Decode symbols with majority voting
+bool WordParser::parse_word(const uint8_t symbols[SYMBOLS_PER_WORD], ALEWord& output,
+                            SampleTime sample_time) {
+    output.sample_time = sample_time;
+    
+    // Step 1: Decode symbols with majority voting, keeping track of bits
+    // whose copies failed to agree
     uint32_t raw_word = 0;
-    uint32_t errors = SymbolDecoder::decode_word_with_voting(symbols, raw_word);
+    uint32_t erasures = 0;
+    SymbolDecoder::decode_word_with_erasures(symbols, raw_word, erasures);
     
     // Step 2: Apply Golay FEC to get 12-bit information
-    // The 24-bit raw word should be treated as a Golay codeword
+    // The 24-bit raw word should be treated as a Golay codeword; known
+    // unreliable bits are decoded as erasures rather than guessed
     uint16_t decoded_info = 0;
-    uint8_t fec_errors = Golay::decode(raw_word, decoded_info);
+    uint8_t fec_errors = Golay::decode_with_erasures(raw_word, erasures, decoded_info);
     
     if (fec_errors == 0xFF) {
         // Uncorrectable FEC error
@@ -51,8 +58,9 @@ bool WordParser::parse_word(const uint8_t symbols[SYMBOLS_PER_WORD], ALEWord& ou
     // - After voting, we have 24 bits
     // - These 24 bits ARE the word (no Golay at word level, Golay is symbol-level)
     
-    // So raw_word from voting IS our 24-bit word
-    return parse_from_bits(raw_word & 0xFFFFFF, output);
+    // So raw_word from voting IS our 24-bit word; parse it as corrected
+    // (re-encoded), so neither bit errors nor erased bits reach the parser
+    return parse_from_bits(Golay::encode(decoded_info), output);
 }
 
 bool WordParser::parse_from_bits(uint32_t word_bits, ALEWord& output) {
@@ -185,6 +193,51 @@ void AddressBook::add_net(const std::string& net_address, const std::string& des
     nets.push_back({net_address, description});
 }
 
+void AddressBook::save_snapshot(SnapshotWriter& writer) const {
+    writer.put_string(self_address);
+    
+    writer.put_u16(static_cast<uint16_t>(stations.size()));
+    for (const auto& station : stations) {
+        writer.put_string(station.first);
+        writer.put_string(station.second);
+    }
+    
+    writer.put_u16(static_cast<uint16_t>(nets.size()));
+    for (const auto& net : nets) {
+        writer.put_string(net.first);
+        writer.put_string(net.second);
+    }
+}
+
+bool AddressBook::restore_snapshot(SnapshotReader& reader) {
+    std::string restored_self = reader.get_string();
+    
+    std::vector<std::pair<std::string, std::string>> restored_stations;
+    uint16_t station_count = reader.get_u16();
+    for (uint16_t i = 0; i < station_count && reader.ok(); i++) {
+        std::string address = reader.get_string();
+        std::string name = reader.get_string();
+        restored_stations.push_back({address, name});
+    }
+    
+    std::vector<std::pair<std::string, std::string>> restored_nets;
+    uint16_t net_count = reader.get_u16();
+    for (uint16_t i = 0; i < net_count && reader.ok(); i++) {
+        std::string address = reader.get_string();
+        std::string description = reader.get_string();
+        restored_nets.push_back({address, description});
+    }
+    
+    if (!reader.ok()) {
+        return false;
+    }
+    
+    self_address = restored_self;
+    stations = std::move(restored_stations);
+    nets = std::move(restored_nets);
+    return true;
+}
+
 bool AddressBook::is_self(const std::string& address) const {
     return address == self_address;
 }
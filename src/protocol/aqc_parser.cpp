@@ -129,6 +129,7 @@ bool AQCParser::parse_call_probe(const ALEWord* words, size_t count, AQCCallProb
     
     // Set timestamp from first word
     probe.timestamp_ms = words[0].timestamp_ms;
+    probe.sample_time = words[0].sample_time;
     
     return true;
 }
@@ -170,6 +171,7 @@ bool AQCParser::parse_call_handshake(const ALEWord* words, size_t count, AQCCall
     }
     
     handshake.timestamp_ms = words[0].timestamp_ms;
+    handshake.sample_time = words[0].sample_time;
     
     return true;
 }
@@ -212,6 +214,7 @@ bool AQCParser::parse_inlink(const ALEWord* words, size_t count, AQCInlink& inli
     }
     
     inlink.timestamp_ms = words[0].timestamp_ms;
+    inlink.sample_time = words[0].sample_time;
     
     return true;
 }
@@ -248,6 +251,7 @@ bool AQCParser::parse_orderwire(const ALEWord* words, size_t count, AQCOrderwire
     
     orderwire.message = message;
     orderwire.timestamp_ms = words[0].timestamp_ms;
+    orderwire.sample_time = words[0].sample_time;
     
     return !message.empty();
 }
@@ -344,6 +348,14 @@ uint32_t SlotManager::calculate_slot_time(uint8_t slot_number, uint32_t base_tim
     return base_time_ms + (slot_number * SLOT_DURATION_MS);
 }
 
+SampleTime SlotManager::calculate_slot_sample(uint8_t slot_number, SampleTime base_sample) {
+    if (slot_number >= NUM_SLOTS) {
+        slot_number = NUM_SLOTS - 1;
+    }
+    
+    return base_sample + slot_number * SLOT_DURATION_SAMPLES;
+}
+
 uint8_t SlotManager::assign_slot(const std::string& address) {
     // Hash address to assign slot
     // Simple hash: sum ASCII values mod 8
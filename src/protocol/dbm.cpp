@@ -0,0 +1,203 @@
+/**
+ * \file dbm.cpp
+ * \brief Implementation of Data Block Message (DBM) codec
+ */
+ 
+#include "dbm_protocol.h"
+#include "golay.h"
+#include <array>
+#include <cstring>
+
+namespace ale {
+
+// ============================================================================
+// CRC-16 (CCITT) - table driven
+// ============================================================================
+
+static constexpr std::array<uint16_t, 256> make_crc16_table() {
+    std::array<uint16_t, 256> table = {};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint16_t crc = static_cast<uint16_t>(i << 8);
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021)
+                                 : static_cast<uint16_t>(crc << 1);
+        }
+        table[i] = crc;
+    }
+    return table;
+}
+
+static constexpr std::array<uint16_t, 256> CRC16_TABLE = make_crc16_table();
+
+uint16_t DBMCodec::calculate_crc16(const uint8_t* data, size_t length) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < length; ++i) {
+        crc = static_cast<uint16_t>((crc << 8) ^ CRC16_TABLE[((crc >> 8) ^ data[i]) & 0xFF]);
+    }
+    return crc;
+}
+
+// ============================================================================
+// DBMCodec Implementation
+// ============================================================================
+
+DBMCodec::DBMCodec() : table_codewords(0) {}
+
+size_t DBMCodec::codewords_for_length(size_t length) {
+    size_t framed_bits = (DBM_LENGTH_BYTES + length + DBM_CRC_BYTES) * 8;
+    return (framed_bits + 11) / 12;
+}
+
+const std::vector<uint32_t>& DBMCodec::get_interleave_table(size_t codewords) {
+    if (table_codewords == codewords) {
+        return interleave_table;
+    }
+    
+    // Matrix: N rows (codewords) x 24 columns (codeword bits)
+    // Written row by row, read column by column
+    size_t total_bits = codewords * DBM_WORD_BITS;
+    interleave_table.resize(total_bits);
+    
+    for (size_t k = 0; k < total_bits; ++k) {
+        size_t column = k / codewords;
+        size_t row = k % codewords;
+        interleave_table[k] = static_cast<uint32_t>(row * DBM_WORD_BITS + column);
+    }
+    
+    table_codewords = codewords;
+    return interleave_table;
+}
+
+bool DBMCodec::encode(const uint8_t* data, size_t length, std::vector<uint32_t>& words) {
+    if (length > DBM_MAX_MESSAGE_BYTES || (length > 0 && !data)) {
+        return false;
+    }
+    
+    // Step 1: Frame message as [length (2) | data | CRC-16 (2)]
+    size_t framed_length = DBM_LENGTH_BYTES + length + DBM_CRC_BYTES;
+    bit_buffer.assign(framed_length + 2, 0);  // +2 pad for 12-bit packing
+    bit_buffer[0] = (length >> 8) & 0xFF;
+    bit_buffer[1] = length & 0xFF;
+    if (length > 0) {
+        memcpy(&bit_buffer[DBM_LENGTH_BYTES], data, length);
+    }
+    uint16_t crc = calculate_crc16(bit_buffer.data(), DBM_LENGTH_BYTES + length);
+    bit_buffer[DBM_LENGTH_BYTES + length] = (crc >> 8) & 0xFF;
+    bit_buffer[DBM_LENGTH_BYTES + length + 1] = crc & 0xFF;
+    
+    // Step 2: Pack bytes into 12-bit information words (3 bytes -> 2 words)
+    size_t codewords = codewords_for_length(length);
+    info_buffer.resize(codewords);
+    for (size_t i = 0; i < codewords; ++i) {
+        size_t byte = (i / 2) * 3;
+        if ((i & 1) == 0) {
+            info_buffer[i] = static_cast<uint16_t>((bit_buffer[byte] << 4) |
+                                                   (bit_buffer[byte + 1] >> 4));
+        } else {
+            info_buffer[i] = static_cast<uint16_t>(((bit_buffer[byte + 1] & 0x0F) << 8) |
+                                                   bit_buffer[byte + 2]);
+        }
+    }
+    
+    // Step 3: Batched Golay encode of whole block
+    codeword_buffer.resize(codewords);
+    Golay::encode_block(info_buffer.data(), codeword_buffer.data(), codewords);
+    
+    // Step 4: Expand to bit matrix (row-wise) and read out via interleave table
+    size_t total_bits = codewords * DBM_WORD_BITS;
+    matrix_buffer.resize(total_bits);
+    for (size_t row = 0; row < codewords; ++row) {
+        uint32_t cw = codeword_buffer[row];
+        uint8_t* dst = &matrix_buffer[row * DBM_WORD_BITS];
+        for (uint32_t bit = 0; bit < DBM_WORD_BITS; ++bit) {
+            dst[bit] = (cw >> bit) & 1;
+        }
+    }
+    
+    const std::vector<uint32_t>& table = get_interleave_table(codewords);
+    words.assign(codewords, 0);
+    for (size_t k = 0; k < total_bits; ++k) {
+        words[k / DBM_WORD_BITS] |= static_cast<uint32_t>(matrix_buffer[table[k]])
+                                    << (k % DBM_WORD_BITS);
+    }
+    
+    return true;
+}
+
+bool DBMCodec::decode(const std::vector<uint32_t>& words, std::vector<uint8_t>& data,
+                      DBMStats* stats) {
+    DBMStats local;
+    local.codewords = static_cast<uint32_t>(words.size());
+    data.clear();
+    
+    size_t codewords = words.size();
+    if (codewords < codewords_for_length(0)) {
+        if (stats) *stats = local;
+        return false;
+    }
+    
+    // Step 1: Deinterleave back into row-wise bit matrix
+    size_t total_bits = codewords * DBM_WORD_BITS;
+    const std::vector<uint32_t>& table = get_interleave_table(codewords);
+    matrix_buffer.resize(total_bits);
+    for (size_t k = 0; k < total_bits; ++k) {
+        matrix_buffer[table[k]] = (words[k / DBM_WORD_BITS] >> (k % DBM_WORD_BITS)) & 1;
+    }
+    
+    codeword_buffer.resize(codewords);
+    for (size_t row = 0; row < codewords; ++row) {
+        const uint8_t* src = &matrix_buffer[row * DBM_WORD_BITS];
+        uint32_t cw = 0;
+        for (uint32_t bit = 0; bit < DBM_WORD_BITS; ++bit) {
+            cw |= static_cast<uint32_t>(src[bit]) << bit;
+        }
+        codeword_buffer[row] = cw;
+    }
+    
+    // Step 2: Batched Golay decode
+    info_buffer.resize(codewords);
+    bit_buffer.resize(codewords);  // reused as per-word error counts
+    local.uncorrectable = Golay::decode_block(codeword_buffer.data(), info_buffer.data(),
+                                              bit_buffer.data(), codewords);
+    for (size_t i = 0; i < codewords; ++i) {
+        if (bit_buffer[i] != 0xFF) {
+            local.bits_corrected += bit_buffer[i];
+        }
+    }
+    
+    // Step 3: Unpack 12-bit words back to bytes
+    std::vector<uint8_t> framed(((codewords + 1) / 2) * 3, 0);
+    for (size_t i = 0; i < codewords; ++i) {
+        size_t byte = (i / 2) * 3;
+        uint16_t info = info_buffer[i];
+        if ((i & 1) == 0) {
+            framed[byte] = (info >> 4) & 0xFF;
+            framed[byte + 1] = static_cast<uint8_t>((info & 0x0F) << 4);
+        } else {
+            framed[byte + 1] |= (info >> 8) & 0x0F;
+            framed[byte + 2] = info & 0xFF;
+        }
+    }
+    
+    // Step 4: Validate length field and CRC
+    size_t length = (static_cast<size_t>(framed[0]) << 8) | framed[1];
+    if (length > DBM_MAX_MESSAGE_BYTES || codewords_for_length(length) != codewords) {
+        if (stats) *stats = local;
+        return false;
+    }
+    
+    uint16_t received_crc = static_cast<uint16_t>((framed[DBM_LENGTH_BYTES + length] << 8) |
+                                                  framed[DBM_LENGTH_BYTES + length + 1]);
+    local.crc_valid = (calculate_crc16(framed.data(), DBM_LENGTH_BYTES + length) == received_crc);
+    
+    if (stats) *stats = local;
+    if (!local.crc_valid) {
+        return false;
+    }
+    
+    data.assign(framed.begin() + DBM_LENGTH_BYTES,
+                framed.begin() + DBM_LENGTH_BYTES + length);
+    return true;
+}
+
+} // namespace ale
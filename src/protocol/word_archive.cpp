@@ -0,0 +1,682 @@
+/**
+ * \file word_archive.cpp
+ * \brief Indexed archive of decoded ALE words and messages
+ */
+
+#include "word_archive.h"
+#include "snapshot.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+namespace ale {
+
+// Segment payload (snapshot-framed):
+//   header: base time u64, max time u64, min/max frequency u32,
+//           rows, frequency count, address count, reference count (u32)
+//   frequencies u32[], addresses (strings)
+//   columns: time u32[rows], frequency id u16[rows], kind u8[rows],
+//            info u8[rows], payload u32[rows],
+//            reference offsets u32[rows + 1], references u16[],
+//            posting offsets u32[addresses + 1], postings u32[]
+static const uint32_t ARCHIVE_VERSION = 1;
+
+// Kind column: message flag, then word or call type
+static const uint8_t KIND_MESSAGE = 0x80;
+static const uint8_t KIND_TYPE_MASK = 0x7F;
+
+// Info column for words: FEC errors, valid flag
+static const uint8_t INFO_VALID = 0x80;
+
+static uint16_t load_u16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+static uint32_t load_u32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+static void decode_row(uint8_t kind, uint8_t info, uint32_t payload, ArchiveRecord& record) {
+    record.is_message = (kind & KIND_MESSAGE) != 0;
+    uint8_t type = kind & KIND_TYPE_MASK;
+    if (record.is_message) {
+        record.call_type = static_cast<CallType>(type);
+        record.word_count = info;
+        record.duration_ms = payload;
+    } else {
+        record.word_type = type == KIND_TYPE_MASK ? WordType::UNKNOWN : static_cast<WordType>(type);
+        record.fec_errors = info & ~INFO_VALID;
+        record.valid = (info & INFO_VALID) != 0;
+        record.raw_payload = payload;
+    }
+}
+
+static bool kind_wanted(uint8_t kind, const ArchiveQuery& query) {
+    return (kind & KIND_MESSAGE) ? query.include_messages : query.include_words;
+}
+
+static bool role_wanted(bool from, ArchiveRole role) {
+    return role == ArchiveRole::ANY || (role == ArchiveRole::FROM) == from;
+}
+
+WordArchive::Segment::Segment()
+    : base_time_ms(0), max_time_ms(0), min_frequency_hz(0), max_frequency_hz(0), rows(0),
+      time_column(nullptr), frequency_column(nullptr), kind_column(nullptr),
+      info_column(nullptr), payload_column(nullptr), reference_offsets(nullptr),
+      references(nullptr), posting_offsets(nullptr), postings(nullptr) {
+}
+
+WordArchive::Segment::~Segment() {
+}
+
+WordArchive::WordArchive()
+    : segment_records(ARCHIVE_DEFAULT_SEGMENT_RECORDS), next_segment(1) {
+    pending.min_time_ms = 0;
+    pending.max_time_ms = 0;
+}
+
+WordArchive::~WordArchive() {
+    close();
+}
+
+std::string WordArchive::segment_path(uint32_t number) const {
+    char name[32];
+    snprintf(name, sizeof(name), "/arc-%08u.seg", number);
+    return directory + name;
+}
+
+bool WordArchive::open(const std::string& path) {
+    close();
+
+#ifndef _WIN32
+    if (::mkdir(path.c_str(), 0755) != 0 && errno != EEXIST) {
+        return false;
+    }
+    
+    DIR* dir = opendir(path.c_str());
+    if (!dir) {
+        return false;
+    }
+    directory = path;
+    
+    std::vector<uint32_t> found;
+    while (dirent* item = readdir(dir)) {
+        unsigned number;
+        char tail;
+        if (sscanf(item->d_name, "arc-%8u.seg%c", &number, &tail) == 1 && number > 0) {
+            found.push_back(number);
+        }
+    }
+    closedir(dir);
+    
+    // Unreadable segments are skipped, but never overwritten
+    std::sort(found.begin(), found.end());
+    for (uint32_t number : found) {
+        load_segment(number);
+        next_segment = number + 1;
+    }
+    return true;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+void WordArchive::close() {
+    if (is_open()) {
+        flush();
+    }
+    segments.clear();
+    pending = PendingSegment();
+    pending.min_time_ms = 0;
+    pending.max_time_ms = 0;
+    directory.clear();
+    next_segment = 1;
+}
+
+bool WordArchive::load_segment(uint32_t number) {
+    std::unique_ptr<MappedFile> file(new MappedFile());
+    if (!file->open(segment_path(number))) {
+        return false;
+    }
+    
+    SnapshotReader reader(nullptr, 0);
+    if (!SnapshotReader::open(file->data(), file->size(), ARCHIVE_VERSION, reader)) {
+        return false;
+    }
+    
+    Segment loaded;
+    loaded.base_time_ms = reader.get_u64();
+    loaded.max_time_ms = reader.get_u64();
+    loaded.min_frequency_hz = reader.get_u32();
+    loaded.max_frequency_hz = reader.get_u32();
+    loaded.rows = reader.get_u32();
+    uint32_t frequency_count = reader.get_u32();
+    uint32_t address_count = reader.get_u32();
+    uint32_t reference_count = reader.get_u32();
+    if (!reader.ok() || frequency_count > 0xFFFF || address_count > MAX_ADDRESSES ||
+        frequency_count > reader.remaining() / 4) {
+        return false;
+    }
+    
+    loaded.frequencies.resize(frequency_count);
+    for (uint32_t i = 0; i < frequency_count; i++) {
+        loaded.frequencies[i] = reader.get_u32();
+    }
+    loaded.addresses.resize(address_count);
+    for (uint32_t i = 0; i < address_count && reader.ok(); i++) {
+        loaded.addresses[i] = reader.get_string();
+        loaded.address_ids[loaded.addresses[i]] = static_cast<uint16_t>(i);
+    }
+    if (!reader.ok()) {
+        return false;
+    }
+    
+    uint64_t rows = loaded.rows;
+    uint64_t columns = rows * (4 + 2 + 1 + 1 + 4) + (rows + 1) * 4 +
+                       static_cast<uint64_t>(reference_count) * 2 +
+                       (static_cast<uint64_t>(address_count) + 1) * 4 +
+                       static_cast<uint64_t>(reference_count) * 4;
+    if (reader.remaining() != columns) {
+        return false;
+    }
+    
+    const uint8_t* p = file->data() + file->size() - reader.remaining();
+    loaded.time_column = p;
+    p += rows * 4;
+    loaded.frequency_column = p;
+    p += rows * 2;
+    loaded.kind_column = p;
+    p += rows;
+    loaded.info_column = p;
+    p += rows;
+    loaded.payload_column = p;
+    p += rows * 4;
+    loaded.reference_offsets = p;
+    p += (rows + 1) * 4;
+    loaded.references = p;
+    p += reference_count * 2;
+    loaded.posting_offsets = p;
+    p += (address_count + 1) * 4;
+    loaded.postings = p;
+    
+    // Offsets are trusted from here on: check they stay in bounds
+    if (load_u32(loaded.reference_offsets + rows * 4) != reference_count ||
+        load_u32(loaded.posting_offsets + address_count * 4) != reference_count) {
+        return false;
+    }
+    for (uint64_t row = 0; row < rows; row++) {
+        if (load_u16(loaded.frequency_column + row * 2) >= frequency_count ||
+            load_u32(loaded.reference_offsets + row * 4) >
+                load_u32(loaded.reference_offsets + (row + 1) * 4)) {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < reference_count; i++) {
+        if ((load_u16(loaded.references + i * 2) & ~ROLE_FROM) >= address_count ||
+            (load_u32(loaded.postings + i * 4) >> 1) >= rows) {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < address_count; i++) {
+        if (load_u32(loaded.posting_offsets + i * 4) >
+            load_u32(loaded.posting_offsets + (i + 1) * 4)) {
+            return false;
+        }
+    }
+    
+    Segment& segment = segments[number];
+    segment.base_time_ms = loaded.base_time_ms;
+    segment.max_time_ms = loaded.max_time_ms;
+    segment.min_frequency_hz = loaded.min_frequency_hz;
+    segment.max_frequency_hz = loaded.max_frequency_hz;
+    segment.rows = loaded.rows;
+    segment.frequencies.swap(loaded.frequencies);
+    segment.address_ids.swap(loaded.address_ids);
+    segment.addresses.swap(loaded.addresses);
+    segment.time_column = loaded.time_column;
+    segment.frequency_column = loaded.frequency_column;
+    segment.kind_column = loaded.kind_column;
+    segment.info_column = loaded.info_column;
+    segment.payload_column = loaded.payload_column;
+    segment.reference_offsets = loaded.reference_offsets;
+    segment.references = loaded.references;
+    segment.posting_offsets = loaded.posting_offsets;
+    segment.postings = loaded.postings;
+    segment.file = std::move(file);
+    return true;
+}
+
+uint16_t WordArchive::pending_address(const std::string& address) {
+    auto it = pending.address_ids.find(address);
+    if (it != pending.address_ids.end()) {
+        return it->second;
+    }
+    uint16_t id = static_cast<uint16_t>(pending.addresses.size());
+    pending.addresses.push_back(address);
+    pending.address_ids[address] = id;
+    return id;
+}
+
+bool WordArchive::append_row(PendingRow& row, const std::vector<std::string>& from,
+                             const std::vector<std::string>& to) {
+    if (!is_open()) {
+        return false;
+    }
+    
+    // Seal first if this row would overflow a dictionary or the u32 time offsets
+    if (!pending.rows.empty()) {
+        size_t new_addresses = 0;
+        for (const auto& address : from) {
+            new_addresses += pending.address_ids.count(address) == 0;
+        }
+        for (const auto& address : to) {
+            new_addresses += pending.address_ids.count(address) == 0;
+        }
+        uint64_t first = std::min(pending.min_time_ms, row.time_ms);
+        uint64_t last = std::max(pending.max_time_ms, row.time_ms);
+        bool new_frequency = pending.frequencies.count(row.frequency_hz) == 0;
+        if (pending.addresses.size() + new_addresses > MAX_ADDRESSES ||
+            (new_frequency && pending.frequencies.size() >= 0xFFFF) ||
+            last - first > UINT32_MAX) {
+            if (!flush()) {
+                return false;
+            }
+        }
+    }
+    
+    for (const auto& address : from) {
+        row.addresses.push_back(pending_address(address) | ROLE_FROM);
+    }
+    for (const auto& address : to) {
+        row.addresses.push_back(pending_address(address));
+    }
+    if (pending.rows.empty()) {
+        pending.min_time_ms = row.time_ms;
+        pending.max_time_ms = row.time_ms;
+    } else {
+        pending.min_time_ms = std::min(pending.min_time_ms, row.time_ms);
+        pending.max_time_ms = std::max(pending.max_time_ms, row.time_ms);
+    }
+    pending.frequencies.insert(row.frequency_hz);
+    pending.rows.push_back(std::move(row));
+    
+    if (pending.rows.size() >= segment_records) {
+        return flush();
+    }
+    return true;
+}
+
+bool WordArchive::append_word(const ALEWord& word, uint32_t frequency_hz, uint64_t time_ms) {
+    PendingRow row;
+    row.time_ms = time_ms;
+    row.frequency_hz = frequency_hz;
+    row.kind = static_cast<uint8_t>(word.type) & KIND_TYPE_MASK;
+    row.info = static_cast<uint8_t>(std::min<uint8_t>(word.fec_errors, ~INFO_VALID & 0xFF) |
+                                    (word.valid ? INFO_VALID : 0));
+    row.payload = word.raw_payload;
+    
+    // Same trimming as MessageAssembler
+    std::string address(word.address, strnlen(word.address, 3));
+    address.erase(address.find_last_not_of(' ') + 1);
+    
+    std::vector<std::string> from;
+    std::vector<std::string> to;
+    if (!address.empty()) {
+        switch (word.type) {
+            case WordType::FROM:
+            case WordType::TIS:
+                from.push_back(address);
+                break;
+            case WordType::TO:
+            case WordType::TWS:
+            case WordType::THRU:
+                to.push_back(address);
+                break;
+            default:
+                break;
+        }
+    }
+    return append_row(row, from, to);
+}
+
+bool WordArchive::append_message(const ALEMessage& message, uint32_t frequency_hz,
+                                 uint64_t time_ms) {
+    PendingRow row;
+    row.time_ms = time_ms;
+    row.frequency_hz = frequency_hz;
+    row.kind = KIND_MESSAGE | (static_cast<uint8_t>(message.call_type) & KIND_TYPE_MASK);
+    row.info = static_cast<uint8_t>(std::min<size_t>(message.words.size(), 255));
+    row.payload = message.duration_ms;
+    
+    std::vector<std::string> from;
+    if (!message.from_address.empty()) {
+        from.push_back(message.from_address);
+    }
+    return append_row(row, from, message.to_addresses);
+}
+
+bool WordArchive::flush() {
+    if (pending.rows.empty()) {
+        return true;
+    }
+    if (!is_open()) {
+        return false;
+    }
+    
+    // Time order makes time ranges a binary search and postings time-ordered
+    std::stable_sort(pending.rows.begin(), pending.rows.end(),
+                     [](const PendingRow& a, const PendingRow& b) {
+                         return a.time_ms < b.time_ms;
+                     });
+    
+    std::vector<uint32_t> frequencies(pending.frequencies.begin(), pending.frequencies.end());
+    uint32_t rows = static_cast<uint32_t>(pending.rows.size());
+    uint32_t reference_count = 0;
+    for (const auto& row : pending.rows) {
+        reference_count += static_cast<uint32_t>(row.addresses.size());
+    }
+    
+    SnapshotWriter writer;
+    writer.put_u64(pending.min_time_ms);
+    writer.put_u64(pending.max_time_ms);
+    writer.put_u32(frequencies.front());
+    writer.put_u32(frequencies.back());
+    writer.put_u32(rows);
+    writer.put_u32(static_cast<uint32_t>(frequencies.size()));
+    writer.put_u32(static_cast<uint32_t>(pending.addresses.size()));
+    writer.put_u32(reference_count);
+    for (uint32_t frequency : frequencies) {
+        writer.put_u32(frequency);
+    }
+    for (const auto& address : pending.addresses) {
+        writer.put_string(address);
+    }
+    
+    for (const auto& row : pending.rows) {
+        writer.put_u32(static_cast<uint32_t>(row.time_ms - pending.min_time_ms));
+    }
+    for (const auto& row : pending.rows) {
+        auto it = std::lower_bound(frequencies.begin(), frequencies.end(), row.frequency_hz);
+        writer.put_u16(static_cast<uint16_t>(it - frequencies.begin()));
+    }
+    for (const auto& row : pending.rows) {
+        writer.put_u8(row.kind);
+    }
+    for (const auto& row : pending.rows) {
+        writer.put_u8(row.info);
+    }
+    for (const auto& row : pending.rows) {
+        writer.put_u32(row.payload);
+    }
+    
+    uint32_t offset = 0;
+    for (const auto& row : pending.rows) {
+        writer.put_u32(offset);
+        offset += static_cast<uint32_t>(row.addresses.size());
+    }
+    writer.put_u32(offset);
+    for (const auto& row : pending.rows) {
+        for (uint16_t reference : row.addresses) {
+            writer.put_u16(reference);
+        }
+    }
+    
+    // Inverted index: rows per address, in row (time) order
+    std::vector<std::vector<uint32_t>> postings(pending.addresses.size());
+    for (uint32_t i = 0; i < rows; i++) {
+        for (uint16_t reference : pending.rows[i].addresses) {
+            uint32_t from = (reference & ROLE_FROM) ? 1 : 0;
+            postings[reference & ~ROLE_FROM].push_back((i << 1) | from);
+        }
+    }
+    offset = 0;
+    for (const auto& list : postings) {
+        writer.put_u32(offset);
+        offset += static_cast<uint32_t>(list.size());
+    }
+    writer.put_u32(offset);
+    for (auto& list : postings) {
+        std::sort(list.begin(), list.end());
+        for (uint32_t entry : list) {
+            writer.put_u32(entry);
+        }
+    }
+    
+    std::vector<uint8_t> framed;
+    writer.finish(ARCHIVE_VERSION, framed);
+    uint32_t number = next_segment;
+    if (!write_file_atomic(segment_path(number), framed.data(), framed.size()) ||
+        !load_segment(number)) {
+        return false;
+    }
+    next_segment++;
+    
+    pending = PendingSegment();
+    pending.min_time_ms = 0;
+    pending.max_time_ms = 0;
+    return true;
+}
+
+uint64_t WordArchive::record_count() const {
+    uint64_t total = pending.rows.size();
+    for (const auto& segment : segments) {
+        total += segment.second.rows;
+    }
+    return total;
+}
+
+template <typename Visit>
+void WordArchive::scan_segment(const Segment& segment, const ArchiveQuery& query,
+                               Visit& visit) const {
+    if (segment.rows == 0 || segment.max_time_ms < query.start_ms ||
+        segment.base_time_ms >= query.end_ms ||
+        segment.max_frequency_hz < query.min_frequency_hz ||
+        segment.min_frequency_hz > query.max_frequency_hz) {
+        return;
+    }
+    
+    uint16_t address_id = 0;
+    if (!query.address.empty()) {
+        auto it = segment.address_ids.find(query.address);
+        if (it == segment.address_ids.end()) {
+            return;
+        }
+        address_id = it->second;
+    }
+    
+    // Time index: rows [first, last) lie in the query range
+    auto row_before = [&segment](uint64_t time_ms) -> uint32_t {
+        if (time_ms <= segment.base_time_ms) {
+            return 0;
+        }
+        uint64_t offset = time_ms - segment.base_time_ms;
+        uint32_t low = 0;
+        uint32_t high = segment.rows;
+        while (low < high) {
+            uint32_t mid = low + (high - low) / 2;
+            if (load_u32(segment.time_column + mid * 4) < offset) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+        return low;
+    };
+    uint32_t first = row_before(query.start_ms);
+    uint32_t last = query.end_ms > segment.max_time_ms ? segment.rows : row_before(query.end_ms);
+    
+    std::vector<char> frequency_wanted(segment.frequencies.size());
+    for (size_t i = 0; i < segment.frequencies.size(); i++) {
+        frequency_wanted[i] = segment.frequencies[i] >= query.min_frequency_hz &&
+                              segment.frequencies[i] <= query.max_frequency_hz;
+    }
+    
+    auto check_row = [&](uint32_t row) {
+        if (kind_wanted(segment.kind_column[row], query) &&
+            frequency_wanted[load_u16(segment.frequency_column + row * 2)]) {
+            visit(segment.base_time_ms + load_u32(segment.time_column + row * 4), &segment, row);
+        }
+    };
+    
+    if (query.address.empty()) {
+        for (uint32_t row = first; row < last; row++) {
+            check_row(row);
+        }
+        return;
+    }
+    
+    // Postings of the address, from the first row in range
+    uint32_t begin = load_u32(segment.posting_offsets + address_id * 4);
+    uint32_t end = load_u32(segment.posting_offsets + (address_id + 1) * 4);
+    while (begin < end) {
+        uint32_t mid = begin + (end - begin) / 2;
+        if ((load_u32(segment.postings + mid * 4) >> 1) < first) {
+            begin = mid + 1;
+        } else {
+            end = mid;
+        }
+    }
+    end = load_u32(segment.posting_offsets + (address_id + 1) * 4);
+    
+    uint32_t previous = UINT32_MAX;
+    for (uint32_t i = begin; i < end; i++) {
+        uint32_t entry = load_u32(segment.postings + i * 4);
+        uint32_t row = entry >> 1;
+        if (row >= last) {
+            break;
+        }
+        if (row == previous || !role_wanted((entry & 1) != 0, query.role)) {
+            continue;
+        }
+        previous = row;
+        check_row(row);
+    }
+}
+
+template <typename Visit>
+void WordArchive::scan_pending(const ArchiveQuery& query, Visit& visit) const {
+    int address_id = -1;
+    if (!query.address.empty()) {
+        auto it = pending.address_ids.find(query.address);
+        if (it == pending.address_ids.end()) {
+            return;
+        }
+        address_id = it->second;
+    }
+    
+    for (uint32_t i = 0; i < pending.rows.size(); i++) {
+        const PendingRow& row = pending.rows[i];
+        if (row.time_ms < query.start_ms || row.time_ms >= query.end_ms ||
+            row.frequency_hz < query.min_frequency_hz ||
+            row.frequency_hz > query.max_frequency_hz || !kind_wanted(row.kind, query)) {
+            continue;
+        }
+        if (address_id >= 0) {
+            bool matched = false;
+            for (uint16_t reference : row.addresses) {
+                if ((reference & ~ROLE_FROM) == address_id &&
+                    role_wanted((reference & ROLE_FROM) != 0, query.role)) {
+                    matched = true;
+                    break;
+                }
+            }
+            if (!matched) {
+                continue;
+            }
+        }
+        visit(row.time_ms, static_cast<const Segment*>(nullptr), i);
+    }
+}
+
+template <typename Visit>
+void WordArchive::scan(const ArchiveQuery& query, Visit& visit) const {
+    for (const auto& segment : segments) {
+        scan_segment(segment.second, query, visit);
+    }
+    scan_pending(query, visit);
+}
+
+ArchiveRecord WordArchive::segment_record(const Segment& segment, uint32_t row) const {
+    ArchiveRecord record;
+    record.time_ms = segment.base_time_ms + load_u32(segment.time_column + row * 4);
+    record.frequency_hz = segment.frequencies[load_u16(segment.frequency_column + row * 2)];
+    decode_row(segment.kind_column[row], segment.info_column[row],
+               load_u32(segment.payload_column + row * 4), record);
+    
+    uint32_t begin = load_u32(segment.reference_offsets + row * 4);
+    uint32_t end = load_u32(segment.reference_offsets + (row + 1) * 4);
+    for (uint32_t i = begin; i < end; i++) {
+        uint16_t reference = load_u16(segment.references + i * 2);
+        const std::string& address = segment.addresses[reference & ~ROLE_FROM];
+        if (reference & ROLE_FROM) {
+            record.from_address = address;
+        } else {
+            record.to_addresses.push_back(address);
+        }
+    }
+    return record;
+}
+
+ArchiveRecord WordArchive::pending_record(const PendingRow& row) const {
+    ArchiveRecord record;
+    record.time_ms = row.time_ms;
+    record.frequency_hz = row.frequency_hz;
+    decode_row(row.kind, row.info, row.payload, record);
+    for (uint16_t reference : row.addresses) {
+        const std::string& address = pending.addresses[reference & ~ROLE_FROM];
+        if (reference & ROLE_FROM) {
+            record.from_address = address;
+        } else {
+            record.to_addresses.push_back(address);
+        }
+    }
+    return record;
+}
+
+size_t WordArchive::query(const ArchiveQuery& query, std::vector<ArchiveRecord>& results) const {
+    struct Match {
+        uint64_t time_ms;
+        const Segment* segment;
+        uint32_t row;
+    };
+    std::vector<Match> matches;
+    auto collect = [&matches](uint64_t time_ms, const Segment* segment, uint32_t row) {
+        matches.push_back({time_ms, segment, row});
+    };
+    scan(query, collect);
+    
+    // Segments are in time order when appends are; sort for when they are not
+    std::stable_sort(matches.begin(), matches.end(), [](const Match& a, const Match& b) {
+        return a.time_ms < b.time_ms;
+    });
+    if (query.max_results > 0 && matches.size() > query.max_results) {
+        matches.resize(query.max_results);
+    }
+    
+    results.clear();
+    results.reserve(matches.size());
+    for (const auto& match : matches) {
+        results.push_back(match.segment ? segment_record(*match.segment, match.row)
+                                        : pending_record(pending.rows[match.row]));
+    }
+    return results.size();
+}
+
+size_t WordArchive::count(const ArchiveQuery& query) const {
+    size_t total = 0;
+    auto counter = [&total](uint64_t, const Segment*, uint32_t) {
+        total++;
+    };
+    scan(query, counter);
+    return total;
+}
+
+} // namespace ale
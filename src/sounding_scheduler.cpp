@@ -0,0 +1,273 @@
+/**
+ * @file sounding_scheduler.cpp
+ * @brief Implementation of multi-channel sounding scheduler
+ */
+
+#include "ale/sounding_scheduler.h"
+#include "ale/lqa_analyzer.h"
+#include <algorithm>
+
+namespace ale {
+
+// Wrap-safe signed difference between two millisecond timestamps
+static int32_t time_diff(uint32_t a, uint32_t b) {
+    return static_cast<int32_t>(a - b);
+}
+
+// Jitter seed from the station address (FNV-1a), never 0 for xorshift
+static uint32_t address_seed(const std::string& address) {
+    uint32_t hash = 2166136261u;
+    for (char c : address) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 16777619u;
+    }
+    return hash ? hash : 1;
+}
+
+SoundingScheduler::SoundingScheduler(const SchedulerConfig& config)
+    : rng_state_(1) {
+    set_config(config);
+}
+
+void SoundingScheduler::set_config(const SchedulerConfig& config) {
+    config_ = config;
+    if (config_.interval_ms == 0) config_.interval_ms = 1;
+    if (config_.activity_bin_ms == 0) config_.activity_bin_ms = 1;
+    if (config_.activity_period_ms < config_.activity_bin_ms) {
+        config_.activity_period_ms = config_.activity_bin_ms;
+    }
+    
+    rng_state_ = config_.seed ? config_.seed : address_seed(config_.self_address);
+    activity_bins_.assign(config_.activity_period_ms / config_.activity_bin_ms, 0);
+}
+
+SchedulerConfig SoundingScheduler::get_config() const {
+    return config_;
+}
+
+void SoundingScheduler::add_channel(uint32_t frequency_hz, float value) {
+    ChannelSchedule* existing = find_channel(frequency_hz);
+    if (existing) {
+        existing->value = value;
+        return;
+    }
+    
+    ChannelSchedule channel;
+    channel.frequency_hz = frequency_hz;
+    channel.value = value;
+    channel.score = 0.0f;
+    channel.last_refresh_ms = 0;
+    channel.due_ms = 0;
+    channel.refreshed = false;
+    channels_.push_back(channel);
+}
+
+bool SoundingScheduler::remove_channel(uint32_t frequency_hz) {
+    auto it = std::find_if(channels_.begin(), channels_.end(),
+        [frequency_hz](const ChannelSchedule& c) {
+            return c.frequency_hz == frequency_hz;
+        });
+        
+    if (it == channels_.end()) {
+        return false;
+    }
+    
+    channels_.erase(it);
+    return true;
+}
+
+size_t SoundingScheduler::get_channel_count() const {
+    return channels_.size();
+}
+
+SoundingScheduler::ChannelSchedule* SoundingScheduler::find_channel(uint32_t frequency_hz) {
+    for (auto& channel : channels_) {
+        if (channel.frequency_hz == frequency_hz) {
+            return &channel;
+        }
+    }
+    return nullptr;
+}
+
+uint32_t SoundingScheduler::jittered_interval() {
+    // xorshift32
+    rng_state_ ^= rng_state_ << 13;
+    rng_state_ ^= rng_state_ >> 17;
+    rng_state_ ^= rng_state_ << 5;
+    
+    float unit = (rng_state_ & 0xFFFFFF) / static_cast<float>(0xFFFFFF);  // [0, 1]
+    float spread = config_.jitter_fraction * (2.0f * unit - 1.0f);        // [-j, +j]
+    float interval = config_.interval_ms * (1.0f + spread);
+    
+    return static_cast<uint32_t>(std::max(interval, 1.0f));
+}
+
+void SoundingScheduler::refresh(ChannelSchedule& channel, uint32_t time_ms) {
+    // Ignore data older than what we already have
+    if (channel.refreshed && time_diff(time_ms, channel.last_refresh_ms) <= 0) {
+        return;
+    }
+    
+    channel.last_refresh_ms = time_ms;
+    channel.due_ms = time_ms + jittered_interval();
+    channel.refreshed = true;
+}
+
+void SoundingScheduler::update_channel_quality(uint32_t frequency_hz, float score,
+                                               uint32_t last_update_ms) {
+    ChannelSchedule* channel = find_channel(frequency_hz);
+    if (!channel) {
+        return;
+    }
+    
+    channel->score = score;
+    if (last_update_ms != 0) {
+        refresh(*channel, last_update_ms);
+    }
+}
+
+void SoundingScheduler::sync_from_analyzer(const LQAAnalyzer& analyzer) {
+    for (const auto& rank : analyzer.rank_all_channels()) {
+        if (!find_channel(rank.frequency_hz)) {
+            add_channel(rank.frequency_hz);
+        }
+        update_channel_quality(rank.frequency_hz, rank.score, rank.last_update_ms);
+    }
+}
+
+void SoundingScheduler::record_call_activity(uint32_t time_ms) {
+    uint32_t bin = (time_ms % config_.activity_period_ms) / config_.activity_bin_ms;
+    if (bin < activity_bins_.size()) {
+        activity_bins_[bin]++;
+    }
+}
+
+float SoundingScheduler::call_likelihood(uint32_t time_ms) const {
+    if (activity_bins_.empty()) {
+        return 0.0f;
+    }
+    
+    uint32_t peak = *std::max_element(activity_bins_.begin(), activity_bins_.end());
+    if (peak == 0) {
+        return 0.0f;
+    }
+    
+    uint32_t bin = (time_ms % config_.activity_period_ms) / config_.activity_bin_ms;
+    if (bin >= activity_bins_.size()) {
+        return 0.0f;
+    }
+    
+    return static_cast<float>(activity_bins_[bin]) / peak;
+}
+
+float SoundingScheduler::staleness(const ChannelSchedule& channel, uint32_t now_ms) const {
+    if (!channel.refreshed) {
+        return config_.max_staleness;  // Never sounded, treat as badly overdue
+    }
+    
+    int32_t age = time_diff(now_ms, channel.last_refresh_ms);
+    if (age <= 0) {
+        return 0.0f;
+    }
+    
+    return static_cast<float>(age) / config_.interval_ms;
+}
+
+float SoundingScheduler::priority(const ChannelSchedule& channel, uint32_t now_ms) const {
+    // Better channels carry more traffic, so their LQA is worth more
+    float quality_weight = 1.0f + std::max(channel.score, 0.0f) / 31.0f;
+    return staleness(channel, now_ms) * channel.value * quality_weight;
+}
+
+SoundingBatch SoundingScheduler::plan(uint32_t now_ms) const {
+    SoundingBatch batch;
+    batch.start_ms = now_ms;
+    
+    if (config_.max_batch == 0) {
+        return batch;
+    }
+    
+    std::vector<ScheduledSounding> due;
+    std::vector<ScheduledSounding> early;
+    
+    for (const auto& channel : channels_) {
+        ScheduledSounding s;
+        s.frequency_hz = channel.frequency_hz;
+        s.staleness = staleness(channel, now_ms);
+        s.priority = priority(channel, now_ms);
+        
+        if (!channel.refreshed || time_diff(now_ms, channel.due_ms) >= 0) {
+            due.push_back(s);
+        } else if (s.staleness >= config_.pull_forward) {
+            early.push_back(s);
+        }
+    }
+    
+    if (due.empty()) {
+        return batch;
+    }
+    
+    // Hold off while calls are likely, except for badly overdue channels
+    if (call_likelihood(now_ms) >= config_.busy_likelihood) {
+        float limit = config_.max_staleness;
+        due.erase(std::remove_if(due.begin(), due.end(),
+            [limit](const ScheduledSounding& s) { return s.staleness < limit; }),
+            due.end());
+            
+        if (due.empty()) {
+            batch.held_off = true;
+            return batch;
+        }
+        early.clear();  // Keep the transmission short during busy periods
+    }
+    
+    auto by_priority = [](const ScheduledSounding& a, const ScheduledSounding& b) {
+        return a.priority > b.priority;
+    };
+    std::sort(due.begin(), due.end(), by_priority);
+    std::sort(early.begin(), early.end(), by_priority);
+    
+    // Due channels first, then fill the batch with nearly-due ones
+    for (const auto& s : due) {
+        if (batch.channels.size() >= config_.max_batch) break;
+        batch.channels.push_back(s);
+    }
+    for (const auto& s : early) {
+        if (batch.channels.size() >= config_.max_batch) break;
+        batch.channels.push_back(s);
+    }
+    
+    return batch;
+}
+
+void SoundingScheduler::mark_sounded(uint32_t frequency_hz, uint32_t time_ms) {
+    ChannelSchedule* channel = find_channel(frequency_hz);
+    if (channel) {
+        refresh(*channel, time_ms);
+    }
+}
+
+void SoundingScheduler::mark_batch_sounded(const SoundingBatch& batch, uint32_t time_ms) {
+    for (const auto& s : batch.channels) {
+        mark_sounded(s.frequency_hz, time_ms);
+    }
+}
+
+uint32_t SoundingScheduler::next_due_ms(uint32_t now_ms) const {
+    bool found = false;
+    uint32_t earliest = now_ms;
+    
+    for (const auto& channel : channels_) {
+        if (!channel.refreshed || time_diff(channel.due_ms, now_ms) <= 0) {
+            return now_ms;
+        }
+        if (!found || time_diff(channel.due_ms, earliest) < 0) {
+            earliest = channel.due_ms;
+            found = true;
+        }
+    }
+    
+    return earliest;
+}
+
+} // namespace ale
@@ -277,6 +277,42 @@ void test_slot_timing() {
     std::cout << "  PASSED\n\n";
 }
 
+// Test sample-clock times past 2^32 samples
+void test_sample_times() {
+    std::cout << "Test: Sample-Clock Times...\n";
+    
+    // Call probe takes its sample time from the first word
+    ALEWord words[2];
+    words[0].type = WordType::TO;
+    strcpy(words[0].address, "ABC");
+    words[0].raw_payload = 0x012345;
+    words[0].sample_time = 5000000000ULL;
+    words[0].valid = true;
+    
+    words[1].type = WordType::FROM;
+    strcpy(words[1].address, "XYZ");
+    words[1].raw_payload = 0;
+    words[1].sample_time = 5000000000ULL + 49 * 64;
+    words[1].valid = true;
+    
+    AQCParser parser;
+    AQCCallProbe probe;
+    [[maybe_unused]] bool result = parser.parse_call_probe(words, 2, probe);
+    
+    assert(result == true);
+    assert(probe.sample_time == 5000000000ULL);
+    
+    // Response slots on the sample clock (1600 samples per 200 ms slot)
+    SampleTime base_sample = (1ULL << 32) + 100;
+    assert(SlotManager::calculate_slot_sample(0, base_sample) == base_sample);
+    assert(SlotManager::calculate_slot_sample(3, base_sample) == base_sample + 3 * 1600);
+    assert(SlotManager::calculate_slot_sample(9, base_sample) == base_sample + 7 * 1600);
+    
+    std::cout << "  ✓ Probe sample: " << probe.sample_time << "\n";
+    std::cout << "  ✓ Slot 3 sample: " << SlotManager::calculate_slot_sample(3, base_sample) << "\n";
+    std::cout << "  PASSED\n\n";
+}
+
 int main() {
     std::cout << "========================================\n";
     std::cout << "AQC-ALE Parser Tests\n";
@@ -292,6 +328,7 @@ int main() {
         test_parse_orderwire();
         test_slot_assignment();
         test_slot_timing();
+        test_sample_times();
         
         std::cout << "========================================\n";
         std::cout << "All AQC Parser tests PASSED! ✓\n";
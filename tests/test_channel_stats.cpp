@@ -0,0 +1,271 @@
+/**
+ * @file test_channel_stats.cpp
+ * @brief Unit tests for per-channel occupancy and noise statistics
+ */
+
+#include "ale/channel_stats.h"
+#include "ale/lqa_analyzer.h"
+#include "ale/lqa_database.h"
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <string>
+
+using namespace ale;
+
+static const uint32_t START_MS = 6000000;
+
+static BandEnergy idle_frame(float noise_floor) {
+    BandEnergy energy;
+    energy.noise_floor = noise_floor;
+    energy.in_band_mean = noise_floor * 1.2f;
+    energy.in_band_peak = noise_floor * 1.5f;
+    return energy;
+}
+
+static BandEnergy tone_frame(float noise_floor) {
+    BandEnergy energy;
+    energy.noise_floor = noise_floor;
+    energy.in_band_mean = noise_floor * 10.0f;
+    energy.in_band_peak = noise_floor * 60.0f;
+    return energy;
+}
+
+static BandEnergy wideband_frame(float noise_floor) {
+    BandEnergy energy;
+    energy.noise_floor = noise_floor;
+    energy.in_band_mean = noise_floor * 10.0f;
+    energy.in_band_peak = noise_floor * 15.0f;
+    return energy;
+}
+
+static uint32_t wall_clock_ms() {
+    auto now = std::chrono::system_clock::now();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        now.time_since_epoch()).count();
+}
+
+void test_empty() {
+    std::cout << "Test: No measurements..." << std::endl;
+    
+    ChannelStats stats;
+    [[maybe_unused]] ChannelStatsSummary summary = stats.get_summary(7073000, 600000, START_MS);
+    assert(summary.frequency_hz == 7073000);
+    assert(summary.frames == 0);
+    assert(summary.busy_fraction == 0.0f);
+    assert(stats.get_channel_count() == 0);
+    
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_busy_fraction_and_events() {
+    std::cout << "Test: Busy fraction and events..." << std::endl;
+    
+    ChannelStats stats;
+    
+    // 3 bursts of 10 tonal frames, 20 idle frames after each
+    uint32_t now = START_MS;
+    for (int burst = 0; burst < 3; burst++) {
+        for (int i = 0; i < 10; i++) {
+            stats.add_measurement(7073000, tone_frame(2.0f), now += 8);
+        }
+        for (int i = 0; i < 20; i++) {
+            stats.add_measurement(7073000, idle_frame(2.0f), now += 8);
+        }
+    }
+    
+    ChannelStatsSummary summary = stats.get_summary(7073000, 600000, now);
+    assert(summary.frames == 90);
+    assert(std::abs(summary.busy_fraction - 30.0f / 90.0f) < 1e-4f);
+    assert(std::abs(summary.tonal_fraction - 1.0f) < 1e-4f);
+    assert(summary.events == 3);
+    assert(summary.peak_level_db > 19.0f);
+    assert(summary.last_measurement_ms == now);
+    
+    // Voice-like energy is busy but not tonal
+    for (int i = 0; i < 30; i++) {
+        stats.add_measurement(7073000, wideband_frame(2.0f), now += 8);
+    }
+    summary = stats.get_summary(7073000, 600000, now);
+    assert(summary.events == 4);
+    assert(std::abs(summary.tonal_fraction - 0.5f) < 1e-4f);
+    
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_noise_percentiles() {
+    std::cout << "Test: Noise floor percentiles..." << std::endl;
+    
+    ChannelStats stats;
+    ChannelStatsConfig config;
+    config.noise_bin_db = 1.0f;
+    stats.set_config(config);
+    
+    // 80% of frames at 0 dB (magnitude 1), 20% at 20 dB (magnitude 10)
+    uint32_t now = START_MS;
+    for (int i = 0; i < 100; i++) {
+        float floor = (i % 5 == 0) ? 10.0f : 1.0f;
+        stats.add_measurement(10142000, idle_frame(floor), now += 10);
+    }
+    
+    [[maybe_unused]] ChannelStatsSummary summary = stats.get_summary(10142000, 600000, now);
+    assert(std::abs(summary.noise_p10_db - 0.5f) < 1e-3f);
+    assert(std::abs(summary.noise_p50_db - 0.5f) < 1e-3f);
+    assert(std::abs(summary.noise_p90_db - 20.5f) < 1e-3f);
+    assert(summary.busy_fraction == 0.0f);
+    
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_buckets_age_out() {
+    std::cout << "Test: Buckets age out..." << std::endl;
+    
+    ChannelStats stats;
+    ChannelStatsConfig config;
+    config.bucket_ms = 1000;
+    config.bucket_count = 10;
+    stats.set_config(config);
+    
+    // Busy in the first second, idle for the next five
+    uint32_t now = START_MS;
+    for (int i = 0; i < 100; i++) {
+        stats.add_measurement(7073000, tone_frame(1.0f), now + i * 10);
+    }
+    for (int second = 1; second <= 5; second++) {
+        for (int i = 0; i < 100; i++) {
+            stats.add_measurement(7073000, idle_frame(1.0f), now + second * 1000 + i * 10);
+        }
+    }
+    now += 5990;
+    
+    // Whole history: 1 busy second in 6
+    ChannelStatsSummary summary = stats.get_summary(7073000, 10000, now);
+    assert(summary.frames == 600);
+    assert(std::abs(summary.busy_fraction - 1.0f / 6.0f) < 1e-4f);
+    
+    // Last 3 seconds: idle
+    summary = stats.get_summary(7073000, 3000, now);
+    assert(summary.frames == 300);
+    assert(summary.busy_fraction == 0.0f);
+    
+    // Much later, the busy second's slot is reused
+    uint32_t later = START_MS + 10000;
+    stats.add_measurement(7073000, idle_frame(1.0f), later);
+    summary = stats.get_summary(7073000, 10000, later);
+    assert(summary.frames == 501);
+    assert(summary.busy_fraction == 0.0f);
+    
+    // Nothing measured recently
+    summary = stats.get_summary(7073000, 10000, START_MS + 100000);
+    assert(summary.frames == 0);
+    assert(summary.last_measurement_ms == later);
+    
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_channels_separate() {
+    std::cout << "Test: Channels kept separate..." << std::endl;
+    
+    ChannelStats stats;
+    uint32_t now = START_MS;
+    for (int i = 0; i < 50; i++) {
+        stats.add_measurement(7073000, tone_frame(1.0f), now++);
+        stats.add_measurement(14109000, idle_frame(1.0f), now++);
+    }
+    
+    auto summaries = stats.get_all_summaries(600000, now);
+    assert(summaries.size() == 2);
+    assert(summaries[0].frequency_hz == 7073000);
+    assert(summaries[0].busy_fraction == 1.0f);
+    assert(summaries[1].frequency_hz == 14109000);
+    assert(summaries[1].busy_fraction == 0.0f);
+    
+    stats.clear();
+    assert(stats.get_channel_count() == 0);
+    
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_analyzer_skips_occupied() {
+    std::cout << "Test: Analyzer skips occupied channels..." << std::endl;
+    
+    LQADatabase db;
+    LQAAnalyzer analyzer(&db);
+    uint32_t now = wall_clock_ms();
+    
+    // 7073 kHz has the better LQA but is busy
+    db.update_entry(7073000, "BRAVO", 25.0f, 0.001f, 0, 100, now);
+    db.update_entry(10142000, "BRAVO", 18.0f, 0.001f, 0, 100, now);
+    
+    auto best = analyzer.get_best_channel_for_station("BRAVO");
+    assert(best && best->frequency_hz == 7073000);
+    
+    ChannelStats stats;
+    for (int i = 0; i < 100; i++) {
+        stats.add_measurement(7073000, (i % 4 == 0) ? idle_frame(1.0f) : wideband_frame(1.0f),
+                              now);
+    }
+    analyzer.set_channel_stats(&stats);
+    
+    best = analyzer.get_best_channel_for_station("BRAVO");
+    assert(best && best->frequency_hz == 10142000);
+    best = analyzer.get_best_channel();
+    assert(best && best->frequency_hz == 10142000);
+    
+    // Ranked, but scaled by the idle fraction
+    auto ranks = analyzer.rank_all_channels();
+    assert(ranks.size() == 2);
+    assert(ranks[0].frequency_hz == 10142000);
+    assert(ranks[1].score < ranks[0].score);
+    
+    [[maybe_unused]] ChannelStatsSummary summary = analyzer.get_channel_statistics(7073000);
+    assert(std::abs(summary.busy_fraction - 0.75f) < 1e-4f);
+    std::string text = analyzer.get_channel_quality_summary(7073000);
+    assert(text.find("Busy: 75%") != std::string::npos);
+    
+    analyzer.set_channel_stats(nullptr);
+    best = analyzer.get_best_channel_for_station("BRAVO");
+    assert(best && best->frequency_hz == 7073000);
+    
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_peak_below_noise_floor() {
+    std::cout << "Test: Peak level below noise floor..." << std::endl;
+    
+    ChannelStats stats;
+    
+    // In-band energy under the out-of-band floor: every level is negative
+    BandEnergy quiet;
+    quiet.noise_floor = 4.0f;
+    quiet.in_band_mean = 2.0f;
+    quiet.in_band_peak = 3.0f;
+    uint32_t now = START_MS;
+    for (int i = 0; i < 20; i++) {
+        stats.add_measurement(7073000, quiet, now += 8);
+    }
+    
+    [[maybe_unused]] ChannelStatsSummary summary = stats.get_summary(7073000, 600000, now);
+    assert(summary.frames == 20);
+    assert(summary.busy_fraction == 0.0f);
+    assert(std::abs(summary.peak_level_db - quiet.level_db()) < 1e-4f);
+    assert(summary.peak_level_db < -5.0f);
+    
+    std::cout << "  PASS" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Channel Statistics Tests ===" << std::endl;
+    
+    test_empty();
+    test_busy_fraction_and_events();
+    test_noise_percentiles();
+    test_buckets_age_out();
+    test_channels_separate();
+    test_analyzer_skips_occupied();
+    test_peak_below_noise_floor();
+    
+    std::cout << "\n=== All Channel Statistics Tests Passed ===" << std::endl;
+    return 0;
+}
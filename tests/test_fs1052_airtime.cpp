@@ -0,0 +1,150 @@
+/**
+ * \file test_fs1052_airtime.cpp
+ * \brief Unit tests for FS-1052 airtime model
+ */
+
+#include "fs1052_airtime.h"
+#include <cassert>
+#include <iostream>
+
+using namespace fs1052;
+
+// Test frame lengths match the formatter
+void test_frame_lengths() {
+    std::cout << "Test: Frame Lengths...\n";
+    
+    uint8_t buffer[1200];
+    
+    ControlFrame ack;
+    ack.frame_type = FrameType::T2_CONTROL;
+    ack.ack_nak_type = AckNakType::DATA_ACK;
+    assert(FrameFormatter::control_frame_length(ack) ==
+           static_cast<size_t>(FrameFormatter::format_control_frame(ack, buffer, sizeof(buffer))));
+    assert(FrameFormatter::control_frame_length(ack) == 45);
+    
+    ControlFrame full;
+    full.address_mode = AddressMode::LONG_18_BYTE;
+    full.herald_present = true;
+    full.message_present = true;
+    full.extension_function_present = true;
+    assert(FrameFormatter::control_frame_length(full) ==
+           static_cast<size_t>(FrameFormatter::format_control_frame(full, buffer, sizeof(buffer))));
+    
+    DataFrame data;
+    data.data_length = 700;
+    assert(FrameFormatter::data_frame_length(700) ==
+           static_cast<size_t>(FrameFormatter::format_data_frame(data, buffer, sizeof(buffer))));
+    
+    std::cout << "  ✓ Control frame lengths match formatted frames\n";
+    std::cout << "  ✓ Data frame length matches formatted frame\n";
+    std::cout << "  PASSED\n\n";
+}
+
+// Test preamble, interleaver padding and EOM
+void test_transmission_time() {
+    std::cout << "Test: Transmission Time...\n";
+    
+    AirtimeModel model;
+    model.set_mode(DataRate::BPS_2400, InterleaverLength::SHORT);
+    assert(model.preamble_ms() == 600);
+    assert(model.block_ms() == 600);
+    assert(model.bits_per_block() == 1440);
+    
+    // 1036-byte frame + EOM = 8320 bits = 6 blocks
+    assert(model.data_frame_ms(MAX_DATA_BLOCK_LENGTH) == 600 + 6 * 600);
+    assert(model.data_end_ms(1036) == 600 + 6 * 600);
+    
+    // EOM alone spills into a new block
+    assert(model.data_end_ms(180) == 600 + 600);
+    assert(model.transmission_ms(180) == 600 + 2 * 600);
+    
+    // Long interleaver: 4.8 s preamble and blocks
+    model.set_mode(DataRate::BPS_2400, InterleaverLength::LONG);
+    assert(model.data_frame_ms(MAX_DATA_BLOCK_LENGTH) == 4800 + 4800);
+    
+    // 75 bps: 45 bits per short block
+    model.set_mode(DataRate::BPS_75, InterleaverLength::SHORT);
+    assert(model.bits_per_block() == 45);
+    assert(model.transmission_ms(10) == 600 + 3 * 600);
+    
+    std::cout << "  ✓ One preamble, whole interleaver blocks\n";
+    std::cout << "  ✓ Long interleaver and low rates\n";
+    std::cout << "  PASSED\n\n";
+}
+
+// Test a series shares one preamble and fits a window
+void test_series_sizing() {
+    std::cout << "Test: Series Sizing...\n";
+    
+    AirtimeModel model;
+    
+    // 8 full frames: 66336 bits = 47 blocks, vs 8 separate transmissions
+    uint32_t series = model.series_ms(8, MAX_DATA_BLOCK_LENGTH);
+    assert(series == 600 + 47 * 600);
+    assert(series < 8 * model.data_frame_ms(MAX_DATA_BLOCK_LENGTH));
+    
+    assert(model.max_frames(series, MAX_DATA_BLOCK_LENGTH) == 8);
+    assert(model.max_frames(series - 1, MAX_DATA_BLOCK_LENGTH) == 7);
+    assert(model.max_frames(500, MAX_DATA_BLOCK_LENGTH) == 0);
+    
+    // Whatever max_frames allows fits the window
+    const uint16_t lengths[] = {100, 500, MAX_DATA_BLOCK_LENGTH};
+    for (uint32_t window = 1000; window < 60000; window += 777) {
+        for (uint16_t length : lengths) {
+            uint32_t n = model.max_frames(window, length);
+            assert(model.series_ms(n, length) <= window || n == 0);
+            assert(model.series_ms(n + 1, length) > window);
+        }
+    }
+    
+    std::cout << "  ✓ Series of 8 frames: " << series << " ms\n";
+    std::cout << "  ✓ max_frames() is the largest series inside the window\n";
+    std::cout << "  PASSED\n\n";
+}
+
+// Test goodput of a send/acknowledge cycle
+void test_expected_goodput() {
+    std::cout << "Test: Expected Goodput...\n";
+    
+    AirtimeModel model;
+    model.set_turnaround_ms(500);
+    
+    // 8 full frames, one 45-byte ACK per frame (2912 bits = 3 blocks)
+    uint32_t series_bytes = 8 * static_cast<uint32_t>(FrameFormatter::data_frame_length(MAX_DATA_BLOCK_LENGTH));
+    uint32_t cycle = model.cycle_ms(series_bytes, 8 * 45);
+    assert(cycle == 2 * 500 + 28800 + 2400);
+    
+    uint32_t goodput = model.expected_goodput_bps(8 * MAX_DATA_BLOCK_LENGTH, series_bytes, 8 * 45);
+    assert(goodput == 8 * MAX_DATA_BLOCK_LENGTH * 8000 / cycle);
+    
+    // Short series pay the preamble and turnarounds more often
+    uint32_t single = model.expected_goodput_bps(MAX_DATA_BLOCK_LENGTH,
+        static_cast<uint32_t>(FrameFormatter::data_frame_length(MAX_DATA_BLOCK_LENGTH)), 45);
+    assert(single < goodput);
+    
+    std::cout << "  ✓ 8-frame series: " << goodput << " bps of 2400\n";
+    std::cout << "  ✓ Single frame: " << single << " bps\n";
+    std::cout << "  PASSED\n\n";
+}
+
+int main() {
+    std::cout << "========================================\n";
+    std::cout << "FS-1052 Airtime Model Tests\n";
+    std::cout << "========================================\n\n";
+    
+    try {
+        test_frame_lengths();
+        test_transmission_time();
+        test_series_sizing();
+        test_expected_goodput();
+        
+        std::cout << "========================================\n";
+        std::cout << "All FS-1052 Airtime tests PASSED! ✓\n";
+        std::cout << "========================================\n";
+        
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Test FAILED with exception: " << e.what() << "\n";
+        return 1;
+    }
+}
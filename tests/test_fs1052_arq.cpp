@@ -8,6 +8,9 @@
 #include <iostream>
 #include <vector>
 #include <cstring>
+#include <initializer_list>
+#include <algorithm>
+#include <string>
 
 using namespace fs1052;
 
@@ -233,7 +236,7 @@ void test_timeout_handling() {
     
     // Simulate timeout
     arq.update(0);      // Start
-    arq.update(1500);   // After timeout
+    arq.update(3000);   // After turnaround, airtime (1.2 s) and timeout
     
     // Should have triggered retransmission
     const auto& stats = arq.get_stats();
@@ -337,6 +340,516 @@ void test_statistics() {
     std::cout << "  PASSED\n\n";
 }
 
+// Build a data ACK frame with the given sequences set in the bitmap
+std::vector<uint8_t> make_ack(std::initializer_list<int> sequences) {
+    ControlFrame ack;
+    ack.frame_type = FrameType::T2_CONTROL;
+    ack.ack_nak_type = AckNakType::DATA_ACK;
+    for (int seq : sequences) {
+        ack.bit_map[seq / 8] |= (1 << (seq % 8));
+    }
+    
+    std::vector<uint8_t> buffer(256);
+    int length = FrameFormatter::format_control_frame(ack, buffer.data(), buffer.size());
+    buffer.resize(length);
+    return buffer;
+}
+
+// Sequence number of a sent data frame
+int sent_sequence(const std::vector<uint8_t>& frame) {
+    DataFrame df;
+    if (!FrameParser::parse_data_frame(frame.data(), frame.size(), df)) {
+        return -1;
+    }
+    return df.sequence_number;
+}
+
+// Test RTT estimator
+void test_rtt_estimator() {
+    std::cout << "Test: RTT Estimator...\n";
+    
+    RTTEstimator rtt;
+    rtt.set_initial_timeout(5000);
+    assert(!rtt.has_sample());
+    assert(rtt.timeout_ms() == 5000);
+    
+    // First sample: SRTT = R, RTTVAR = R/2, RTO = SRTT + 4 RTTVAR
+    rtt.add_sample(2000);
+    assert(rtt.srtt_ms() == 2000);
+    assert(rtt.rttvar_ms() == 1000);
+    assert(rtt.timeout_ms() == 6000);
+    
+    // Steady RTT: variance decays and RTO converges on SRTT + granularity
+    for (int i = 0; i < 30; i++) {
+        rtt.add_sample(2000);
+    }
+    assert(rtt.timeout_ms() >= 2100 && rtt.timeout_ms() < 2200);
+    
+    // Exponential backoff, capped
+    uint32_t base = rtt.timeout_ms();
+    rtt.backoff();
+    assert(rtt.timeout_ms() == 2 * base);
+    rtt.backoff();
+    assert(rtt.timeout_ms() == 4 * base);
+    rtt.set_limits(1000, 10000);
+    for (int i = 0; i < 10; i++) {
+        rtt.backoff();
+    }
+    assert(rtt.timeout_ms() == 10000);
+    
+    // A new valid sample clears backoff
+    rtt.add_sample(2000);
+    assert(rtt.backoff_count() == 0);
+    assert(rtt.timeout_ms() < 2200);
+    
+    std::cout << "  ✓ SRTT/RTTVAR per RFC 6298\n";
+    std::cout << "  ✓ Exponential backoff capped at limit\n";
+    std::cout << "  ✓ Sample clears backoff\n";
+    std::cout << "  PASSED\n\n";
+}
+
+// Test timeout adapts to measured round trip
+void test_adaptive_timeout() {
+    std::cout << "Test: Adaptive ACK Timeout...\n";
+    
+    TestHarness harness;
+    VariableARQ arq;
+    arq.set_data_rate(DataRate::BPS_2400);
+    arq.init([&](const uint8_t* f, int l) { harness.tx_callback(f, l); });
+    
+    // Two blocks, 1036 + 490 byte frames in one transmission at 2400 bps:
+    // 500 ms turnaround, 600 ms preamble, 9 interleaver blocks -> 6500 ms
+    std::vector<uint8_t> data(1500, 0x55);
+    arq.update(0);
+    arq.start_transmission(data.data(), data.size());
+    assert(harness.sent_frames.size() == 2);
+    assert(arq.get_ack_timeout() == 5000);  // Initial timeout
+    
+    // ACK 2 s after the last bit: sample excludes the frames' airtime
+    arq.update(6500 + 2000);
+    std::vector<uint8_t> ack = make_ack({0, 1});
+    arq.handle_received_frame(ack.data(), ack.size());
+    
+    const RTTEstimator& rtt = arq.get_rtt_estimator();
+    assert(arq.get_stats().rtt_samples == 1);
+    assert(rtt.srtt_ms() == 2000);
+    assert(arq.get_ack_timeout() == 6000);
+    assert(arq.is_transfer_complete());
+    
+    // 1500 bytes delivered in 8.5 s
+    assert(arq.achieved_goodput_bps() == 1500 * 8000 / 8500);
+    assert(arq.expected_goodput_bps() > arq.achieved_goodput_bps());
+    
+    std::cout << "  ✓ RTT measured from end of transmission: " << rtt.srtt_ms() << " ms\n";
+    std::cout << "  ✓ Timeout derived from RTT: " << arq.get_ack_timeout() << " ms\n";
+    std::cout << "  ✓ Goodput " << arq.achieved_goodput_bps() << " bps achieved, "
+              << arq.expected_goodput_bps() << " bps for full series\n";
+    std::cout << "  PASSED\n\n";
+}
+
+// Test selective retransmission, Karn's rule and backoff
+void test_selective_retransmission() {
+    std::cout << "Test: Selective Retransmission...\n";
+    
+    TestHarness harness;
+    VariableARQ arq;
+    arq.set_data_rate(DataRate::BPS_2400);
+    arq.set_window_size(3);
+    arq.set_ack_timeout(20000);  // Longer than the first series' RTT
+    arq.init([&](const uint8_t* f, int l) { harness.tx_callback(f, l); });
+    
+    // Five full blocks; series 0, 1, 2 in one transmission from 500 ms:
+    // frames decodable at 4700, 8300 and 11900 ms, which ends it
+    std::vector<uint8_t> data(5 * MAX_DATA_BLOCK_LENGTH, 0xA5);
+    arq.update(0);
+    arq.start_transmission(data.data(), data.size());
+    assert(harness.sent_frames.size() == 3);
+    
+    // Block 2 missing but sent after block 1: not known lost yet. Next
+    // series 3, 4 runs from 14400 to 22200 ms
+    arq.update(11900 + 2000);
+    std::vector<uint8_t> ack = make_ack({0, 1});
+    arq.handle_received_frame(ack.data(), ack.size());
+    assert(arq.get_stats().rtt_samples == 1);
+    assert(arq.get_ack_timeout() == 6000);
+    assert(harness.sent_frames.size() == 5);
+    assert(sent_sequence(harness.sent_frames[3]) == 3);
+    assert(sent_sequence(harness.sent_frames[4]) == 4);
+    
+    // RTO 6000: block 2 overdue, blocks 3 and 4 still in flight and not
+    // resent. Block 2 joins the transmission still on the air
+    arq.update(17900);
+    assert(arq.get_stats().timeouts == 0);
+    arq.update(18000);
+    assert(arq.get_stats().timeouts == 1);
+    assert(arq.get_stats().retransmits_skipped == 2);
+    assert(harness.sent_frames.size() == 6);
+    assert(sent_sequence(harness.sent_frames[5]) == 2);
+    
+    // Backoff doubles the timeout
+    assert(arq.get_ack_timeout() == 12000);
+    
+    // ACK of the retransmitted block is ambiguous: no RTT sample (Karn).
+    // Block 3 went out before it and is missing: resent at once
+    arq.update(25800 + 2000);
+    ack = make_ack({0, 1, 2, 4});
+    arq.handle_received_frame(ack.data(), ack.size());
+    assert(arq.get_stats().rtt_samples == 1);
+    assert(arq.get_stats().timeouts == 1);
+    assert(harness.sent_frames.size() == 7);
+    assert(sent_sequence(harness.sent_frames[6]) == 3);
+    
+    ack = make_ack({0, 1, 2, 3, 4});
+    arq.update(32500 + 2000);
+    arq.handle_received_frame(ack.data(), ack.size());
+    assert(arq.get_stats().rtt_samples == 1);
+    assert(arq.is_transfer_complete());
+    
+    std::cout << "  ✓ Bitmap gap resent without waiting for timeout\n";
+    std::cout << "  ✓ Karn's rule skips retransmitted blocks\n";
+    std::cout << "  ✓ Only overdue blocks resent on timeout\n";
+    std::cout << "  ✓ Exponential backoff after timeout\n";
+    std::cout << "  PASSED\n\n";
+}
+
+// Test series sized to an airtime limit
+void test_series_airtime_limit() {
+    std::cout << "Test: Series Airtime Limit...\n";
+    
+    TestHarness harness;
+    VariableARQ arq;
+    arq.set_data_rate(DataRate::BPS_2400);
+    arq.init([&](const uint8_t* f, int l) { harness.tx_callback(f, l); });
+    
+    // 15 s holds four full frames (600 ms preamble + 24 blocks)
+    uint32_t unlimited = arq.expected_goodput_bps();
+    arq.set_max_series_ms(15000);
+    assert(arq.get_airtime_model().max_frames(15000, MAX_DATA_BLOCK_LENGTH) == 4);
+    assert(arq.expected_goodput_bps() < unlimited);
+    
+    std::vector<uint8_t> data(10 * MAX_DATA_BLOCK_LENGTH, 0x3C);
+    arq.update(0);
+    arq.start_transmission(data.data(), data.size());
+    assert(harness.sent_frames.size() == 4);
+    
+    // Long interleaver: a single frame already exceeds the limit but is sent
+    arq.reset();
+    harness.sent_frames.clear();
+    arq.set_interleaver(InterleaverLength::LONG);
+    arq.set_max_series_ms(5000);
+    arq.start_transmission(data.data(), data.size());
+    assert(harness.sent_frames.size() == 1);
+    DataFrame df;
+    bool parsed = FrameParser::parse_data_frame(harness.sent_frames[0].data(),
+                                                harness.sent_frames[0].size(), df);
+    assert(parsed);
+    assert(df.interleaver_length == InterleaverLength::LONG);
+    
+    std::cout << "  ✓ Series cut to fit " << arq.get_max_series_ms() << " ms\n";
+    std::cout << "  ✓ At least one block per series\n";
+    std::cout << "  ✓ Expected goodput " << unlimited << " bps with full windows\n";
+    std::cout << "  PASSED\n\n";
+}
+
+// Test complete transfer between two ARQ endpoints
+void test_loopback_transfer() {
+    std::cout << "Test: Loopback Transfer...\n";
+    
+    std::vector<std::vector<uint8_t>> to_receiver;
+    std::vector<std::vector<uint8_t>> to_sender;
+    
+    VariableARQ sender;
+    VariableARQ receiver;
+    sender.init([&](const uint8_t* f, int l) { to_receiver.emplace_back(f, f + l); });
+    receiver.init([&](const uint8_t* f, int l) { to_sender.emplace_back(f, f + l); });
+    receiver.process_event(ARQEvent::START_RX);
+    
+    std::vector<uint8_t> data(3000);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<uint8_t>(i * 7);
+    }
+    sender.start_transmission(data.data(), data.size());
+    
+    uint32_t time_ms = 0;
+    for (int i = 0; i < 100 && !sender.is_transfer_complete(); i++) {
+        auto frames = std::move(to_receiver);
+        to_receiver.clear();
+        for (const auto& f : frames) {
+            receiver.handle_received_frame(f.data(), f.size());
+        }
+        
+        auto acks = std::move(to_sender);
+        to_sender.clear();
+        for (const auto& f : acks) {
+            sender.handle_received_frame(f.data(), f.size());
+        }
+        
+        time_ms += 500;
+        sender.update(time_ms);
+        receiver.update(time_ms);
+    }
+    
+    assert(sender.is_transfer_complete());
+    assert(receiver.get_received_data() == data);
+    assert(receiver.get_stats().acks_sent == 3);
+    assert(sender.get_stats().blocks_retransmitted == 0);
+    assert(sender.get_stats().rtt_samples > 0);
+    
+    std::cout << "  ✓ Receiver acknowledges each block\n";
+    std::cout << "  ✓ Transfer completes without retransmission\n";
+    std::cout << "  PASSED\n\n";
+}
+
+// Test compression negotiated through ACK extension bits
+void test_compressed_transfer() {
+    std::cout << "Test: Compressed Transfer...\n";
+    
+    std::vector<std::vector<uint8_t>> to_receiver;
+    std::vector<std::vector<uint8_t>> to_sender;
+    
+    VariableARQ sender;
+    VariableARQ receiver;
+    sender.init([&](const uint8_t* f, int l) { to_receiver.emplace_back(f, f + l); });
+    receiver.init([&](const uint8_t* f, int l) { to_sender.emplace_back(f, f + l); });
+    sender.enable_compression(true);
+    receiver.enable_compression(true);
+    
+    auto run = [&](const std::vector<uint8_t>& data) {
+        receiver.reset();
+        receiver.process_event(ARQEvent::START_RX);
+        sender.start_transmission(data.data(), data.size());
+        
+        uint32_t time_ms = 0;
+        for (int i = 0; i < 100 && !sender.is_transfer_complete(); i++) {
+            auto frames = std::move(to_receiver);
+            to_receiver.clear();
+            for (const auto& f : frames) {
+                receiver.handle_received_frame(f.data(), f.size());
+            }
+            
+            auto acks = std::move(to_sender);
+            to_sender.clear();
+            for (const auto& f : acks) {
+                sender.handle_received_frame(f.data(), f.size());
+            }
+            
+            time_ms += 500;
+            sender.update(time_ms);
+            receiver.update(time_ms);
+        }
+        assert(sender.is_transfer_complete());
+        assert(receiver.get_received_data() == data);
+    };
+    
+    std::string text;
+    for (int i = 0; i < 60; i++) {
+        text += "INFO: position report from station " + std::to_string(i % 5) + " received\n";
+    }
+    std::vector<uint8_t> data(text.begin(), text.end());
+    
+    // Peer capability unknown until its first ACK: sent raw
+    assert(!sender.peer_supports_compression());
+    run(data);
+    assert(sender.get_stats().messages_compressed == 0);
+    assert(sender.peer_supports_compression());
+    
+    // Second message compressed
+    sender.reset();
+    run(data);
+    assert(sender.get_stats().messages_compressed == 1);
+    assert(sender.get_stats().bytes_saved > data.size() / 2);
+    assert(sender.get_stats().blocks_sent < 3);
+    
+    // Incompressible data bypasses the codec
+    std::vector<uint8_t> noise(2000);
+    uint32_t x = 12345;
+    for (auto& b : noise) {
+        x = x * 1103515245 + 12345;
+        b = static_cast<uint8_t>(x >> 24);
+    }
+    sender.reset();
+    run(noise);
+    assert(sender.get_stats().messages_compressed == 0);
+    assert(sender.get_stats().compression_bypassed == 1);
+    
+    std::cout << "  ✓ Capability learned from peer ACK\n";
+    std::cout << "  ✓ Compressed message reassembled and decoded\n";
+    std::cout << "  ✓ Incompressible message sent raw\n";
+    std::cout << "  PASSED\n\n";
+}
+
+// Test repair blocks rebuilding lost frames without retransmission
+void test_repair_blocks() {
+    std::cout << "Test: Repair Blocks...\n";
+    
+    std::vector<std::vector<uint8_t>> to_receiver;
+    std::vector<std::vector<uint8_t>> to_sender;
+    
+    VariableARQ sender;
+    VariableARQ receiver;
+    sender.init([&](const uint8_t* f, int l) { to_receiver.emplace_back(f, f + l); });
+    receiver.init([&](const uint8_t* f, int l) { to_sender.emplace_back(f, f + l); });
+    sender.set_ack_timeout(60000);
+    sender.set_repair_blocks(2, 4);
+    receiver.process_event(ARQEvent::START_RX);
+    
+    std::vector<uint8_t> data(8 * 1014 + 100);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<uint8_t>(i * 13 + (i >> 8));
+    }
+    sender.start_transmission(data.data(), data.size());
+    
+    // 9 blocks in series of 4/4/1, each followed by 2 repair blocks
+    assert(to_receiver.size() == 9 + 3 * 2);
+    assert(sender.get_stats().repair_blocks_sent == 6);
+    
+    // Lose two data blocks of the first series, one of the second and
+    // a repair block of the last
+    std::vector<size_t> lost = {0, 2, 7, 14};
+    uint32_t time_ms = 0;
+    for (int i = 0; i < 100 && !sender.is_transfer_complete(); i++) {
+        auto frames = std::move(to_receiver);
+        to_receiver.clear();
+        for (size_t f = 0; f < frames.size(); f++) {
+            if (i == 0 && std::find(lost.begin(), lost.end(), f) != lost.end()) {
+                continue;
+            }
+            receiver.handle_received_frame(frames[f].data(), frames[f].size());
+        }
+        
+        auto acks = std::move(to_sender);
+        to_sender.clear();
+        for (const auto& f : acks) {
+            sender.handle_received_frame(f.data(), f.size());
+        }
+        
+        time_ms += 500;
+        sender.update(time_ms);
+        receiver.update(time_ms);
+    }
+    
+    assert(sender.is_transfer_complete());
+    assert(receiver.get_received_data() == data);
+    assert(receiver.get_stats().blocks_recovered == 3);
+    assert(sender.get_stats().blocks_retransmitted == 0);
+    assert(sender.get_stats().timeouts == 0);
+    
+    std::cout << "  ✓ Lost blocks rebuilt from repair blocks\n";
+    std::cout << "  ✓ No retransmission round needed\n";
+    std::cout << "  PASSED\n\n";
+}
+
+// Test repair blocks counted against the series airtime limit
+void test_repair_airtime_limit() {
+    std::cout << "Test: Repair Blocks Within Airtime Limit...\n";
+    
+    TestHarness harness;
+    VariableARQ arq;
+    arq.set_data_rate(DataRate::BPS_2400);
+    arq.init([&](const uint8_t* f, int l) { harness.tx_callback(f, l); });
+    arq.set_repair_blocks(2, 2);
+    
+    // Room for three full frames: two data blocks fit, but not with the
+    // two repair blocks that close their series
+    uint32_t limit_ms = 1000;
+    while (arq.get_airtime_model().max_frames(limit_ms, MAX_DATA_BLOCK_LENGTH) < 3) {
+        limit_ms += 100;
+    }
+    arq.set_max_series_ms(limit_ms);
+    
+    std::vector<uint8_t> data(8 * 1000, 0x5A);
+    arq.update(0);
+    arq.start_transmission(data.data(), data.size());
+    
+    uint32_t bytes = 0;
+    for (const auto& frame : harness.sent_frames) {
+        bytes += static_cast<uint32_t>(frame.size());
+    }
+    [[maybe_unused]] uint32_t airtime_ms = arq.get_airtime_model().transmission_ms(bytes);
+    assert(airtime_ms <= limit_ms);
+    assert(harness.sent_frames.size() == 1);
+    assert(arq.get_stats().repair_blocks_sent == 0);
+    assert(arq.expected_goodput_bps() > 0);
+    
+    std::cout << "  ✓ " << harness.sent_frames.size() << " frame(s) in "
+              << airtime_ms << " of " << limit_ms << " ms\n";
+    std::cout << "  PASSED\n\n";
+}
+
+// Test series sent as one burst, contiguous and scatter-gather
+void test_burst_transfer() {
+    std::cout << "Test: Burst Transfer...\n";
+    
+    for (int gather = 0; gather < 2; gather++) {
+        std::vector<std::vector<uint8_t>> to_receiver;
+        std::vector<std::vector<uint8_t>> to_sender;
+        
+        VariableARQ sender;
+        VariableARQ receiver;
+        sender.init([&](const uint8_t* f, int l) { to_receiver.emplace_back(f, f + l); });
+        receiver.init([&](const uint8_t* f, int l) { to_sender.emplace_back(f, f + l); });
+        sender.enable_burst_transmission(true);
+        if (gather) {
+            sender.set_gather_callback([&](const FrameSegment* segments, int count) {
+                std::vector<uint8_t> burst;
+                for (int k = 0; k < count; k++) {
+                    burst.insert(burst.end(), segments[k].data, segments[k].data + segments[k].length);
+                }
+                to_receiver.push_back(burst);
+            });
+        }
+        receiver.process_event(ARQEvent::START_RX);
+        
+        std::vector<uint8_t> data(3000);
+        for (size_t i = 0; i < data.size(); i++) {
+            data[i] = static_cast<uint8_t>(i * 13);
+        }
+        sender.start_transmission(data.data(), data.size());
+        
+        // Whole series in one transmission, led by its herald
+        assert(to_receiver.size() == 1);
+        ControlFrame herald;
+        size_t herald_length = FrameParser::frame_length(to_receiver[0].data(), to_receiver[0].size());
+        assert(herald_length > 0 && herald_length < to_receiver[0].size());
+        bool parsed = FrameParser::parse_control_frame(to_receiver[0].data(), herald_length, herald);
+        assert(parsed);
+        assert(herald.herald_present);
+        assert(herald.frames_in_next_series == 3);
+        assert(herald.bytes_in_data_frames == MAX_DATA_BLOCK_LENGTH);
+        
+        uint32_t time_ms = 0;
+        for (int i = 0; i < 100 && !sender.is_transfer_complete(); i++) {
+            auto frames = std::move(to_receiver);
+            to_receiver.clear();
+            for (const auto& f : frames) {
+                receiver.handle_received_frame(f.data(), f.size());
+            }
+            
+            auto acks = std::move(to_sender);
+            to_sender.clear();
+            for (const auto& f : acks) {
+                sender.handle_received_frame(f.data(), f.size());
+            }
+            
+            time_ms += 500;
+            sender.update(time_ms);
+            receiver.update(time_ms);
+        }
+        
+        assert(sender.is_transfer_complete());
+        assert(receiver.get_received_data() == data);
+        assert(sender.get_stats().bursts_sent == 1);
+        assert(receiver.get_stats().heralds_received == 1);
+        assert(receiver.get_stats().blocks_received == 3);
+        assert(receiver.get_stats().acks_sent == 1);
+    }
+    
+    std::cout << "  ✓ Herald and all blocks in one transmission\n";
+    std::cout << "  ✓ Scatter-gather output matches\n";
+    std::cout << "  ✓ One ACK per burst\n";
+    std::cout << "  PASSED\n\n";
+}
+
 // Test utility functions
 void test_utility_functions() {
     std::cout << "Test: Utility Functions...\n";
@@ -372,6 +885,15 @@ int main() {
         test_data_reception();
         test_sequence_wrapping();
         test_statistics();
+        test_rtt_estimator();
+        test_adaptive_timeout();
+        test_selective_retransmission();
+        test_series_airtime_limit();
+        test_loopback_transfer();
+        test_compressed_transfer();
+        test_repair_blocks();
+    test_repair_airtime_limit();
+        test_burst_transfer();
         test_utility_functions();
         
         std::cout << "========================================\n";
@@ -0,0 +1,197 @@
+/**
+ * \file test_fs1052_burst.cpp
+ * \brief Unit tests for FS-1052 series builder
+ */
+
+#include "fs1052_burst.h"
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+using namespace fs1052;
+
+static DataFrame make_frame(uint8_t sequence, uint16_t length) {
+    DataFrame frame;
+    frame.data_rate = static_cast<uint8_t>(DataRate::BPS_2400);
+    frame.sequence_number = sequence;
+    frame.msg_byte_offset = sequence * length;
+    frame.data_length = length;
+    for (uint16_t i = 0; i < length; i++) {
+        frame.data[i] = static_cast<uint8_t>(sequence * 31 + i);
+    }
+    return frame;
+}
+
+static ControlFrame make_herald(int frames) {
+    ControlFrame frame;
+    frame.frame_type = FrameType::T3_CONTROL;
+    frame.herald_present = true;
+    frame.frames_in_next_series = static_cast<uint8_t>(frames);
+    return frame;
+}
+
+static std::vector<uint8_t> flatten(const std::vector<FrameSegment>& segments) {
+    std::vector<uint8_t> bytes;
+    for (const auto& segment : segments) {
+        bytes.insert(bytes.end(), segment.data, segment.data + segment.length);
+    }
+    return bytes;
+}
+
+// Reference burst: frames formatted one at a time and concatenated
+static std::vector<uint8_t> reference_burst(const std::vector<DataFrame>& frames, int herald) {
+    std::vector<uint8_t> bytes;
+    uint8_t buffer[1200];
+    if (herald > 0) {
+        int length = FrameFormatter::format_control_frame(make_herald(herald), buffer, sizeof(buffer));
+        bytes.insert(bytes.end(), buffer, buffer + length);
+    }
+    for (const auto& frame : frames) {
+        int length = FrameFormatter::format_data_frame(frame, buffer, sizeof(buffer));
+        bytes.insert(bytes.end(), buffer, buffer + length);
+    }
+    return bytes;
+}
+
+// Test contiguous burst matches frames formatted one by one
+void test_contiguous_burst() {
+    std::cout << "Test: Contiguous Burst...\n";
+    
+    std::vector<DataFrame> frames;
+    for (uint8_t i = 0; i < 5; i++) {
+        frames.push_back(make_frame(i, i == 4 ? 100 : MAX_DATA_BLOCK_LENGTH));
+    }
+    
+    // Small initial capacity forces the buffer to grow
+    BurstBuilder burst(64);
+    for (const auto& frame : frames) {
+        bool added = burst.add_data_frame(frame, frame.data);
+        assert(added);
+    }
+    bool prepended = burst.prepend_control_frame(make_herald(5));
+    assert(prepended);
+    assert(!burst.prepend_control_frame(make_herald(5)));
+    
+    std::vector<uint8_t> expected = reference_burst(frames, 5);
+    assert(burst.frame_count() == 6);
+    assert(burst.size() == expected.size());
+    assert(memcmp(burst.data(), expected.data(), expected.size()) == 0);
+    assert(burst.segments().size() == 1);
+    
+    // Reuse after clear
+    burst.clear();
+    assert(burst.empty());
+    burst.add_data_frame(frames[0]);
+    expected = reference_burst({frames[0]}, 0);
+    assert(burst.size() == expected.size());
+    assert(memcmp(burst.data(), expected.data(), expected.size()) == 0);
+    
+    std::cout << "  ✓ " << frames.size() << " frames and herald in one buffer\n";
+    std::cout << "  ✓ Bytes identical to per-frame formatting\n";
+    std::cout << "  PASSED\n\n";
+}
+
+// Test scatter-gather segments reference payloads and flatten correctly
+void test_gather_burst() {
+    std::cout << "Test: Scatter-Gather Burst...\n";
+    
+    std::vector<DataFrame> frames;
+    for (uint8_t i = 0; i < 3; i++) {
+        frames.push_back(make_frame(i, 500));
+    }
+    
+    BurstBuilder burst(0, true);
+    for (const auto& frame : frames) {
+        burst.add_data_frame(frame, frame.data);
+    }
+    burst.prepend_control_frame(make_herald(3));
+    
+    // Herald + header, then per frame: payload, CRC + next header
+    const std::vector<FrameSegment>& segments = burst.segments();
+    assert(segments.size() == 2 * frames.size() + 1);
+    assert(segments[1].data == frames[0].data);
+    assert(segments[1].length == 500);
+    
+    std::vector<uint8_t> expected = reference_burst(frames, 3);
+    assert(flatten(segments) == expected);
+    assert(burst.size() == expected.size());
+    
+    // Copied frames are merged into the buffer pieces
+    burst.clear();
+    burst.add_data_frame(frames[0]);
+    burst.add_data_frame(frames[1]);
+    assert(burst.segments().size() == 1);
+    assert(flatten(burst.segments()) == reference_burst({frames[0], frames[1]}, 0));
+    
+    std::cout << "  ✓ Payloads referenced, not copied\n";
+    std::cout << "  ✓ Segments flatten to the contiguous burst\n";
+    std::cout << "  PASSED\n\n";
+}
+
+// Test splitting a burst back into frames
+void test_frame_length() {
+    std::cout << "Test: Frame Length...\n";
+    
+    std::vector<DataFrame> frames = {make_frame(0, 300), make_frame(1, 7)};
+    BurstBuilder burst;
+    ControlFrame ack;
+    ack.frame_type = FrameType::T2_CONTROL;
+    ack.ack_nak_type = AckNakType::DATA_ACK;
+    burst.add_control_frame(ack);
+    for (const auto& frame : frames) {
+        burst.add_data_frame(frame);
+    }
+    
+    const uint8_t* p = burst.data();
+    size_t remaining = burst.size();
+    
+    size_t length = FrameParser::frame_length(p, remaining);
+    assert(length == FrameFormatter::control_frame_length(ack));
+    ControlFrame cf;
+    bool parsed = FrameParser::parse_control_frame(p, length, cf);
+    assert(parsed);
+    p += length;
+    remaining -= length;
+    
+    for (const auto& frame : frames) {
+        length = FrameParser::frame_length(p, remaining);
+        assert(length == FrameFormatter::data_frame_length(frame.data_length));
+        DataFrame df;
+        parsed = FrameParser::parse_data_frame(p, length, df);
+        assert(parsed);
+        assert(df.sequence_number == frame.sequence_number);
+        assert(memcmp(df.data, frame.data, frame.data_length) == 0);
+        p += length;
+        remaining -= length;
+    }
+    assert(remaining == 0);
+    
+    // Truncated frame
+    assert(FrameParser::frame_length(burst.data(), 5) == 0);
+    
+    std::cout << "  ✓ Control and data frames delimited\n";
+    std::cout << "  ✓ Truncated frame rejected\n";
+    std::cout << "  PASSED\n\n";
+}
+
+int main() {
+    std::cout << "========================================\n";
+    std::cout << "FS-1052 Burst Builder Tests\n";
+    std::cout << "========================================\n\n";
+    
+    try {
+        test_contiguous_burst();
+        test_gather_burst();
+        test_frame_length();
+        
+        std::cout << "========================================\n";
+        std::cout << "All FS-1052 Burst tests PASSED! ✓\n";
+        std::cout << "========================================\n";
+        
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Test FAILED with exception: " << e.what() << "\n";
+        return 1;
+    }
+}
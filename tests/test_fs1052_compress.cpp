@@ -0,0 +1,220 @@
+/**
+ * \file test_fs1052_compress.cpp
+ * \brief Unit tests for FS-1052 payload compression
+ */
+
+#include "fs1052_compress.h"
+#include "fs1052_protocol.h"
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace fs1052;
+
+static std::vector<uint8_t> bytes_of(const std::string& text) {
+    return std::vector<uint8_t>(text.begin(), text.end());
+}
+
+// Test compress/decompress round trip
+void test_roundtrip() {
+    std::cout << "Test: Compression Round Trip...\n";
+    bool ok;
+    
+    std::string log;
+    for (int i = 0; i < 40; i++) {
+        log += "2026-03-14T12:00:" + std::to_string(10 + i) +
+               "Z INFO: station K" + std::to_string(i % 4) +
+               " link quality SNR " + std::to_string(i % 17) + " dB\n";
+    }
+    std::vector<uint8_t> data = bytes_of(log);
+    
+    std::vector<uint8_t> packed;
+    ok = PayloadCompressor::compress(data.data(), data.size(), packed);
+    assert(ok);
+    assert(packed.size() < data.size() / 2);
+    assert(PayloadCompressor::stream_length(packed.data(), packed.size()) == packed.size());
+    
+    std::vector<uint8_t> unpacked;
+    ok = PayloadCompressor::decompress(packed.data(), packed.size(), unpacked);
+    assert(ok);
+    assert(unpacked == data);
+    size_t log_packed = packed.size();
+    
+    // Long runs exercise overlapping matches and extended lengths
+    std::vector<uint8_t> runs(5000, 'A');
+    runs.insert(runs.end(), 300, 'B');
+    ok = PayloadCompressor::compress(runs.data(), runs.size(), packed);
+    assert(ok);
+    assert(packed.size() < 64);
+    ok = PayloadCompressor::decompress(packed.data(), packed.size(), unpacked);
+    assert(ok);
+    assert(unpacked == runs);
+    
+    std::cout << "  ✓ Log text " << data.size() << " -> " << log_packed << " bytes\n";
+    std::cout << "  ✓ Decompressed output matches input\n";
+    std::cout << "  PASSED\n\n";
+}
+
+// Test static dictionary on short messages
+void test_dictionary_gain() {
+    std::cout << "Test: Static Dictionary...\n";
+    bool ok;
+    
+    // Too short to compress against itself; gain comes from the dictionary
+    std::vector<uint8_t> data = bytes_of("ERROR: connection refused by station, please retransmit the message");
+    
+    std::vector<uint8_t> packed;
+    assert(PayloadCompressor::should_compress(data.data(), data.size()));
+    ok = PayloadCompressor::compress(data.data(), data.size(), packed);
+    assert(ok);
+    assert(packed.size() < data.size() * 3 / 4);
+    
+    std::vector<uint8_t> unpacked;
+    ok = PayloadCompressor::decompress(packed.data(), packed.size(), unpacked);
+    assert(ok);
+    assert(unpacked == data);
+    
+    std::cout << "  ✓ " << data.size() << " byte message -> " << packed.size() << " bytes\n";
+    std::cout << "  PASSED\n\n";
+}
+
+// Test entropy-based bypass
+void test_entropy_bypass() {
+    std::cout << "Test: Entropy Bypass...\n";
+    bool ok;
+    
+    std::mt19937 rng(1052);
+    std::vector<uint8_t> random(4096);
+    for (auto& b : random) {
+        b = static_cast<uint8_t>(rng());
+    }
+    
+    float entropy = PayloadCompressor::estimate_entropy(random.data(), random.size());
+    assert(entropy > COMPRESS_MAX_ENTROPY);
+    assert(!PayloadCompressor::should_compress(random.data(), random.size()));
+    
+    // Even if attempted, incompressible data is never expanded
+    std::vector<uint8_t> packed;
+    ok = PayloadCompressor::compress(random.data(), random.size(), packed);
+    assert(!ok);
+    assert(packed.empty());
+    
+    std::vector<uint8_t> text = bytes_of("the quick brown fox jumps over the lazy dog, again and again");
+    assert(PayloadCompressor::estimate_entropy(text.data(), text.size()) < 5.0f);
+    
+    // Short messages are not worth the header
+    assert(!PayloadCompressor::should_compress(text.data(), 8));
+    
+    std::cout << "  ✓ Random data entropy " << entropy << " bits/byte, skipped\n";
+    std::cout << "  ✓ Incompressible output rejected\n";
+    std::cout << "  PASSED\n\n";
+}
+
+// Test rejection of malformed streams
+void test_malformed_streams() {
+    std::cout << "Test: Malformed Streams...\n";
+    bool ok;
+    
+    std::vector<uint8_t> data = bytes_of("WARNING: frequency 7.102 MHz channel busy, WARNING: frequency 7.102 MHz channel busy");
+    std::vector<uint8_t> packed;
+    ok = PayloadCompressor::compress(data.data(), data.size(), packed);
+    assert(ok);
+    
+    std::vector<uint8_t> out;
+    
+    // Truncated
+    ok = PayloadCompressor::decompress(packed.data(), packed.size() - 1, out);
+    assert(!ok);
+    
+    // Wrong method
+    std::vector<uint8_t> bad = packed;
+    bad[0] = 0x7F;
+    ok = PayloadCompressor::decompress(bad.data(), bad.size(), out);
+    assert(!ok);
+    assert(PayloadCompressor::stream_length(bad.data(), bad.size()) == 0);
+    
+    // Every single-byte corruption either fails or stays in bounds
+    for (size_t i = 1; i < packed.size(); i++) {
+        bad = packed;
+        bad[i] ^= 0xFF;
+        if (PayloadCompressor::decompress(bad.data(), bad.size(), out)) {
+            assert(out.size() == data.size());
+        }
+    }
+    
+    // Declared length far beyond what the payload can produce (~34 GB)
+    const uint8_t huge[] = {COMPRESS_METHOD_LZ_DICT, 0x80, 0x80, 0x80, 0x80, 0x40, 1, 0x00};
+    ok = PayloadCompressor::decompress(huge, sizeof(huge), out);
+    assert(!ok);
+    assert(out.empty());
+    
+    std::cout << "  ✓ Truncated and mislabelled streams rejected\n";
+    std::cout << "  ✓ Oversized declared length rejected\n";
+    std::cout << "  ✓ Corrupted streams decode safely\n";
+    std::cout << "  PASSED\n\n";
+}
+
+// Test negotiation fields in control/data frames
+void test_frame_flags() {
+    std::cout << "Test: Frame Compression Flags...\n";
+    bool ok;
+    
+    ControlFrame ack;
+    ack.frame_type = FrameType::T2_CONTROL;
+    ack.ack_nak_type = AckNakType::DATA_ACK;
+    ack.bit_map[0] = 0x05;
+    ack.extension_function_present = true;
+    ack.function_bits[0] = EXT_FUNC_COMPRESSION;
+    
+    uint8_t buffer[256];
+    int length = FrameFormatter::format_control_frame(ack, buffer, sizeof(buffer));
+    assert(length > 0);
+    
+    ControlFrame parsed;
+    ok = FrameParser::parse_control_frame(buffer, length, parsed);
+    assert(ok);
+    assert(parsed.bit_map[0] == 0x05);
+    assert(parsed.extension_function_present);
+    assert(parsed.function_bits[0] == EXT_FUNC_COMPRESSION);
+    
+    DataFrame df;
+    df.compressed = true;
+    df.data_length = 4;
+    uint8_t data_buffer[64];
+    length = FrameFormatter::format_data_frame(df, data_buffer, sizeof(data_buffer));
+    
+    DataFrame parsed_df;
+    ok = FrameParser::parse_data_frame(data_buffer, length, parsed_df);
+    assert(ok);
+    assert(parsed_df.compressed);
+    
+    std::cout << "  ✓ Capability bit carried in ACK extension field\n";
+    std::cout << "  ✓ Compressed flag carried in data frame header\n";
+    std::cout << "  PASSED\n\n";
+}
+
+int main() {
+    std::cout << "========================================\n";
+    std::cout << "FS-1052 Payload Compression Tests\n";
+    std::cout << "========================================\n\n";
+    
+    try {
+        test_roundtrip();
+        test_dictionary_gain();
+        test_entropy_bypass();
+        test_malformed_streams();
+        test_frame_flags();
+        
+        std::cout << "========================================\n";
+        std::cout << "All FS-1052 Compression tests PASSED! ✓\n";
+        std::cout << "========================================\n";
+        
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Test FAILED with exception: " << e.what() << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,366 @@
+/**
+ * \file test_fs1052_sis.cpp
+ * \brief Unit tests for FS-1052 subnetwork interface server
+ */
+
+#include "fs1052_sis.h"
+#include <cassert>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+using namespace fs1052;
+
+// Two servers joined by an in-memory link; frames are queued and handed
+// over between update() rounds
+struct Link {
+    SISServer a;
+    SISServer b;
+    std::deque<std::vector<uint8_t>> to_a;
+    std::deque<std::vector<uint8_t>> to_b;
+    uint32_t now_ms;
+    std::string path_a;
+    std::string path_b;
+    
+    Link(const SISConfig& config = SISConfig()) : now_ms(0) {
+        path_a = "/tmp/fs1052_sis_a_" + std::to_string(getpid());
+        path_b = "/tmp/fs1052_sis_b_" + std::to_string(getpid());
+        a.set_config(config);
+        b.set_config(config);
+        bool opened = a.open(path_a, [this](const uint8_t* frame, int length) {
+            to_b.emplace_back(frame, frame + length);
+        });
+        assert(opened);
+        opened = b.open(path_b, [this](const uint8_t* frame, int length) {
+            to_a.emplace_back(frame, frame + length);
+        });
+        assert(opened);
+    }
+    
+    void step() {
+        now_ms += 50;
+        a.update(now_ms);
+        b.update(now_ms);
+        while (!to_b.empty() || !to_a.empty()) {
+            if (!to_b.empty()) {
+                std::vector<uint8_t> frame = std::move(to_b.front());
+                to_b.pop_front();
+                b.handle_received_frame(frame.data(), static_cast<int>(frame.size()));
+            }
+            if (!to_a.empty()) {
+                std::vector<uint8_t> frame = std::move(to_a.front());
+                to_a.pop_front();
+                a.handle_received_frame(frame.data(), static_cast<int>(frame.size()));
+            }
+        }
+    }
+    
+    // Step until the client has a primitive (or give up)
+    bool receive(SISClient& client, SISMessage& message, int max_steps = 400) {
+        for (int i = 0; i < max_steps; i++) {
+            if (client.receive(message, 0)) {
+                return true;
+            }
+            step();
+        }
+        return false;
+    }
+};
+
+static std::vector<uint8_t> make_payload(size_t length, uint8_t seed) {
+    std::vector<uint8_t> data(length);
+    for (size_t i = 0; i < length; i++) {
+        data[i] = static_cast<uint8_t>(seed + i * 7);
+    }
+    return data;
+}
+
+static void bind_client(Link& link, const std::string& path, SISClient& client, uint8_t sap) {
+    bool connected = client.connect(path);
+    assert(connected);
+    bool sent = client.bind(sap, 15);
+    assert(sent);
+    SISMessage message;
+    bool received = link.receive(client, message);
+    assert(received);
+    assert(message.type == SISPrimitive::BIND_ACCEPTED);
+    assert(message.sap == sap);
+}
+
+// Test primitive header coding
+void test_header() {
+    std::cout << "Test: Primitive Header...\n";
+    
+    uint8_t buffer[SIS_HEADER_LENGTH + 10];
+    size_t length = sis_format_header(SISPrimitive::DATA_REJECTED, 10, buffer);
+    assert(length == SIS_HEADER_LENGTH);
+    assert(buffer[0] == ((SIS_VERSION << 4) | 0x0A));
+    
+    SISPrimitive type;
+    uint16_t payload_length = 0;
+    bool parsed = sis_parse_header(buffer, sizeof(buffer), type, payload_length);
+    assert(parsed);
+    assert(type == SISPrimitive::DATA_REJECTED);
+    assert(payload_length == 10);
+    
+    // Length must match the packet; version must match
+    parsed = sis_parse_header(buffer, sizeof(buffer) - 1, type, payload_length);
+    assert(!parsed);
+    buffer[0] = 0x2A;
+    parsed = sis_parse_header(buffer, sizeof(buffer), type, payload_length);
+    assert(!parsed);
+    
+    std::cout << "  ✓ Header round trip\n";
+    std::cout << "  ✓ Bad length and version rejected\n";
+    std::cout << "  PASSED\n\n";
+}
+
+// Test SAP binding rules
+void test_bind() {
+    std::cout << "Test: SAP Binding...\n";
+    
+    Link link;
+    SISClient first;
+    bind_client(link, link.path_a, first, 3);
+    assert(link.a.client_count() == 1);
+    
+    SISMessage message;
+    SISClient second;
+    bool connected = second.connect(link.path_a);
+    assert(connected);
+    
+    second.bind(3, 0);
+    bool received = link.receive(second, message);
+    assert(received);
+    assert(message.type == SISPrimitive::BIND_REJECTED);
+    assert(message.reason == SISReason::SAP_IN_USE);
+    
+    second.bind(SIS_MAX_SAP + 1, 0);
+    received = link.receive(second, message);
+    assert(received);
+    assert(message.reason == SISReason::INVALID_SAP);
+    
+    // Unbinding frees the SAP for another client
+    first.unbind();
+    received = link.receive(first, message);
+    assert(received);
+    assert(message.type == SISPrimitive::UNBIND_INDICATION);
+    second.bind(3, 0);
+    received = link.receive(second, message);
+    assert(received);
+    assert(message.type == SISPrimitive::BIND_ACCEPTED);
+    assert(message.mtu == SIS_DEFAULT_MTU);
+    
+    second.bind(4, 0);
+    received = link.receive(second, message);
+    assert(received);
+    assert(message.reason == SISReason::ALREADY_BOUND);
+    assert(link.a.get_stats().binds_rejected == 3);
+    
+    std::cout << "  ✓ SAP in use, invalid SAP and double bind rejected\n";
+    std::cout << "  ✓ Unbound SAP can be taken again\n";
+    std::cout << "  PASSED\n\n";
+}
+
+// Test data delivery across the link in both directions
+void test_data_transfer() {
+    std::cout << "Test: Data Transfer...\n";
+    
+    Link link;
+    SISClient sender;
+    SISClient other;
+    SISClient receiver;
+    bind_client(link, link.path_a, sender, 1);
+    bind_client(link, link.path_a, other, 2);
+    bind_client(link, link.path_b, receiver, 5);
+    
+    std::vector<uint8_t> first = make_payload(3000, 1);
+    std::vector<uint8_t> second = make_payload(40, 2);
+    bool sent = sender.send_data(5, 4, 100, first.data(), static_cast<uint16_t>(first.size()));
+    assert(sent);
+    sent = other.send_data(5, 9, 200, second.data(), static_cast<uint16_t>(second.size()));
+    assert(sent);
+    
+    // Both requests travel in one ARQ message, most urgent first
+    SISMessage message;
+    bool received = link.receive(receiver, message);
+    assert(received);
+    assert(message.type == SISPrimitive::DATA);
+    assert(message.sap == 2);
+    assert(message.priority == 9);
+    assert(message.data == second);
+    received = link.receive(receiver, message);
+    assert(received);
+    assert(message.sap == 1);
+    assert(message.data == first);
+    assert(link.a.get_stats().batches_sent == 1);
+    assert(link.b.get_stats().batches_received == 1);
+    
+    received = link.receive(sender, message);
+    assert(received);
+    assert(message.type == SISPrimitive::DATA_CONFIRM);
+    assert(message.ref == 100);
+    received = link.receive(other, message);
+    assert(received);
+    assert(message.ref == 200);
+    
+    // Reverse direction, then a second message the same way
+    std::vector<uint8_t> reply = make_payload(500, 3);
+    receiver.send_data(1, 0, 7, reply.data(), static_cast<uint16_t>(reply.size()));
+    received = link.receive(sender, message);
+    assert(received);
+    assert(message.type == SISPrimitive::DATA);
+    assert(message.sap == 5);
+    assert(message.data == reply);
+    
+    sender.send_data(5, 0, 101, second.data(), static_cast<uint16_t>(second.size()));
+    received = link.receive(receiver, message);
+    assert(received);
+    assert(message.type == SISPrimitive::DATA || message.type == SISPrimitive::DATA_CONFIRM);
+    if (message.type == SISPrimitive::DATA_CONFIRM) {
+        received = link.receive(receiver, message);
+        assert(received);
+    }
+    assert(message.type == SISPrimitive::DATA);
+    assert(message.data == second);
+    assert(link.b.get_stats().batches_received == 2);
+    
+    std::cout << "  ✓ Two clients multiplexed into one ARQ message\n";
+    std::cout << "  ✓ Confirms after acknowledgment\n";
+    std::cout << "  ✓ Both directions, consecutive messages\n";
+    std::cout << "  PASSED\n\n";
+}
+
+// Test per-client flow control window
+void test_flow_control() {
+    std::cout << "Test: Flow Control...\n";
+    
+    SISConfig config;
+    config.client_window = 2;
+    config.max_batch_bytes = 100;
+    Link link(config);
+    SISClient sender;
+    SISClient receiver;
+    bind_client(link, link.path_a, sender, 1);
+    bind_client(link, link.path_b, receiver, 2);
+    
+    // Hold the link so nothing completes while requests pile up
+    std::vector<uint8_t> data = make_payload(80, 4);
+    for (uint16_t ref = 0; ref < 6; ref++) {
+        bool sent = sender.send_data(2, 0, ref, data.data(), static_cast<uint16_t>(data.size()));
+        assert(sent);
+    }
+    link.a.update(link.now_ms);
+    assert(link.a.queued_requests() + (link.a.is_sending() ? 1 : 0) <= 2);
+    assert(link.a.get_stats().requests_received == 2);
+    link.to_b.clear();
+    
+    // Releasing the link lets every request through in turn
+    int confirmed = 0;
+    int delivered = 0;
+    SISMessage message;
+    for (int i = 0; i < 2000 && (confirmed < 6 || delivered < 6); i++) {
+        link.step();
+        while (sender.receive(message, 0)) {
+            assert(message.type == SISPrimitive::DATA_CONFIRM);
+            confirmed++;
+        }
+        while (receiver.receive(message, 0)) {
+            assert(message.data == data);
+            delivered++;
+        }
+    }
+    assert(confirmed == 6);
+    assert(delivered == 6);
+    assert(link.a.get_stats().requests_received == 6);
+    
+    std::cout << "  ✓ No more than the window read from a client\n";
+    std::cout << "  ✓ All requests confirmed as the window opens\n";
+    std::cout << "  PASSED\n\n";
+}
+
+// Test rejections and undeliverable data
+void test_rejections() {
+    std::cout << "Test: Rejections...\n";
+    
+    SISConfig config;
+    config.mtu = 256;
+    config.max_clients = 2;
+    Link link(config);
+    SISMessage message;
+    
+    SISClient unbound;
+    bool connected = unbound.connect(link.path_a);
+    assert(connected);
+    uint8_t byte = 0;
+    unbound.send_data(1, 0, 9, &byte, 1);
+    bool received = link.receive(unbound, message);
+    assert(received);
+    assert(message.type == SISPrimitive::DATA_REJECTED);
+    assert(message.ref == 9);
+    assert(message.reason == SISReason::NOT_BOUND);
+    
+    SISClient sender;
+    bind_client(link, link.path_a, sender, 1);
+    std::vector<uint8_t> large = make_payload(300, 5);
+    sender.send_data(1, 0, 10, large.data(), static_cast<uint16_t>(large.size()));
+    received = link.receive(sender, message);
+    assert(received);
+    assert(message.reason == SISReason::TOO_LARGE);
+    assert(message.ref == 10);
+    
+    // Server full
+    SISClient extra;
+    connected = extra.connect(link.path_a);
+    assert(connected);
+    received = link.receive(extra, message);
+    assert(received);
+    assert(message.type == SISPrimitive::UNBIND_INDICATION);
+    assert(message.reason == SISReason::TOO_MANY_CLIENTS);
+    assert(link.a.client_count() == 2);
+    
+    // Nobody bound at the destination: confirmed, but dropped there
+    sender.send_data(7, 0, 11, large.data(), 100);
+    received = link.receive(sender, message);
+    assert(received);
+    assert(message.type == SISPrimitive::DATA_CONFIRM);
+    assert(link.b.get_stats().indications_dropped == 1);
+    
+    // Disconnect frees the client slot and its SAP
+    sender.close();
+    for (int i = 0; i < 5; i++) {
+        link.step();
+    }
+    assert(link.a.client_count() == 1);
+    
+    std::cout << "  ✓ Unbound, oversized and excess clients rejected\n";
+    std::cout << "  ✓ Data for an unbound SAP dropped at the peer\n";
+    std::cout << "  PASSED\n\n";
+}
+
+int main() {
+    std::cout << "========================================\n";
+    std::cout << "FS-1052 Subnetwork Interface Tests\n";
+    std::cout << "========================================\n\n";
+    
+    try {
+        test_header();
+        test_bind();
+        test_data_transfer();
+        test_flow_control();
+        test_rejections();
+        
+        std::cout << "========================================\n";
+        std::cout << "All FS-1052 SIS tests PASSED! ✓\n";
+        std::cout << "========================================\n";
+        
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Test FAILED with exception: " << e.what() << "\n";
+        return 1;
+    }
+}
@@ -15,6 +15,7 @@
 #include "fft_demodulator.h"
 #include "symbol_decoder.h"
 #include "golay.h"
+#include "sample_clock.h"
 
 #include <iostream>
 #include <cmath>
@@ -118,6 +119,10 @@ bool test_majority_voting() {
         { {0, 0, 1}, 0, "2-of-3 zeros" },
         { {1, 1, 0}, 1, "2-of-3 ones" },
         { {0, 1, 1}, 1, "2-of-3 ones (different order)" },
+        { {0xFF, 0, 0}, 0, "Failed copy, 2 zeros" },
+        { {1, 0xFF, 1}, 1, "Failed copy, 2 ones" },
+        { {0xFF, 0xFF, 1}, 1, "Single valid copy" },
+        { {1, 0, 0xFF}, 0, "Failed copy, tie" },
     };
     
     bool all_pass = true;
@@ -272,6 +277,381 @@ bool test_end_to_end_modem() {
     return true;
 }
 
+// ============================================================================
+// Test 6: Golay Errors-and-Erasures Decoding
+// ============================================================================
+
+static uint32_t test_random(uint32_t& state) {
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+}
+
+// Mask of count distinct random bits of 24, avoiding exclude
+static uint32_t random_positions(uint32_t& state, uint32_t count, uint32_t exclude) {
+    uint32_t mask = 0;
+    while (count > 0) {
+        uint32_t bit = 1U << (test_random(state) % 24);
+        if (!((mask | exclude) & bit)) {
+            mask |= bit;
+            count--;
+        }
+    }
+    return mask;
+}
+
+bool test_golay_erasures() {
+    std::cout << "\n[TEST 6] Golay Errors-and-Erasures\n";
+    std::cout << "===================================\n";
+    
+    uint32_t state = 12345;
+    
+    // Every mix of e errors and s erasures with 2e + s <= 7
+    for (uint32_t erased = 0; erased <= Golay::MAX_ERASURES; ++erased) {
+        for (uint32_t errors = 0; 2 * errors + erased <= 7; ++errors) {
+            for (int trial = 0; trial < 200; ++trial) {
+                uint16_t original = test_random(state) & 0xFFF;
+                uint32_t codeword = Golay::encode(original);
+                uint32_t erasures = random_positions(state, erased, 0);
+                uint32_t flips = random_positions(state, errors, erasures);
+    
+                // Erased bits hold garbage
+                uint32_t received = (codeword ^ flips) ^ (test_random(state) & erasures);
+    
+                uint16_t decoded = 0;
+                uint8_t result = Golay::decode_with_erasures(received, erasures, decoded);
+                if (decoded != original || result != errors + erased) {
+                    std::cout << "  FAIL: " << errors << " errors, " << erased
+                              << " erasures (result " << (int)result << ")\n";
+                    return false;
+                }
+            }
+        }
+        std::cout << "  " << erased << " erasures with up to " << (7 - erased) / 2
+                  << " errors: PASS\n";
+    }
+    
+    // Four wrong bits at known positions: beyond errors-only decoding
+    {
+        uint16_t original = 0x3C5;
+        uint32_t codeword = Golay::encode(original);
+        uint32_t erasures = (1U << 2) | (1U << 9) | (1U << 14) | (1U << 21);
+        uint32_t received = codeword ^ erasures;
+        
+        uint16_t plain = 0;
+        uint8_t plain_result = Golay::decode(received, plain);
+        uint16_t decoded = 0;
+        uint8_t result = Golay::decode_with_erasures(received, erasures, decoded);
+        
+        bool pass = (plain_result == 0xFF || plain != original) &&
+                    decoded == original && result == 4;
+        std::cout << "  4 known-bad bits recovered: " << (pass ? "PASS" : "FAIL") << "\n";
+        if (!pass) return false;
+    }
+    
+    // Too many erasures
+    {
+        uint16_t decoded = 0;
+        uint8_t result = Golay::decode_with_erasures(Golay::encode(0x123), 0xFF, decoded);
+        bool pass = (result == 0xFF);
+        std::cout << "  8 erasures rejected: " << (pass ? "PASS" : "FAIL") << "\n";
+        if (!pass) return false;
+    }
+    
+    // Block form agrees with single-word form
+    {
+        uint32_t codewords[16];
+        uint32_t erasures[16];
+        uint16_t info[16];
+        uint8_t results[16];
+        for (int i = 0; i < 16; ++i) {
+            erasures[i] = random_positions(state, i % 8, 0);
+            codewords[i] = Golay::encode(static_cast<uint16_t>(i * 251)) ^ erasures[i];
+        }
+        uint32_t failed = Golay::decode_block_with_erasures(codewords, erasures, info, results, 16);
+        bool pass = (failed == 0);
+        for (int i = 0; i < 16 && pass; ++i) {
+            pass = (info[i] == ((i * 251) & 0xFFF)) && results[i] == (i % 8);
+        }
+        std::cout << "  Block decode: " << (pass ? "PASS" : "FAIL") << "\n";
+        if (!pass) return false;
+    }
+    
+    // Erasures from voting: failed symbols and split votes
+    {
+        uint32_t codeword = Golay::encode(0xA5C);
+        uint8_t symbols[SYMBOLS_PER_WORD * SYMBOL_REPETITION];
+        for (uint32_t i = 0; i < SYMBOLS_PER_WORD * SYMBOL_REPETITION; ++i) {
+            uint32_t bit = (codeword >> (i % SYMBOLS_PER_WORD)) & 1;
+            symbols[i] = (i % SYMBOLS_PER_WORD) < WORD_BITS ? (bit ? 7 : 0) : 0;
+        }
+        
+        // Bit 4: two copies lost; bit 10: one lost, one flipped;
+        // bit 17: one flipped (outvoted, not erased)
+        symbols[4] = 0xFF;
+        symbols[4 + SYMBOLS_PER_WORD] = 0xFF;
+        symbols[10] = 0xFF;
+        symbols[10 + 2 * SYMBOLS_PER_WORD] ^= 7;
+        symbols[17 + SYMBOLS_PER_WORD] ^= 7;
+        
+        uint32_t word = 0;
+        uint32_t erasures = 0;
+        uint32_t split = SymbolDecoder::decode_word_with_erasures(symbols, word, erasures);
+        
+        uint16_t decoded = 0;
+        uint8_t result = Golay::decode_with_erasures(word, erasures, decoded);
+        bool pass = erasures == ((1U << 4) | (1U << 10)) && split == 3 &&
+                    decoded == 0xA5C && result <= 2;
+        std::cout << "  Voting erasure mask: " << (pass ? "PASS" : "FAIL") << "\n";
+        if (!pass) return false;
+    }
+    
+    std::cout << "PASS: All Golay erasure tests\n";
+    return true;
+}
+
+// ============================================================================
+// Test 7: Bit-Sliced Golay
+// ============================================================================
+
+bool test_golay_sliced() {
+    std::cout << "\n[TEST 7] Bit-Sliced Golay\n";
+    std::cout << "=========================\n";
+    
+    uint32_t state = 777;
+    
+    // Transpose round trip, including a partial group
+    {
+        uint32_t words[Golay::SLICE_WIDTH];
+        uint32_t back[Golay::SLICE_WIDTH];
+        uint64_t planes[24];
+        for (size_t i = 0; i < Golay::SLICE_WIDTH; ++i) {
+            words[i] = test_random(state) & 0xFFFFFF;
+        }
+        Golay::to_bit_planes(words, 37, planes);
+        
+        bool pass = true;
+        for (int k = 0; k < 24 && pass; ++k) {
+            for (size_t lane = 0; lane < Golay::SLICE_WIDTH; ++lane) {
+                uint64_t expected = lane < 37 ? (words[lane] >> k) & 1 : 0;
+                if (((planes[k] >> lane) & 1) != expected) {
+                    pass = false;
+                    break;
+                }
+            }
+        }
+        Golay::from_bit_planes(planes, back, 37);
+        pass = pass && std::memcmp(words, back, 37 * sizeof(uint32_t)) == 0;
+        std::cout << "  Bit-plane transpose: " << (pass ? "PASS" : "FAIL") << "\n";
+        if (!pass) return false;
+    }
+    
+    // Encoder matches the table
+    {
+        uint32_t info_words[Golay::SLICE_WIDTH];
+        uint32_t codewords[Golay::SLICE_WIDTH];
+        uint64_t planes[24];
+        for (size_t i = 0; i < Golay::SLICE_WIDTH; ++i) {
+            info_words[i] = (test_random(state) & 0xFFF) << 12;
+        }
+        Golay::to_bit_planes(info_words, Golay::SLICE_WIDTH, planes);
+        Golay::encode_sliced(planes);
+        Golay::from_bit_planes(planes, codewords, Golay::SLICE_WIDTH);
+        
+        bool pass = true;
+        for (size_t i = 0; i < Golay::SLICE_WIDTH; ++i) {
+            pass = pass && codewords[i] == Golay::encode(info_words[i] >> 12);
+        }
+        std::cout << "  Sliced encode: " << (pass ? "PASS" : "FAIL") << "\n";
+        if (!pass) return false;
+    }
+    
+    // Block decode matches decode() for 0-5 errors, including the tail
+    {
+        const size_t count = 64 * 40 + 13;
+        std::vector<uint32_t> received(count);
+        std::vector<uint16_t> info(count);
+        std::vector<uint8_t> results(count);
+        uint32_t expected_failures = 0;
+        for (size_t i = 0; i < count; ++i) {
+            uint32_t flips = random_positions(state, i % 6, 0);
+            received[i] = Golay::encode(test_random(state) & 0xFFF) ^ flips;
+            uint16_t unused = 0;
+            if (Golay::decode(received[i], unused) == 0xFF) {
+                expected_failures++;
+            }
+        }
+        
+        uint32_t failures = Golay::decode_block(received.data(), info.data(), results.data(), count);
+        bool pass = (failures == expected_failures) && failures > 0;
+        for (size_t i = 0; i < count && pass; ++i) {
+            uint16_t expected = 0;
+            uint8_t result = Golay::decode(received[i], expected);
+            pass = (info[i] == expected) && (results[i] == result);
+        }
+        std::cout << "  Block decode matches decode() (" << failures << " uncorrectable): "
+                  << (pass ? "PASS" : "FAIL") << "\n";
+        if (!pass) return false;
+    }
+    
+    std::cout << "PASS: All bit-sliced Golay tests\n";
+    return true;
+}
+
+// ============================================================================
+// Test 8: Sample Clock
+// ============================================================================
+
+bool test_sample_clock() {
+    std::cout << "\n[TEST 8] Sample Clock\n";
+    std::cout << "=====================\n";
+    
+    const int64_t ANCHOR_NS = 5000000000LL;
+    const int64_t ANCHOR_WALL_MS = 1700000000000LL;
+    const SampleTime PAST_32_BITS = (1ULL << 33) + 8000;
+    
+    // Conversions past 2^32 samples (~6 days at 8 kHz)
+    {
+        SampleClock clock;
+        clock.anchor(0, ANCHOR_NS, ANCHOR_WALL_MS);
+        
+        int64_t expected_ns = ANCHOR_NS + static_cast<int64_t>(PAST_32_BITS) * 125000;
+        bool pass = clock.to_monotonic_ns(8000) == ANCHOR_NS + 1000000000LL &&
+                    clock.to_wall_ms(8000) == ANCHOR_WALL_MS + 1000 &&
+                    clock.to_monotonic_ns(PAST_32_BITS) == expected_ns &&
+                    clock.from_monotonic_ns(expected_ns) == PAST_32_BITS &&
+                    clock.from_wall_ms(clock.to_wall_ms(PAST_32_BITS)) == PAST_32_BITS &&
+                    clock.from_monotonic_ns(0) == 0 &&
+                    clock.to_timer_ms(PAST_32_BITS) ==
+                        static_cast<uint32_t>(expected_ns / 1000000);
+        std::cout << "  64-bit conversions: " << (pass ? "PASS" : "FAIL") << "\n";
+        if (!pass) return false;
+    }
+    
+    // Rate change keeps the current sample's time and applies after it
+    {
+        SampleClock clock;
+        clock.anchor(0, ANCHOR_NS, ANCHOR_WALL_MS);
+        SampleTime now = clock.advance(80000);
+        int64_t before = clock.to_monotonic_ns(now);
+        clock.set_sample_rate(8000.8);
+        bool pass = clock.now() == 80000 &&
+                    clock.to_monotonic_ns(now) == before &&
+                    clock.to_monotonic_ns(now + 80008) == before + 10000000000LL &&
+                    SampleClock::ms_to_samples(392) == 49 * 64;
+        std::cout << "  Rate change continuity: " << (pass ? "PASS" : "FAIL") << "\n";
+        if (!pass) return false;
+    }
+    
+    // Demodulator stamps symbols from the capture clock across 2^32
+    {
+        uint8_t test_data[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+        ToneGenerator gen;
+        std::vector<int16_t> audio(8 * 64);
+        uint32_t samples_gen = gen.generate_symbols(test_data, 8, audio.data());
+        
+        const SampleTime start = (1ULL << 32) - 200;
+        FFTDemodulator demod;
+        demod.set_sample_time(start);
+        auto detected = demod.process_audio(audio.data(), samples_gen);
+        
+        bool pass = detected.size() == 8 &&
+                    demod.get_sample_time() == start + samples_gen;
+        for (size_t i = 0; i < detected.size() && pass; ++i) {
+            pass = detected[i].sample_index == start + i * 64 + 63;
+        }
+        demod.reset();
+        pass = pass && demod.get_sample_time() == start + samples_gen;
+        std::cout << "  Symbol sample times: " << (pass ? "PASS" : "FAIL") << "\n";
+        if (!pass) return false;
+    }
+    
+    std::cout << "PASS: All sample clock tests\n";
+    return true;
+}
+
+// ============================================================================
+// Test 9: Clock Drift Estimation
+// ============================================================================
+
+bool test_clock_drift() {
+    std::cout << "\n[TEST 9] Clock Drift Estimation\n";
+    std::cout << "===============================\n";
+    
+    // Sound card 37 ppm fast, 256-sample buffers delivered 0.2-5 ms late
+    const double PPM = 37.0;
+    const double true_rate = SAMPLE_RATE_HZ * (1.0 + PPM * 1e-6);
+    const int64_t START_NS = 1000000000LL;
+    const uint32_t BUFFER = 256;
+    auto true_ns = [&](SampleTime sample) {
+        return START_NS + static_cast<int64_t>(std::llround(sample * 1e9 / true_rate));
+    };
+    
+    uint32_t state = 4242;
+    SampleTime sample = 0;
+    SampleTime dropped = 0;
+    ClockDriftEstimator estimator;
+    SampleClock nominal;
+    nominal.anchor(0, true_ns(0), 1700000000000LL);
+    
+    auto run_seconds = [&](uint32_t seconds) {
+        SampleTime end = sample + static_cast<SampleTime>(seconds) * SAMPLE_RATE_HZ;
+        while (sample < end) {
+            sample += BUFFER;
+            int64_t delay_ns = 200000 + test_random(state) % 4800000;
+            estimator.observe(sample, true_ns(sample + dropped) + delay_ns);
+        }
+    };
+    
+    // Rate after 15 minutes
+    {
+        run_seconds(900);
+        double ppm = estimator.get_ppm();
+        bool pass = estimator.is_locked() && std::fabs(ppm - PPM) < 0.5 &&
+                    estimator.get_restarts() == 0;
+        std::cout << "  Measured " << std::fixed << std::setprecision(2) << ppm
+                  << " ppm (residual " << estimator.get_residual_ns() / 1000.0 << " us): "
+                  << (pass ? "PASS" : "FAIL") << "\n";
+        std::cout << std::defaultfloat << std::setprecision(6);
+        if (!pass) return false;
+    }
+    
+    // Compensated mapping holds 10 minutes ahead; nominal is tens of ms off
+    {
+        SampleClock clock;
+        clock.anchor(0, true_ns(0), 1700000000000LL);
+        bool applied = estimator.compensate(clock);
+        
+        SampleTime ahead = sample + 600 * SAMPLE_RATE_HZ;
+        double error_ms = std::fabs(static_cast<double>(clock.to_monotonic_ns(ahead) - true_ns(ahead))) / 1e6;
+        double nominal_ms = std::fabs(static_cast<double>(nominal.to_monotonic_ns(ahead) - true_ns(ahead))) / 1e6;
+        SampleTime scheduled = clock.from_monotonic_ns(true_ns(ahead));
+        bool pass = applied && error_ms < 1.0 && nominal_ms > 20.0 &&
+                    std::fabs(clock.get_sample_rate() - true_rate) < 0.004 &&
+                    (scheduled > ahead ? scheduled - ahead : ahead - scheduled) < 8;
+        std::cout << "  Error at +10 min: " << std::fixed << std::setprecision(2) << error_ms
+                  << " ms compensated, " << nominal_ms << " ms nominal: "
+                  << (pass ? "PASS" : "FAIL") << "\n";
+        std::cout << std::defaultfloat << std::setprecision(6);
+        if (!pass) return false;
+    }
+    
+    // Dropped samples restart estimation, which locks again
+    {
+        dropped = 4000;
+        run_seconds(10);
+        bool restarted = estimator.get_restarts() == 1 && !estimator.is_locked();
+        run_seconds(120);
+        bool pass = restarted && estimator.is_locked() &&
+                    std::fabs(estimator.get_ppm() - PPM) < 2.0 &&
+                    estimator.get_restarts() == 1;
+        std::cout << "  Restart after dropped samples: " << (pass ? "PASS" : "FAIL") << "\n";
+        if (!pass) return false;
+    }
+    
+    std::cout << "PASS: All clock drift tests\n";
+    return true;
+}
+
 // ============================================================================
 // Main Test Runner
 // ============================================================================
@@ -291,6 +671,10 @@ int run_all_tests() {
     if (test_majority_voting()) { pass_count++; } else { fail_count++; }
     if (test_golay_codec()) { pass_count++; } else { fail_count++; }
     if (test_end_to_end_modem()) { pass_count++; } else { fail_count++; }
+    if (test_golay_erasures()) { pass_count++; } else { fail_count++; }
+    if (test_golay_sliced()) { pass_count++; } else { fail_count++; }
+    if (test_sample_clock()) { pass_count++; } else { fail_count++; }
+    if (test_clock_drift()) { pass_count++; } else { fail_count++; }
     
     std::cout << "\n";
     std::cout << "╔════════════════════════════════════════════════════════════╗\n";
@@ -10,6 +10,9 @@
 #include <thread>
 #include <chrono>
 #include <fstream>
+#include <algorithm>
+#include <string>
+#include <vector>
 
 using namespace ale;
 
@@ -275,6 +278,203 @@ void test_configuration() {
     std::cout << "  PASS" << std::endl;
 }
 
+// Reference for the scoring formula (weighted SNR, success, recency)
+static float reference_score(const LQAEntry& entry, const LQAConfig& config, uint32_t now_ms) {
+    float score = std::min(31.0f, std::max(0.0f, entry.snr_db)) * config.snr_weight;
+    if (entry.total_words > 0) {
+        score += (1.0f - std::min(1.0f, entry.ber)) * 31.0f * config.success_weight;
+    }
+    uint32_t last_activity = std::max(entry.last_contact_ms, entry.last_sounding_ms);
+    if (last_activity > 0) {
+        float age_factor = 1.0f - static_cast<float>(now_ms - last_activity) / config.max_age_ms;
+        score += std::max(0.0f, std::min(1.0f, age_factor)) * 31.0f * config.recency_weight;
+    }
+    return std::min(31.0f, std::max(0.0f, score));
+}
+
+void test_rescore_all() {
+    std::cout << "Test: Bulk rescoring..." << std::endl;
+    
+    LQADatabase db;
+    LQAConfig config;
+    config.max_age_ms = 100000;
+    db.set_config(config);
+    
+    // Spread of SNR, BER and ages; soundings and contacts
+    const uint32_t base_ms = 5000000;
+    for (int i = 0; i < 1000; i++) {
+        std::string station = (i % 3 == 0) ? "" : "ST" + std::to_string(i % 17);
+        db.update_entry(2000000 + (i % 59) * 1000, station, static_cast<float>(i % 40) - 5.0f,
+                        (i % 11) * 0.1f, i % 4, (i % 5 == 0) ? 0 : 100,
+                        base_ms + (i % 200) * 1000);
+    }
+    size_t count = db.get_entry_count();
+    
+    // Entries age: every score follows the formula at the new time
+    uint32_t later_ms = base_ms + 250000;
+    db.rescore_all(later_ms);
+    std::vector<LQAEntry> entries = db.get_all_entries();
+    assert(entries.size() == count);
+    for (const auto& entry : entries) {
+        assert(std::abs(entry.score - reference_score(entry, config, later_ms)) < 1e-4f);
+    }
+    
+    // New weights rescore every entry
+    config.snr_weight = 1.0f;
+    config.success_weight = 0.0f;
+    config.recency_weight = 0.0f;
+    db.set_config(config);
+    for (const auto& entry : db.get_all_entries()) {
+        assert(std::abs(entry.score - std::min(31.0f, std::max(0.0f, entry.snr_db))) < 1e-4f);
+    }
+    
+    std::cout << "  Rescored " << count << " entries" << std::endl;
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_update_score_aged_to_now() {
+    std::cout << "Test: Update scores age against current time..." << std::endl;
+    
+    LQADatabase db;
+    LQAConfig config;
+    config.snr_weight = 0.0f;
+    config.success_weight = 0.0f;
+    config.recency_weight = 1.0f;
+    config.max_age_ms = 100000;
+    db.set_config(config);
+    
+    // Same metrics; one measured now, one replayed with an old timestamp
+    db.update_entry(7073000, "FRESH", 20.0f, 0.01f, 0, 100);
+    db.update_entry(7073000, "STALE", 20.0f, 0.01f, 0, 100, 12345);
+    
+    auto fresh = db.get_entry(7073000, "FRESH");
+    auto stale = db.get_entry(7073000, "STALE");
+    assert(fresh != nullptr && stale != nullptr);
+    assert(fresh->score > 30.0f);
+    assert(stale->score < 1.0f);
+    
+    std::cout << "  Fresh " << fresh->score << ", stale " << stale->score << std::endl;
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_score_all_what_if() {
+    std::cout << "Test: What-if scoring..." << std::endl;
+    
+    LQADatabase db;
+    db.update_entry(7073000, "ALFA", 25.0f, 0.01f, 0, 100, 1000);
+    db.update_entry(7073000, "BRAVO", 10.0f, 0.2f, 3, 100, 2000);
+    db.update_entry(14109000, "", 30.0f, 0.0f, 0, 0, 3000);
+    
+    LQAConfig what_if;
+    what_if.snr_weight = 0.2f;
+    what_if.success_weight = 0.2f;
+    what_if.recency_weight = 0.6f;
+    what_if.max_age_ms = 10000;
+    
+    std::vector<float> stored;
+    for (const auto& entry : db.get_all_entries()) {
+        stored.push_back(entry.score);
+    }
+    std::vector<float> scores = db.score_all(what_if, 6000);
+    std::vector<LQAEntry> entries = db.get_all_entries();
+    assert(scores.size() == entries.size());
+    for (size_t i = 0; i < entries.size(); i++) {
+        assert(std::abs(scores[i] - reference_score(entries[i], what_if, 6000)) < 1e-4f);
+        assert(entries[i].score == stored[i]);   // Stored scores untouched
+    }
+    
+    // Single-entry path agrees with the bulk one
+    LQAEntry entry = entries[0];
+    entry.last_contact_ms = 0;
+    entry.last_sounding_ms = 0;
+    float single = db.compute_score(entry);
+    assert(std::abs(single - reference_score(entry, db.get_config(), 0)) < 1e-4f);
+    
+    // Pruning keeps the remaining rows addressable
+    LQAConfig config = db.get_config();
+    config.max_age_ms = 1;
+    db.set_config(config);
+    int removed = db.prune_stale_entries();
+    assert(removed == 3);
+    db.update_entry(7073000, "BRAVO", 12.0f, 0.1f, 0, 100);
+    auto bravo = db.get_entry(7073000, "BRAVO");
+    assert(bravo != nullptr);
+    assert(bravo->sample_count == 1);
+    
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_incremental_prune() {
+    std::cout << "Test: Incremental pruning..." << std::endl;
+    
+    LQADatabase db;
+    LQAConfig config;
+    config.max_age_ms = 1000;
+    db.set_config(config);
+    
+    uint32_t expiry = 0;
+    assert(!db.next_expiry(expiry));
+    
+    // Activity at 10000..10999 ms, one entry per ms
+    for (uint32_t i = 0; i < 1000; i++) {
+        db.update_entry(3000000 + i * 100, "ST" + std::to_string(i % 7), 15.0f, 0.01f, 0, 10,
+                        10000 + i);
+    }
+    [[maybe_unused]] bool found = db.next_expiry(expiry);
+    assert(found);
+    assert(expiry == 10000 + 1000 + 1);
+    
+    // Nothing stale yet
+    int removed = db.prune_expired(11000);
+    assert(removed == 0);
+    
+    // Refreshing the oldest entry moves it to the back
+    db.update_entry(3000000, "ST0", 15.0f, 0.01f, 0, 10, 12000);
+    found = db.next_expiry(expiry);
+    assert(found);
+    assert(expiry == 10001 + 1000 + 1);
+    
+    // Slices of at most 50, oldest first
+    uint32_t now = 11500;
+    removed = db.prune_expired(now, 50);
+    assert(removed == 50);
+    found = db.next_expiry(expiry);
+    assert(found);
+    assert(expiry == 10051 + 1000 + 1);
+    int total = removed;
+    while ((removed = db.prune_expired(now, 50)) > 0) {
+        assert(removed <= 50);
+        total += removed;
+    }
+    assert(total == 499);   // 10001..10499 stale at 11500
+    assert(db.get_entry_count() == 501);
+    
+    // Survivors are exactly the entries still fresh, and all reachable
+    for (const auto& entry : db.get_all_entries()) {
+        [[maybe_unused]] uint32_t last = std::max(entry.last_contact_ms, entry.last_sounding_ms);
+        assert(static_cast<int32_t>(now - last) <= static_cast<int32_t>(config.max_age_ms));
+        assert(db.get_entry(entry.frequency_hz, entry.remote_station) != nullptr);
+    }
+    assert(db.get_entry(3000000, "ST0") != nullptr);
+    
+    // Expiry index survives save/load
+    const std::string filepath = "test_lqa_expiry.db";
+    [[maybe_unused]] bool saved = db.save_to_file(filepath);
+    assert(saved);
+    LQADatabase loaded;
+    [[maybe_unused]] bool read = loaded.load_from_file(filepath);
+    assert(read);
+    std::remove(filepath.c_str());
+    found = loaded.next_expiry(expiry);
+    assert(found);
+    assert(expiry == 10500 + 1000 + 1);
+    removed = loaded.prune_expired(20000);
+    assert(removed == 501);
+    assert(!loaded.next_expiry(expiry));
+    
+    std::cout << "  PASS" << std::endl;
+}
+
 int main() {
     std::cout << "=== LQA Database Tests ===" << std::endl;
     
@@ -289,6 +489,10 @@ int main() {
     test_export_csv();
     test_get_all_entries();
     test_configuration();
+    test_rescore_all();
+    test_update_score_aged_to_now();
+    test_score_all_what_if();
+    test_incremental_prune();
     
     std::cout << "\n=== All LQA Database Tests Passed ===" << std::endl;
     return 0;
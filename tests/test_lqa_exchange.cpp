@@ -0,0 +1,284 @@
+/**
+ * @file test_lqa_exchange.cpp
+ * @brief Unit tests for LQA table exchange
+ */
+
+#include "ale/lqa_exchange.h"
+#include "ale/lqa_database.h"
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+using namespace ale;
+
+static const uint32_t NOW_MS = 5000000;
+
+void test_round_trip() {
+    std::cout << "Test: Encode/decode round trip..." << std::endl;
+    
+    LQADatabase db;
+    db.update_entry(7073000, "BRAVO", 18.3f, 0.002f, 1, 40, NOW_MS - 60000);
+    db.update_entry(7073000, "", 5.0f, 0.05f, 0, 0, NOW_MS - 120000);
+    db.update_entry(14109000, "CHARLIE", -4.2f, 0.2f, 3, 10, NOW_MS - 1000);
+    
+    LQAExchange exchange(&db);
+    std::vector<uint8_t> data = exchange.encode(NOW_MS);
+    
+    LQAExchangeTable table;
+    [[maybe_unused]] bool ok = LQAExchange::decode(data.data(), data.size(), table);
+    assert(ok);
+    assert(table.sender_time_ms == NOW_MS);
+    assert(table.since_ms == 0);
+    assert(table.entries.size() == 3);
+    
+    auto originals = db.get_all_entries();
+    for (size_t i = 0; i < originals.size(); i++) {
+        [[maybe_unused]] const LQAEntry& original = originals[i];
+        [[maybe_unused]] const LQAExchangeEntry& entry = table.entries[i];
+        assert(entry.frequency_hz == original.frequency_hz);
+        assert(entry.remote_station == original.remote_station);
+        assert(std::abs(entry.snr_db - original.snr_db) <= 0.25f);
+        assert(std::abs(std::log10(entry.ber) - std::log10(original.ber)) <= 1.0f / 64.0f);
+        assert(std::abs(entry.score - original.score) <= 1.0f / 16.0f);
+        assert(entry.sample_count == original.sample_count);
+        assert(entry.total_words == static_cast<uint32_t>(original.total_words));
+        assert(entry.sounding == original.remote_station.empty());
+    }
+    assert(table.entries[0].age_s == 120);
+    assert(table.entries[1].age_s == 60);
+    assert(table.entries[2].age_s == 1);
+    
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_compact_size() {
+    std::cout << "Test: Encoded size..." << std::endl;
+    
+    LQADatabase db;
+    const char* stations[] = {"BRAVO", "CHARLIE", "DELTA", "ECHO"};
+    for (int channel = 0; channel < 50; channel++) {
+        for (const char* station : stations) {
+            db.update_entry(3000000 + channel * 500000, station, 12.0f, 0.01f, 1, 20,
+                            NOW_MS - 300000);
+        }
+    }
+    
+    LQAExchange exchange(&db);
+    std::vector<uint8_t> data = exchange.encode(NOW_MS);
+    
+    // 200 entries: station names sent once, about 10 bytes per entry
+    assert(data.size() < 200 * 12);
+    
+    LQAExchangeTable table;
+    [[maybe_unused]] bool ok = LQAExchange::decode(data.data(), data.size(), table);
+    assert(ok);
+    assert(table.entries.size() == 200);
+    
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_delta_since() {
+    std::cout << "Test: Delta since epoch..." << std::endl;
+    
+    LQADatabase db;
+    db.update_entry(7073000, "BRAVO", 10.0f, 0.01f, 0, 10, NOW_MS - 600000);
+    db.update_entry(10142000, "BRAVO", 15.0f, 0.01f, 0, 10, NOW_MS - 30000);
+    db.update_entry(14109000, "CHARLIE", 20.0f, 0.01f, 0, 10, NOW_MS - 10000);
+    
+    LQAExchange exchange(&db);
+    std::vector<uint8_t> data = exchange.encode(NOW_MS, NOW_MS - 60000);
+    
+    LQAExchangeTable table;
+    [[maybe_unused]] bool ok = LQAExchange::decode(data.data(), data.size(), table);
+    assert(ok);
+    assert(table.since_ms == NOW_MS - 60000);
+    assert(table.entries.size() == 2);
+    assert(table.entries[0].frequency_hz == 10142000);
+    assert(table.entries[1].frequency_hz == 14109000);
+    
+    // Nothing new
+    data = exchange.encode(NOW_MS, NOW_MS);
+    ok = LQAExchange::decode(data.data(), data.size(), table);
+    assert(ok);
+    assert(table.entries.empty());
+    
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_merge_weighting() {
+    std::cout << "Test: Merge weighting..." << std::endl;
+    
+    LQADatabase remote_db;
+    remote_db.update_entry(7073000, "CHARLIE", 10.0f, 0.01f, 0, 20, NOW_MS - 20000);
+    remote_db.update_entry(10142000, "DELTA", 16.0f, 0.001f, 0, 20, NOW_MS - 20000);
+    
+    LQADatabase local_db;
+    local_db.update_entry(7073000, "CHARLIE", 20.0f, 0.01f, 0, 20, NOW_MS - 40000);
+    
+    LQAExchange sender(&remote_db);
+    std::vector<uint8_t> data = sender.encode(NOW_MS);
+    LQAExchangeTable table;
+    [[maybe_unused]] bool ok = LQAExchange::decode(data.data(), data.size(), table);
+    assert(ok);
+    
+    LQAExchange receiver(&local_db);
+    receiver.set_merge_weight(0.5f);
+    [[maybe_unused]] int merged = receiver.merge(table, "BRAVO", "ALFA", NOW_MS);
+    assert(merged == 2);
+    
+    // Existing entry: one local sample (decayed) against half a remote one
+    float decay = local_db.get_config().time_decay_factor;
+    [[maybe_unused]] float expected = (20.0f * decay + 10.0f * 0.5f) / (decay + 0.5f);
+    auto entry = local_db.get_entry(7073000, "CHARLIE");
+    assert(entry);
+    assert(std::abs(entry->snr_db - expected) < 0.3f);
+    assert(entry->sample_count == 2);
+    assert(entry->last_contact_ms == NOW_MS - 20000);
+    
+    // New entry taken as reported
+    entry = local_db.get_entry(10142000, "DELTA");
+    assert(entry);
+    assert(std::abs(entry->snr_db - 16.0f) < 0.3f);
+    assert(entry->sample_count == 1);
+    assert(entry->score > 0.0f);
+    
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_merge_reciprocal() {
+    std::cout << "Test: Merge maps own station to sender..." << std::endl;
+    
+    // BRAVO heard ALFA on 7073 kHz
+    LQADatabase remote_db;
+    remote_db.update_entry(7073000, "ALFA", 14.0f, 0.005f, 0, 30, NOW_MS - 5000);
+    
+    LQAExchange sender(&remote_db);
+    std::vector<uint8_t> data = sender.encode(NOW_MS);
+    LQAExchangeTable table;
+    [[maybe_unused]] bool ok = LQAExchange::decode(data.data(), data.size(), table);
+    assert(ok);
+    
+    LQADatabase local_db;
+    LQAExchange receiver(&local_db);
+    [[maybe_unused]] int merged = receiver.merge(table, "BRAVO", "ALFA", NOW_MS);
+    assert(merged == 1);
+    
+    assert(!local_db.get_entry(7073000, "ALFA"));
+    auto entry = local_db.get_entry(7073000, "BRAVO");
+    assert(entry);
+    assert(std::abs(entry->snr_db - 14.0f) < 0.3f);
+    
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_merge_duplicate() {
+    std::cout << "Test: Duplicate table merged once..." << std::endl;
+    
+    LQADatabase remote_db;
+    remote_db.update_entry(7073000, "CHARLIE", 10.0f, 0.01f, 0, 20, NOW_MS - 20000);
+    
+    LQAExchange sender(&remote_db);
+    std::vector<uint8_t> data = sender.encode(NOW_MS);
+    LQAExchangeTable table;
+    [[maybe_unused]] bool ok = LQAExchange::decode(data.data(), data.size(), table);
+    assert(ok);
+    
+    LQADatabase local_db;
+    LQAExchange receiver(&local_db);
+    [[maybe_unused]] int first = receiver.merge(table, "BRAVO", "ALFA", NOW_MS);
+    [[maybe_unused]] int second = receiver.merge(table, "BRAVO", "ALFA", NOW_MS);
+    assert(first == 1);
+    assert(second == 0);
+    assert(local_db.get_entry(7073000, "CHARLIE")->sample_count == 1);
+    
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_malformed() {
+    std::cout << "Test: Malformed tables rejected..." << std::endl;
+    
+    LQADatabase db;
+    db.update_entry(7073000, "BRAVO", 10.0f, 0.01f, 0, 20, NOW_MS - 20000);
+    db.update_entry(10142000, "CHARLIE", 12.0f, 0.01f, 0, 20, NOW_MS - 20000);
+    
+    LQAExchange exchange(&db);
+    std::vector<uint8_t> data = exchange.encode(NOW_MS);
+    LQAExchangeTable table;
+    
+    // Every truncation fails
+    for (size_t length = 0; length < data.size(); length++) {
+        [[maybe_unused]] bool ok = LQAExchange::decode(data.data(), length, table);
+        assert(!ok);
+    }
+    
+    // Trailing garbage
+    std::vector<uint8_t> longer = data;
+    longer.push_back(0);
+    [[maybe_unused]] bool ok = LQAExchange::decode(longer.data(), longer.size(), table);
+    assert(!ok);
+    
+    // Unknown version
+    std::vector<uint8_t> future = data;
+    future[2] = LQA_EXCHANGE_VERSION + 1;
+    ok = LQAExchange::decode(future.data(), future.size(), table);
+    assert(!ok);
+    
+    ok = LQAExchange::decode(data.data(), data.size(), table);
+    assert(ok);
+    
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_merge_clamps_age() {
+    std::cout << "Test: Merge clamps reported age..." << std::endl;
+    
+    LQAExchangeTable table;
+    table.sender_time_ms = NOW_MS;
+    const uint32_t ages_s[] = { 10, 4294968, UINT32_MAX };
+    for (size_t i = 0; i < 3; i++) {
+        LQAExchangeEntry remote;
+        remote.frequency_hz = 7073000 + static_cast<uint32_t>(i) * 1000000;
+        remote.remote_station = "CHARLIE";
+        remote.snr_db = 10.0f;
+        remote.ber = 0.01f;
+        remote.age_s = ages_s[i];
+        remote.sample_count = 1;
+        table.entries.push_back(remote);
+    }
+    
+    LQADatabase local_db;
+    LQAExchange receiver(&local_db);
+    [[maybe_unused]] int merged = receiver.merge(table, "BRAVO", "ALFA", NOW_MS);
+    assert(merged == 3);
+    
+    // Huge ages land at the database max age, never in the future
+    [[maybe_unused]] uint32_t max_age_ms = local_db.get_config().max_age_ms;
+    for (size_t i = 0; i < 3; i++) {
+        auto entry = local_db.get_entry(table.entries[i].frequency_hz, "CHARLIE");
+        assert(entry);
+        [[maybe_unused]] int32_t age_ms = static_cast<int32_t>(NOW_MS - entry->last_contact_ms);
+        assert(age_ms >= 0);
+        assert(static_cast<uint32_t>(age_ms) <= max_age_ms);
+        assert(i == 0 ? age_ms == 10000 : static_cast<uint32_t>(age_ms) == max_age_ms);
+    }
+    
+    std::cout << "  PASS" << std::endl;
+}
+
+int main() {
+    std::cout << "=== LQA Exchange Tests ===" << std::endl;
+    
+    test_round_trip();
+    test_compact_size();
+    test_delta_since();
+    test_merge_weighting();
+    test_merge_reciprocal();
+    test_merge_duplicate();
+    test_malformed();
+    test_merge_clamps_age();
+    
+    std::cout << "\n=== All LQA Exchange Tests Passed ===" << std::endl;
+    return 0;
+}
@@ -0,0 +1,218 @@
+/**
+ * @file test_lqa_update_queue.cpp
+ * @brief Unit tests for LQA update queue
+ */
+
+#include "ale/lqa_update_queue.h"
+#include "ale/lqa_analyzer.h"
+#include "ale/lqa_database.h"
+#include "ale/lqa_metrics.h"
+#include <iostream>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ale;
+
+static const uint32_t NOW_MS = 5000000;
+
+static bool same_entry(const LQAEntry& a, const LQAEntry& b) {
+    return a.frequency_hz == b.frequency_hz && a.remote_station == b.remote_station &&
+           std::abs(a.snr_db - b.snr_db) < 1e-4f && std::abs(a.ber - b.ber) < 1e-6f &&
+           std::abs(a.sinad_db - b.sinad_db) < 1e-4f &&
+           std::abs(a.multipath_score - b.multipath_score) < 1e-6f &&
+           std::abs(a.noise_floor_dbm - b.noise_floor_dbm) < 1e-4f &&
+           a.fec_errors == b.fec_errors && a.total_words == b.total_words &&
+           a.last_contact_ms == b.last_contact_ms && a.last_sounding_ms == b.last_sounding_ms &&
+           a.sample_count == b.sample_count && std::abs(a.score - b.score) < 1e-4f;
+}
+
+void test_matches_direct_updates() {
+    std::cout << "Test: Drained batch matches direct updates..." << std::endl;
+    
+    LQADatabase direct;
+    LQADatabase queued;
+    LQAUpdateQueue queue(&queued, 256);
+    
+    // Interleaved keys, several records each
+    const char* stations[] = {"BRAVO", "CHARLIE", ""};
+    for (int i = 0; i < 60; i++) {
+        uint32_t frequency = 7000000 + (i % 4) * 1000000;
+        const char* station = stations[i % 3];
+        float snr = 5.0f + (i * 7) % 20;
+        float ber = 0.001f * (1 + i % 5);
+        uint32_t time = NOW_MS + i * 100;
+        direct.update_entry(frequency, station, snr, ber, i % 3, 10, time);
+        bool ok = queue.push_update(frequency, station, snr, ber, i % 3, 10, time);
+        assert(ok);
+    }
+    
+    size_t taken = queue.drain();
+    assert(taken == 60);
+    
+    auto expected = direct.get_all_entries();
+    auto actual = queued.get_all_entries();
+    assert(expected.size() == actual.size());
+    for (size_t i = 0; i < expected.size(); i++) {
+        assert(same_entry(expected[i], actual[i]));
+    }
+    
+    // 12 channel/station keys: one lookup and rescore each
+    LQAUpdateQueueStats stats = queue.get_stats();
+    assert(stats.pushed == 60);
+    assert(stats.applied == 60);
+    assert(stats.batches == 1);
+    assert(stats.keys == 12);
+    
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_soundings() {
+    std::cout << "Test: Soundings match analyzer..." << std::endl;
+    
+    LQADatabase direct;
+    LQAAnalyzer analyzer(&direct);
+    LQADatabase queued;
+    LQAUpdateQueue queue(&queued);
+    
+    analyzer.process_sounding("BRAVO", 7073000, 14.0f, 0.01f, NOW_MS);
+    queue.push_sounding("BRAVO", 7073000, 14.0f, 0.01f, NOW_MS);
+    
+    MetricsSample sample;
+    sample.snr_db = 9.0f;
+    sample.noise_power_dbm = -95.0f;
+    sample.fec_errors_corrected = 2;
+    sample.decode_success = true;
+    sample.multipath_delay_ms = 1.5f;
+    sample.timestamp_ms = NOW_MS + 500;
+    analyzer.process_sounding_extended("BRAVO", 7073000, sample);
+    queue.push_sounding_extended("BRAVO", 7073000, sample);
+    
+    queue.drain();
+    
+    auto expected = direct.get_all_entries();
+    auto actual = queued.get_all_entries();
+    assert(expected.size() == 2);
+    assert(actual.size() == 2);
+    for (size_t i = 0; i < expected.size(); i++) {
+        assert(same_entry(expected[i], actual[i]));
+    }
+    
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_full_and_partial_drain() {
+    std::cout << "Test: Full ring drops, partial drain..." << std::endl;
+    
+    LQADatabase db;
+    LQAUpdateQueue queue(&db, 6);
+    assert(queue.capacity() == 8);
+    
+    int accepted = 0;
+    for (int i = 0; i < 10; i++) {
+        if (queue.push_update(7073000, "BRAVO", 10.0f, 0.01f, 0, 1, NOW_MS + i)) {
+            accepted++;
+        }
+    }
+    assert(accepted == 8);
+    assert(queue.get_stats().dropped == 2);
+    assert(queue.size_approx() == 8);
+    
+    size_t taken = queue.drain(3);
+    assert(taken == 3);
+    assert(db.get_entry(7073000, "BRAVO")->sample_count == 3);
+    
+    // Room again
+    bool ok = queue.push_update(7073000, "BRAVO", 10.0f, 0.01f, 0, 1, NOW_MS + 20);
+    assert(ok);
+    taken = queue.drain();
+    assert(taken == 6);
+    assert(queue.size_approx() == 0);
+    
+    auto entry = db.get_entry(7073000, "BRAVO");
+    assert(entry->sample_count == 9);
+    assert(entry->last_contact_ms == NOW_MS + 20);
+    
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_truncated_station() {
+    std::cout << "Test: Long station address truncated..." << std::endl;
+    
+    LQAUpdate update;
+    update.set_station("ABCDEFGHIJKLMNOPQRS");
+    assert(update.station_length == LQA_UPDATE_STATION_LENGTH);
+    assert(update.get_station() == "ABCDEFGHIJKLMNO");
+    
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_concurrent_producers() {
+    std::cout << "Test: Concurrent producers..." << std::endl;
+    
+    const int PRODUCERS = 4;
+    const int PER_PRODUCER = 20000;
+    
+    LQADatabase db;
+    LQAUpdateQueue queue(&db, 512);
+    std::atomic<int> running(PRODUCERS);
+    
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; p++) {
+        producers.emplace_back([&queue, &running, p]() {
+            std::string station = "STN" + std::to_string(p);
+            for (int i = 0; i < PER_PRODUCER; i++) {
+                uint32_t frequency = 3000000 + (i % 8) * 1000000;
+                while (!queue.push_update(frequency, station, 10.0f, 0.01f, 0, 1,
+                                          NOW_MS + i)) {
+                    std::this_thread::yield();
+                }
+            }
+            running--;
+        });
+    }
+    
+    // Owner thread drains while producers run
+    size_t total = 0;
+    while (running.load() > 0 || queue.size_approx() > 0) {
+        total += queue.drain();
+    }
+    total += queue.drain();
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    
+    assert(total == static_cast<size_t>(PRODUCERS * PER_PRODUCER));
+    LQAUpdateQueueStats stats = queue.get_stats();
+    assert(stats.pushed == total);
+    assert(stats.applied == total);
+    assert(stats.keys <= stats.applied);
+    
+    assert(db.get_entry_count() == PRODUCERS * 8);
+    for (int p = 0; p < PRODUCERS; p++) {
+        int words = 0;
+        for (const auto& entry : db.get_entries_for_station("STN" + std::to_string(p))) {
+            assert(entry.sample_count == PER_PRODUCER / 8);
+            words += entry.total_words;
+        }
+        assert(words == PER_PRODUCER);
+    }
+    
+    std::cout << "  PASS" << std::endl;
+}
+
+int main() {
+    std::cout << "=== LQA Update Queue Tests ===" << std::endl;
+    
+    test_matches_direct_updates();
+    test_soundings();
+    test_full_and_partial_drain();
+    test_truncated_station();
+    test_concurrent_producers();
+    
+    std::cout << "\n=== All LQA Update Queue Tests Passed ===" << std::endl;
+    return 0;
+}
@@ -9,6 +9,8 @@
  *  4. Message assembly
  *  5. Call type detection
  *  6. End-to-end call scenarios
+ *  7. Word sequence grammar (DFA)
+ *  8. Message sample time
  */
 
 #include "ale_word.h"
@@ -16,6 +18,7 @@
 #include <iostream>
 #include <iomanip>
 #include <cstring>
+#include <initializer_list>
 
 namespace ale {
 
@@ -307,6 +310,120 @@ bool test_call_type_detection() {
     return true;
 }
 
+// ============================================================================
+// Test 7: Word Sequence Grammar
+// ============================================================================
+
+bool test_sequence_grammar() {
+    std::cout << "\n[TEST 7] Word Sequence Grammar (DFA)\n";
+    std::cout << "====================================\n";
+    
+    bool all_pass = true;
+    
+    auto run = [](std::initializer_list<WordType> types) -> SequenceState {
+        WordSequenceValidator v;
+        for (WordType t : types) {
+            v.feed(t);
+        }
+        return v.state();
+    };
+    
+    struct TestCase {
+        SequenceState actual;
+        SequenceState expected;
+        const char* description;
+    };
+    
+    TestCase cases[] = {
+        { run({WordType::TIS}), SequenceState::SOUNDING, "TIS" },
+        { run({WordType::TO, WordType::FROM}), SequenceState::INDIVIDUAL, "TO FROM" },
+        { run({WordType::THRU, WordType::TO, WordType::DATA, WordType::REP, WordType::FROM}),
+          SequenceState::INDIVIDUAL, "THRU TO DATA REP FROM" },
+        { run({WordType::TWS, WordType::TIS}), SequenceState::NET, "TWS TIS" },
+        { run({WordType::TO, WordType::CMD, WordType::DATA, WordType::FROM}),
+          SequenceState::AMD, "TO CMD DATA FROM" },
+        { run({WordType::TO, WordType::DATA}), SequenceState::TO_EXT, "TO DATA (pending)" },
+        { run({WordType::FROM}), SequenceState::REJECT, "FROM first" },
+        { run({WordType::TO, WordType::TWS}), SequenceState::REJECT, "TO TWS" },
+        { run({WordType::TO, WordType::FROM, WordType::DATA}), SequenceState::REJECT, "word after FROM" },
+        { run({WordType::THRU, WordType::FROM}), SequenceState::REJECT, "THRU FROM" },
+    };
+    
+    for (const auto& tc : cases) {
+        bool pass = (tc.actual == tc.expected);
+        std::cout << "  " << std::setw(24) << std::left << tc.description
+                  << (pass ? "PASS" : "FAIL") << "\n";
+        if (!pass) all_pass = false;
+    }
+    std::cout << std::right;
+    
+    // Assembler drops garbage immediately and restarts on a valid start word
+    MessageAssembler assembler;
+    WordParser parser;
+    auto make_word = [&parser](WordType type, const char* chars, uint32_t time_ms) -> ALEWord {
+        uint32_t payload = WordParser::encode_ascii(chars);
+        uint32_t preamble = static_cast<uint8_t>(type) & 0x07;
+        
+        ALEWord word;
+        parser.parse_from_bits(preamble | (payload << 3), word);
+        word.timestamp_ms = time_ms;
+        word.valid = true;
+        return word;
+    };
+    
+    assembler.add_word(make_word(WordType::FROM, "XXX", 100));
+    bool dropped = !assembler.is_active();
+    assembler.add_word(make_word(WordType::TO, "K6K", 200));
+    assembler.add_word(make_word(WordType::REP, "K6K", 300));
+    assembler.add_word(make_word(WordType::TWS, "NET", 400));  // Illegal after TO, restarts
+    bool done = assembler.add_word(make_word(WordType::FROM, "W1A", 500));
+    
+    ALEMessage msg;
+    bool restarted = done && assembler.get_message(msg) &&
+                     msg.call_type == CallType::NET &&
+                     msg.words.size() == 2 && msg.start_time_ms == 400;
+                     
+    std::cout << "  Garbage dropped:        " << (dropped ? "PASS" : "FAIL") << "\n";
+    std::cout << "  Restart on new start:   " << (restarted ? "PASS" : "FAIL") << "\n";
+    
+    return all_pass && dropped && restarted;
+}
+
+// ============================================================================
+// Test 8: Message Sample Time
+// ============================================================================
+
+bool test_message_sample_time() {
+    std::cout << "\n[TEST 8] Message Sample Time\n";
+    std::cout << "============================\n";
+    
+    MessageAssembler assembler;
+    WordParser parser;
+    
+    auto make_word = [&parser](WordType type, const char* chars, SampleTime sample) -> ALEWord {
+        uint32_t payload = WordParser::encode_ascii(chars);
+        uint32_t preamble = static_cast<uint8_t>(type) & 0x07;
+        
+        ALEWord word;
+        parser.parse_from_bits(preamble | (payload << 3), word);
+        word.sample_time = sample;
+        word.valid = true;
+        return word;
+    };
+    
+    // Sample times beyond 32 bits (receiver up for a week)
+    const SampleTime call_start = (1ULL << 32) + 5000;
+    assembler.add_word(make_word(WordType::TO, "K6K", call_start));
+    bool done = assembler.add_word(make_word(WordType::FROM, "W1A", call_start + 49 * 64));
+    
+    ALEMessage msg;
+    bool correct = done && assembler.get_message(msg) && (msg.start_sample == call_start);
+    
+    std::cout << "  Start sample: " << msg.start_sample << "\n";
+    std::cout << "  Result: " << (correct ? "PASS" : "FAIL") << "\n";
+    return correct;
+}
+
 // ============================================================================
 // Main Test Runner
 // ============================================================================
@@ -326,6 +443,8 @@ int run_all_tests() {
     if (test_address_book()) { pass_count++; } else { fail_count++; }
     if (test_message_assembly()) { pass_count++; } else { fail_count++; }
     if (test_call_type_detection()) { pass_count++; } else { fail_count++; }
+    if (test_sequence_grammar()) { pass_count++; } else { fail_count++; }
+    if (test_message_sample_time()) { pass_count++; } else { fail_count++; }
     
     std::cout << "\n";
     std::cout << "╔════════════════════════════════════════════════════════════╗\n";
@@ -0,0 +1,215 @@
+/**
+ * @file test_sounding_scheduler.cpp
+ * @brief Unit tests for sounding scheduler
+ */
+
+#include "ale/sounding_scheduler.h"
+#include "ale/lqa_analyzer.h"
+#include "ale/lqa_database.h"
+#include <iostream>
+#include <cassert>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace ale;
+
+void test_new_channels_due() {
+    std::cout << "Test: New channels due immediately..." << std::endl;
+    
+    SoundingScheduler scheduler;
+    scheduler.add_channel(7073000);
+    scheduler.add_channel(10142000);
+    assert(scheduler.get_channel_count() == 2);
+    
+    SoundingBatch batch = scheduler.plan(1000);
+    assert(batch.channels.size() == 2);
+    assert(scheduler.next_due_ms(1000) == 1000);
+    
+    scheduler.mark_batch_sounded(batch, 1000);
+    assert(scheduler.plan(1001).empty());
+    
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_jitter_spreads_due_times() {
+    std::cout << "Test: Jitter spreads due times..." << std::endl;
+    
+    SchedulerConfig config;
+    config.interval_ms = 100000;
+    config.jitter_fraction = 0.2f;
+    SoundingScheduler scheduler(config);
+    
+    for (uint32_t i = 0; i < 8; i++) {
+        scheduler.add_channel(7000000 + i * 1000000);
+        scheduler.mark_sounded(7000000 + i * 1000000, 1000);
+    }
+    
+    // Due times stay within +/- 20% of the interval and are not identical
+    std::set<uint32_t> due_times;
+    [[maybe_unused]] uint32_t earliest = scheduler.next_due_ms(1000);
+    assert(earliest >= 1000 + 80000);
+    for (uint32_t t = 1000 + 80000; t <= 1000 + 120000; t += 1000) {
+        SoundingBatch batch = scheduler.plan(t);
+        for (const auto& s : batch.channels) {
+            due_times.insert(t);
+            scheduler.mark_sounded(s.frequency_hz, t);
+        }
+    }
+    assert(due_times.size() > 1);
+    
+    std::cout << "  Distinct due times: " << due_times.size() << std::endl;
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_priority_and_batching() {
+    std::cout << "Test: Priority and batching..." << std::endl;
+    
+    SchedulerConfig config;
+    config.interval_ms = 10000;
+    config.jitter_fraction = 0.0f;
+    config.max_batch = 3;
+    config.pull_forward = 0.75f;
+    SoundingScheduler scheduler(config);
+    
+    scheduler.add_channel(7073000, 1.0f);
+    scheduler.add_channel(14107000, 3.0f);   // High-value channel
+    scheduler.add_channel(18106000, 1.0f);
+    scheduler.add_channel(21096000, 1.0f);
+    
+    scheduler.mark_sounded(7073000, 0);
+    scheduler.mark_sounded(14107000, 0);
+    scheduler.mark_sounded(18106000, 2000);   // 80% stale at t=10000
+    scheduler.mark_sounded(21096000, 5000);   // 50% stale, not pulled forward
+    
+    SoundingBatch batch = scheduler.plan(10000);
+    assert(batch.channels.size() == 3);
+    assert(batch.channels[0].frequency_hz == 14107000);
+    assert(batch.channels[1].frequency_hz == 7073000);
+    assert(batch.channels[2].frequency_hz == 18106000);
+    
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_fresh_lqa_postpones() {
+    std::cout << "Test: Fresh LQA postpones sounding..." << std::endl;
+    
+    SchedulerConfig config;
+    config.interval_ms = 10000;
+    config.jitter_fraction = 0.0f;
+    SoundingScheduler scheduler(config);
+    
+    scheduler.add_channel(7073000);
+    scheduler.mark_sounded(7073000, 0);
+    scheduler.update_channel_quality(7073000, 25.0f, 8000);
+    
+    assert(scheduler.plan(10000).empty());
+    assert(scheduler.next_due_ms(10000) == 18000);
+    assert(!scheduler.plan(18000).empty());
+    
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_call_activity_holdoff() {
+    std::cout << "Test: Call activity hold-off..." << std::endl;
+    
+    SchedulerConfig config;
+    config.interval_ms = 10000;
+    config.jitter_fraction = 0.0f;
+    config.activity_bin_ms = 1000;
+    config.activity_period_ms = 100000;
+    config.max_staleness = 2.0f;
+    SoundingScheduler scheduler(config);
+    
+    // Calls cluster in second 10-11 of every period
+    for (int i = 0; i < 5; i++) {
+        scheduler.record_call_activity(10500 + i * 100000);
+    }
+    assert(scheduler.call_likelihood(10200) > 0.99f);
+    assert(scheduler.call_likelihood(30000) < 0.01f);
+    
+    scheduler.add_channel(7073000);
+    scheduler.mark_sounded(7073000, 0);
+    
+    SoundingBatch busy = scheduler.plan(10200);
+    assert(busy.empty() && busy.held_off);
+    
+    SoundingBatch quiet = scheduler.plan(12000);
+    assert(!quiet.empty());
+    
+    // Badly overdue channel is sounded even at a busy time
+    SoundingBatch overdue = scheduler.plan(210500);
+    assert(!overdue.empty() && !overdue.held_off);
+    
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_sync_from_analyzer() {
+    std::cout << "Test: Sync from analyzer..." << std::endl;
+    
+    LQADatabase db;
+    LQAAnalyzer analyzer(&db);
+    analyzer.process_sounding("REMOTE", 7073000, 22.0f, 0.001f, 5000);
+    analyzer.process_sounding("REMOTE", 14107000, 18.0f, 0.01f, 6000);
+    
+    SchedulerConfig config;
+    config.interval_ms = 10000;
+    config.jitter_fraction = 0.0f;
+    SoundingScheduler scheduler(config);
+    scheduler.sync_from_analyzer(analyzer);
+    
+    assert(scheduler.get_channel_count() == 2);
+    assert(scheduler.next_due_ms(5000) == 15000);
+    
+    std::cout << "  PASS" << std::endl;
+}
+
+// Due times of one channel over several soundings
+static std::vector<uint32_t> due_sequence(const std::string& self_address, uint32_t seed = 0) {
+    SchedulerConfig config;
+    config.interval_ms = 100000;
+    config.jitter_fraction = 0.2f;
+    config.self_address = self_address;
+    config.seed = seed;
+    SoundingScheduler scheduler(config);
+    scheduler.add_channel(7073000);
+    
+    std::vector<uint32_t> due_times;
+    uint32_t now = 1000;
+    for (int i = 0; i < 8; i++) {
+        scheduler.mark_sounded(7073000, now);
+        now = scheduler.next_due_ms(now);
+        due_times.push_back(now);
+    }
+    return due_times;
+}
+
+void test_jitter_seeded_by_address() {
+    std::cout << "Test: Jitter seeded by self address..." << std::endl;
+    
+    // Same address repeats its schedule, different addresses do not
+    // sound in lockstep
+    assert(due_sequence("K6ABC") == due_sequence("K6ABC"));
+    assert(due_sequence("K6ABC") != due_sequence("W1XYZ"));
+    assert(due_sequence("K6ABC") != due_sequence("K6ABD"));
+    
+    // An explicit seed overrides the address
+    assert(due_sequence("K6ABC", 42) == due_sequence("W1XYZ", 42));
+    
+    std::cout << "  PASS" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Sounding Scheduler Tests ===" << std::endl;
+    
+    test_new_channels_due();
+    test_jitter_spreads_due_times();
+    test_priority_and_batching();
+    test_fresh_lqa_postpones();
+    test_call_activity_holdoff();
+    test_sync_from_analyzer();
+    test_jitter_seeded_by_address();
+    
+    std::cout << "\n=== All Sounding Scheduler Tests Passed ===" << std::endl;
+    return 0;
+}
@@ -9,13 +9,20 @@
  *  4. Incoming call handling
  *  5. LQA (Link Quality Analysis)
  *  6. Timeout handling
+ *  7. Sounding
+ *  8. Transition table and delegate callbacks
+ *  9. Listen-before-transmit
+ * 10. Snapshot/restore
+ * 11. Transmit sample times
  */
 
 #include "ale_state_machine.h"
 #include <iostream>
 #include <iomanip>
 #include <vector>
+#include <array>
 #include <cstring>
+#include <cstdio>
 
 namespace ale {
 
@@ -393,6 +400,308 @@ bool test_sounding() {
     return pass && returned_to_scan;
 }
 
+// ============================================================================
+// Test 8: Transition Table and Delegate Callbacks
+// ============================================================================
+
+bool test_transition_table() {
+    std::cout << "\n[TEST 8] Transition Table and Delegates\n";
+    std::cout << "=======================================\n";
+    
+    // Spot-check lookups against the documented procedure
+    ALEState next = ALEState::IDLE;
+    bool legal = ALEStateMachine::lookup_transition(ALEState::ERROR, ALEEvent::START_SCAN, next) &&
+                 next == ALEState::SCANNING &&
+                 ALEStateMachine::lookup_transition(ALEState::SOUNDING, ALEEvent::ERROR_OCCURRED, next) &&
+                 next == ALEState::ERROR &&
+                 !ALEStateMachine::lookup_transition(ALEState::LINKED, ALEEvent::START_SCAN, next) &&
+                 !ALEStateMachine::lookup_transition(ALEState::IDLE, static_cast<ALEEvent>(42), next);
+    std::cout << "  Table lookups: " << (legal ? "PASS" : "FAIL") << "\n";
+    
+    // Illegal event leaves state untouched
+    ALEStateMachine sm;
+    sm.process_event(ALEEvent::START_SCAN);
+    bool ignored = !sm.process_event(ALEEvent::HANDSHAKE_COMPLETE) &&
+                   sm.get_state() == ALEState::SCANNING;
+    std::cout << "  Illegal event ignored: " << (ignored ? "PASS" : "FAIL") << "\n";
+    
+    // Delegates bound to tracker methods, no std::function involved
+    StateTracker states;
+    WordTracker words;
+    sm.set_state_handler(ALEStateMachine::StateChangeHandler::from_method<
+        StateTracker, &StateTracker::record>(&states));
+    sm.set_transmit_handler(ALEStateMachine::TransmitHandler::from_method<
+        WordTracker, &WordTracker::record>(&words));
+    sm.set_self_address("W1A");
+    
+    sm.initiate_call("K6K");
+    bool delegated = states.had_transition(ALEState::SCANNING, ALEState::CALLING) &&
+                     words.count() == 2;
+    std::cout << "  Delegate callbacks: " << (delegated ? "PASS" : "FAIL") << "\n";
+    
+    // std::function setter replaces a bound delegate
+    int legacy_calls = 0;
+    sm.set_state_callback([&legacy_calls](ALEState, ALEState) { legacy_calls++; });
+    states.clear();
+    sm.process_event(ALEEvent::HANDSHAKE_COMPLETE);
+    bool replaced = (legacy_calls == 1) && states.transitions.empty();
+    std::cout << "  Legacy callback override: " << (replaced ? "PASS" : "FAIL") << "\n";
+    
+    return legal && ignored && delegated && replaced;
+}
+
+// ============================================================================
+// Test 9: Listen Before Transmit
+// ============================================================================
+
+bool test_listen_before_transmit() {
+    std::cout << "\n[TEST 9] Listen Before Transmit\n";
+    std::cout << "===============================\n";
+    
+    // Synthetic FFT frames: one strong tone, flat wideband, and quiet noise
+    std::array<float, FFT_SIZE> tone_mags;
+    std::array<float, FFT_SIZE> voice_mags;
+    std::array<float, FFT_SIZE> quiet_mags;
+    tone_mags.fill(0.5f);
+    voice_mags.fill(0.5f);
+    quiet_mags.fill(0.5f);
+    tone_mags[FFT_BIN_OFFSET + 4] = 200.0f;
+    for (uint32_t bin = FFT_BIN_OFFSET; bin < FFT_BIN_OFFSET + FFT_BIN_SPAN; ++bin) {
+        voice_mags[bin] = 20.0f;
+    }
+    BandEnergy tone = FFTDemodulator::measure_band_energy(tone_mags);
+    BandEnergy voice = FFTDemodulator::measure_band_energy(voice_mags);
+    BandEnergy quiet = FFTDemodulator::measure_band_energy(quiet_mags);
+    
+    // Detector classification
+    ChannelOccupancyDetector detector;
+    detector.start(0);
+    for (int i = 0; i < 10; ++i) detector.add_measurement(tone);
+    OccupancyResult r_data = detector.result();
+    detector.start(0);
+    for (int i = 0; i < 10; ++i) detector.add_measurement(voice);
+    OccupancyResult r_voice = detector.result();
+    detector.start(0);
+    for (int i = 0; i < 10; ++i) detector.add_measurement(quiet);
+    OccupancyResult r_quiet = detector.result();
+    
+    bool classified = r_data.busy && r_data.activity == ChannelActivity::DATA &&
+                      r_voice.busy && r_voice.activity == ChannelActivity::VOICE &&
+                      !r_quiet.busy && r_quiet.activity == ChannelActivity::CLEAR;
+    std::cout << "  Occupancy classification: " << (classified ? "PASS" : "FAIL") << "\n";
+    
+    // State machine: channel 0 busy, channel 2 has better LQA than channel 1
+    ALEStateMachine sm;
+    WordTracker words;
+    sm.set_transmit_handler(ALEStateMachine::TransmitHandler::from_method<
+        WordTracker, &WordTracker::record>(&words));
+    sm.set_self_address("W1A");
+    
+    ScanConfig config;
+    config.scan_list.push_back(Channel(7100000));
+    config.scan_list.push_back(Channel(14100000));
+    config.scan_list.push_back(Channel(21100000));
+    config.scan_list[1].lqa_score = 40.0f;
+    config.scan_list[2].lqa_score = 80.0f;
+    sm.configure_scan(config);
+    
+    LBTConfig lbt;
+    lbt.enabled = true;
+    lbt.occupancy.window_ms = 100;
+    sm.configure_lbt(lbt);
+    
+    bool queued = sm.initiate_call("K6K") && sm.is_transmit_pending() && words.count() == 0;
+    
+    uint32_t t = 0;
+    for (; t <= 100; t += 20) {
+        sm.report_band_energy(tone);
+        sm.update(t);
+    }
+    bool hopped = sm.is_transmit_pending() && words.count() == 0 &&
+                  sm.get_current_channel()->frequency_hz == 21100000 &&
+                  sm.get_lbt_stats().channel_hops == 1;
+                  
+    for (; t <= 220; t += 20) {
+        sm.report_band_energy(quiet);
+        sm.update(t);
+    }
+    bool sent = !sm.is_transmit_pending() && words.count() == 2 &&
+                sm.get_state() == ALEState::CALLING &&
+                sm.get_current_channel()->frequency_hz == 21100000;
+                
+    std::cout << "  Call queued for listen: " << (queued ? "PASS" : "FAIL") << "\n";
+    std::cout << "  Busy channel -> next-best: " << (hopped ? "PASS" : "FAIL") << "\n";
+    std::cout << "  Sent on clear channel: " << (sent ? "PASS" : "FAIL") << "\n";
+    
+    // Single channel, always busy: defer, then give up
+    ALEStateMachine sm2;
+    sm2.add_scan_channel(Channel(7100000));
+    lbt.max_attempts = 2;
+    lbt.defer_ms = 200;
+    sm2.configure_lbt(lbt);
+    sm2.send_sounding();
+    for (t = 0; t <= 1000 && sm2.is_transmit_pending(); t += 20) {
+        sm2.report_band_energy(voice);
+        sm2.update(t);
+    }
+    const LBTStats& stats = sm2.get_lbt_stats();
+    bool abandoned = !sm2.is_transmit_pending() && stats.deferrals == 1 &&
+                     stats.abandoned == 1 && sm2.get_state() == ALEState::IDLE;
+    std::cout << "  Deferral then abandon: " << (abandoned ? "PASS" : "FAIL") << "\n";
+    
+    return classified && queued && hopped && sent && abandoned;
+}
+
+// ============================================================================
+// Test 10: Snapshot/Restore
+// ============================================================================
+
+bool test_snapshot_restore() {
+    std::cout << "\n[TEST 10] Snapshot/Restore\n";
+    std::cout << "==========================\n";
+    
+    // Linked after scanning with LQA history, established at t=50000
+    ALEStateMachine sm;
+    sm.set_self_address("W1A");
+    ScanConfig config;
+    config.scan_list.push_back(Channel(7100000));
+    config.scan_list.push_back(Channel(14100000, "LSB"));
+    config.scan_list.push_back(Channel(21100000));
+    sm.configure_scan(config);
+    sm.update(40000);
+    sm.process_event(ALEEvent::START_SCAN);
+    sm.update(40200);   // Dwell elapsed: hop to next channel
+    
+    LinkQuality lq;
+    lq.snr_db = 12.5f;
+    lq.fec_errors = 2;
+    sm.update_link_quality(lq);
+    
+    sm.update(50000);
+    sm.process_event(ALEEvent::CALL_DETECTED);
+    sm.process_event(ALEEvent::HANDSHAKE_COMPLETE);
+    sm.update(60000);
+    
+    std::vector<uint8_t> snapshot;
+    sm.save_snapshot(snapshot);
+    std::cout << "  Snapshot size: " << snapshot.size() << " bytes\n";
+    
+    // Restart: new instance, clock restarted near zero
+    ALEStateMachine restored;
+    ChannelTracker tuned;
+    restored.set_channel_handler(ALEStateMachine::ChannelHandler::from_method<
+        ChannelTracker, &ChannelTracker::record>(&tuned));
+    bool loaded = restored.restore_snapshot(snapshot.data(), snapshot.size(), 1000);
+    
+    const Channel* ch = restored.get_current_channel();
+    const Channel* expected = sm.get_current_channel();
+    bool state_ok = loaded && restored.get_state() == ALEState::LINKED &&
+                    ch && ch->frequency_hz == expected->frequency_hz &&
+                    ch->mode == expected->mode && ch->lqa_score == expected->lqa_score &&
+                    tuned.count() == 1 && tuned.frequencies[0] == expected->frequency_hz;
+    std::cout << "  State, channel and LQA restored: " << (state_ok ? "PASS" : "FAIL") << "\n";
+    
+    // Link entered 10 s before the snapshot: 110 s of the 120 s timeout remain
+    restored.update(1000 + 109000);
+    bool still_linked = restored.get_state() == ALEState::LINKED;
+    restored.update(1000 + 111000);
+    bool timed_out = restored.get_state() != ALEState::LINKED;
+    std::cout << "  Link timeout rebased: " << (still_linked && timed_out ? "PASS" : "FAIL") << "\n";
+    
+    // Corrupt or truncated snapshots are rejected without touching state
+    ALEStateMachine untouched;
+    std::vector<uint8_t> corrupt = snapshot;
+    corrupt[corrupt.size() / 2] ^= 0x40;
+    bool rejected = !untouched.restore_snapshot(corrupt.data(), corrupt.size(), 0) &&
+                    !untouched.restore_snapshot(snapshot.data(), snapshot.size() - 1, 0) &&
+                    untouched.get_state() == ALEState::IDLE &&
+                    untouched.get_current_channel() == nullptr;
+    std::cout << "  Corrupt snapshot rejected: " << (rejected ? "PASS" : "FAIL") << "\n";
+    
+    // Partially assembled message survives the round trip
+    MessageAssembler assembler;
+    WordParser parser;
+    ALEWord to_word;
+    parser.parse_from_bits(static_cast<uint32_t>(WordType::TO) |
+                           (WordParser::encode_ascii("K6K") << 3), to_word);
+    to_word.timestamp_ms = 5000;
+    assembler.add_word(to_word);
+    
+    SnapshotWriter writer;
+    assembler.save_snapshot(writer);
+    SnapshotReader reader(writer.data().data(), writer.size());
+    MessageAssembler assembler2;
+    bool words_ok = assembler2.restore_snapshot(reader, 100) && assembler2.is_active();
+    
+    ALEWord from_word;
+    parser.parse_from_bits(static_cast<uint32_t>(WordType::FROM) |
+                           (WordParser::encode_ascii("W1A") << 3), from_word);
+    from_word.timestamp_ms = 5500;
+    ALEMessage msg;
+    bool completed = assembler2.add_word(from_word) && assembler2.get_message(msg) &&
+                     msg.call_type == CallType::INDIVIDUAL &&
+                     msg.to_addresses.size() == 1 && msg.to_addresses[0] == "K6K" &&
+                     msg.start_time_ms == 5100;
+    std::cout << "  Partial message restored: " << (words_ok && completed ? "PASS" : "FAIL") << "\n";
+    
+    // File round trip: background persister writes, startup maps it back
+    const std::string path = "test_state_machine.snapshot";
+    SnapshotPersister persister;
+    persister.start(path);
+    sm.enable_periodic_snapshot(&persister, 1000);
+    sm.update(60500);   // Interval not yet elapsed
+    sm.update(61000);
+    persister.flush();
+    bool periodic = persister.get_write_count() == 1 && persister.get_error_count() == 0;
+    persister.stop();
+    
+    ALEStateMachine from_file;
+    bool file_ok = periodic && from_file.load_snapshot_file(path, 0) &&
+                   from_file.get_state() == ALEState::LINKED &&
+                   from_file.get_current_channel()->frequency_hz == expected->frequency_hz;
+    std::remove(path.c_str());
+    std::cout << "  Background write + mapped load: " << (file_ok ? "PASS" : "FAIL") << "\n";
+    
+    return state_ok && still_linked && timed_out && rejected && words_ok && completed && file_ok;
+}
+
+// ============================================================================
+// Test 11: Transmit Sample Times
+// ============================================================================
+
+bool test_transmit_sample_times() {
+    std::cout << "\n[TEST 11] Transmit Sample Times\n";
+    std::cout << "===============================\n";
+    
+    ALEStateMachine sm;
+    WordTracker tracker;
+    
+    sm.set_transmit_callback([&tracker](const ALEWord& word) {
+        tracker.record(word);
+    });
+    
+    // Transmit words are scheduled on the capture clock, here past
+    // 2^32 samples
+    SampleClock clock;
+    clock.advance(UINT32_MAX);
+    clock.advance(8000);
+    sm.set_sample_clock(&clock);
+    
+    std::cout << "  Initiating individual call: ";
+    bool sent = sm.initiate_call("K6KB") && (tracker.count() == 2);
+    std::cout << (sent ? "PASS" : "FAIL") << "\n";
+    if (!sent) return false;
+    
+    // Back to back from the current sample
+    std::cout << "  Word sample times: ";
+    SampleTime start = UINT32_MAX + 8000ULL;
+    bool schedule_ok = (tracker.words[0].sample_time == start) &&
+                       (tracker.words[1].sample_time == start + 49 * 64);
+    std::cout << (schedule_ok ? "PASS" : "FAIL") << "\n";
+    
+    return schedule_ok;
+}
+
 // ============================================================================
 // Main Test Runner
 // ============================================================================
@@ -414,6 +723,10 @@ int run_all_tests() {
     if (test_lqa()) { pass_count++; } else { fail_count++; }
     if (test_timeouts()) { pass_count++; } else { fail_count++; }
     if (test_sounding()) { pass_count++; } else { fail_count++; }
+    if (test_transition_table()) { pass_count++; } else { fail_count++; }
+    if (test_listen_before_transmit()) { pass_count++; } else { fail_count++; }
+    if (test_snapshot_restore()) { pass_count++; } else { fail_count++; }
+    if (test_transmit_sample_times()) { pass_count++; } else { fail_count++; }
     
     std::cout << "\n";
     std::cout << "╔════════════════════════════════════════════════════════════╗\n";
@@ -0,0 +1,378 @@
+/**
+ * \file test_word_archive.cpp
+ * \brief Unit tests for the indexed word/message archive
+ */
+
+#include "word_archive.h"
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace ale;
+
+static const uint64_t DAY_MS = 24ULL * 3600 * 1000;
+static const uint64_t START_MS = 1700000000000ULL;
+
+static std::string make_directory() {
+    char path[] = "/tmp/word_archive_XXXXXX";
+    char* created = mkdtemp(path);
+    assert(created);
+    return created;
+}
+
+static std::vector<std::string> list_files(const std::string& directory) {
+    std::vector<std::string> files;
+    DIR* dir = opendir(directory.c_str());
+    while (dir) {
+        dirent* item = readdir(dir);
+        if (!item) {
+            closedir(dir);
+            break;
+        }
+        if (item->d_name[0] != '.') {
+            files.push_back(item->d_name);
+        }
+    }
+    return files;
+}
+
+static void remove_directory(const std::string& directory) {
+    for (const auto& name : list_files(directory)) {
+        std::remove((directory + "/" + name).c_str());
+    }
+    rmdir(directory.c_str());
+}
+
+static ALEWord make_word(WordType type, const char* address, uint8_t errors = 0) {
+    ALEWord word;
+    word.type = type;
+    std::memcpy(word.address, address, 3);
+    word.raw_payload = WordParser::encode_ascii(address);
+    word.fec_errors = errors;
+    word.valid = true;
+    return word;
+}
+
+static ALEMessage make_call(const std::string& to, const std::string& from) {
+    ALEMessage message;
+    message.call_type = CallType::INDIVIDUAL;
+    message.to_addresses.push_back(to);
+    message.from_address = from;
+    message.words.resize(4);
+    message.duration_ms = 1568;
+    message.complete = true;
+    return message;
+}
+
+// Calls from one station, words from everyone, across channels
+static void fill_sample(WordArchive& archive) {
+    bool ok = true;
+    ok &= archive.append_word(make_word(WordType::TO, "K6K"), 7073000, START_MS + 100);
+    ok &= archive.append_word(make_word(WordType::FROM, "W1A", 2), 7073000, START_MS + 200);
+    ok &= archive.append_message(make_call("K6K", "W1A"), 7073000, START_MS + 200);
+    ok &= archive.append_word(make_word(WordType::TIS, "N0C"), 10142000, START_MS + 5000);
+    ok &= archive.append_word(make_word(WordType::DATA, "ABC"), 10142000, START_MS + 5100);
+    ok &= archive.append_message(make_call("W1A", "K6K"), 14109000, START_MS + 9000);
+    assert(ok);
+}
+
+static void check_sample(const WordArchive& archive) {
+    std::vector<ArchiveRecord> results;
+    
+    // Everything, in time order
+    ArchiveQuery all;
+    [[maybe_unused]] size_t found = archive.query(all, results);
+    assert(found == 6);
+    for (size_t i = 1; i < results.size(); i++) {
+        assert(results[i - 1].time_ms <= results[i].time_ms);
+    }
+    
+    // Word fields
+    assert(!results[1].is_message);
+    assert(results[1].word_type == WordType::FROM);
+    assert(results[1].fec_errors == 2);
+    assert(results[1].valid);
+    assert(results[1].from_address == "W1A");
+    assert(results[1].raw_payload == WordParser::encode_ascii("W1A"));
+    
+    // Calls from W1A
+    ArchiveQuery from;
+    from.address = "W1A";
+    from.role = ArchiveRole::FROM;
+    from.include_words = false;
+    found = archive.query(from, results);
+    assert(found == 1);
+    assert(results[0].is_message);
+    assert(results[0].call_type == CallType::INDIVIDUAL);
+    assert(results[0].from_address == "W1A");
+    assert(results[0].to_addresses.size() == 1 && results[0].to_addresses[0] == "K6K");
+    assert(results[0].word_count == 4);
+    assert(results[0].duration_ms == 1568);
+    assert(results[0].frequency_hz == 7073000);
+    
+    // W1A in any role: its FROM word, its call, the call to it
+    ArchiveQuery any;
+    any.address = "W1A";
+    assert(archive.count(any) == 3);
+    any.role = ArchiveRole::TO;
+    assert(archive.count(any) == 1);
+    
+    // Frequency and time ranges
+    ArchiveQuery band;
+    band.min_frequency_hz = 7000000;
+    band.max_frequency_hz = 7300000;
+    assert(archive.count(band) == 3);
+    ArchiveQuery window;
+    window.start_ms = START_MS + 200;
+    window.end_ms = START_MS + 9000;
+    assert(archive.count(window) == 4);
+    
+    // DATA words are stored but not indexed by address
+    ArchiveQuery data;
+    data.address = "ABC";
+    assert(archive.count(data) == 0);
+    
+    // Unknown station
+    ArchiveQuery unknown;
+    unknown.address = "ZZZ";
+    assert(archive.count(unknown) == 0);
+    
+    // Limit keeps the earliest
+    ArchiveQuery limited;
+    limited.max_results = 2;
+    found = archive.query(limited, results);
+    assert(found == 2);
+    assert(results[1].time_ms == START_MS + 200);
+}
+
+void test_pending_queries() {
+    std::cout << "Test: Queries before sealing...\n";
+    
+    std::string directory = make_directory();
+    WordArchive archive;
+    [[maybe_unused]] bool opened = archive.open(directory);
+    assert(opened);
+    
+    fill_sample(archive);
+    assert(archive.pending_records() == 6);
+    assert(archive.segment_count() == 0);
+    check_sample(archive);
+    
+    archive.close();
+    remove_directory(directory);
+    std::cout << "  PASS\n";
+}
+
+void test_sealed_and_reopened() {
+    std::cout << "Test: Sealed segments survive reopen...\n";
+    
+    std::string directory = make_directory();
+    {
+        WordArchive archive;
+        [[maybe_unused]] bool opened = archive.open(directory);
+        assert(opened);
+        archive.set_segment_records(4);
+        fill_sample(archive);
+        
+        // One full segment sealed, two records pending
+        assert(archive.segment_count() == 1);
+        assert(archive.pending_records() == 2);
+        check_sample(archive);
+    }
+    
+    WordArchive archive;
+    [[maybe_unused]] bool opened = archive.open(directory);
+    assert(opened);
+    assert(archive.segment_count() == 2);
+    assert(archive.pending_records() == 0);
+    assert(archive.record_count() == 6);
+    check_sample(archive);
+    
+    // New segments continue the numbering
+    [[maybe_unused]] bool ok = archive.append_word(make_word(WordType::TIS, "N0C"), 3596000, START_MS + DAY_MS);
+    assert(ok);
+    ok = archive.flush();
+    assert(ok);
+    assert(archive.segment_count() == 3);
+    assert(list_files(directory).size() == 3);
+    
+    archive.close();
+    remove_directory(directory);
+    std::cout << "  PASS\n";
+}
+
+void test_out_of_order_appends() {
+    std::cout << "Test: Out-of-order appends...\n";
+    
+    std::string directory = make_directory();
+    WordArchive archive;
+    [[maybe_unused]] bool opened = archive.open(directory);
+    assert(opened);
+    
+    const uint64_t times[] = {500, 100, 400, 200, 300};
+    for (uint64_t time : times) {
+        [[maybe_unused]] bool ok = archive.append_word(make_word(WordType::TIS, "N0C"), 7073000, START_MS + time);
+        assert(ok);
+    }
+    [[maybe_unused]] bool ok = archive.flush();
+    assert(ok);
+    ok = archive.append_word(make_word(WordType::TIS, "N0C"), 7073000, START_MS + 250);
+    assert(ok);
+    
+    ArchiveQuery query;
+    query.address = "N0C";
+    query.start_ms = START_MS + 200;
+    query.end_ms = START_MS + 450;
+    std::vector<ArchiveRecord> results;
+    [[maybe_unused]] size_t found = archive.query(query, results);
+    assert(found == 4);
+    assert(results[0].time_ms == START_MS + 200);
+    assert(results[1].time_ms == START_MS + 250);
+    assert(results[3].time_ms == START_MS + 400);
+    
+    archive.close();
+    remove_directory(directory);
+    std::cout << "  PASS\n";
+}
+
+void test_corrupt_segment_skipped() {
+    std::cout << "Test: Corrupt segment skipped...\n";
+    
+    std::string directory = make_directory();
+    {
+        WordArchive archive;
+        [[maybe_unused]] bool opened = archive.open(directory);
+        assert(opened);
+        archive.set_segment_records(3);
+        fill_sample(archive);
+    }
+    assert(list_files(directory).size() == 2);
+    
+    // Damage one byte of the first segment
+    std::string path = directory + "/arc-00000001.seg";
+    FILE* file = std::fopen(path.c_str(), "r+b");
+    assert(file);
+    std::fseek(file, 40, SEEK_SET);
+    int byte = std::fgetc(file);
+    std::fseek(file, 40, SEEK_SET);
+    std::fputc(byte ^ 0x5A, file);
+    std::fclose(file);
+    
+    WordArchive archive;
+    [[maybe_unused]] bool opened = archive.open(directory);
+    assert(opened);
+    assert(archive.segment_count() == 1);
+    assert(archive.record_count() == 3);
+    
+    // The damaged file is left alone
+    [[maybe_unused]] bool ok = archive.append_word(make_word(WordType::TIS, "N0C"), 7073000, START_MS + DAY_MS);
+    assert(ok);
+    ok = archive.flush();
+    assert(ok);
+    assert(list_files(directory).size() == 3);
+    
+    archive.close();
+    remove_directory(directory);
+    std::cout << "  PASS\n";
+}
+
+void test_months_of_records() {
+    std::cout << "Test: Months of records...\n";
+    
+    const int STATIONS = 40;
+    const int RECORDS = 200000;
+    const uint64_t SPAN_MS = 90 * DAY_MS;
+    const uint32_t channels[] = {3596000, 5371000, 7073000, 10142000, 14109000, 18106000};
+    
+    std::vector<std::string> stations;
+    for (int i = 0; i < STATIONS; i++) {
+        char name[4];
+        snprintf(name, sizeof(name), "S%02d", i);
+        stations.push_back(name);
+    }
+    
+    std::string directory = make_directory();
+    WordArchive archive;
+    [[maybe_unused]] bool opened = archive.open(directory);
+    assert(opened);
+    archive.set_segment_records(16384);
+    
+    // "Calls from S07 on 7 MHz in the last week", counted while appending
+    const uint64_t week_start = START_MS + SPAN_MS - 7 * DAY_MS;
+    size_t expected = 0;
+    uint32_t state = 1;
+    for (int i = 0; i < RECORDS; i++) {
+        state = state * 1664525u + 1013904223u;
+        uint64_t time = START_MS + SPAN_MS * i / RECORDS;
+        uint32_t frequency = channels[(state >> 8) % 6];
+        const std::string& from = stations[(state >> 12) % STATIONS];
+        const std::string& to = stations[(state >> 20) % STATIONS];
+        [[maybe_unused]] bool ok = archive.append_message(make_call(to, from), frequency, time);
+        assert(ok);
+        if (from == "S07" && frequency == 7073000 && time >= week_start) {
+            expected++;
+        }
+    }
+    [[maybe_unused]] bool ok = archive.flush();
+    assert(ok);
+    assert(archive.segment_count() == (RECORDS + 16383) / 16384);
+    archive.close();
+    
+    // Fresh process: only bounds and dictionaries are loaded
+    auto start = std::chrono::steady_clock::now();
+    opened = archive.open(directory);
+    assert(opened);
+    auto opened_at = std::chrono::steady_clock::now();
+    
+    ArchiveQuery query;
+    query.address = "S07";
+    query.role = ArchiveRole::FROM;
+    query.min_frequency_hz = 7000000;
+    query.max_frequency_hz = 7300000;
+    query.start_ms = week_start;
+    std::vector<ArchiveRecord> results;
+    size_t found = archive.query(query, results);
+    auto queried_at = std::chrono::steady_clock::now();
+    
+    assert(expected > 0);
+    assert(found == expected);
+    for ([[maybe_unused]] const auto& record : results) {
+        assert(record.from_address == "S07");
+        assert(record.frequency_hz == 7073000);
+        assert(record.time_ms >= week_start);
+    }
+    
+    std::cout << "  " << RECORDS << " records, " << archive.segment_count() << " segments: open "
+              << std::chrono::duration<double, std::milli>(opened_at - start).count()
+              << " ms, query " << std::chrono::duration<double, std::milli>(queried_at - opened_at).count()
+              << " ms (" << found << " results)\n";
+    
+    archive.close();
+    remove_directory(directory);
+    std::cout << "  PASS\n";
+}
+
+int main() {
+    std::cout << "========================================\n";
+    std::cout << "Word Archive Tests\n";
+    std::cout << "========================================\n\n";
+    
+    test_pending_queries();
+    test_sealed_and_reopened();
+    test_out_of_order_appends();
+    test_corrupt_segment_skipped();
+    test_months_of_records();
+    
+    std::cout << "========================================\n";
+    std::cout << "All Word Archive tests PASSED!\n";
+    std::cout << "========================================\n";
+    return 0;
+}